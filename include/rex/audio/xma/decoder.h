@@ -12,8 +12,10 @@
 #pragma once
 
 #include <atomic>
+#include <condition_variable>
 #include <mutex>
 #include <queue>
+#include <vector>
 
 #include <rex/audio/xma/context.h>
 #include <rex/audio/xma/register_file.h>
@@ -52,6 +54,7 @@ class XmaDecoder {
   void WriteRegister(uint32_t addr, uint32_t value);
 
   bool is_paused() const { return paused_; }
+  // Blocks until every decode worker has parked.
   void Pause();
   void Resume();
 
@@ -59,7 +62,20 @@ class XmaDecoder {
   int GetContextId(uint32_t guest_ptr);
 
  private:
+  // Scheduling state of a context in the work queue. A context is only ever
+  // decoded by one worker at a time; a kick that arrives while it is being
+  // decoded is remembered and the context is queued again afterwards, so
+  // per-context work stays in kick order.
+  enum class ContextWorkState : uint8_t {
+    kIdle,
+    kQueued,
+    kRunning,
+    kRunningRequeue,
+  };
+
   void WorkerThreadMain();
+  // Queues a kicked context for decoding. Requires queue_mutex_.
+  bool QueueContext(uint32_t context_id);
 
   static uint32_t MMIOReadRegisterThunk(void* ppc_context, XmaDecoder* as,
                                         uint32_t addr) {
@@ -75,17 +91,24 @@ class XmaDecoder {
   runtime::Processor* processor_ = nullptr;
 
   std::atomic<bool> worker_running_ = {false};
-  kernel::object_ref<kernel::XHostThread> worker_thread_;
-  std::unique_ptr<rex::thread::Event> work_event_ = nullptr;
+  std::vector<kernel::object_ref<kernel::XHostThread>> worker_threads_;
+
+  // Guards work_queue_, context_work_state_, paused_ and parked_workers_.
+  std::mutex queue_mutex_;
+  // Signaled when work is queued, on resume and on shutdown.
+  std::condition_variable work_cond_;
+  // Signaled when a worker parks for Pause().
+  std::condition_variable pause_cond_;
+  std::queue<uint32_t> work_queue_;
+  uint32_t parked_workers_ = 0;
 
   bool paused_ = false;
-  rex::thread::Fence pause_fence_;   // Signaled when worker paused.
-  rex::thread::Fence resume_fence_;  // Signaled when resume requested.
 
   XmaRegisterFile register_file_;
 
   static const uint32_t kContextCount = 320;
   XmaContext contexts_[kContextCount];
+  ContextWorkState context_work_state_[kContextCount] = {};
   bit::BitMap context_bitmap_;
 
   uint32_t context_data_first_ptr_ = 0;
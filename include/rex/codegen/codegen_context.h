@@ -16,6 +16,7 @@
 #include <rex/codegen/binary_view.h>
 #include <rex/codegen/code_region.h>
 #include <rex/codegen/config.h>
+#include <rex/codegen/profile.h>
 #include <rex/result.h>
 #include <memory>
 #include <unordered_map>
@@ -69,6 +70,9 @@ struct AnalysisState {
     std::unordered_map<uint32_t, uint32_t> invalidInstructions;  ///< addr -> size
     std::unordered_set<uint32_t> knownIndirectCalls;             ///< bctr addresses
     std::vector<uint32_t> exceptionHandlerFuncs;                 ///< Handler addresses
+
+    /// Distinct functions at each byte offset of the RTTI vtables, for devirtualization
+    std::unordered_map<uint32_t, std::vector<uint32_t>> vtableSlotTargets;
 };
 
 /**
@@ -123,6 +127,7 @@ public:
     // === OWNED DATA (single source of truth) ===
     FunctionGraph graph;              ///< All functions (including imports)
     AnalysisErrors errors;            ///< Accumulated errors
+    CodegenProfile profile;           ///< Per-phase timings for --profile / codegen_bench
 
     /// Scan phase artifacts (passed to Discover for scanner setup)
     struct {
@@ -92,11 +92,21 @@ struct RecompilerConfig
     bool nonArgumentRegistersAsLocalVariables = false;
     bool nonVolatileRegistersAsLocalVariables = false;
     bool generateExceptionHandlers = false;  ///< Generate SEH exception handler wrappers
+    uint32_t codegenThreads = 0;             ///< Emission worker threads (0 = hardware concurrency, 1 = serial)
+    bool codegenCache = true;                ///< Reuse unchanged function bodies from the previous run
+    bool flagLiveness = true;                ///< Skip CR and XER[CA] updates nothing reads
+    bool flagLivenessAssumeAbi = false;      ///< Treat volatile CR fields and XER as dead at calls and returns
+    bool flushModeAnalysis = false;          ///< Track the FPU/VMX flush mode across labels and calls
+    uint32_t devirtualizeMaxTargets = 2;     ///< Guard indirect calls with up to this many likely targets (0 = off)
+    uint32_t inlineMaxInstructions = 0;      ///< Emit leaf functions up to this many instructions in place of calls (0 = off)
+    bool profileInstrument = false;          ///< Count function entries and indirect call targets at runtime
+    std::string profileUsePath;              ///< Execution profile to optimize against, relative to the config
 
     // === Analysis tuning (optional) ===
     uint32_t maxJumpExtension = 65536;     ///< Max bytes to extend function for jump table targets
     uint32_t dataRegionThreshold = 16;     ///< Consecutive invalid instructions to mark as data region
     uint32_t largeFunctionThreshold = 1048576;  ///< 1MB - warn if function exceeds this size
+    uint32_t analysisThreads = 0;          ///< Discovery worker threads (0 = hardware concurrency, 1 = serial)
 
     // === Manual overrides ===
     std::unordered_map<uint32_t, FunctionConfig> functions;  ///< Function/chunk configuration
@@ -104,10 +114,12 @@ struct RecompilerConfig
     std::unordered_map<uint32_t, MidAsmHook> midAsmHooks;
     uint32_t longJmpAddress = 0;
     uint32_t setJmpAddress = 0;
+    std::unordered_set<uint32_t> overriddenFunctions;  ///< Functions whose PPC_WEAK_FUNC is replaced at link time
 
     // === User hints (merged with analysis results in AnalysisState) ===
     std::unordered_map<uint32_t, uint32_t> invalidInstructionHints;  ///< addr -> size
     std::unordered_set<uint32_t> knownIndirectCallHints;  ///< bctr addresses that are vtable/computed calls
+    std::unordered_map<uint32_t, std::vector<uint32_t>> indirectCallTargets;  ///< bctr/bctrl address -> likely targets
     std::vector<uint32_t> exceptionHandlerFuncHints;  ///< Additional exception handler addresses
 
     /**
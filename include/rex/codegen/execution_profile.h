@@ -0,0 +1,68 @@
+/**
+ * @file        rex/codegen/execution_profile.h
+ * @brief       Guest execution counts fed back into codegen
+ *
+ * @copyright   Copyright (c) 2026 Tom Clay <tomc@tctechstuff.com>
+ *              All rights reserved.
+ *
+ * @license     BSD 3-Clause License
+ *              See LICENSE file in the project root for full license text.
+ */
+
+#pragma once
+
+#include <rex/result.h>
+#include <cstdint>
+#include <filesystem>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace rex::codegen {
+
+/// Where profile-guided codegen places a function
+enum class FunctionHeat : uint8_t
+{
+    Normal,
+    Hot,   ///< Among the functions making up kHotFraction of all calls
+    Cold,  ///< Never entered while profiling
+};
+
+/**
+ * Counts from a run of a `profile_instrument` build, written by
+ * rex::runtime::guest::GuestProfile and read back with `profile_use`.
+ *
+ * Usage:
+ *   auto profile = ExecutionProfile::Load(path);
+ *   if (profile && profile->heat(fn.base()) == FunctionHeat::Hot) ...
+ */
+class ExecutionProfile
+{
+public:
+    /// Share of all recorded calls the hot functions account for
+    static constexpr double kHotFraction = 0.9;
+
+    struct IndirectSite
+    {
+        uint64_t total = 0;  ///< Every call, including untracked targets
+        std::vector<std::pair<uint32_t, uint64_t>> targets;  ///< Most frequent first
+    };
+
+    /// Parse a profile file. Unknown record kinds are skipped.
+    static Result<ExecutionProfile> Load(const std::filesystem::path& path);
+
+    uint64_t entryCount(uint32_t function) const;
+    FunctionHeat heat(uint32_t function) const;
+    uint64_t totalEntries() const { return totalEntries_; }
+
+    /// Targets seen at each indirect call site, by bctr/bctrl address
+    const std::unordered_map<uint32_t, IndirectSite>& indirectSites() const { return indirectSites_; }
+
+private:
+    std::unordered_map<uint32_t, uint64_t> entries_;
+    std::unordered_map<uint32_t, IndirectSite> indirectSites_;
+    uint64_t totalEntries_ = 0;
+    uint64_t hotThreshold_ = 0;  ///< Smallest entry count that is still hot
+};
+
+} // namespace rex::codegen
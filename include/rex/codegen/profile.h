@@ -0,0 +1,95 @@
+/**
+ * @file        rex/codegen/profile.h
+ * @brief       Per-phase timing and throughput report for the codegen pipeline
+ *
+ * @copyright   Copyright (c) 2026 Tom Clay <tomc@tctechstuff.com>
+ *              All rights reserved.
+ *
+ * @license     BSD 3-Clause License
+ *              See LICENSE file in the project root for full license text.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace rex::codegen {
+
+/// Measurements for one pipeline phase. Zero counters are omitted from rates.
+struct PhaseProfile {
+    std::string name;
+    double wallMs = 0.0;
+    uint64_t peakRssBytes = 0;   ///< Process peak RSS when the phase ended
+    uint64_t instructions = 0;   ///< Instructions decoded by the phase
+    uint64_t functions = 0;      ///< Functions processed (emitted, for Recompile)
+    uint64_t bytesWritten = 0;   ///< Bytes of C++ produced (Recompile) or written to disk (Flush)
+};
+
+/**
+ * Collects PhaseProfile records as the pipeline runs.
+ *
+ * Analyze() and Recompiler record into CodegenContext::profile
+ * unconditionally; recording is a clock read and a getrusage per phase, so
+ * there is no separate "enabled" switch. `rexglue codegen --profile`
+ * (written to --profile_output, default codegen_profile.json next to the
+ * config) and codegen_bench serialize the result with toJson().
+ *
+ * Usage:
+ *   {
+ *       auto phase = ctx.profile.begin("Scan");
+ *       scanBinary(ctx);
+ *       phase.setInstructions(n);
+ *   }   // recorded here
+ */
+class CodegenProfile {
+public:
+    /// RAII scope for one phase; records on stop() or destruction.
+    class Phase {
+    public:
+        Phase(CodegenProfile& profile, std::string_view name);
+        ~Phase() { stop(); }
+
+        Phase(const Phase&) = delete;
+        Phase& operator=(const Phase&) = delete;
+
+        void setInstructions(uint64_t count) { record_.instructions = count; }
+        void setFunctions(uint64_t count) { record_.functions = count; }
+        void setBytesWritten(uint64_t bytes) { record_.bytesWritten = bytes; }
+
+        /// End the phase early. Later calls (and the destructor) do nothing.
+        void stop();
+
+    private:
+        CodegenProfile* profile_;
+        PhaseProfile record_;
+        std::chrono::steady_clock::time_point start_;
+        bool stopped_ = false;
+    };
+
+    Phase begin(std::string_view name) { return Phase(*this, name); }
+
+    const std::vector<PhaseProfile>& phases() const { return phases_; }
+    void clear() { phases_.clear(); }
+
+    /// Sum of wall time over all recorded phases.
+    double totalMs() const;
+
+    /**
+     * Serialize as JSON: {"phases": [...], "total_ms": N, "peak_rss_bytes": N}.
+     * Each phase carries its raw counters plus per-second rates for the
+     * counters that are nonzero.
+     */
+    std::string toJson() const;
+
+    /// Peak resident set size of this process so far, in bytes (0 if unavailable).
+    static uint64_t peakRssBytes();
+
+private:
+    std::vector<PhaseProfile> phases_;
+};
+
+} // namespace rex::codegen
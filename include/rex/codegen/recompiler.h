@@ -14,10 +14,13 @@
 #include <rex/codegen/config.h>
 #include <rex/codegen/recompiled_function.h>
 #include <rex/codegen/codegen_context.h>
+#include <rex/codegen/execution_profile.h>
 #include <filesystem>
 #include <memory>
 #include <vector>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <fmt/core.h>
 
 // Forward declarations
@@ -30,6 +33,8 @@ namespace codegen {
 
 // Forward declare Function from recompiled_function.h
 struct Function;
+class EmitCache;
+struct EmittedInsn;
 
 struct RecompilerLocalVariables
 {
@@ -62,13 +67,37 @@ enum class CSRState
     VMX
 };
 
+/// How a function leaves the host flush mode for its caller (see flush_mode.h)
+enum class FlushModeExit : uint8_t
+{
+    NoReturn,   ///< No path returns
+    Unchanged,  ///< Returns in whatever mode it was called in
+    FPU,        ///< Always returns with flush mode disabled
+    VMX,        ///< Always returns with flush mode enabled
+    Unknown,
+};
+
+/// Exit of every recompiled function, by base address
+using FlushModeExits = std::unordered_map<uint32_t, FlushModeExit>;
+
+/// Targets guarded ahead of the function table at each bctr/bctrl (see devirtualize.h)
+using IndirectCallTargets = std::unordered_map<uint32_t, std::vector<uint32_t>>;
+
+/// Bases of the leaf functions emitted in place of their calls (see inline_leaves.h)
+using InlineLeaves = std::unordered_set<uint32_t>;
+
 struct Recompiler
 {
     // Enforce In-order Execution of I/O constant for quick comparison
     // TODO: this shouldn't be here... find a new place for this EIEIO constant
     static constexpr uint32_t c_eieio = 0xAC06007C;
 
-    std::unique_ptr<rex::Runtime> runtime;
+    std::shared_ptr<rex::Runtime> runtime;  // Shared with emission workers
+    std::shared_ptr<const FlushModeExits> flushModeExits;  // Shared with emission workers
+    std::shared_ptr<const IndirectCallTargets> indirectCallTargets;  // Shared with emission workers
+    std::shared_ptr<const InlineLeaves> inlineLeaves;  // Shared with emission workers
+    std::shared_ptr<const ExecutionProfile> executionProfile;  // Shared with emission workers
+    IndirectCallTargets profileCallTargets;  // Observed by executionProfile, below [[indirect_call_targets]]
     CodegenContext* ctx_ = nullptr;  // Non-owning pointer to context
     std::string out;
     size_t cppFileIndex = 0;
@@ -76,6 +105,9 @@ struct Recompiler
     // Deferred file writes - buffered until validation passes
     std::vector<std::pair<std::string, std::string>> pendingWrites;
 
+    // Every file name produced by the last FlushPendingWrites (written or unchanged)
+    std::unordered_set<std::string> generatedFiles;
+
     // Track if validation failed during Analyze()
     bool validationFailed_ = false;
 
@@ -98,6 +130,7 @@ struct Recompiler
     }
 
     /// Recompile a single instruction (internal).
+    /// @param liveFlags CR bits and XER[CA] read after the instruction (see flag_liveness.h)
     bool recompile(
         const FunctionNode& fn,
         uint32_t base,
@@ -105,11 +138,21 @@ struct Recompiler
         const uint32_t* data,
         std::unordered_map<uint32_t, JumpTable>::iterator& switchTable,
         RecompilerLocalVariables& localVariables,
-        CSRState& csrState);
+        CSRState& csrState,
+        uint64_t liveFlags);
 
     /// Recompile an entire function (internal).
     bool recompile(const FunctionNode& fn);
 
+    /**
+     * Emit the body of an inlineLeaves function in place of a call to it.
+     * @param liveAfter CR bits and XER[CA] the caller reads after the call
+     */
+    bool recompileInline(const FunctionNode& callee,
+                         RecompilerLocalVariables& localVariables,
+                         CSRState& csrState,
+                         uint64_t liveAfter);
+
     /**
      * Recompile all functions and write output.
      * Generated code will include SDK headers (rexglue/runtime/ppc_context.h).
@@ -118,6 +161,26 @@ struct Recompiler
      */
     bool recompile(bool force);
 
+    /**
+     * Run the passes that need every function before any is emitted: late
+     * switch tables, the execution profile, flush-mode exits, indirect call
+     * targets and inline leaves. Call it before recompile(fn) when not going
+     * through recompile(bool).
+     * @param functions Functions to emit (must not be imports); the profile may reorder them
+     */
+    void analyzeFunctions(std::vector<const FunctionNode*>& functions);
+
+    /**
+     * Emit every function into its own buffer, in parallel when
+     * config().codegenThreads allows it. Result order matches the input
+     * order, so stitching the buffers reproduces a serial run byte-for-byte.
+     * @param functions Functions to emit (must not be imports)
+     * @param cache Optional prepared EmitCache; hits skip emission entirely
+     * @return One emitted C++ body per input function
+     */
+    std::vector<std::string> emitFunctions(const std::vector<const FunctionNode*>& functions,
+                                           EmitCache* cache = nullptr);
+
     /**
      * Save current output buffer to pending writes.
      * @param name Optional custom filename; if empty, uses auto-generated name
@@ -128,6 +191,25 @@ struct Recompiler
     void FlushPendingWrites();
 
 private:
+    /// Run late jump-table detection up front so emission never mutates config().
+    void detectLateSwitchTables(const std::vector<const FunctionNode*>& functions);
+
+    /**
+     * Decode a function's instructions in emission order. Read-only, so
+     * emission workers can call it concurrently.
+     * @param warnUnmapped Warn about blocks with no mapped data
+     */
+    std::vector<EmittedInsn> decodeFunction(const FunctionNode& fn, bool warnUnmapped = false) const;
+
+    /// Solve flushModeExits over every function before emission.
+    void analyzeFlushModes(const std::vector<const FunctionNode*>& functions);
+
+    /**
+     * Load config().profileUsePath into executionProfile, collect the targets
+     * it saw into profileCallTargets, and move hot functions to the front.
+     */
+    void applyExecutionProfile(std::vector<const FunctionNode*>& functions);
+
     // Accessors for ctx_ members (convenience)
     FunctionGraph& graph() { return ctx_->graph; }
     const FunctionGraph& graph() const { return ctx_->graph; }
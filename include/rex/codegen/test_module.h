@@ -42,6 +42,16 @@ public:
      */
     void Load(uint32_t base_address, const uint8_t* data, size_t size);
 
+    /**
+     * @brief Declare a trailing PDATA table so the full Analyze() pipeline can run
+     * @param address Guest address of the table; must lie inside the loaded data
+     * @param size Table size in bytes (IMAGE_CE_RUNTIME_FUNCTION entries)
+     *
+     * Everything from address to the end of the image becomes a non-executable
+     * .pdata section and .text is trimmed to end before it.
+     */
+    void SetExceptionDirectory(uint32_t address, uint32_t size);
+
     // Module interface overrides
     const std::string& name() const override { return name_; }
     void set_name(const std::string& name) { name_ = name; }
@@ -49,6 +59,9 @@ public:
     uint32_t base_address() const override { return base_address_; }
     uint32_t image_size() const override { return size_; }
     uint32_t entry_point() const override { return base_address_; }
+    uint32_t exception_directory_rva() const override { return exception_dir_address_ ? exception_dir_address_ - base_address_ : 0; }
+    uint32_t exception_directory_size() const override { return exception_dir_size_; }
+    uint32_t exception_directory_address() const override { return exception_dir_address_; }
     bool ContainsAddress(uint32_t address) override;
 
 protected:
@@ -58,6 +71,8 @@ private:
     std::string name_{"test"};
     uint32_t base_address_ = 0;
     uint32_t size_ = 0;
+    uint32_t exception_dir_address_ = 0;
+    uint32_t exception_dir_size_ = 0;
 };
 
 }  // namespace rex::codegen
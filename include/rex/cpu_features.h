@@ -0,0 +1,38 @@
+/**
+ * @file        cpu_features.h
+ * @brief       Host CPU instruction set extensions
+ *
+ * @copyright   Copyright (c) 2026 Tom Clay <tomc@tctechstuff.com>
+ *              All rights reserved.
+ *
+ * @license     BSD 3-Clause License
+ *              See LICENSE file in the project root for full license text.
+ */
+
+#pragma once
+
+namespace rex {
+
+/// Extensions the host CPU supports, probed once. Flags for the other
+/// architecture are always false. The AVX flags also require the OS to save
+/// the wider register state.
+struct CpuFeatures {
+  // x86-64
+  bool ssse3 = false;
+  bool sse41 = false;
+  bool pclmul = false;
+  bool avx2 = false;
+  bool avx512f = false;
+  bool avx512bw = false;
+  bool bmi2 = false;
+  // ARM64
+  bool crc32 = false;
+  // Both: AES-NI/SHA-NI on x86-64, the ARMv8 crypto extensions on ARM64.
+  bool aes = false;
+  bool sha1 = false;
+  bool sha256 = false;
+};
+
+const CpuFeatures& GetCpuFeatures();
+
+}  // namespace rex
@@ -0,0 +1,166 @@
+/**
+ * @file        crypto.h
+ * @brief       CRC32, SHA-1, SHA-256 and AES-128 with CPU-accelerated paths
+ *
+ * @copyright   Copyright (c) 2026 Tom Clay <tomc@tctechstuff.com>
+ *              All rights reserved.
+ *
+ * @license     BSD 3-Clause License
+ *              See LICENSE file in the project root for full license text.
+ *
+ * @remarks     Each primitive has a portable implementation and, where the
+ *              CPU has them, PCLMULQDQ/SHA-NI/AES-NI (x86-64) or ARMv8
+ *              CRC/SHA/AES instruction paths, selected per call. Setting the
+ *              crypto_hardware cvar to false forces the portable code.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace rex::crypto {
+
+/// Whether the accelerated path for each primitive can run on this CPU.
+/// These ignore the crypto_hardware cvar.
+bool HasHardwareCrc32();
+bool HasHardwareSha1();
+bool HasHardwareSha256();
+bool HasHardwareAes();
+
+/// Continues a CRC-32 (IEEE 802.3, reflected, as zlib's crc32()) over
+/// `length` bytes. Start with `crc` = 0.
+uint32_t Crc32(uint32_t crc, const void* data, size_t length);
+
+/// Runs the SHA-1 compression function over whole 64-byte blocks.
+void Sha1Compress(uint32_t state[5], const uint8_t* blocks, size_t block_count);
+/// Runs the SHA-256 compression function over whole 64-byte blocks.
+void Sha256Compress(uint32_t state[8], const uint8_t* blocks, size_t block_count);
+
+namespace detail {
+
+struct Sha1Traits {
+    static constexpr size_t kStateWords = 5;
+    static constexpr uint32_t kInitialState[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE,
+                                                  0x10325476, 0xC3D2E1F0};
+    static void Compress(uint32_t* state, const uint8_t* blocks, size_t block_count) {
+        Sha1Compress(state, blocks, block_count);
+    }
+};
+
+struct Sha256Traits {
+    static constexpr size_t kStateWords = 8;
+    static constexpr uint32_t kInitialState[8] = {0x6A09E667, 0xBB67AE85, 0x3C6EF372,
+                                                  0xA54FF53A, 0x510E527F, 0x9B05688C,
+                                                  0x1F83D9AB, 0x5BE0CD19};
+    static void Compress(uint32_t* state, const uint8_t* blocks, size_t block_count) {
+        Sha256Compress(state, blocks, block_count);
+    }
+};
+
+/// Incremental Merkle-Damgard hash with SHA padding. The raw state is
+/// exposed so that guest-side hash contexts can be resumed and saved.
+template <typename Traits>
+class ShaHash {
+ public:
+    static constexpr size_t kBlockSize = 64;
+    static constexpr size_t kStateWords = Traits::kStateWords;
+    static constexpr size_t kDigestSize = kStateWords * 4;
+
+    ShaHash() { std::memcpy(state_, Traits::kInitialState, sizeof(state_)); }
+
+    /// Resumes a hash after `count` bytes; `buffer` holds the last
+    /// `count % kBlockSize` of them.
+    ShaHash(const uint32_t* state, uint64_t count, const uint8_t* buffer) : count_(count) {
+        std::memcpy(state_, state, sizeof(state_));
+        std::memcpy(buffer_, buffer, count % kBlockSize);
+    }
+
+    void Update(const void* data, size_t length) {
+        auto bytes = static_cast<const uint8_t*>(data);
+        size_t used = size_t(count_ % kBlockSize);
+        count_ += length;
+        if (used && length) {
+            size_t take = kBlockSize - used < length ? kBlockSize - used : length;
+            std::memcpy(buffer_ + used, bytes, take);
+            bytes += take;
+            length -= take;
+            if (used + take < kBlockSize) {
+                return;
+            }
+            Traits::Compress(state_, buffer_, 1);
+        }
+        if (length >= kBlockSize) {
+            Traits::Compress(state_, bytes, length / kBlockSize);
+            bytes += length & ~(kBlockSize - 1);
+            length &= kBlockSize - 1;
+        }
+        if (length) {
+            std::memcpy(buffer_, bytes, length);
+        }
+    }
+
+    /// Pads and writes the big-endian digest. Afterwards state() holds the
+    /// final digest words; the hash must not be updated again.
+    void Final(uint8_t digest[kDigestSize]) {
+        uint64_t bit_count = count_ * 8;
+        size_t used = size_t(count_ % kBlockSize);
+        buffer_[used++] = 0x80;
+        if (used > kBlockSize - 8) {
+            std::memset(buffer_ + used, 0, kBlockSize - used);
+            Traits::Compress(state_, buffer_, 1);
+            used = 0;
+        }
+        std::memset(buffer_ + used, 0, kBlockSize - 8 - used);
+        for (size_t i = 0; i < 8; ++i) {
+            buffer_[kBlockSize - 1 - i] = uint8_t(bit_count >> (i * 8));
+        }
+        Traits::Compress(state_, buffer_, 1);
+        for (size_t i = 0; i < kStateWords; ++i) {
+            digest[i * 4 + 0] = uint8_t(state_[i] >> 24);
+            digest[i * 4 + 1] = uint8_t(state_[i] >> 16);
+            digest[i * 4 + 2] = uint8_t(state_[i] >> 8);
+            digest[i * 4 + 3] = uint8_t(state_[i]);
+        }
+    }
+
+    const uint32_t* state() const { return state_; }
+    uint64_t count() const { return count_; }
+    /// The `count() % kBlockSize` bytes not yet compressed.
+    const uint8_t* buffer() const { return buffer_; }
+
+ private:
+    uint32_t state_[kStateWords];
+    uint64_t count_ = 0;
+    uint8_t buffer_[kBlockSize] = {};
+};
+
+}  // namespace detail
+
+using Sha1 = detail::ShaHash<detail::Sha1Traits>;
+using Sha256 = detail::ShaHash<detail::Sha256Traits>;
+
+/// AES-128 with both key schedules expanded up front.
+class Aes128 {
+ public:
+    static constexpr size_t kBlockSize = 16;
+
+    explicit Aes128(const uint8_t key[16]);
+
+    void EncryptBlock(const uint8_t in[16], uint8_t out[16]) const;
+    void DecryptBlock(const uint8_t in[16], uint8_t out[16]) const;
+
+    /// CBC over whole blocks; `iv` is updated so that consecutive calls
+    /// chain. `in` and `out` may be the same buffer.
+    void EncryptCbc(uint8_t iv[16], const uint8_t* in, uint8_t* out, size_t length) const;
+    void DecryptCbc(uint8_t iv[16], const uint8_t* in, uint8_t* out, size_t length) const;
+
+ private:
+    // Round keys as big-endian words, in the layout of rijndael-alg-fst.
+    // The decryption schedule is the equivalent inverse cipher's.
+    uint32_t encrypt_keys_[44];
+    uint32_t decrypt_keys_[44];
+};
+
+}  // namespace rex::crypto
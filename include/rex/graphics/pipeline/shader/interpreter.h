@@ -15,6 +15,9 @@
 #include <array>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <memory>
+#include <unordered_map>
 
 #include <rex/assert.h>
 #include <rex/graphics/register_file.h>
@@ -28,8 +31,11 @@ namespace rex::graphics {
 
 class ShaderInterpreter {
  public:
-  ShaderInterpreter(const RegisterFile& register_file, const memory::Memory& memory)
-      : register_file_(register_file), memory_(memory) {}
+  // Largest number of vertices ExecuteBatch processes at once.
+  static constexpr uint32_t kMaxBatchLanes = 16;
+
+  ShaderInterpreter(const RegisterFile& register_file, const memory::Memory& memory);
+  ~ShaderInterpreter();
 
   class ExportSink {
    public:
@@ -39,6 +45,17 @@ class ShaderInterpreter {
                         const float* value, uint32_t value_mask) {}
   };
 
+  // Receives the exports of ExecuteBatch, value[component][lane], for the
+  // lanes in lane_mask.
+  class BatchExportSink {
+   public:
+    virtual ~BatchExportSink() = default;
+    virtual void AllocExport(ucode::AllocType type, uint32_t size) {}
+    virtual void Export(ucode::ExportRegister export_register,
+                        const float (*value)[kMaxBatchLanes],
+                        uint32_t value_mask, uint32_t lane_mask) {}
+  };
+
   void SetTraceWriter(TraceWriter* new_trace_writer) {
     trace_writer_ = new_trace_writer;
   }
@@ -48,9 +65,22 @@ class ShaderInterpreter {
     export_sink_ = new_export_sink;
   }
 
+  BatchExportSink* GetBatchExportSink() const { return batch_export_sink_; }
+  void SetBatchExportSink(BatchExportSink* new_batch_export_sink) {
+    batch_export_sink_ = new_batch_export_sink;
+  }
+
   const float* temp_registers() const { return &temp_registers_[0][0]; }
   float* temp_registers() { return &temp_registers_[0][0]; }
 
+  // The lanes of one component of a temporary register used by ExecuteBatch.
+  const float* batch_temp_register(uint32_t index, uint32_t component) const {
+    return batch_temp_registers_[index][component];
+  }
+  float* batch_temp_register(uint32_t index, uint32_t component) {
+    return batch_temp_registers_[index][component];
+  }
+
   static bool CanInterpretShader(const Shader& shader) {
     assert_true(shader.is_ucode_analyzed());
     // Texture instructions are not very common in vertex shaders (and not used
@@ -64,14 +94,21 @@ class ShaderInterpreter {
   void SetShader(xenos::ShaderType shader_type, const uint32_t* ucode) {
     shader_type_ = shader_type;
     ucode_ = ucode;
+    program_ = nullptr;
   }
-  void SetShader(const Shader& shader) {
-    assert_true(CanInterpretShader(shader));
-    SetShader(shader.type(), shader.ucode_dwords());
-  }
+  // Also selects the pre-decoded form of the shader for ExecuteBatch, decoding
+  // it on first use.
+  void SetShader(const Shader& shader);
 
   void Execute();
 
+  // Executes the shader for lane_count (1 to kMaxBatchLanes) vertices at once,
+  // with the temporary registers in batch_temp_register and the exports going
+  // to the batch export sink. Lanes run in lockstep with per-lane predication;
+  // from a control flow instruction the lanes disagree on, the rest of the
+  // shader is executed one lane at a time. Requires SetShader(const Shader&).
+  void ExecuteBatch(uint32_t lane_count);
+
  private:
   struct State {
     ucode::VertexFetchInstruction vfetch_full_last;
@@ -105,6 +142,22 @@ class ShaderInterpreter {
     }
   };
 
+  struct BatchState {
+    ucode::VertexFetchInstruction vfetch_full_last[kMaxBatchLanes];
+    uint32_t vfetch_address_dwords[kMaxBatchLanes];
+    float previous_scalar[kMaxBatchLanes];
+    int32_t address_register[kMaxBatchLanes];
+    // One bit per lane.
+    uint32_t predicate;
+
+    void Reset() { std::memset(this, 0, sizeof(*this)); }
+  };
+
+  struct DecodedAluSource;
+  struct DecodedAluInstruction;
+  struct DecodedFetchInstruction;
+  struct Program;
+
   static float FlushDenormal(float value) {
     uint32_t bits = *reinterpret_cast<const uint32_t*>(&value);
     bits &= (bits & UINT32_C(0x7F800000)) ? ~UINT32_C(0) : (UINT32_C(1) << 31);
@@ -123,11 +176,36 @@ class ShaderInterpreter {
   }
   const std::array<float, 4> GetFloatConstant(
       uint32_t address, bool is_relative, bool relative_address_is_a0) const;
+  // Takes the final index, with relative addressing already applied.
+  const std::array<float, 4> GetFloatConstant(int32_t index) const;
 
+  // Runs the control flow starting from cf_index with the current state.
+  void ExecuteControlFlow(uint32_t cf_index);
   void ExecuteAluInstruction(ucode::AluInstruction instr);
   void StoreFetchResult(uint32_t dest, bool is_dest_relative, uint32_t swizzle,
                         const float* value);
   void ExecuteVertexFetchInstruction(ucode::VertexFetchInstruction instr);
+  void LoadVertexFetchResult(ucode::VertexFetchInstruction instr,
+                             const xenos::xe_gpu_vertex_fetch_t& fetch_constant,
+                             uint32_t address_dwords, float* result) const;
+
+  static std::unique_ptr<Program> DecodeProgram(const Shader& shader);
+  template <uint32_t Lanes>
+  void ExecuteBatchLanes(uint32_t lane_mask);
+  template <uint32_t Lanes>
+  void LoadBatchAluSource(const DecodedAluSource& source,
+                          uint32_t component_count,
+                          float (*value)[kMaxBatchLanes]) const;
+  template <uint32_t Lanes>
+  void ExecuteBatchAluInstruction(const DecodedAluInstruction& instr,
+                                  uint32_t lane_mask);
+  void ExecuteBatchFetchInstruction(const DecodedFetchInstruction& instr,
+                                    uint32_t lane_mask);
+  void StoreBatchFetchResult(uint32_t dest, bool is_dest_relative,
+                             uint32_t swizzle, const float* value,
+                             uint32_t lane);
+  // Finishes the lanes one by one with Execute's control flow loop.
+  void ExecuteLanesFromControlFlow(uint32_t cf_index, uint32_t lane_mask);
 
   const RegisterFile& register_file_;
   const memory::Memory& memory_;
@@ -135,14 +213,23 @@ class ShaderInterpreter {
   TraceWriter* trace_writer_ = nullptr;
 
   ExportSink* export_sink_ = nullptr;
+  BatchExportSink* batch_export_sink_ = nullptr;
 
   xenos::ShaderType shader_type_ = xenos::ShaderType::kVertex;
   const uint32_t* ucode_ = nullptr;
 
+  // Decoded shaders by ucode hash.
+  std::unordered_map<uint64_t, std::unique_ptr<Program>> programs_;
+  const Program* program_ = nullptr;
+
   // For both inputs and locals.
   float temp_registers_[xenos::kMaxShaderTempRegisters][4];
+  // Structure of arrays, [register][component][lane].
+  alignas(64) float batch_temp_registers_[xenos::kMaxShaderTempRegisters][4]
+                                         [kMaxBatchLanes];
 
   State state_;
+  BatchState batch_state_;
 };
 
 }  // namespace rex::graphics
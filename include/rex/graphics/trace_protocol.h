@@ -23,7 +23,7 @@ static const char kTraceExtension[] = "xtr";
 // Other changes besides the file format may require bumps, such as
 // anything that changes what is recorded into the files (new GPU
 // command processor commands, etc).
-constexpr uint32_t kTraceFormatVersion = 1;
+constexpr uint32_t kTraceFormatVersion = 2;
 
 // Trace file header identifying information about the trace.
 // This must be positioned at the start of the file and must only occur once.
@@ -55,6 +55,7 @@ enum class TraceCommandType : uint32_t {
   kEvent,
   kRegisters,
   kGammaRamp,
+  kMemoryReference,
 };
 
 struct PrimaryBufferStartCommand {
@@ -113,6 +114,21 @@ struct MemoryCommand {
   uint32_t decoded_length;
 };
 
+// Repeats a kMemoryRead or kMemoryWrite whose data is identical to that of an
+// earlier memory command in the same file, so the data is only stored once.
+struct MemoryReferenceCommand {
+  TraceCommandType type;
+
+  // kMemoryRead or kMemoryWrite, as the command would have been recorded.
+  TraceCommandType memory_type;
+  // Base physical memory pointer this read or write starts at.
+  uint32_t base_ptr;
+  // Number of bytes the data occupies in memory after decoding.
+  uint32_t decoded_length;
+  // Offset from the start of the file of the MemoryCommand holding the data.
+  uint64_t source_offset;
+};
+
 // Represents a full 10 MB snapshot of EDRAM contents, for trace initialization
 // (since replaying the trace will reconstruct its state at any point later) as
 // a sequence of tiles with row-major samples (2x multisampling as 1x2 samples,
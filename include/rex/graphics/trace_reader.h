@@ -105,6 +105,10 @@ class TraceReader {
 
  protected:
   void ParseTrace();
+  // Returns the earlier command holding the data of a kMemoryReference, or
+  // nullptr if the reference doesn't point at a memory command.
+  const MemoryCommand* ResolveMemoryReference(
+      const MemoryReferenceCommand* cmd) const;
   bool DecompressMemory(MemoryEncodingFormat encoding_format, const void* src,
                         size_t src_size, void* dest, size_t dest_size);
 
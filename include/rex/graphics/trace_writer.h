@@ -11,16 +11,28 @@
 
 #pragma once
 
+#include <condition_variable>
 #include <cstdio>
+#include <deque>
 #include <filesystem>
+#include <memory>
+#include <mutex>
 #include <set>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
+#include <rex/hash.h>
+#include <rex/thread.h>
 #include <rex/graphics/registers.h>
 #include <rex/graphics/trace_protocol.h>
 
 namespace rex::graphics {
 
+// Commands are serialized uncompressed into a buffer on the calling (command
+// processor) thread. Full buffers are handed to a writer thread, which
+// compresses the payloads and does the file I/O, and are then recycled.
 class TraceWriter {
  public:
   explicit TraceWriter(uint8_t* membase);
@@ -53,15 +65,86 @@ class TraceWriter {
                       uint32_t gamma_ramp_rw_component);
 
  private:
+  // Buffer size at which it is handed to the writer thread.
+  static constexpr size_t kSubmitThreshold = 4 * 1024 * 1024;
+  // Submitting blocks while this many buffers are waiting to be written.
+  static constexpr size_t kMaxQueuedBuffers = 8;
+  // Memory payloads shorter than this aren't worth a reference command.
+  static constexpr size_t kDedupThreshold = 256;
+  // Only this many of the most recent payloads can be referenced.
+  static constexpr size_t kMaxDedupPayloads = 16384;
+
+  struct PayloadHasher {
+    size_t operator()(const XXH128_hash_t& hash) const {
+      return static_cast<size_t>(hash.low64);
+    }
+  };
+  struct PayloadEqual {
+    bool operator()(const XXH128_hash_t& a, const XXH128_hash_t& b) const {
+      return XXH128_isEqual(a, b);
+    }
+  };
+
+  struct Buffer {
+    std::vector<uint8_t> data;
+    // Offset in data and payload ID of each MemoryCommand whose data may be
+    // referenced later. MemoryReferenceCommand::source_offset holds the ID
+    // until the writer thread resolves it to a file offset.
+    std::vector<std::pair<size_t, uint32_t>> payloads;
+    bool flush = false;
+  };
+
   void WriteMemoryCommand(TraceCommandType type, uint32_t base_ptr,
                           size_t length, const void* host_ptr = nullptr);
 
+  // Appends a command header, starting a new command.
+  template <typename T>
+  void Append(const T& cmd) {
+    BeginCommand();
+    Append(&cmd, sizeof(cmd));
+  }
+  // Appends data following the current command's header.
+  void Append(const void* data, size_t length);
+  void BeginCommand();
+  void SubmitBuffer(bool flush);
+
+  void WriterThread();
+  void WriteBuffer(Buffer& buffer);
+  template <typename T>
+  void WritePayload(T cmd, const uint8_t* data, uint32_t length,
+                    bool compress);
+  void WriteFile(const void* data, size_t length);
+
   std::set<uint64_t> cached_memory_reads_;
+  // Memory payloads already in the file: 128-bit content hash to payload ID.
+  // The hash alone identifies the bytes, so no copy of them is kept. Hashes
+  // are evicted oldest first once kMaxDedupPayloads are tracked.
+  std::unordered_map<XXH128_hash_t, uint32_t, PayloadHasher, PayloadEqual>
+      written_payloads_;
+  std::deque<XXH128_hash_t> payload_order_;
+  uint32_t next_payload_id_ = 0;
   uint8_t* membase_;
   FILE* file_ = nullptr;
 
   bool compress_output_ = true;
   size_t compression_threshold_ = 1024;
+
+  std::unique_ptr<Buffer> current_buffer_;
+
+  // Writer thread input is protected with queue_lock_; queue_cond_ is
+  // signaled both when a buffer is queued and when one has been written.
+  std::mutex queue_lock_;
+  std::condition_variable queue_cond_;
+  std::deque<std::unique_ptr<Buffer>> queued_buffers_;
+  std::vector<std::unique_ptr<Buffer>> free_buffers_;
+  bool writer_thread_shutdown_ = false;
+  std::unique_ptr<rex::thread::Thread> writer_thread_;
+
+  // Owned by the writer thread while it runs.
+  uint64_t file_offset_ = 0;
+  // File offset of each payload's MemoryCommand, by payload ID.
+  std::vector<uint64_t> payload_offsets_;
+  std::vector<char> compressed_data_;
 };
 
 }  // namespace rex::graphics
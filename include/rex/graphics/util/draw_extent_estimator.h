@@ -39,28 +39,53 @@ class DrawExtentEstimator {
                         const Shader& vertex_shader);
 
  private:
-  class PositionYExportSink : public ShaderInterpreter::ExportSink {
+  // Collects the exports needed for the vertex Y extent for every lane of an
+  // ExecuteBatch.
+  class PositionYExportSink : public ShaderInterpreter::BatchExportSink {
    public:
-    void Export(ucode::ExportRegister export_register, const float* value,
-                uint32_t value_mask) override;
+    void Export(ucode::ExportRegister export_register,
+                const float (*value)[ShaderInterpreter::kMaxBatchLanes],
+                uint32_t value_mask, uint32_t lane_mask) override;
 
     void Reset() {
-      position_y_.reset();
-      position_w_.reset();
-      point_size_.reset();
-      vertex_kill_.reset();
+      position_y_lanes_ = 0;
+      position_w_lanes_ = 0;
+      point_size_lanes_ = 0;
+      vertex_kill_lanes_ = 0;
     }
 
-    const std::optional<float>& position_y() const { return position_y_; }
-    const std::optional<float>& position_w() const { return position_w_; }
-    const std::optional<float>& point_size() const { return point_size_; }
-    const std::optional<uint32_t>& vertex_kill() const { return vertex_kill_; }
+    std::optional<float> position_y(uint32_t lane) const {
+      return Get(position_y_lanes_, position_y_, lane);
+    }
+    std::optional<float> position_w(uint32_t lane) const {
+      return Get(position_w_lanes_, position_w_, lane);
+    }
+    std::optional<float> point_size(uint32_t lane) const {
+      return Get(point_size_lanes_, point_size_, lane);
+    }
+    std::optional<uint32_t> vertex_kill(uint32_t lane) const {
+      return Get(vertex_kill_lanes_, vertex_kill_, lane);
+    }
 
    private:
-    std::optional<float> position_y_;
-    std::optional<float> position_w_;
-    std::optional<float> point_size_;
-    std::optional<uint32_t> vertex_kill_;
+    template <typename T>
+    static std::optional<T> Get(uint32_t lanes, const T* values,
+                                uint32_t lane) {
+      if (!(lanes & (UINT32_C(1) << lane))) {
+        return std::nullopt;
+      }
+      return values[lane];
+    }
+
+    // Bits of the lanes for which each value has been exported.
+    uint32_t position_y_lanes_ = 0;
+    uint32_t position_w_lanes_ = 0;
+    uint32_t point_size_lanes_ = 0;
+    uint32_t vertex_kill_lanes_ = 0;
+    float position_y_[ShaderInterpreter::kMaxBatchLanes];
+    float position_w_[ShaderInterpreter::kMaxBatchLanes];
+    float point_size_[ShaderInterpreter::kMaxBatchLanes];
+    uint32_t vertex_kill_[ShaderInterpreter::kMaxBatchLanes];
   };
 
   const RegisterFile& register_file_;
@@ -12,9 +12,10 @@
 
 #include <atomic>
 #include <condition_variable>
+#include <deque>
 #include <functional>
-#include <list>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -231,11 +232,33 @@ class KernelState {
       uint32_t overlapped_ptr, std::move_only_function<void()> pre_callback = nullptr,
       std::move_only_function<void()> post_callback = nullptr);
 
+  // Runs fn on the host I/O worker pool. Used for overlapped file I/O so the
+  // issuing guest thread doesn't block on the host disk. Work items run in
+  // FIFO order but may run concurrently with each other.
+  void QueueIoWork(std::move_only_function<void()> fn);
+
   bool Save(stream::ByteStream* stream);
   bool Restore(stream::ByteStream* stream);
 
  private:
+  // FIFO work queue served by host threads that are started on first use.
+  struct WorkerPool {
+    explicit WorkerPool(const char* name) : name(name) {}
+    const char* name;
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::deque<std::move_only_function<void()>> queue;
+    std::vector<object_ref<XHostThread>> threads;
+    bool running = false;
+  };
+
   void LoadKernelModule(object_ref<KernelModule> kernel_module);
+  // Starts thread_count threads on the pool's first use.
+  void QueueWork(WorkerPool& pool, uint32_t thread_count,
+                 std::move_only_function<void()> fn);
+  void WorkerThreadMain(WorkerPool& pool);
+  void ShutdownWorkerPool(WorkerPool& pool);
+  void FinishDeferredOverlapped();
 
   Runtime* emulator_;
   memory::Memory* memory_;
@@ -263,12 +286,19 @@ class KernelState {
 
   uint32_t process_info_block_address_ = 0;
 
-  std::atomic<bool> dispatch_thread_running_;
-  object_ref<XHostThread> dispatch_thread_;
   // Must be guarded by the global critical region.
   util::NativeList dpc_list_;
-  std::condition_variable_any dispatch_cond_;
-  std::list<std::move_only_function<void()>> dispatch_queue_;
+
+  // Deferred overlapped completions scheduled on the timer queue and not yet
+  // finished. Destruction waits for this to drain.
+  std::atomic<uint32_t> deferred_pending_{0};
+  std::atomic<bool> deferred_shutdown_{false};
+
+  // Overlapped file I/O runs on io_pool_. Deferred overlapped completions get
+  // deferred_pool_ to themselves, as some (XAM UI dialogs) block until the
+  // user answers and must not hold up disk reads meanwhile.
+  WorkerPool io_pool_{"Kernel I/O"};
+  WorkerPool deferred_pool_{"Kernel Deferred"};
 
   bit::BitMap tls_bitmap_;
 
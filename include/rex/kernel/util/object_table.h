@@ -10,6 +10,9 @@
  * @modified    Tom Clay, 2026 - Adapted for ReXGlue runtime
  */
 
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -25,6 +28,14 @@ class ByteStream;
 
 namespace rex::kernel::util {
 
+// Handle table for kernel objects.
+//
+// Lookups (LookupObject) never take a lock: the table is a fixed directory of
+// pages that are never moved once published, and each slot counts the lookups
+// in flight on it so RemoveHandle can wait them out before dropping the
+// table's reference. Allocation, handle counts (RetainHandle, ReleaseHandle),
+// the per-object handle lists and the name table are guarded by the table's
+// own mutex, which is independent of the global critical region.
 class ObjectTable {
  public:
   ObjectTable();
@@ -47,7 +58,7 @@ class ObjectTable {
 
   template <typename T>
   object_ref<T> LookupObject(X_HANDLE handle) {
-    auto object = LookupObject(handle, false);
+    auto object = LookupAndRetain(handle);
     if (object) {
       assert_true(object->type() == T::kObjectType);
     }
@@ -80,12 +91,32 @@ class ObjectTable {
 
  private:
   struct ObjectTableEntry {
-    int handle_ref_count = 0;
-    XObject* object = nullptr;
+    // Lookups currently between reading `object` and retaining it.
+    std::atomic<uint32_t> readers{0};
+    std::atomic<int32_t> handle_ref_count{0};
+    std::atomic<XObject*> object{nullptr};
   };
 
+  // Slots live in fixed-size pages so growing the table never moves an entry
+  // a concurrent lookup may be reading. The directory covers every handle
+  // value from kHandleBase up.
+  static constexpr uint32_t kPageShift = 12;
+  static constexpr uint32_t kPageSize = 1u << kPageShift;
+  static constexpr uint32_t kMaxSlots = (0u - XObject::kHandleBase) >> 2;
+  static constexpr uint32_t kMaxPages = kMaxSlots >> kPageShift;
+
+  ObjectTableEntry& EntryAt(uint32_t slot) {
+    return pages_[slot >> kPageShift][slot & (kPageSize - 1)];
+  }
   ObjectTableEntry* LookupTable(X_HANDLE handle);
-  XObject* LookupObject(X_HANDLE handle, bool already_locked);
+  XObject* LookupAndRetain(X_HANDLE handle);
+  static XObject* RetainEntry(ObjectTableEntry& entry);
+  static void WaitForReaders(ObjectTableEntry& entry);
+  // Empties the slot; mutex_ must be held. Returns the table's reference, or
+  // null if the slot was already empty.
+  XObject* DetachEntry(ObjectTableEntry& entry, X_HANDLE handle);
+  // Drops the reference DetachEntry returned, after the lock is released.
+  static void FinishRemoval(ObjectTableEntry& entry, XObject* object);
   void GetObjectsByType(XObject::Type type,
                         std::vector<object_ref<XObject>>* results);
 
@@ -96,9 +127,9 @@ class ObjectTable {
   X_STATUS FindFreeSlot(uint32_t* out_slot);
   bool Resize(uint32_t new_capacity);
 
-  rex::thread::global_critical_region global_critical_region_;
-  uint32_t table_capacity_ = 0;
-  ObjectTableEntry* table_ = nullptr;
+  std::mutex mutex_;  // Allocation, XObject::handles() and name_table_
+  std::atomic<uint32_t> table_capacity_{0};
+  std::unique_ptr<std::unique_ptr<ObjectTableEntry[]>[]> pages_;
   uint32_t last_free_entry_ = 0;
   std::unordered_map<string::string_key_case, X_HANDLE> name_table_;
 };
@@ -10,6 +10,9 @@
  * @modified    Tom Clay, 2026 - Adapted for ReXGlue runtime
  */
 
+#include <deque>
+#include <functional>
+#include <mutex>
 #include <string>
 
 #include <rex/kernel/xevent.h>
@@ -102,14 +105,26 @@ class XFile : public XObject {
 
   X_STATUS ReadScatter(uint32_t segments_guest_address, uint32_t length,
                        uint64_t byte_offset, uint32_t* out_bytes_read,
-                       uint32_t apc_context);
+                       uint32_t apc_context, bool notify_completion = true);
 
   X_STATUS Write(uint32_t buffer_guess_address, uint32_t buffer_length,
                  uint64_t byte_offset, uint32_t* out_bytes_written,
-                 uint32_t apc_context);
+                 uint32_t apc_context, bool notify_completion = true);
 
   X_STATUS SetLength(size_t length);
 
+  // Runs an overlapped operation on the kernel I/O pool. Operations on one
+  // file run one at a time in issue order; different files run in parallel.
+  void QueueAsyncIo(std::move_only_function<void()> fn);
+
+  // Overlapped requests pass notify_completion = false above and report here
+  // once the guest's status block holds the result: posts to the IO
+  // completion ports and signals the file. ResetCompletion() unsignals the
+  // file when a request starts.
+  void NotifyCompletion(uint32_t apc_context, X_STATUS result,
+                        uint32_t bytes_transferred);
+  void ResetCompletion() { async_event_->Reset(); }
+
   void RegisterIOCompletionPort(uint32_t key, object_ref<XIOCompletion> port);
   void RemoveIOCompletionPort(uint32_t key);
 
@@ -129,12 +144,19 @@ class XFile : public XObject {
  private:
   XFile();
 
+  void DrainAsyncIo();
+
   rex::filesystem::File* file_ = nullptr;
   std::unique_ptr<rex::thread::Event> async_event_ = nullptr;
 
   std::mutex completion_port_lock_;
   std::vector<std::pair<uint32_t, object_ref<XIOCompletion>>> completion_ports_;
 
+  std::mutex async_io_lock_;
+  std::deque<std::move_only_function<void()>> async_io_queue_;
+  // True while a drain of async_io_queue_ is queued or running on the pool.
+  bool async_io_running_ = false;
+
   // TODO(benvanik): create flags, open state, etc.
 
   uint64_t position_ = 0;
@@ -99,6 +99,56 @@ union PageEntry {
   };
 };
 
+// Index of the free (state == 0) pages of a heap page table, kept alongside
+// it so allocation can find a fitting run in O(log n) rather than walking the
+// page table. This is a segment tree over pages where each node records the
+// longest free prefix, suffix and inner run of the pages it covers.
+class FreePageIndex {
+ public:
+  static constexpr uint32_t kNotFound = UINT32_MAX;
+
+  // Sizes the index for page_count pages, all free.
+  void Initialize(uint32_t page_count);
+  // Marks every page free.
+  void Reset();
+
+  void MarkFree(uint32_t first_page, uint32_t page_count) {
+    Set(first_page, page_count, true);
+  }
+  void MarkUsed(uint32_t first_page, uint32_t page_count) {
+    Set(first_page, page_count, false);
+  }
+
+  // Lowest page p >= begin with [p, p + count) free and p + count <= end.
+  uint32_t FindFirst(uint32_t begin, uint32_t end, uint32_t count) const;
+  // Highest page p >= begin with [p, p + count) free and p + count <= end.
+  uint32_t FindLast(uint32_t begin, uint32_t end, uint32_t count) const;
+  // First used page in [begin, end), or end if they are all free.
+  uint32_t FindUsed(uint32_t begin, uint32_t end) const;
+
+ private:
+  struct Node {
+    uint32_t prefix;  // Free pages at the start of the node's range.
+    uint32_t suffix;  // Free pages at the end of the node's range.
+    uint32_t best;    // Longest free run anywhere in the node's range.
+  };
+
+  void Set(uint32_t first_page, uint32_t page_count, bool free);
+  void Pull(uint32_t node, uint32_t half);
+  uint32_t FindFirst(uint32_t node, uint32_t lo, uint32_t len, uint32_t begin,
+                     uint32_t end, uint32_t count, uint32_t& run) const;
+  uint32_t FindLast(uint32_t node, uint32_t lo, uint32_t len, uint32_t begin,
+                    uint32_t end, uint32_t count, uint32_t& run) const;
+  uint32_t FindUsed(uint32_t node, uint32_t lo, uint32_t len, uint32_t begin,
+                    uint32_t end) const;
+
+  uint32_t page_count_ = 0;
+  // Leaves in the tree; a power of two >= page_count_. Leaves past
+  // page_count_ are permanently used so no run extends beyond the heap.
+  uint32_t leaf_count_ = 0;
+  std::vector<Node> nodes_;
+};
+
 // Heap abstraction for page-based allocation.
 class BaseHeap {
  public:
@@ -209,6 +259,9 @@ class BaseHeap {
   uint32_t host_address_offset_;
   rex::thread::global_critical_region global_critical_region_;
   std::vector<PageEntry> page_table_;
+  // Free runs of page_table_; must be updated whenever a page changes between
+  // free and allocated.
+  FreePageIndex free_pages_;
 };
 
 // Normal heap allowing allocations from guest virtual address ranges.
@@ -261,6 +314,9 @@ class PhysicalHeap : public BaseHeap {
       std::unique_lock<std::recursive_mutex> global_lock_locked_once,
       uint32_t virtual_address, uint32_t length, bool is_write,
       bool unwatch_exact_range, bool unprotect = true);
+  // Triggers callbacks for the watched pages written since the last poll if
+  // writes are watched without page protection.
+  void PollWrites();
 
   uint32_t GetPhysicalAddress(uint32_t address) const;
 
@@ -449,6 +505,19 @@ class Memory {
       uint32_t virtual_address, uint32_t length, bool is_write,
       bool unwatch_exact_range, bool unprotect = true);
 
+  // With the userfaultfd write watch backend (see the write_watch cvar), the
+  // host records writes to watched pages instead of raising access violations,
+  // and they become invalidation notifications only here, in one batch. Must be
+  // called before using the guest-written contents of physical memory, such as
+  // before executing GPU commands. Does nothing with page protection watches.
+  void PollPhysicalMemoryWrites();
+
+  // Whether physical memory writes are watched by the host and need polling
+  // rather than by page protection.
+  bool is_physical_memory_write_watch_polled() const {
+    return write_watch_ != nullptr;
+  }
+
   // Allocates virtual memory from the 'system' heap.
   // System memory is kept separate from game memory but is still accessible
   // using normal guest virtual addresses. Kernel structures and other internal
@@ -549,6 +618,9 @@ class Memory {
   } views_ = {{0, 0, 0, 0, 0, 0, 0, 0, 0}};
 
   std::unique_ptr<runtime::MMIOHandler> mmio_handler_;
+  // Write watching for the guest views of physical memory if not using page
+  // protection.
+  std::unique_ptr<rex::memory::WriteWatch> write_watch_;
 
   struct {
     VirtualHeap v00000000;
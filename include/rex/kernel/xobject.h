@@ -222,9 +222,27 @@ class XObject {
   }
 
   // Stash native pointer into X_DISPATCH_HEADER
+  // The handle is written before the signature is published so that a reader
+  // who sees the signature (LoadStashedHandle) also sees the matching handle.
   static void StashHandle(X_DISPATCH_HEADER* header, uint32_t handle) {
-    header->wait_list_flink = kXObjSignature;
-    header->wait_list_blink = handle;
+    std::atomic_ref<uint32_t>(header->wait_list_blink.value)
+        .store(be<uint32_t>(handle).value, std::memory_order_relaxed);
+    std::atomic_ref<uint32_t>(header->wait_list_flink.value)
+        .store(be<uint32_t>(kXObjSignature).value, std::memory_order_release);
+  }
+
+  // Returns the handle stashed by StashHandle, or 0 if the header has not
+  // been initialized by us. Safe to call without any lock held.
+  static uint32_t LoadStashedHandle(X_DISPATCH_HEADER* header) {
+    uint32_t flink = std::atomic_ref<uint32_t>(header->wait_list_flink.value)
+                         .load(std::memory_order_acquire);
+    if (flink != be<uint32_t>(kXObjSignature).value) {
+      return 0;
+    }
+    be<uint32_t> handle;
+    handle.value = std::atomic_ref<uint32_t>(header->wait_list_blink.value)
+                       .load(std::memory_order_relaxed);
+    return handle;
   }
 
   static uint32_t TimeoutTicksToMs(int64_t timeout_ticks);
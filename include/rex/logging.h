@@ -16,20 +16,28 @@
 #include <spdlog/spdlog.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/sinks/basic_file_sink.h>
+#include <spdlog/details/os.h>
 #include <spdlog/fmt/fmt.h>
 #include <memory>
 #include <array>
+#include <atomic>
+#include <cstddef>
+#include <new>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <map>
 #include <cstdlib>
 #include <cassert>
+#include <tuple>
+#include <type_traits>
 #include <utility>
 
 // Logging CVAR declarations (defined in flags.cpp)
 REXCVAR_DECLARE(std::string, log_level);
 REXCVAR_DECLARE(std::string, log_file);
 REXCVAR_DECLARE(bool, log_verbose);
+REXCVAR_DECLARE(bool, log_async);
 REXCVAR_DECLARE(bool, enable_console);
 namespace rex {
 
@@ -110,6 +118,9 @@ void InitLogging(const char* log_file = nullptr,
 /// Shutdown logging (flush and cleanup)
 void ShutdownLogging();
 
+/// Write out everything logged so far, including queued async messages
+void FlushLogging();
+
 /// Get logger for a specific category
 std::shared_ptr<spdlog::logger> GetLogger(LogCategory category);
 
@@ -157,6 +168,164 @@ LogConfig BuildLogConfig(const char* log_file,
 /// Get the current guest thread ID for logging
 uint32_t GetLogGuestThreadId();
 
+//=============================================================================
+// Level Check and Async Queue (used by the macros below)
+//=============================================================================
+
+namespace detail {
+
+/// Level of each category's logger, mirrored so that a disabled statement
+/// costs one relaxed load. Zero (trace) until logging is initialized, so the
+/// first statement reaches GetLoggerRaw(), which initializes it.
+inline std::array<std::atomic<int>, std::to_underlying(LogCategory::Count)>
+    g_category_levels{};
+
+/// Set while log_async is on: statements are queued for the writer thread.
+inline std::atomic<bool> g_async_logging{false};
+
+/// Logger for a category without the shared_ptr refcount round trip.
+spdlog::logger* GetLoggerRaw(LogCategory category);
+
+/// A queued statement. The format string must be a literal (it is kept by
+/// pointer); the arguments are copied into `args` and formatted later by
+/// `format`, which also destroys them.
+struct AsyncLogRecord {
+    static constexpr size_t kArgBytes = 192;
+
+    void (*format)(AsyncLogRecord& record, spdlog::memory_buf_t& out);
+    spdlog::log_clock::time_point time;
+    spdlog::source_loc loc;
+    size_t thread_id;
+    LogCategory category;
+    spdlog::level::level_enum level;
+    alignas(std::max_align_t) std::byte args[kArgBytes];
+};
+
+/// Reserves the calling thread's next ring slot, waiting for the writer if
+/// the ring is full. Must be followed by CommitAsyncRecord(). Returns nullptr
+/// if the record can't be queued, because the writer is stopping or the
+/// thread is exiting; it is then written with WriteRecordNow() instead.
+AsyncLogRecord* BeginAsyncRecord();
+void CommitAsyncRecord();
+void WriteRecordNow(AsyncLogRecord& record);
+
+// Arguments are captured by value. Strings are copied since the caller's
+// buffer may be gone by the time the writer formats; anything else that is
+// not a plain value makes the statement format on the calling thread.
+template <typename T>
+constexpr bool kIsAsyncString =
+    std::is_convertible_v<const T&, std::string_view> && !std::is_arithmetic_v<T>;
+
+template <typename T>
+using AsyncArg = std::conditional_t<kIsAsyncString<std::decay_t<T>>, std::string,
+                                    std::decay_t<T>>;
+
+template <typename T>
+constexpr bool kIsAsyncCapturable =
+    kIsAsyncString<std::decay_t<T>> || std::is_arithmetic_v<std::decay_t<T>> ||
+    std::is_enum_v<std::decay_t<T>> ||
+    (std::is_pointer_v<std::decay_t<T>> &&
+     !std::is_same_v<std::remove_cv_t<std::remove_pointer_t<std::decay_t<T>>>, char>);
+
+template <typename... Args>
+struct AsyncLogPayload {
+    fmt::string_view format;
+    std::tuple<AsyncArg<Args>...> args;
+
+    static void Format(AsyncLogRecord& record, spdlog::memory_buf_t& out) {
+        auto* payload = std::launder(reinterpret_cast<AsyncLogPayload*>(record.args));
+        std::apply(
+            [&](const auto&... values) {
+                fmt::vformat_to(fmt::appender(out), payload->format,
+                                fmt::make_format_args(values...));
+            },
+            payload->args);
+        payload->~AsyncLogPayload();
+    }
+};
+
+/// Already-formatted text, for statements that could not be captured.
+struct AsyncLogText {
+    std::string text;
+
+    static void Format(AsyncLogRecord& record, spdlog::memory_buf_t& out) {
+        auto* payload = std::launder(reinterpret_cast<AsyncLogText*>(record.args));
+        out.append(payload->text.data(), payload->text.data() + payload->text.size());
+        payload->~AsyncLogText();
+    }
+};
+
+template <typename Payload, typename... CtorArgs>
+void QueueAsync(LogCategory category, spdlog::source_loc loc,
+                spdlog::level::level_enum level, CtorArgs&&... ctor_args) {
+    static_assert(sizeof(Payload) <= AsyncLogRecord::kArgBytes);
+    static_assert(alignof(Payload) <= alignof(std::max_align_t));
+    AsyncLogRecord local;
+    AsyncLogRecord* record = BeginAsyncRecord();
+    bool queued = record != nullptr;
+    if (!queued) {
+        record = &local;
+    }
+    record->format = &Payload::Format;
+    record->time = spdlog::log_clock::now();
+    record->loc = loc;
+    record->thread_id = spdlog::details::os::thread_id();
+    record->category = category;
+    record->level = level;
+    new (record->args) Payload{std::forward<CtorArgs>(ctor_args)...};
+    if (queued) {
+        CommitAsyncRecord();
+    } else {
+        WriteRecordNow(*record);
+    }
+}
+
+template <typename... Args>
+void LogAsync(LogCategory category, spdlog::source_loc loc,
+              spdlog::level::level_enum level, fmt::format_string<Args...> format,
+              Args&&... args) {
+    using Payload = AsyncLogPayload<Args...>;
+    if constexpr ((kIsAsyncCapturable<Args> && ...) &&
+                  sizeof(Payload) <= AsyncLogRecord::kArgBytes &&
+                  alignof(Payload) <= alignof(std::max_align_t)) {
+        QueueAsync<Payload>(category, loc, level, fmt::string_view(format),
+                            std::tuple<AsyncArg<Args>...>(std::forward<Args>(args)...));
+    } else {
+        QueueAsync<AsyncLogText>(category, loc, level,
+                                 fmt::format(format, std::forward<Args>(args)...));
+    }
+}
+
+template <typename... Args>
+void Log(LogCategory category, spdlog::source_loc loc, spdlog::level::level_enum level,
+         fmt::format_string<Args...> format, Args&&... args) {
+    if (g_async_logging.load(std::memory_order_relaxed)) {
+        LogAsync(category, loc, level, format, std::forward<Args>(args)...);
+    } else if (auto* logger = GetLoggerRaw(category)) {
+        logger->log(loc, level, format, std::forward<Args>(args)...);
+    }
+}
+
+/// Single non-literal message, e.g. a std::string built by the caller.
+template <typename T>
+void Log(LogCategory category, spdlog::source_loc loc, spdlog::level::level_enum level,
+         const T& message) {
+    if (g_async_logging.load(std::memory_order_relaxed)) {
+        LogAsync(category, loc, level, "{}", message);
+    } else if (auto* logger = GetLoggerRaw(category)) {
+        logger->log(loc, level, message);
+    }
+}
+
+}  // namespace detail
+
+/// True if a statement at `level` in `category` would be written
+inline bool ShouldLog(LogCategory category, spdlog::level::level_enum level) {
+    return static_cast<int>(level) >=
+           detail::g_category_levels[std::to_underlying(category)].load(
+               std::memory_order_relaxed);
+}
+
 //=============================================================================
 // Internal Macros (DO NOT USE DIRECTLY)
 //=============================================================================
@@ -167,9 +336,10 @@ uint32_t GetLogGuestThreadId();
 
 #define REX_LOG_IMPL(cat, lvl, ...) \
     do { \
-        if (auto _rex_log = ::rex::GetLogger(::rex::LogCategory::cat)) { \
-            _rex_log->log(spdlog::source_loc{__FILE__, __LINE__, __FUNCTION__}, \
-                          lvl, __VA_ARGS__); \
+        if (::rex::ShouldLog(::rex::LogCategory::cat, lvl)) { \
+            ::rex::detail::Log(::rex::LogCategory::cat, \
+                               spdlog::source_loc{__FILE__, __LINE__, __FUNCTION__}, \
+                               lvl, __VA_ARGS__); \
         } \
     } while(0)
 
@@ -285,7 +455,7 @@ uint32_t GetLogGuestThreadId();
 #define REX_FATAL(fmt, ...) \
     do { \
         REXLOG_CRITICAL("[FATAL] " fmt __VA_OPT__(,) __VA_ARGS__); \
-        if (auto _l = ::rex::GetLogger()) _l->flush(); \
+        ::rex::FlushLogging(); \
         std::abort(); \
     } while(0)
 
@@ -293,7 +463,7 @@ uint32_t GetLogGuestThreadId();
 #define REX_FATAL_FN(fmt, ...) \
     do { \
         REXLOG_CRITICAL("[FATAL] {}: " fmt, __FUNCTION__ __VA_OPT__(,) __VA_ARGS__); \
-        if (auto _l = ::rex::GetLogger()) _l->flush(); \
+        ::rex::FlushLogging(); \
         std::abort(); \
     } while(0)
 
@@ -303,7 +473,7 @@ uint32_t GetLogGuestThreadId();
         if (!(cond)) { \
             REXLOG_CRITICAL("[FATAL] {}: check failed: " #cond " - " fmt, \
                 __FUNCTION__ __VA_OPT__(,) __VA_ARGS__); \
-            if (auto _l = ::rex::GetLogger()) _l->flush(); \
+            ::rex::FlushLogging(); \
             std::abort(); \
         } \
     } while(0)
@@ -15,9 +15,12 @@
 #include <cstring>
 #include <filesystem>
 #include <functional>
+#include <memory>
 #include <string>
 #include <string_view>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 #include <rex/assert.h>
 #include <rex/byte_order.h>
@@ -159,6 +162,34 @@ void* MapFileView(FileMappingHandle handle, void* base_address, size_t length,
                   PageAccess access, size_t file_offset);
 bool UnmapFileView(FileMappingHandle handle, void* base_address, size_t length);
 
+// Records the first write to each page of armed ranges without raising access
+// violations - the host kernel marks the pages as written by itself, and the
+// written pages are collected later in batches. Backed by userfaultfd
+// asynchronous write protection and PAGEMAP_SCAN (Linux 6.7+), which also work
+// on shared file mappings; not available on other hosts.
+class WriteWatch {
+ public:
+  // Returns nullptr if the host doesn't support write watching.
+  static std::unique_ptr<WriteWatch> Create();
+  ~WriteWatch();
+
+  // Enables watching in a mapped range, needed once before Arm.
+  bool Register(void* base_address, size_t length);
+  // Forgets earlier writes to the pages in the range and records the next.
+  bool Arm(void* base_address, size_t length);
+  // Appends the runs of pages in the range written since they were armed, as
+  // (offset from base_address, length), and arms them again.
+  bool CollectWritten(void* base_address, size_t length,
+                      std::vector<std::pair<size_t, size_t>>& written_out);
+
+ private:
+  WriteWatch(int userfault_fd, int pagemap_fd)
+      : userfault_fd_(userfault_fd), pagemap_fd_(pagemap_fd) {}
+
+  int userfault_fd_;
+  int pagemap_fd_;
+};
+
 inline size_t hash_combine(size_t seed) { return seed; }
 
 template <typename T, typename... Ts>
@@ -174,6 +205,20 @@ inline void* low_address(void* address) {
 
 void copy_128_aligned(void* dest, const void* src, size_t count);
 
+// Kernels behind the copy_and_swap_* functions. The widest one the CPU
+// supports is picked on first use; benchmarks and tests may pin another.
+enum class SwapKernel {
+  kScalar,
+  kSSSE3,
+  kAVX2,
+  kAVX512,
+  kNEON,
+};
+bool IsSwapKernelSupported(SwapKernel kernel);
+SwapKernel GetSwapKernel();
+// Returns false (and changes nothing) if the kernel is not supported.
+bool SetSwapKernel(SwapKernel kernel);
+
 void copy_and_swap_16_aligned(void* dest, const void* src, size_t count);
 void copy_and_swap_16_unaligned(void* dest, const void* src, size_t count);
 void copy_and_swap_32_aligned(void* dest, const void* src, size_t count);
@@ -15,3 +15,4 @@
 #include <rex/runtime/guest/types.h>
 #include <rex/runtime/guest/memory.h>
 #include <rex/runtime/guest/exceptions.h>
+#include <rex/runtime/guest/profile.h>
@@ -81,6 +81,8 @@ using PPCFunc = void(PPCContext& ctx, uint8_t* base);
 #define PPC_EXTERN_FUNC(x) extern PPC_FUNC(x)
 #define PPC_EXTERN_IMPORT(x) extern "C" PPC_FUNC(x)  // For __imp__ kernel imports
 #define PPC_WEAK_FUNC(x) __attribute__((weak,noinline)) PPC_FUNC(x)
+#define PPC_FUNC_IMPL_HOT(x) extern "C" __attribute__((hot)) PPC_FUNC(x)    // Profile-guided placement
+#define PPC_FUNC_IMPL_COLD(x) extern "C" __attribute__((cold)) PPC_FUNC(x)
 
 // Compiler-specific assume hint for alignment
 #if defined(__clang__)
@@ -0,0 +1,85 @@
+/**
+ * @file        runtime/guest/profile.h
+ * @brief       Execution counters for profile-guided recompilation
+ *
+ * @copyright   Copyright (c) 2026 Tom Clay <tomc@tctechstuff.com>
+ *              All rights reserved.
+ *
+ * @license     BSD 3-Clause License
+ *              See LICENSE file in the project root for full license text.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+
+namespace rex::runtime::guest {
+
+/**
+ * Counts recorded by code generated with `profile_instrument = true`.
+ *
+ * Holds one entry counter per guest function and a small target histogram
+ * per indirect call site, indexed by address like the function table. Every
+ * counter is a relaxed atomic, so an instrumented call costs one uncontended
+ * add. `rexglue codegen --profile_use` reads the file written by Save().
+ */
+class GuestProfile {
+ public:
+  /// Targets tracked per indirect call site; the rest only add to a total
+  static constexpr size_t kSiteTargets = 4;
+
+  GuestProfile(uint32_t code_base, uint32_t code_size);
+  ~GuestProfile();
+
+  GuestProfile(const GuestProfile&) = delete;
+  GuestProfile& operator=(const GuestProfile&) = delete;
+
+  void RecordEntry(uint32_t function) {
+    uint32_t index = (function - code_base_) >> 2;
+    if (index < slot_count_) {
+      entries_[index].fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  void RecordIndirect(uint32_t site, uint32_t target);
+
+  /**
+   * Write the counts as text, one record per line:
+   *   entry <function> <count>
+   *   indirect <site> <target> <count>
+   * Addresses are hex. Calls to untracked targets are recorded with target 0.
+   */
+  bool Save(const std::filesystem::path& path) const;
+
+ private:
+  struct IndirectSite {
+    std::atomic<uint32_t> targets[kSiteTargets] = {};
+    std::atomic<uint64_t> counts[kSiteTargets] = {};
+    std::atomic<uint64_t> other{0};
+  };
+
+  uint32_t code_base_;
+  uint32_t slot_count_;
+  std::unique_ptr<std::atomic<uint64_t>[]> entries_;
+  std::unique_ptr<std::atomic<IndirectSite*>[]> sites_;  // Allocated on first call
+};
+
+/// Recorder for instrumented code, or null when not profiling
+extern GuestProfile* g_guest_profile;
+
+}  // namespace rex::runtime::guest
+
+#define PPC_PROFILE_ENTRY(addr) \
+  do { \
+    if (auto* profile_ = ::rex::runtime::guest::g_guest_profile) \
+      profile_->RecordEntry(addr); \
+  } while (0)
+
+#define PPC_PROFILE_INDIRECT(site, target) \
+  do { \
+    if (auto* profile_ = ::rex::runtime::guest::g_guest_profile) \
+      profile_->RecordIndirect(site, target); \
+  } while (0)
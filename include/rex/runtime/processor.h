@@ -20,6 +20,7 @@
 #include <rex/memory/mapped_memory.h>
 #include <rex/thread/mutex.h>
 #include <rex/runtime/guest/context.h>
+#include <rex/runtime/guest/profile.h>
 #include <rex/runtime/export_resolver.h>
 #include <rex/runtime/module.h>
 #include <rex/runtime/thread_state.h>
@@ -109,6 +110,9 @@ class Processor {
   ::PPCFunc* GetFunction(uint32_t guest_address);
   bool HasFunctionTable() const { return function_table_initialized_; }
 
+  // Writes the counts of a profile_instrument build to --guest_profile, if set
+  void SaveProfile();
+
  private:
   memory::Memory* memory_ = nullptr;
   ExportResolver* export_resolver_ = nullptr;
@@ -126,6 +130,9 @@ class Processor {
   uint32_t image_base_ = 0;
   uint32_t image_size_ = 0;
   bool function_table_initialized_ = false;
+
+  // Counters for profile_instrument builds, when --guest_profile is set
+  std::unique_ptr<guest::GuestProfile> profile_;
 };
 
 }  // namespace rex::runtime
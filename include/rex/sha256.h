@@ -2,6 +2,8 @@
  * SHA256 hashing utilities
  *
  * Provides SHA256 hashing for strings and files, used for cache invalidation.
+ * Hex-string convenience over rex::crypto::Sha256 (rex/crypto.h), which
+ * does the hashing; use that directly for incremental or binary digests.
  */
 
 #pragma once
@@ -117,8 +117,10 @@ void SyncMemory();
 void Sleep(std::chrono::microseconds duration);
 template <typename Rep, typename Period>
 void Sleep(std::chrono::duration<Rep, Period> duration) {
-  Sleep(std::chrono::duration_cast<std::chrono::microseconds>(duration));
+  Sleep(std::chrono::ceil<std::chrono::microseconds>(duration));
 }
+// Sleeps the current thread until the given deadline has passed.
+void SleepUntil(std::chrono::steady_clock::time_point deadline);
 
 enum class SleepResult {
   kSuccess,
@@ -131,9 +133,17 @@ enum class SleepResult {
 SleepResult AlertableSleep(std::chrono::microseconds duration);
 template <typename Rep, typename Period>
 SleepResult AlertableSleep(std::chrono::duration<Rep, Period> duration) {
-  return AlertableSleep(
-      std::chrono::duration_cast<std::chrono::microseconds>(duration));
+  return AlertableSleep(std::chrono::ceil<std::chrono::microseconds>(duration));
 }
+SleepResult AlertableSleepUntil(std::chrono::steady_clock::time_point deadline);
+
+// Like SleepUntil, but the wait ends with a short spin so the wake-up lands
+// within a few microseconds of the deadline rather than a scheduler tick after
+// it. The spin costs CPU; use this only where the guest asked for a precise
+// delay, such as KeDelayExecutionThread.
+void PreciseSleepUntil(std::chrono::steady_clock::time_point deadline);
+SleepResult AlertablePreciseSleepUntil(
+    std::chrono::steady_clock::time_point deadline);
 
 typedef uint32_t TlsHandle;
 constexpr TlsHandle kInvalidTlsHandle = UINT_MAX;
@@ -0,0 +1,169 @@
+/**
+ * @file        thread/spsc_ring.h
+ * @brief       Per-thread single-producer rings drained by one consumer
+ *
+ * @copyright   Copyright (c) 2026 Tom Clay <tomc@tctechstuff.com>
+ *              All rights reserved.
+ *
+ * @license     BSD 3-Clause License
+ *              See LICENSE file in the project root for full license text.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace rex::thread {
+
+/// Fixed-size ring written only by one thread and drained by one consumer at
+/// a time. The capacity is rounded up to a power of two.
+template <typename T>
+class SpscRing {
+ public:
+    explicit SpscRing(size_t capacity)
+        : items_(std::bit_ceil(capacity)), mask_(items_.size() - 1) {}
+
+    /// Next free slot, or nullptr if the ring is full. Publish it with Commit().
+    T* Begin() {
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) >= items_.size()) {
+            return nullptr;
+        }
+        return &items_[head & mask_];
+    }
+    void Commit() {
+        head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    /// Copies item into the ring; false if it is full.
+    bool TryPush(const T& item) {
+        T* slot = Begin();
+        if (!slot) {
+            return false;
+        }
+        *slot = item;
+        Commit();
+        return true;
+    }
+
+    /// Calls fn on every committed item, oldest first, and frees their slots.
+    template <typename Fn>
+    void Drain(Fn&& fn) {
+        uint64_t tail = tail_.load(std::memory_order_relaxed);
+        uint64_t head = head_.load(std::memory_order_acquire);
+        for (; tail != head; ++tail) {
+            fn(items_[tail & mask_]);
+        }
+        tail_.store(tail, std::memory_order_release);
+    }
+
+    uint64_t size() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+
+ private:
+    std::vector<T> items_;
+    size_t mask_;
+    alignas(64) std::atomic<uint64_t> head_{0};
+    alignas(64) std::atomic<uint64_t> tail_{0};
+};
+
+/// One Ring per producer thread. A thread's ring is created by its first
+/// Get() and retired when the thread ends; the next Drain() reads what is
+/// left in it and frees it.
+///
+/// The calling thread's ring is found through a thread_local per Ring type,
+/// so each Ring type may only be used by one ThreadRings.
+template <typename Ring>
+class ThreadRings {
+ public:
+    /// The calling thread's ring, created with make() (returning a
+    /// std::unique_ptr<Ring>) on first use. Returns nullptr once the thread's
+    /// ring was retired by its exit, e.g. from a thread_local destructor that
+    /// runs after it; the caller must then do without the ring.
+    template <typename Make>
+    Ring* Get(Make&& make) {
+        if (current_) {
+            return current_->ring.get();
+        }
+        if (exited_) {
+            return nullptr;
+        }
+        // Constructed once per thread, so it's destroyed when the thread ends.
+        static thread_local Retirer retirer;
+        auto entry = std::make_unique<Entry>();
+        entry->ring = make();
+        std::lock_guard<std::mutex> lock(lock_);
+        current_ = entries_.emplace_back(std::move(entry)).get();
+        return current_->ring.get();
+    }
+
+    /// The calling thread's ring if it has one, without creating it.
+    Ring* Current() const { return current_ ? current_->ring.get() : nullptr; }
+
+    /// Retires the calling thread's ring now. A later Get() creates a new one.
+    void Retire() {
+        if (current_) {
+            current_->retired.store(true, std::memory_order_release);
+            current_ = nullptr;
+        }
+    }
+
+    /// Calls fn on every ring under the registry lock.
+    template <typename Fn>
+    void ForEach(Fn&& fn) {
+        std::lock_guard<std::mutex> lock(lock_);
+        for (auto& entry : entries_) {
+            fn(*entry->ring);
+        }
+    }
+
+    /// Like ForEach, then frees the rings of threads that had retired before
+    /// fn ran on them. Drains are serialized by the registry lock.
+    template <typename Fn>
+    void Drain(Fn&& fn) {
+        std::lock_guard<std::mutex> lock(lock_);
+        for (auto it = entries_.begin(); it != entries_.end();) {
+            // Read before draining so nothing pushed before retiring is lost.
+            bool retired = (*it)->retired.load(std::memory_order_acquire);
+            fn(*(*it)->ring);
+            if (retired) {
+                it = entries_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+ private:
+    struct Entry {
+        std::unique_ptr<Ring> ring;
+        std::atomic<bool> retired{false};
+    };
+
+    struct Retirer {
+        ~Retirer() {
+            if (current_) {
+                current_->retired.store(true, std::memory_order_release);
+            }
+            current_ = nullptr;
+            exited_ = true;
+        }
+    };
+
+    // Trivially destructible, so they stay usable from any thread_local
+    // destructor, including ones that run after the Retirer's.
+    static inline thread_local Entry* current_ = nullptr;
+    static inline thread_local bool exited_ = false;
+
+    std::mutex lock_;
+    std::vector<std::unique_ptr<Entry>> entries_;
+};
+
+}  // namespace rex::thread
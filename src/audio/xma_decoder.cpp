@@ -11,6 +11,9 @@
 
 #include <rex/audio/xma/decoder.h>
 
+#include <algorithm>
+
+#include <fmt/format.h>
 #include <rex/audio/xma/context.h>
 #include <rex/cvar.h>
 #include <rex/logging.h>
@@ -30,6 +33,11 @@ REXCVAR_DEFINE_BOOL(ffmpeg_verbose, false,
     "Verbose FFmpeg output (debug and above)",
     "Audio");
 
+REXCVAR_DEFINE_UINT32(xma_decoder_threads, 0,
+    "Audio",
+    "XMA decode worker threads (0 = auto)")
+    .lifecycle(rex::cvar::Lifecycle::kRequiresRestart);
+
 // As with normal Microsoft, there are like twelve different ways to access
 // the audio APIs. Early games use XMA*() methods almost exclusively to touch
 // decoders. Later games use XAudio*() and direct memory writes to the XMA
@@ -125,73 +133,96 @@ X_STATUS XmaDecoder::Setup(kernel::KernelState* kernel_state) {
   register_file_[XmaRegister::NextContextIndex] = 1;
   context_bitmap_.Resize(kContextCount);
 
-  worker_running_ = true;
-  work_event_ = rex::thread::Event::CreateAutoResetEvent(false);
-  assert_not_null(work_event_);
-  worker_thread_ = kernel::object_ref<kernel::XHostThread>(
-      new kernel::XHostThread(kernel_state, 128 * 1024, 0, [this]() {
-        WorkerThreadMain();
-        return 0;
-      }));
-  worker_thread_->set_name("XMA Decoder");
+  // Decoding is driven by context kicks: WriteRegister queues the kicked
+  // contexts and a small pool of workers drains the queue, sleeping when it
+  // is empty.
+  uint32_t worker_count = REXCVAR_GET(xma_decoder_threads);
+  if (!worker_count) {
+    worker_count =
+        std::clamp(rex::thread::logical_processor_count() / 4, 1u, 4u);
+  }
 
-  worker_thread_->Create();
+  worker_running_ = true;
+  for (uint32_t i = 0; i < worker_count; ++i) {
+    auto worker_thread = kernel::object_ref<kernel::XHostThread>(
+        new kernel::XHostThread(kernel_state, 128 * 1024, 0, [this]() {
+          WorkerThreadMain();
+          return 0;
+        }));
+    worker_thread->set_name(fmt::format("XMA Decoder {}", i));
+    worker_thread->Create();
+    worker_threads_.push_back(std::move(worker_thread));
+  }
 
   return X_STATUS_SUCCESS;
 }
 
+bool XmaDecoder::QueueContext(uint32_t context_id) {
+  auto& state = context_work_state_[context_id];
+  switch (state) {
+    case ContextWorkState::kIdle:
+      state = ContextWorkState::kQueued;
+      work_queue_.push(context_id);
+      return true;
+    case ContextWorkState::kRunning:
+      // The worker decoding it will queue it again when done.
+      state = ContextWorkState::kRunningRequeue;
+      return false;
+    default:
+      return false;
+  }
+}
+
 void XmaDecoder::WorkerThreadMain() {
-  uint32_t idle_loop_count = 0;
+  std::unique_lock<std::mutex> lock(queue_mutex_);
   while (worker_running_) {
-    // Okay, let's loop through XMA contexts to find ones we need to decode!
-    bool did_work = false;
-    for (uint32_t n = 0; n < kContextCount; n++) {
-      XmaContext& context = contexts_[n];
-      did_work = context.Work() || did_work;
-
-      // TODO: Need thread safety to do this.
-      // Probably not too important though.
-      // registers_.current_context = n;
-      // registers_.next_context = (n + 1) % kContextCount;
-    }
-
     if (paused_) {
-      pause_fence_.Signal();
-      resume_fence_.Wait();
+      ++parked_workers_;
+      pause_cond_.notify_all();
+      work_cond_.wait(lock, [this] { return !paused_ || !worker_running_; });
+      --parked_workers_;
+      continue;
     }
 
-    if (!did_work) {
-      idle_loop_count++;
-    } else {
-      idle_loop_count = 0;
+    if (work_queue_.empty()) {
+      work_cond_.wait(lock, [this] {
+        return !work_queue_.empty() || paused_ || !worker_running_;
+      });
+      continue;
     }
 
-    if (idle_loop_count > 500) {
-      // Idle for an extended period. Introduce a 20ms wait.
-      rex::thread::Wait(work_event_.get(), false,
-                          std::chrono::milliseconds(20));
-    }
+    uint32_t context_id = work_queue_.front();
+    work_queue_.pop();
+    context_work_state_[context_id] = ContextWorkState::kRunning;
+
+    lock.unlock();
+    contexts_[context_id].Work();
+    lock.lock();
 
-    rex::thread::MaybeYield();
+    auto& state = context_work_state_[context_id];
+    if (state == ContextWorkState::kRunningRequeue) {
+      state = ContextWorkState::kQueued;
+      work_queue_.push(context_id);
+    } else {
+      state = ContextWorkState::kIdle;
+    }
   }
 }
 
 void XmaDecoder::Shutdown() {
-  worker_running_ = false;
-
-  if (work_event_) {
-    work_event_->Set();
-  }
-
-  if (paused_) {
-    Resume();
+  {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    worker_running_ = false;
+    paused_ = false;
   }
+  work_cond_.notify_all();
+  pause_cond_.notify_all();
 
-  if (worker_thread_) {
-    // Wait for work thread.
-    rex::thread::Wait(worker_thread_->thread(), false);
-    worker_thread_.reset();
+  // Wait for work threads.
+  for (auto& worker_thread : worker_threads_) {
+    rex::thread::Wait(worker_thread->thread(), false);
   }
+  worker_threads_.clear();
 
   if (context_data_first_ptr_) {
     memory()->SystemHeapFree(context_data_first_ptr_);
@@ -296,15 +327,22 @@ void XmaDecoder::WriteRegister(uint32_t addr, uint32_t value) {
 
     // The context ID is a bit in the range of the entire context array.
     uint32_t base_context_id = (r - XmaRegister::Context0Kick) * 32;
+    uint32_t queued = 0;
     for (int i = 0; value && i < 32; ++i, value >>= 1) {
       if (value & 1) {
         uint32_t context_id = base_context_id + i;
         auto& context = contexts_[context_id];
         context.Enable();
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        queued += QueueContext(context_id) ? 1 : 0;
       }
     }
-    // Signal the decoder thread to start processing.
-    work_event_->Set();
+    // Wake as many decoder workers as there is new work.
+    if (queued == 1) {
+      work_cond_.notify_one();
+    } else if (queued > 1) {
+      work_cond_.notify_all();
+    }
   } else if (r >= XmaRegister::Context0Lock && r <= XmaRegister::Context9Lock) {
     // Context lock command.
     // This requests a lock by flagging the context.
@@ -317,8 +355,6 @@ void XmaDecoder::WriteRegister(uint32_t addr, uint32_t value) {
         context.Disable();
       }
     }
-    // Signal the decoder thread to start processing.
-    // work_event_->Set();
   } else if (r >= XmaRegister::Context0Clear &&
              r <= XmaRegister::Context9Clear) {
     // Context clear command.
@@ -351,21 +387,28 @@ void XmaDecoder::WriteRegister(uint32_t addr, uint32_t value) {
 }
 
 void XmaDecoder::Pause() {
+  std::unique_lock<std::mutex> lock(queue_mutex_);
   if (paused_) {
     return;
   }
   paused_ = true;
+  work_cond_.notify_all();
 
-  pause_fence_.Wait();
+  // Workers finish the context they are decoding before parking.
+  pause_cond_.wait(lock, [this] {
+    return parked_workers_ == worker_threads_.size() || !worker_running_;
+  });
 }
 
 void XmaDecoder::Resume() {
-  if (!paused_) {
-    return;
+  {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    if (!paused_) {
+      return;
+    }
+    paused_ = false;
   }
-  paused_ = false;
-
-  resume_fence_.Signal();
+  work_cond_.notify_all();
 }
 
 }  // namespace rex::audio
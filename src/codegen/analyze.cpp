@@ -13,6 +13,7 @@
 #include <rex/codegen/config.h>
 #include "decoded_binary.h"
 #include "discovery.h"
+#include "parallel.h"
 #include <rex/codegen/vtable_scanner.h>
 #include <rex/runtime/export_resolver.h>
 #include <rex/byte_order.h>
@@ -826,65 +827,96 @@ void scanBinary(CodegenContext& ctx) {
 // Discover Phase: iterative function block discovery
 //=============================================================================
 
-void discoverFunction(
-    CodegenContext& ctx,
-    uint32_t funcAddr,
-    const std::unordered_set<uint32_t>& knownFunctions)
+struct DiscoveryJob {
+    uint32_t funcAddr = 0;
+    uint32_t pdataSize = 0;
+    const CodeRegion* region = nullptr;
+    BlockDiscoveryResult result;
+};
+
+// Minimum candidates per worker before discovery fans out to another thread
+constexpr size_t kMinDiscoveriesPerWorker = 32;
+
+/// Serial part of discovery: decide whether funcAddr needs blocks and collect
+/// the inputs for discoverBlocks(). Returns false if there is nothing to do.
+bool prepareDiscovery(CodegenContext& ctx, uint32_t funcAddr, DiscoveryJob& job)
 {
     auto& graph = ctx.graph;
-    auto& binary = ctx.binary();
-    auto& decoded = ctx.decoded();
 
     auto* node = graph.getFunction(funcAddr);
-    if (!node) return;
+    if (!node) return false;
 
     // Skip if already discovered
     if (!node->canDiscover()) {
         REXCODEGEN_TRACE("Analyze: function 0x{:08X} already discovered, skipping", funcAddr);
-        return;
+        return false;
     }
 
     // Imports don't need block discovery
     if (node->isImport()) {
         node->discoverAsImport();
-        return;
+        return false;
     }
 
     REXCODEGEN_TRACE("Analyze: discovering function 0x{:08X} ({})", funcAddr, node->name());
 
-    // Lookup pdataSize for exception handler boundary
-    uint32_t pdataSize = 0;
+    job.funcAddr = funcAddr;
 
+    // Lookup pdataSize for exception handler boundary
     // For CONFIG functions: use only the explicitly declared size (if any)
     // If no size specified (size=0), let discovery find natural boundaries via region
     // Don't inherit PDATA sizes for CONFIG functions - they're user hints for entry points
     if (node->authority() == FunctionAuthority::CONFIG) {
-        pdataSize = node->size();  // 0 if not specified, which is correct
-        REXCODEGEN_TRACE("Analyze: 0x{:08X} is CONFIG, using declared size={}", funcAddr, pdataSize);
+        job.pdataSize = node->size();  // 0 if not specified, which is correct
+        REXCODEGEN_TRACE("Analyze: 0x{:08X} is CONFIG, using declared size={}", funcAddr, job.pdataSize);
     } else {
         // For non-CONFIG functions, use PDATA size if available
         auto pdataIt = ctx.scan.pdataSizes.find(funcAddr);
         if (pdataIt != ctx.scan.pdataSizes.end()) {
-            pdataSize = pdataIt->second;
-            REXCODEGEN_TRACE("Analyze: 0x{:08X} using PDATA size={}", funcAddr, pdataSize);
+            job.pdataSize = pdataIt->second;
+            REXCODEGEN_TRACE("Analyze: 0x{:08X} using PDATA size={}", funcAddr, job.pdataSize);
         }
     }
+    return true;
+}
 
+/// Parallel part of discovery: only reads the decoded binary and scan results.
+void runDiscovery(
+    const CodegenContext& ctx,
+    DecodedBinary& decoded,
+    DiscoveryJob& job,
+    const std::unordered_set<uint32_t>& knownFunctions)
+{
     // Find the code region containing this function
-    const CodeRegion* region = nullptr;
     for (const auto& r : ctx.scan.codeRegions) {
-        if (r.contains(funcAddr)) {
-            region = &r;
+        if (r.contains(job.funcAddr)) {
+            job.region = &r;
             break;
         }
     }
-    if (!region) {
-        REXCODEGEN_WARN("Analyze: function 0x{:08X} not in any code region", funcAddr);
+    if (!job.region) {
         return;
     }
 
     // Pass pdataSize so forward branches within function extent are correctly identified
-    auto result = discoverBlocks(decoded, funcAddr, *region, knownFunctions, pdataSize);
+    job.result = discoverBlocks(decoded, job.funcAddr, *job.region, knownFunctions, job.pdataSize);
+}
+
+/// Serial part of discovery: commit blocks and newly found targets to the graph.
+void applyDiscovery(CodegenContext& ctx, DiscoveryJob& job)
+{
+    auto& graph = ctx.graph;
+    auto& binary = ctx.binary();
+    const uint32_t funcAddr = job.funcAddr;
+    const uint32_t pdataSize = job.pdataSize;
+    auto& result = job.result;
+
+    auto* node = graph.getFunction(funcAddr);
+
+    if (!job.region) {
+        REXCODEGEN_WARN("Analyze: function 0x{:08X} not in any code region", funcAddr);
+        return;
+    }
 
     if (result.blocks.empty()) {
         REXCODEGEN_WARN("Analyze: no blocks found for function 0x{:08X}", funcAddr);
@@ -977,6 +1009,39 @@ void discoverFunction(
     }
 }
 
+/**
+ * Discover blocks for a batch of registered functions.
+ *
+ * discoverBlocks() only reads the decoded binary, so candidates are decoded on
+ * a worker pool and their results committed to the graph afterwards in input
+ * order. The graph ends up identical to discovering them one by one.
+ */
+void discoverFunctions(
+    CodegenContext& ctx,
+    const std::vector<uint32_t>& funcAddrs,
+    const std::unordered_set<uint32_t>& knownFunctions)
+{
+    std::vector<DiscoveryJob> jobs;
+    jobs.reserve(funcAddrs.size());
+    for (uint32_t funcAddr : funcAddrs) {
+        DiscoveryJob job;
+        if (prepareDiscovery(ctx, funcAddr, job)) {
+            jobs.push_back(std::move(job));
+        }
+    }
+
+    auto& decoded = ctx.decoded();
+    size_t threadCount = ResolveThreadCount(ctx.Config().analysisThreads, jobs.size(),
+                                            kMinDiscoveriesPerWorker);
+    ParallelFor(jobs.size(), threadCount, [&](size_t i) {
+        runDiscovery(ctx, decoded, jobs[i], knownFunctions);
+    });
+
+    for (auto& job : jobs) {
+        applyDiscovery(ctx, job);
+    }
+}
+
 void discoverAllFunctions(CodegenContext& ctx) {
     REXCODEGEN_INFO("Analyze: starting iterative discovery...");
 
@@ -1021,9 +1086,7 @@ void discoverAllFunctions(CodegenContext& ctx) {
             }
         }
 
-        for (uint32_t funcAddr : needsDiscovery) {
-            discoverFunction(ctx, funcAddr, knownFunctions);
-        }
+        discoverFunctions(ctx, needsDiscovery, knownFunctions);
     }
 
     REXCODEGEN_INFO("Analyze: {} functions after call graph expansion", graph.functionCount());
@@ -1035,10 +1098,18 @@ void discoverAllFunctions(CodegenContext& ctx) {
 
         size_t newFunctions = 0;
 
+        auto& slotTargets = ctx.analysisState().vtableSlotTargets;
+        slotTargets.clear();
+
         for (const auto& vt : vtables) {
             for (size_t i = 0; i < vt.slots.size(); i++) {
                 uint32_t funcAddr = vt.slots[i];
 
+                auto& targets = slotTargets[static_cast<uint32_t>(i * 4)];
+                if (std::find(targets.begin(), targets.end(), funcAddr) == targets.end()) {
+                    targets.push_back(funcAddr);
+                }
+
                 if (graph.isEntryPoint(funcAddr)) continue;
                 if (binary.isInImportExportRange(funcAddr)) continue;
 
@@ -1074,9 +1145,7 @@ void discoverAllFunctions(CodegenContext& ctx) {
                     }
                 }
 
-                for (uint32_t funcAddr : needsDiscovery) {
-                    discoverFunction(ctx, funcAddr, knownFunctions);
-                }
+                discoverFunctions(ctx, needsDiscovery, knownFunctions);
 
                 if (graph.functionCount() == lastFunctionCount) break;
                 lastFunctionCount = graph.functionCount();
@@ -1296,6 +1365,9 @@ bool looksLikeExceptionData(const BinaryView& binary, const FunctionGraph& graph
     return false;
 }
 
+// Minimum code regions per worker before gap-fill splitting fans out
+constexpr size_t kMinRegionsPerWorker = 256;
+
 void gapFillCodeRegions(CodegenContext& ctx) {
     REXCODEGEN_INFO("Analyze: checking for uncovered code regions...");
 
@@ -1312,10 +1384,17 @@ void gapFillCodeRegions(CodegenContext& ctx) {
     size_t gapsFound = 0;
     size_t segmentsCreated = 0;
 
-    for (const auto& region : scan.codeRegions) {
-        // Split region on terminators (blr, tail calls), then check each segment
-        auto segments = splitRegionOnTerminators(region, binary, knownCallables);
+    // Split regions on terminators (blr, tail calls) in parallel; splitting
+    // only reads the binary, registration below stays in region order.
+    std::vector<std::vector<CodeRegion>> regionSegments(scan.codeRegions.size());
+    size_t threadCount = ResolveThreadCount(ctx.Config().analysisThreads, scan.codeRegions.size(),
+                                            kMinRegionsPerWorker);
+    ParallelFor(scan.codeRegions.size(), threadCount, [&](size_t i) {
+        regionSegments[i] = splitRegionOnTerminators(scan.codeRegions[i], binary, knownCallables);
+    });
 
+    for (const auto& segments : regionSegments) {
+        // Check each segment of the region
         for (const auto& segment : segments) {
             // Skip if this segment's start is already a registered function entry
             if (graph.isEntryPoint(segment.start)) continue;
@@ -1570,34 +1649,54 @@ VoidResult validateGraph(CodegenContext& ctx) {
 Result<void> Analyze(CodegenContext& ctx) {
     REXCODEGEN_INFO("Analyze: starting analysis...");
 
-    ctx.initDecoded();
+    auto& profile = ctx.profile;
+    size_t firstPhase = profile.phases().size();
+
+    {
+        auto phase = profile.begin("Decode");
+        ctx.initDecoded();
+        phase.setInstructions(ctx.decoded().instructionCount());
+    }
     REXCODEGEN_INFO("Analyze: decoded {} instructions across {} code regions",
                    ctx.decoded().instructionCount(), ctx.decoded().codeRegions().size());
 
     std::vector<uint32_t> ehDiscoveredFuncs;
 
     // 1. Register entry points (imports, helpers, config, pdata)
-    auto regResult = registerEntryPoints(ctx, ehDiscoveredFuncs);
-    if (!regResult) {
-        return regResult;
+    {
+        auto phase = profile.begin("Register");
+        auto regResult = registerEntryPoints(ctx, ehDiscoveredFuncs);
+        if (!regResult) {
+            return regResult;
+        }
+        phase.setFunctions(ctx.graph.functionCount());
     }
 
     // 2. Scan binary into code/data regions
-    scanBinary(ctx);
+    {
+        auto phase = profile.begin("Scan");
+        scanBinary(ctx);
+    }
 
     // 3. Discover function blocks iteratively (includes vtable scan)
-    discoverAllFunctions(ctx);
+    {
+        auto phase = profile.begin("Discover");
+        discoverAllFunctions(ctx);
+        phase.setFunctions(ctx.graph.functionCount());
+    }
 
     // 3.5. Function pointer scan: find lis/addi pairs loading code addresses
     // TODO(tomc): disabled for now, causes too many false positives
     // functionPointerScan(ctx);
 
-    // 4. Gap fill uncovered regions
-    gapFillCodeRegions(ctx);
-
-    // 5. Discover blocks for gap-filled functions
-    // (They need their blocks discovered too... don't be selfish)
     {
+        auto phase = profile.begin("GapFill");
+
+        // 4. Gap fill uncovered regions
+        gapFillCodeRegions(ctx);
+
+        // 5. Discover blocks for gap-filled functions
+        // (They need their blocks discovered too... don't be selfish)
         auto& graph = ctx.graph;
 
         // Build set of known functions for boundary detection
@@ -1617,28 +1716,43 @@ Result<void> Analyze(CodegenContext& ctx) {
             }
         }
 
-        for (uint32_t funcAddr : needsDiscovery) {
-            discoverFunction(ctx, funcAddr, knownFunctions);
-        }
+        discoverFunctions(ctx, needsDiscovery, knownFunctions);
 
         REXCODEGEN_INFO("Analyze: discovered blocks for {} gap-filled functions", needsDiscovery.size());
-    }
 
-    // 5.5. Remove absorbed GAP_FILL functions
-    cleanupAbsorbedGapFills(ctx);
+        // 5.5. Remove absorbed GAP_FILL functions
+        cleanupAbsorbedGapFills(ctx);
+        phase.setFunctions(needsDiscovery.size());
+    }
 
     // 6. Merge: resolve jumps and seal functions
-    mergeAndSeal(ctx);
+    {
+        auto phase = profile.begin("Merge");
+        mergeAndSeal(ctx);
+        phase.setFunctions(ctx.graph.functionCount());
+    }
 
     // 7. Validate
-    auto validateResult = validateGraph(ctx);
-    if (!validateResult) {
-        return validateResult;
+    {
+        auto phase = profile.begin("Validate");
+        auto validateResult = validateGraph(ctx);
+        if (!validateResult) {
+            return validateResult;
+        }
     }
 
     REXCODEGEN_INFO("Analyze: complete - {} functions ready for code generation",
                    ctx.graph.functionCount());
 
+    double totalMs = 0.0;
+    std::string summary;
+    for (size_t i = firstPhase; i < profile.phases().size(); i++) {
+        const auto& phase = profile.phases()[i];
+        totalMs += phase.wallMs;
+        summary += fmt::format(" {}={:.1f}ms", phase.name, phase.wallMs);
+    }
+    REXCODEGEN_INFO("Analyze: phase times:{} (total {:.1f}ms)", summary, totalMs);
+
     return Ok();
 }
 
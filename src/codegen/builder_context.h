@@ -29,8 +29,9 @@ struct RecompilerLocalVariables;
     * @brief CSR (Control/Status Register) flush mode state.
     *
     * Tracks the current MXCSR configuration for floating-point operations:
-    * - **Unknown**: Initial state or after function call. Next FP/VMX instruction
-    *   will emit a conditional mode check.
+    * - **Unknown**: Initial state, or after a call or at a label where the flush
+    *   mode analysis couldn't tell. Next FP/VMX instruction will emit a
+    *   conditional mode check.
     * - **FPU**: Denormals preserved (flush-to-zero disabled). Used by scalar
     *   floating-point instructions (fadd, fmul, etc.)
     * - **VMX**: Denormals flushed to zero. Used by vector floating-point
@@ -67,6 +68,9 @@ struct BuilderContext
     /// Iterator to current switch table, or end() if none
     std::unordered_map<uint32_t, JumpTable>::iterator& switchTable;
 
+    /// CR bits and XER[CA] read after this instruction (flags:: mask from flag_liveness.h)
+    uint64_t liveFlags;
+
     /// Get the recompiler configuration
     const RecompilerConfig& config() const;
 
@@ -186,6 +190,15 @@ struct BuilderContext
         */
     const CallTarget* findCallTarget(uint32_t site) const;
 
+    /**
+        * @brief Whether a call from this instruction to target is emitted inline.
+        *
+        * Target must be one of the recompiler's inline leaves (inline_leaves.h).
+        * Calls inside an SEH try range and calls from functions the execution
+        * profile saw as cold stay calls.
+        */
+    bool inline_call(const FunctionNode& target) const;
+
     /**
         * @brief Emit C++ code for a function call.
         * @param address Target function address
@@ -193,9 +206,20 @@ struct BuilderContext
         * Uses pre-resolved CallTarget from FunctionNode when available.
         * Falls back to symbol lookup for backward compatibility.
         * Handles special cases like setjmp/longjmp and __restgprlr_N functions.
+        * Small leaf functions are emitted in place (see inline_call()).
         */
     void emit_function_call(uint32_t address);
 
+    /**
+        * @brief Emit C++ code for a call through ctr.
+        *
+        * Tests ctr against the targets the recompiler picked for this site
+        * (devirtualize.h) and calls the match directly, so the host compiler
+        * can predict or inline it. Anything else goes through the function
+        * table.
+        */
+    void emit_indirect_call();
+
     /**
         * @brief Emit C++ code for a conditional branch.
         * @param not_ If true, invert the condition
@@ -208,6 +232,10 @@ struct BuilderContext
 
     /**
         * @brief Emit CSR flush mode change if needed.
+        *
+        * The recompiler calls this before every instruction RequiredFlushMode()
+        * (flush_mode.h) assigns a mode, so builders don't.
+        *
         * @param enable true for VMX mode (flush-to-zero), false for FPU mode
         */
     void emit_set_flush_mode(bool enable);
@@ -221,6 +249,32 @@ struct BuilderContext
     /// Reset switchTable iterator to end (used after processing a switch)
     void reset_switch_table();
 
+    //=========================================================================
+    // Flag Liveness Helpers
+    //=========================================================================
+
+    /// Check if any bit of a CR field is read after this instruction
+    bool cr_field_live(size_t field) const;
+
+    /// Check if CR bit (0 = lt, 1 = gt, 2 = eq, 3 = so) of a field is read after this instruction
+    bool cr_bit_live(size_t field, uint32_t bit) const;
+
+    /// Check if XER[CA] is read after this instruction
+    bool ca_live() const;
+
+    /**
+        * @brief Emit a CR field update from an integer comparison.
+        * @param field CR field index (0-7)
+        * @param type C++ comparison type (e.g., "int32_t", "uint64_t")
+        * @param lhs Left operand expression
+        * @param rhs Right operand expression
+        *
+        * Emits `crN.compare<T>(lhs, rhs, xer)` when the whole field is read
+        * later, assigns only the bits that are read otherwise, and nothing
+        * when none are.
+        */
+    void emit_compare(size_t field, std::string_view type, std::string_view lhs, std::string_view rhs);
+
     //=========================================================================
     // Vector (SIMD) Code Generation Helpers
     //=========================================================================
@@ -29,16 +29,18 @@ bool build_add(BuilderContext& ctx)
 
 bool build_adde(BuilderContext& ctx)
 {
-    ctx.println("\t{}.u8 = ({}.u32 + {}.u32 < {}.u32) | ({}.u32 + {}.u32 + {}.ca < {}.ca);",
-        ctx.temp(),
-        ctx.r(ctx.insn.operands[1]), ctx.r(ctx.insn.operands[2]), ctx.r(ctx.insn.operands[1]),
-        ctx.r(ctx.insn.operands[1]), ctx.r(ctx.insn.operands[2]), ctx.xer(), ctx.xer());
+    if (ctx.ca_live())
+        ctx.println("\t{}.u8 = ({}.u32 + {}.u32 < {}.u32) | ({}.u32 + {}.u32 + {}.ca < {}.ca);",
+            ctx.temp(),
+            ctx.r(ctx.insn.operands[1]), ctx.r(ctx.insn.operands[2]), ctx.r(ctx.insn.operands[1]),
+            ctx.r(ctx.insn.operands[1]), ctx.r(ctx.insn.operands[2]), ctx.xer(), ctx.xer());
     ctx.println("\t{}.u64 = {}.u64 + {}.u64 + {}.ca;",
         ctx.r(ctx.insn.operands[0]),
         ctx.r(ctx.insn.operands[1]),
         ctx.r(ctx.insn.operands[2]),
         ctx.xer());
-    ctx.println("\t{}.ca = {}.u8;", ctx.xer(), ctx.temp());
+    if (ctx.ca_live())
+        ctx.println("\t{}.ca = {}.u8;", ctx.xer(), ctx.temp());
     emitRecordFormCompare(ctx);
     return true;
 }
@@ -54,10 +56,11 @@ bool build_addi(BuilderContext& ctx)
 
 bool build_addic(BuilderContext& ctx)
 {
-    ctx.println("\t{}.ca = {}.u32 > {};",
-        ctx.xer(),
-        ctx.r(ctx.insn.operands[1]),
-        ~ctx.insn.operands[2]);
+    if (ctx.ca_live())
+        ctx.println("\t{}.ca = {}.u32 > {};",
+            ctx.xer(),
+            ctx.r(ctx.insn.operands[1]),
+            ~ctx.insn.operands[2]);
     ctx.println("\t{}.s64 = {}.s64 + {};",
         ctx.r(ctx.insn.operands[0]),
         ctx.r(ctx.insn.operands[1]),
@@ -81,10 +84,11 @@ bool build_addze(BuilderContext& ctx)
         ctx.temp(),
         ctx.r(ctx.insn.operands[1]),
         ctx.xer());
-    ctx.println("\t{}.ca = {}.u32 < {}.u32;",
-        ctx.xer(),
-        ctx.temp(),
-        ctx.r(ctx.insn.operands[1]));
+    if (ctx.ca_live())
+        ctx.println("\t{}.ca = {}.u32 < {}.u32;",
+            ctx.xer(),
+            ctx.temp(),
+            ctx.r(ctx.insn.operands[1]));
     ctx.println("\t{}.s64 = {}.s64;",
         ctx.r(ctx.insn.operands[0]),
         ctx.temp());
@@ -95,15 +99,17 @@ bool build_addze(BuilderContext& ctx)
 bool build_addme(BuilderContext& ctx)
 {
     // addme: rD = rA + CA - 1 (which is rA + CA + 0xFFFFFFFFFFFFFFFF)
-    ctx.println("\t{}.u8 = ({}.u32 + 0xFFFFFFFFu < {}.u32) | ({}.u32 + 0xFFFFFFFFu + {}.ca < {}.ca);",
-        ctx.temp(),
-        ctx.r(ctx.insn.operands[1]), ctx.r(ctx.insn.operands[1]),
-        ctx.r(ctx.insn.operands[1]), ctx.xer(), ctx.xer());
+    if (ctx.ca_live())
+        ctx.println("\t{}.u8 = ({}.u32 + 0xFFFFFFFFu < {}.u32) | ({}.u32 + 0xFFFFFFFFu + {}.ca < {}.ca);",
+            ctx.temp(),
+            ctx.r(ctx.insn.operands[1]), ctx.r(ctx.insn.operands[1]),
+            ctx.r(ctx.insn.operands[1]), ctx.xer(), ctx.xer());
     ctx.println("\t{}.u64 = {}.u64 + {}.ca + 0xFFFFFFFFFFFFFFFFull;",
         ctx.r(ctx.insn.operands[0]),
         ctx.r(ctx.insn.operands[1]),
         ctx.xer());
-    ctx.println("\t{}.ca = {}.u8;", ctx.xer(), ctx.temp());
+    if (ctx.ca_live())
+        ctx.println("\t{}.ca = {}.u8;", ctx.xer(), ctx.temp());
     emitRecordFormCompare(ctx);
     return true;
 }
@@ -111,10 +117,11 @@ bool build_addme(BuilderContext& ctx)
 bool build_addc(BuilderContext& ctx)
 {
     // addc: rD = rA + rB, CA = carry out
-    ctx.println("\t{}.ca = {}.u32 + {}.u32 < {}.u32;",
-        ctx.xer(),
-        ctx.r(ctx.insn.operands[1]), ctx.r(ctx.insn.operands[2]),
-        ctx.r(ctx.insn.operands[1]));
+    if (ctx.ca_live())
+        ctx.println("\t{}.ca = {}.u32 + {}.u32 < {}.u32;",
+            ctx.xer(),
+            ctx.r(ctx.insn.operands[1]), ctx.r(ctx.insn.operands[2]),
+            ctx.r(ctx.insn.operands[1]));
     ctx.println("\t{}.u64 = {}.u64 + {}.u64;",
         ctx.r(ctx.insn.operands[0]),
         ctx.r(ctx.insn.operands[1]),
@@ -281,10 +288,11 @@ bool build_subf(BuilderContext& ctx)
 
 bool build_subfc(BuilderContext& ctx)
 {
-    ctx.println("\t{}.ca = {}.u32 >= {}.u32;",
-        ctx.xer(),
-        ctx.r(ctx.insn.operands[2]),
-        ctx.r(ctx.insn.operands[1]));
+    if (ctx.ca_live())
+        ctx.println("\t{}.ca = {}.u32 >= {}.u32;",
+            ctx.xer(),
+            ctx.r(ctx.insn.operands[2]),
+            ctx.r(ctx.insn.operands[1]));
     ctx.println("\t{}.s64 = {}.s64 - {}.s64;",
         ctx.r(ctx.insn.operands[0]),
         ctx.r(ctx.insn.operands[2]),
@@ -295,26 +303,29 @@ bool build_subfc(BuilderContext& ctx)
 
 bool build_subfe(BuilderContext& ctx)
 {
-    ctx.println("\t{}.u8 = (~{}.u32 + {}.u32 < ~{}.u32) | (~{}.u32 + {}.u32 + {}.ca < {}.ca);",
-        ctx.temp(),
-        ctx.r(ctx.insn.operands[1]), ctx.r(ctx.insn.operands[2]), ctx.r(ctx.insn.operands[1]),
-        ctx.r(ctx.insn.operands[1]), ctx.r(ctx.insn.operands[2]), ctx.xer(), ctx.xer());
+    if (ctx.ca_live())
+        ctx.println("\t{}.u8 = (~{}.u32 + {}.u32 < ~{}.u32) | (~{}.u32 + {}.u32 + {}.ca < {}.ca);",
+            ctx.temp(),
+            ctx.r(ctx.insn.operands[1]), ctx.r(ctx.insn.operands[2]), ctx.r(ctx.insn.operands[1]),
+            ctx.r(ctx.insn.operands[1]), ctx.r(ctx.insn.operands[2]), ctx.xer(), ctx.xer());
     ctx.println("\t{}.u64 = ~{}.u64 + {}.u64 + {}.ca;",
         ctx.r(ctx.insn.operands[0]),
         ctx.r(ctx.insn.operands[1]),
         ctx.r(ctx.insn.operands[2]),
         ctx.xer());
-    ctx.println("\t{}.ca = {}.u8;", ctx.xer(), ctx.temp());
+    if (ctx.ca_live())
+        ctx.println("\t{}.ca = {}.u8;", ctx.xer(), ctx.temp());
     emitRecordFormCompare(ctx);
     return true;
 }
 
 bool build_subfic(BuilderContext& ctx)
 {
-    ctx.println("\t{}.ca = {}.u32 <= {};",
-        ctx.xer(),
-        ctx.r(ctx.insn.operands[1]),
-        ctx.insn.operands[2]);
+    if (ctx.ca_live())
+        ctx.println("\t{}.ca = {}.u32 <= {};",
+            ctx.xer(),
+            ctx.r(ctx.insn.operands[1]),
+            ctx.insn.operands[2]);
     ctx.println("\t{}.s64 = {} - {}.s64;",
         ctx.r(ctx.insn.operands[0]),
         static_cast<int32_t>(ctx.insn.operands[2]),
@@ -325,15 +336,17 @@ bool build_subfic(BuilderContext& ctx)
 bool build_subfze(BuilderContext& ctx)
 {
     // subfze: rD = ~rA + CA (subtract from zero extended)
-    ctx.println("\t{}.u8 = ~{}.u32 + {}.ca < ~{}.u32;",
-        ctx.temp(),
-        ctx.r(ctx.insn.operands[1]), ctx.xer(),
-        ctx.r(ctx.insn.operands[1]));
+    if (ctx.ca_live())
+        ctx.println("\t{}.u8 = ~{}.u32 + {}.ca < ~{}.u32;",
+            ctx.temp(),
+            ctx.r(ctx.insn.operands[1]), ctx.xer(),
+            ctx.r(ctx.insn.operands[1]));
     ctx.println("\t{}.u64 = ~{}.u64 + {}.ca;",
         ctx.r(ctx.insn.operands[0]),
         ctx.r(ctx.insn.operands[1]),
         ctx.xer());
-    ctx.println("\t{}.ca = {}.u8;", ctx.xer(), ctx.temp());
+    if (ctx.ca_live())
+        ctx.println("\t{}.ca = {}.u8;", ctx.xer(), ctx.temp());
     emitRecordFormCompare(ctx);
     return true;
 }
@@ -341,15 +354,17 @@ bool build_subfze(BuilderContext& ctx)
 bool build_subfme(BuilderContext& ctx)
 {
     // subfme: rD = ~rA + CA - 1 (subtract from minus one extended)
-    ctx.println("\t{}.u8 = (~{}.u32 + 0xFFFFFFFFu < ~{}.u32) | (~{}.u32 + 0xFFFFFFFFu + {}.ca < {}.ca);",
-        ctx.temp(),
-        ctx.r(ctx.insn.operands[1]), ctx.r(ctx.insn.operands[1]),
-        ctx.r(ctx.insn.operands[1]), ctx.xer(), ctx.xer());
+    if (ctx.ca_live())
+        ctx.println("\t{}.u8 = (~{}.u32 + 0xFFFFFFFFu < ~{}.u32) | (~{}.u32 + 0xFFFFFFFFu + {}.ca < {}.ca);",
+            ctx.temp(),
+            ctx.r(ctx.insn.operands[1]), ctx.r(ctx.insn.operands[1]),
+            ctx.r(ctx.insn.operands[1]), ctx.xer(), ctx.xer());
     ctx.println("\t{}.u64 = ~{}.u64 + {}.ca + 0xFFFFFFFFFFFFFFFFull;",
         ctx.r(ctx.insn.operands[0]),
         ctx.r(ctx.insn.operands[1]),
         ctx.xer());
-    ctx.println("\t{}.ca = {}.u8;", ctx.xer(), ctx.temp());
+    if (ctx.ca_live())
+        ctx.println("\t{}.ca = {}.u8;", ctx.xer(), ctx.temp());
     emitRecordFormCompare(ctx);
     return true;
 }
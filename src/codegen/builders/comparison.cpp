@@ -11,6 +11,7 @@
 
 #include "../builder_context.h"
 #include "helpers.h"
+#include <fmt/format.h>
 
 namespace rex::codegen {
 
@@ -20,21 +21,17 @@ namespace rex::codegen {
 
 bool build_cmpd(BuilderContext& ctx)
 {
-    ctx.println("\t{}.compare<int64_t>({}.s64, {}.s64, {});",
-        ctx.cr(ctx.insn.operands[0]),
-        ctx.r(ctx.insn.operands[1]),
-        ctx.r(ctx.insn.operands[2]),
-        ctx.xer());
+    ctx.emit_compare(ctx.insn.operands[0], "int64_t",
+        fmt::format("{}.s64", ctx.r(ctx.insn.operands[1])),
+        fmt::format("{}.s64", ctx.r(ctx.insn.operands[2])));
     return true;
 }
 
 bool build_cmpdi(BuilderContext& ctx)
 {
-    ctx.println("\t{}.compare<int64_t>({}.s64, {}, {});",
-        ctx.cr(ctx.insn.operands[0]),
-        ctx.r(ctx.insn.operands[1]),
-        static_cast<int32_t>(ctx.insn.operands[2]),
-        ctx.xer());
+    ctx.emit_compare(ctx.insn.operands[0], "int64_t",
+        fmt::format("{}.s64", ctx.r(ctx.insn.operands[1])),
+        fmt::format("{}", static_cast<int32_t>(ctx.insn.operands[2])));
     return true;
 }
 
@@ -44,21 +41,17 @@ bool build_cmpdi(BuilderContext& ctx)
 
 bool build_cmpld(BuilderContext& ctx)
 {
-    ctx.println("\t{}.compare<uint64_t>({}.u64, {}.u64, {});",
-        ctx.cr(ctx.insn.operands[0]),
-        ctx.r(ctx.insn.operands[1]),
-        ctx.r(ctx.insn.operands[2]),
-        ctx.xer());
+    ctx.emit_compare(ctx.insn.operands[0], "uint64_t",
+        fmt::format("{}.u64", ctx.r(ctx.insn.operands[1])),
+        fmt::format("{}.u64", ctx.r(ctx.insn.operands[2])));
     return true;
 }
 
 bool build_cmpldi(BuilderContext& ctx)
 {
-    ctx.println("\t{}.compare<uint64_t>({}.u64, {}, {});",
-        ctx.cr(ctx.insn.operands[0]),
-        ctx.r(ctx.insn.operands[1]),
-        ctx.insn.operands[2],
-        ctx.xer());
+    ctx.emit_compare(ctx.insn.operands[0], "uint64_t",
+        fmt::format("{}.u64", ctx.r(ctx.insn.operands[1])),
+        fmt::format("{}", ctx.insn.operands[2]));
     return true;
 }
 
@@ -68,21 +61,17 @@ bool build_cmpldi(BuilderContext& ctx)
 
 bool build_cmplw(BuilderContext& ctx)
 {
-    ctx.println("\t{}.compare<uint32_t>({}.u32, {}.u32, {});",
-        ctx.cr(ctx.insn.operands[0]),
-        ctx.r(ctx.insn.operands[1]),
-        ctx.r(ctx.insn.operands[2]),
-        ctx.xer());
+    ctx.emit_compare(ctx.insn.operands[0], "uint32_t",
+        fmt::format("{}.u32", ctx.r(ctx.insn.operands[1])),
+        fmt::format("{}.u32", ctx.r(ctx.insn.operands[2])));
     return true;
 }
 
 bool build_cmplwi(BuilderContext& ctx)
 {
-    ctx.println("\t{}.compare<uint32_t>({}.u32, {}, {});",
-        ctx.cr(ctx.insn.operands[0]),
-        ctx.r(ctx.insn.operands[1]),
-        ctx.insn.operands[2],
-        ctx.xer());
+    ctx.emit_compare(ctx.insn.operands[0], "uint32_t",
+        fmt::format("{}.u32", ctx.r(ctx.insn.operands[1])),
+        fmt::format("{}", ctx.insn.operands[2]));
     return true;
 }
 
@@ -92,21 +81,17 @@ bool build_cmplwi(BuilderContext& ctx)
 
 bool build_cmpw(BuilderContext& ctx)
 {
-    ctx.println("\t{}.compare<int32_t>({}.s32, {}.s32, {});",
-        ctx.cr(ctx.insn.operands[0]),
-        ctx.r(ctx.insn.operands[1]),
-        ctx.r(ctx.insn.operands[2]),
-        ctx.xer());
+    ctx.emit_compare(ctx.insn.operands[0], "int32_t",
+        fmt::format("{}.s32", ctx.r(ctx.insn.operands[1])),
+        fmt::format("{}.s32", ctx.r(ctx.insn.operands[2])));
     return true;
 }
 
 bool build_cmpwi(BuilderContext& ctx)
 {
-    ctx.println("\t{}.compare<int32_t>({}.s32, {}, {});",
-        ctx.cr(ctx.insn.operands[0]),
-        ctx.r(ctx.insn.operands[1]),
-        static_cast<int32_t>(ctx.insn.operands[2]),
-        ctx.xer());
+    ctx.emit_compare(ctx.insn.operands[0], "int32_t",
+        fmt::format("{}.s32", ctx.r(ctx.insn.operands[1])),
+        fmt::format("{}", static_cast<int32_t>(ctx.insn.operands[2])));
     return true;
 }
 
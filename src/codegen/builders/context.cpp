@@ -15,6 +15,7 @@
 #include <rex/runtime.h>
 #include <rex/logging.h>
 #include "helpers.h"
+#include "../flag_liveness.h"
 #include <algorithm>
 
 namespace rex::codegen {
@@ -186,6 +187,25 @@ const CallTarget* BuilderContext::findCallTarget(uint32_t site) const
     return nullptr;
 }
 
+bool BuilderContext::inline_call(const FunctionNode& target) const
+{
+    if (!recompiler.inlineLeaves || !recompiler.inlineLeaves->contains(target.base()))
+        return false;
+
+    if (recompiler.executionProfile && recompiler.executionProfile->heat(fn.base()) == FunctionHeat::Cold)
+        return false;
+
+    if (fn.hasExceptionInfo()) {
+        if (const auto* seh = fn.exceptionInfo()->asSeh()) {
+            for (const auto& scope : seh->scopes) {
+                if (base >= scope.tryStart && base <= scope.tryEnd)
+                    return false;
+            }
+        }
+    }
+    return true;
+}
+
 void BuilderContext::emit_function_call(uint32_t address)
 {
     const auto& cfg = config();
@@ -223,6 +243,11 @@ void BuilderContext::emit_function_call(uint32_t address)
                 return;
             }
 
+            if (inline_call(*targetFn)) {
+                recompiler.recompileInline(*targetFn, locals, csrState, liveFlags);
+                return;
+            }
+
             println("\t{}(ctx, base);", name);
             return;
         }
@@ -275,6 +300,32 @@ void BuilderContext::emit_function_call(uint32_t address)
     println("\tREX_FATAL(\"Unresolved call from 0x{:08X} to 0x{:08X}\");", base, address);
 }
 
+void BuilderContext::emit_indirect_call()
+{
+    if (config().profileInstrument)
+        println("\tPPC_PROFILE_INDIRECT(0x{:X}, {}.u32);", base, ctr());
+
+    const std::vector<uint32_t>* targets = nullptr;
+    if (recompiler.indirectCallTargets) {
+        if (auto it = recompiler.indirectCallTargets->find(base); it != recompiler.indirectCallTargets->end())
+            targets = &it->second;
+    }
+
+    if (!targets) {
+        println("\tPPC_CALL_INDIRECT_FUNC({}.u32);", ctr());
+        return;
+    }
+
+    for (size_t i = 0; i < targets->size(); i++) {
+        uint32_t target = (*targets)[i];
+        println("\t{}if ({}.u32 == 0x{:X}) {{", i == 0 ? "" : "} else ", ctr(), target);
+        println("\t\t{}(ctx, base);", graph().getFunction(target)->name());
+    }
+    println("\t}} else {{");
+    println("\t\tPPC_CALL_INDIRECT_FUNC({}.u32);", ctr());
+    println("\t}}");
+}
+
 void BuilderContext::emit_conditional_branch(bool not_, std::string_view cond)
 {
     uint32_t target = insn.operands[1];
@@ -405,6 +456,43 @@ void BuilderContext::reset_switch_table()
     switchTable = recompiler.ctx_->Config().switchTables.end();
 }
 
+//=============================================================================
+// Flag Liveness
+//=============================================================================
+
+bool BuilderContext::cr_field_live(size_t field) const
+{
+    return (liveFlags & flags::crField(field)) != 0;
+}
+
+bool BuilderContext::cr_bit_live(size_t field, uint32_t bit) const
+{
+    return (liveFlags >> (field * 4 + bit)) & 1;
+}
+
+bool BuilderContext::ca_live() const
+{
+    return (liveFlags & flags::kCa) != 0;
+}
+
+void BuilderContext::emit_compare(size_t field, std::string_view type, std::string_view lhs, std::string_view rhs)
+{
+    if ((liveFlags & flags::crField(field)) == flags::crField(field))
+    {
+        println("\t{}.compare<{}>({}, {}, {});", cr(field), type, lhs, rhs, xer());
+        return;
+    }
+
+    if (cr_bit_live(field, 0))
+        println("\t{}.lt = {} < {};", cr(field), lhs, rhs);
+    if (cr_bit_live(field, 1))
+        println("\t{}.gt = {} > {};", cr(field), lhs, rhs);
+    if (cr_bit_live(field, 2))
+        println("\t{}.eq = {} == {};", cr(field), lhs, rhs);
+    if (cr_bit_live(field, 3))
+        println("\t{}.so = {}.so;", cr(field), xer());
+}
+
 //=============================================================================
 // Vector (SIMD) Code Generation Helpers
 //=============================================================================
@@ -456,7 +544,7 @@ void BuilderContext::emit_load_d_form(const char* load_macro, const char* dest_t
     // D-form: rD = LOAD(rA + D) where operands[0]=rD, operands[1]=D, operands[2]=rA
     // load_macro should be like "PPC_LOAD_U8" - we replace PPC_LOAD with PPC_MM_LOAD for MMIO
     const char* macro = load_macro;
-    static char mm_macro[64];
+    char mm_macro[64];
     if (check_mmio && mmio_check_d_form()) {
         // Replace "PPC_LOAD_" with "PPC_MM_LOAD_"
         if (strncmp(load_macro, "PPC_LOAD_", 9) == 0) {
@@ -476,7 +564,7 @@ void BuilderContext::emit_load_x_form(const char* load_macro, const char* dest_t
     // X-form: rD = LOAD(rA + rB) where operands[0]=rD, operands[1]=rA, operands[2]=rB
     // load_macro should be like "PPC_LOAD_U8" - we replace PPC_LOAD with PPC_MM_LOAD for MMIO
     const char* macro = load_macro;
-    static char mm_macro[64];
+    char mm_macro[64];
     if (check_mmio && mmio_check_x_form()) {
         // Replace "PPC_LOAD_" with "PPC_MM_LOAD_"
         if (strncmp(load_macro, "PPC_LOAD_", 9) == 0) {
@@ -496,7 +584,7 @@ void BuilderContext::emit_store_d_form(const char* store_macro, const char* src_
     // D-form: STORE(rA + D, rS) where operands[0]=rS, operands[1]=D, operands[2]=rA
     // store_macro should be like "PPC_STORE_U8" - we replace PPC_STORE with PPC_MM_STORE for MMIO
     const char* macro = store_macro;
-    static char mm_macro[64];
+    char mm_macro[64];
     if (check_mmio && mmio_check_d_form()) {
         // Replace "PPC_STORE_" with "PPC_MM_STORE_"
         if (strncmp(store_macro, "PPC_STORE_", 10) == 0) {
@@ -516,7 +604,7 @@ void BuilderContext::emit_store_x_form(const char* store_macro, const char* src_
     // X-form: STORE(rA + rB, rS) where operands[0]=rS, operands[1]=rA, operands[2]=rB
     // store_macro should be like "PPC_STORE_U8" - we replace PPC_STORE with PPC_MM_STORE for MMIO
     const char* macro = store_macro;
-    static char mm_macro[64];
+    char mm_macro[64];
     if (check_mmio && mmio_check_x_form()) {  // Use X-form specific check (operands[1] is base)
         // Replace "PPC_STORE_" with "PPC_MM_STORE_"
         if (strncmp(store_macro, "PPC_STORE_", 10) == 0) {
@@ -154,7 +154,7 @@ bool build_bctr(BuilderContext& ctx)
         // NOTE(tomc): If this is actually an unresolved switch table, the code after
         // will be unreachable. This is caught during analysis by discover_blocks.
         // The validation phase will report missing switch tables.
-        ctx.println("\tPPC_CALL_INDIRECT_FUNC({}.u32);", ctx.ctr());
+        ctx.emit_indirect_call();
         ctx.println("\treturn;");
     }
     return true;
@@ -164,7 +164,7 @@ bool build_bctrl(BuilderContext& ctx)
 {
     if (!ctx.config().skipLr)
         ctx.println("\tctx.lr = 0x{:X};", ctx.base + 4);
-    ctx.println("\tPPC_CALL_INDIRECT_FUNC({}.u32);", ctx.ctr());
+    ctx.emit_indirect_call();
     ctx.csrState = CSRState::Unknown; // the call could change it
     return true;
 }
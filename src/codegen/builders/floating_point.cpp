@@ -20,7 +20,6 @@ namespace rex::codegen {
 
 bool build_fabs(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(false);
     ctx.println("\t{}.u64 = {}.u64 & ~0x8000000000000000;",
         ctx.f(ctx.insn.operands[0]), ctx.f(ctx.insn.operands[1]));
     return true;
@@ -28,7 +27,6 @@ bool build_fabs(BuilderContext& ctx)
 
 bool build_fnabs(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(false);
     ctx.println("\t{}.u64 = {}.u64 | 0x8000000000000000;",
         ctx.f(ctx.insn.operands[0]), ctx.f(ctx.insn.operands[1]));
     return true;
@@ -36,7 +34,6 @@ bool build_fnabs(BuilderContext& ctx)
 
 bool build_fneg(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(false);
     ctx.println("\t{}.u64 = {}.u64 ^ 0x8000000000000000;",
         ctx.f(ctx.insn.operands[0]), ctx.f(ctx.insn.operands[1]));
     return true;
@@ -48,7 +45,6 @@ bool build_fneg(BuilderContext& ctx)
 
 bool build_fmr(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(false);
     ctx.println("\t{}.f64 = {}.f64;",
         ctx.f(ctx.insn.operands[0]), ctx.f(ctx.insn.operands[1]));
     return true;
@@ -56,7 +52,6 @@ bool build_fmr(BuilderContext& ctx)
 
 bool build_fcfid(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(false);
     ctx.println("\t{}.f64 = double({}.s64);",
         ctx.f(ctx.insn.operands[0]), ctx.f(ctx.insn.operands[1]));
     return true;
@@ -64,7 +59,6 @@ bool build_fcfid(BuilderContext& ctx)
 
 bool build_fctid(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(false);
     ctx.println("\t{}.s64 = ({}.f64 > double(LLONG_MAX)) ? LLONG_MAX : simde_mm_cvtsd_si64(simde_mm_load_sd(&{}.f64));",
         ctx.f(ctx.insn.operands[0]), ctx.f(ctx.insn.operands[1]), ctx.f(ctx.insn.operands[1]));
     return true;
@@ -72,7 +66,6 @@ bool build_fctid(BuilderContext& ctx)
 
 bool build_fctidz(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(false);
     ctx.println("\t{}.s64 = ({}.f64 > double(LLONG_MAX)) ? LLONG_MAX : simde_mm_cvttsd_si64(simde_mm_load_sd(&{}.f64));",
         ctx.f(ctx.insn.operands[0]), ctx.f(ctx.insn.operands[1]), ctx.f(ctx.insn.operands[1]));
     return true;
@@ -80,7 +73,6 @@ bool build_fctidz(BuilderContext& ctx)
 
 bool build_fctiwz(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(false);
     ctx.println("\t{}.s64 = ({}.f64 > double(INT_MAX)) ? INT_MAX : simde_mm_cvttsd_si32(simde_mm_load_sd(&{}.f64));",
         ctx.f(ctx.insn.operands[0]), ctx.f(ctx.insn.operands[1]), ctx.f(ctx.insn.operands[1]));
     return true;
@@ -88,7 +80,6 @@ bool build_fctiwz(BuilderContext& ctx)
 
 bool build_frsp(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(false);
     ctx.println("\t{}.f64 = double(float({}.f64));",
         ctx.f(ctx.insn.operands[0]), ctx.f(ctx.insn.operands[1]));
     return true;
@@ -100,9 +91,9 @@ bool build_frsp(BuilderContext& ctx)
 
 bool build_fcmpu(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(false);
-    ctx.println("\t{}.compare({}.f64, {}.f64);",
-        ctx.cr(ctx.insn.operands[0]), ctx.f(ctx.insn.operands[1]), ctx.f(ctx.insn.operands[2]));
+    if (ctx.cr_field_live(ctx.insn.operands[0]))
+        ctx.println("\t{}.compare({}.f64, {}.f64);",
+            ctx.cr(ctx.insn.operands[0]), ctx.f(ctx.insn.operands[1]), ctx.f(ctx.insn.operands[2]));
     return true;
 }
 
@@ -120,7 +111,6 @@ bool build_fcmpo(BuilderContext& ctx)
 
 bool build_fadd(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(false);
     ctx.println("\t{}.f64 = {}.f64 + {}.f64;",
         ctx.f(ctx.insn.operands[0]), ctx.f(ctx.insn.operands[1]), ctx.f(ctx.insn.operands[2]));
     return true;
@@ -128,7 +118,6 @@ bool build_fadd(BuilderContext& ctx)
 
 bool build_fadds(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(false);
     ctx.println("\t{}.f64 = double(float({}.f64 + {}.f64));",
         ctx.f(ctx.insn.operands[0]), ctx.f(ctx.insn.operands[1]), ctx.f(ctx.insn.operands[2]));
     return true;
@@ -140,7 +129,6 @@ bool build_fadds(BuilderContext& ctx)
 
 bool build_fsub(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(false);
     ctx.println("\t{}.f64 = {}.f64 - {}.f64;",
         ctx.f(ctx.insn.operands[0]), ctx.f(ctx.insn.operands[1]), ctx.f(ctx.insn.operands[2]));
     return true;
@@ -148,7 +136,6 @@ bool build_fsub(BuilderContext& ctx)
 
 bool build_fsubs(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(false);
     ctx.println("\t{}.f64 = double(float({}.f64 - {}.f64));",
         ctx.f(ctx.insn.operands[0]), ctx.f(ctx.insn.operands[1]), ctx.f(ctx.insn.operands[2]));
     return true;
@@ -160,7 +147,6 @@ bool build_fsubs(BuilderContext& ctx)
 
 bool build_fmul(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(false);
     ctx.println("\t{}.f64 = {}.f64 * {}.f64;",
         ctx.f(ctx.insn.operands[0]), ctx.f(ctx.insn.operands[1]), ctx.f(ctx.insn.operands[2]));
     return true;
@@ -168,7 +154,6 @@ bool build_fmul(BuilderContext& ctx)
 
 bool build_fmuls(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(false);
     ctx.println("\t{}.f64 = double(float({}.f64 * {}.f64));",
         ctx.f(ctx.insn.operands[0]), ctx.f(ctx.insn.operands[1]), ctx.f(ctx.insn.operands[2]));
     return true;
@@ -180,7 +165,6 @@ bool build_fmuls(BuilderContext& ctx)
 
 bool build_fdiv(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(false);
     ctx.println("\t{}.f64 = {}.f64 / {}.f64;",
         ctx.f(ctx.insn.operands[0]), ctx.f(ctx.insn.operands[1]), ctx.f(ctx.insn.operands[2]));
     return true;
@@ -188,7 +172,6 @@ bool build_fdiv(BuilderContext& ctx)
 
 bool build_fdivs(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(false);
     ctx.println("\t{}.f64 = double(float({}.f64 / {}.f64));",
         ctx.f(ctx.insn.operands[0]), ctx.f(ctx.insn.operands[1]), ctx.f(ctx.insn.operands[2]));
     return true;
@@ -200,7 +183,6 @@ bool build_fdivs(BuilderContext& ctx)
 
 bool build_fmadd(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(false);
     ctx.println("\t{}.f64 = {}.f64 * {}.f64 + {}.f64;",
         ctx.f(ctx.insn.operands[0]), ctx.f(ctx.insn.operands[1]),
         ctx.f(ctx.insn.operands[2]), ctx.f(ctx.insn.operands[3]));
@@ -209,7 +191,6 @@ bool build_fmadd(BuilderContext& ctx)
 
 bool build_fmadds(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(false);
     ctx.println("\t{}.f64 = double(float({}.f64 * {}.f64 + {}.f64));",
         ctx.f(ctx.insn.operands[0]), ctx.f(ctx.insn.operands[1]),
         ctx.f(ctx.insn.operands[2]), ctx.f(ctx.insn.operands[3]));
@@ -218,7 +199,6 @@ bool build_fmadds(BuilderContext& ctx)
 
 bool build_fmsub(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(false);
     ctx.println("\t{}.f64 = {}.f64 * {}.f64 - {}.f64;",
         ctx.f(ctx.insn.operands[0]), ctx.f(ctx.insn.operands[1]),
         ctx.f(ctx.insn.operands[2]), ctx.f(ctx.insn.operands[3]));
@@ -227,7 +207,6 @@ bool build_fmsub(BuilderContext& ctx)
 
 bool build_fmsubs(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(false);
     ctx.println("\t{}.f64 = double(float({}.f64 * {}.f64 - {}.f64));",
         ctx.f(ctx.insn.operands[0]), ctx.f(ctx.insn.operands[1]),
         ctx.f(ctx.insn.operands[2]), ctx.f(ctx.insn.operands[3]));
@@ -236,7 +215,6 @@ bool build_fmsubs(BuilderContext& ctx)
 
 bool build_fnmadds(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(false);
     ctx.println("\t{}.f64 = double(float(-({}.f64 * {}.f64 + {}.f64)));",
         ctx.f(ctx.insn.operands[0]), ctx.f(ctx.insn.operands[1]),
         ctx.f(ctx.insn.operands[2]), ctx.f(ctx.insn.operands[3]));
@@ -245,7 +223,6 @@ bool build_fnmadds(BuilderContext& ctx)
 
 bool build_fnmsub(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(false);
     ctx.println("\t{}.f64 = -({}.f64 * {}.f64 - {}.f64);",
         ctx.f(ctx.insn.operands[0]), ctx.f(ctx.insn.operands[1]),
         ctx.f(ctx.insn.operands[2]), ctx.f(ctx.insn.operands[3]));
@@ -254,7 +231,6 @@ bool build_fnmsub(BuilderContext& ctx)
 
 bool build_fnmsubs(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(false);
     ctx.println("\t{}.f64 = double(float(-({}.f64 * {}.f64 - {}.f64)));",
         ctx.f(ctx.insn.operands[0]), ctx.f(ctx.insn.operands[1]),
         ctx.f(ctx.insn.operands[2]), ctx.f(ctx.insn.operands[3]));
@@ -267,7 +243,6 @@ bool build_fnmsubs(BuilderContext& ctx)
 
 bool build_fres(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(false);
     ctx.println("\t{}.f64 = float(1.0 / {}.f64);",
         ctx.f(ctx.insn.operands[0]), ctx.f(ctx.insn.operands[1]));
     return true;
@@ -278,7 +253,6 @@ bool build_frsqrte(BuilderContext& ctx)
     // frsqrte: Floating reciprocal square root estimate
     // Uses lookup table approach from RPCS3
     // Credit: https://github.com/RPCS3/rpcs3/blob/master/rpcs3/Emu/Cell/PPUInterpreter.cpp
-    ctx.emit_set_flush_mode(false);
     ctx.println("\t{}.u64 = uint64_t(rex::runtime::guest::ppu_frsqrte_lut.data[{}.u64 >> 49]) << 32;",
         ctx.f(ctx.insn.operands[0]), ctx.f(ctx.insn.operands[1]));
     return true;
@@ -286,7 +260,6 @@ bool build_frsqrte(BuilderContext& ctx)
 
 bool build_fsqrt(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(false);
     ctx.println("\t{}.f64 = sqrt({}.f64);",
         ctx.f(ctx.insn.operands[0]), ctx.f(ctx.insn.operands[1]));
     return true;
@@ -294,7 +267,6 @@ bool build_fsqrt(BuilderContext& ctx)
 
 bool build_fsqrts(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(false);
     ctx.println("\t{}.f64 = double(float(sqrt({}.f64)));",
         ctx.f(ctx.insn.operands[0]), ctx.f(ctx.insn.operands[1]));
     return true;
@@ -306,7 +278,6 @@ bool build_fsqrts(BuilderContext& ctx)
 
 bool build_fsel(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(false);
     ctx.println("\t{}.f64 = {}.f64 >= 0.0 ? {}.f64 : {}.f64;",
         ctx.f(ctx.insn.operands[0]), ctx.f(ctx.insn.operands[1]),
         ctx.f(ctx.insn.operands[2]), ctx.f(ctx.insn.operands[3]));
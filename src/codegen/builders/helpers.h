@@ -71,6 +71,7 @@ inline bool isRecordForm(const ppc_insn& insn)
  *   CR0[GT] = result > 0
  *   CR0[EQ] = result == 0
  *   CR0[SO] = XER[SO]
+ * Bits nothing reads afterwards are not emitted.
  *
  * @param ctx The builder context containing the instruction being processed
  */
@@ -78,8 +79,7 @@ inline void emitRecordFormCompare(BuilderContext& ctx)
 {
     if (isRecordForm(ctx.insn))
     {
-        ctx.println("\t{}.compare<int32_t>({}.s32, 0, {});",
-            ctx.cr(0), ctx.r(ctx.insn.operands[0]), ctx.xer());
+        ctx.emit_compare(0, "int32_t", ctx.r(ctx.insn.operands[0]) + ".s32", "0");
     }
 }
 
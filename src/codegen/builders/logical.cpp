@@ -45,8 +45,7 @@ bool build_andi(BuilderContext& ctx)
         ctx.r(ctx.insn.operands[1]),
         ctx.insn.operands[2]);
     // ANDI. always sets CR0
-    ctx.println("\t{}.compare<int32_t>({}.s32, 0, {});",
-        ctx.cr(0), ctx.r(ctx.insn.operands[0]), ctx.xer());
+    ctx.emit_compare(0, "int32_t", ctx.r(ctx.insn.operands[0]) + ".s32", "0");
     return true;
 }
 
@@ -57,8 +56,7 @@ bool build_andis(BuilderContext& ctx)
         ctx.r(ctx.insn.operands[1]),
         ctx.insn.operands[2] << 16);
     // ANDIS. always sets CR0
-    ctx.println("\t{}.compare<int32_t>({}.s32, 0, {});",
-        ctx.cr(0), ctx.r(ctx.insn.operands[0]), ctx.xer());
+    ctx.emit_compare(0, "int32_t", ctx.r(ctx.insn.operands[0]) + ".s32", "0");
     return true;
 }
 
@@ -387,13 +385,14 @@ bool build_srad(BuilderContext& ctx)
 {
     ctx.println("\t{}.u64 = {}.u64 & 0x7F;", ctx.temp(), ctx.r(ctx.insn.operands[2]));
     ctx.println("\tif ({}.u64 > 0x3F) {}.u64 = 0x3F;", ctx.temp(), ctx.temp());
-    ctx.println("\t{}.ca = ({}.s64 < 0) & ((({}.s64 >> {}.u64) << {}.u64) != {}.s64);",
-        ctx.xer(),
-        ctx.r(ctx.insn.operands[1]),
-        ctx.r(ctx.insn.operands[1]),
-        ctx.temp(),
-        ctx.temp(),
-        ctx.r(ctx.insn.operands[1]));
+    if (ctx.ca_live())
+        ctx.println("\t{}.ca = ({}.s64 < 0) & ((({}.s64 >> {}.u64) << {}.u64) != {}.s64);",
+            ctx.xer(),
+            ctx.r(ctx.insn.operands[1]),
+            ctx.r(ctx.insn.operands[1]),
+            ctx.temp(),
+            ctx.temp(),
+            ctx.r(ctx.insn.operands[1]));
     ctx.println("\t{}.s64 = {}.s64 >> {}.u64;",
         ctx.r(ctx.insn.operands[0]),
         ctx.r(ctx.insn.operands[1]),
@@ -405,11 +404,12 @@ bool build_sradi(BuilderContext& ctx)
 {
     if (ctx.insn.operands[2] != 0)
     {
-        ctx.println("\t{}.ca = ({}.s64 < 0) & (({}.u64 & 0x{:X}) != 0);",
-            ctx.xer(),
-            ctx.r(ctx.insn.operands[1]),
-            ctx.r(ctx.insn.operands[1]),
-            compute_mask(64 - ctx.insn.operands[2], 63));
+        if (ctx.ca_live())
+            ctx.println("\t{}.ca = ({}.s64 < 0) & (({}.u64 & 0x{:X}) != 0);",
+                ctx.xer(),
+                ctx.r(ctx.insn.operands[1]),
+                ctx.r(ctx.insn.operands[1]),
+                compute_mask(64 - ctx.insn.operands[2], 63));
         ctx.println("\t{}.s64 = {}.s64 >> {};",
             ctx.r(ctx.insn.operands[0]),
             ctx.r(ctx.insn.operands[1]),
@@ -417,7 +417,8 @@ bool build_sradi(BuilderContext& ctx)
     }
     else
     {
-        ctx.println("\t{}.ca = 0;", ctx.xer());
+        if (ctx.ca_live())
+            ctx.println("\t{}.ca = 0;", ctx.xer());
         ctx.println("\t{}.s64 = {}.s64;",
             ctx.r(ctx.insn.operands[0]),
             ctx.r(ctx.insn.operands[1]));
@@ -429,13 +430,14 @@ bool build_sraw(BuilderContext& ctx)
 {
     ctx.println("\t{}.u32 = {}.u32 & 0x3F;", ctx.temp(), ctx.r(ctx.insn.operands[2]));
     ctx.println("\tif ({}.u32 > 0x1F) {}.u32 = 0x1F;", ctx.temp(), ctx.temp());
-    ctx.println("\t{}.ca = ({}.s32 < 0) & ((({}.s32 >> {}.u32) << {}.u32) != {}.s32);",
-        ctx.xer(),
-        ctx.r(ctx.insn.operands[1]),
-        ctx.r(ctx.insn.operands[1]),
-        ctx.temp(),
-        ctx.temp(),
-        ctx.r(ctx.insn.operands[1]));
+    if (ctx.ca_live())
+        ctx.println("\t{}.ca = ({}.s32 < 0) & ((({}.s32 >> {}.u32) << {}.u32) != {}.s32);",
+            ctx.xer(),
+            ctx.r(ctx.insn.operands[1]),
+            ctx.r(ctx.insn.operands[1]),
+            ctx.temp(),
+            ctx.temp(),
+            ctx.r(ctx.insn.operands[1]));
     ctx.println("\t{}.s64 = {}.s32 >> {}.u32;",
         ctx.r(ctx.insn.operands[0]),
         ctx.r(ctx.insn.operands[1]),
@@ -448,11 +450,12 @@ bool build_srawi(BuilderContext& ctx)
 {
     if (ctx.insn.operands[2] != 0)
     {
-        ctx.println("\t{}.ca = ({}.s32 < 0) & (({}.u32 & 0x{:X}) != 0);",
-            ctx.xer(),
-            ctx.r(ctx.insn.operands[1]),
-            ctx.r(ctx.insn.operands[1]),
-            compute_mask(64 - ctx.insn.operands[2], 63));
+        if (ctx.ca_live())
+            ctx.println("\t{}.ca = ({}.s32 < 0) & (({}.u32 & 0x{:X}) != 0);",
+                ctx.xer(),
+                ctx.r(ctx.insn.operands[1]),
+                ctx.r(ctx.insn.operands[1]),
+                compute_mask(64 - ctx.insn.operands[2], 63));
         ctx.println("\t{}.s64 = {}.s32 >> {};",
             ctx.r(ctx.insn.operands[0]),
             ctx.r(ctx.insn.operands[1]),
@@ -460,7 +463,8 @@ bool build_srawi(BuilderContext& ctx)
     }
     else
     {
-        ctx.println("\t{}.ca = 0;", ctx.xer());
+        if (ctx.ca_live())
+            ctx.println("\t{}.ca = 0;", ctx.xer());
         ctx.println("\t{}.s64 = {}.s32;",
             ctx.r(ctx.insn.operands[0]),
             ctx.r(ctx.insn.operands[1]));
@@ -253,7 +253,6 @@ bool build_ldarx(BuilderContext& ctx)
 
 bool build_lfd(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(false);
     ctx.print("\t{}.u64 = PPC_LOAD_U64(", ctx.f(ctx.insn.operands[0]));
     if (ctx.insn.operands[2] != 0)
         ctx.print("{}.u32 + ", ctx.r(ctx.insn.operands[2]));
@@ -263,7 +262,6 @@ bool build_lfd(BuilderContext& ctx)
 
 bool build_lfdx(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(false);
     ctx.print("\t{}.u64 = PPC_LOAD_U64(", ctx.f(ctx.insn.operands[0]));
     if (ctx.insn.operands[1] != 0)
         ctx.print("{}.u32 + ", ctx.r(ctx.insn.operands[1]));
@@ -273,7 +271,6 @@ bool build_lfdx(BuilderContext& ctx)
 
 bool build_lfs(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(false);
     ctx.print("\t{}.u32 = PPC_LOAD_U32(", ctx.temp());
     if (ctx.insn.operands[2] != 0)
         ctx.print("{}.u32 + ", ctx.r(ctx.insn.operands[2]));
@@ -284,7 +281,6 @@ bool build_lfs(BuilderContext& ctx)
 
 bool build_lfsx(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(false);
     ctx.print("\t{}.u32 = PPC_LOAD_U32(", ctx.temp());
     if (ctx.insn.operands[1] != 0)
         ctx.print("{}.u32 + ", ctx.r(ctx.insn.operands[1]));
@@ -296,7 +292,6 @@ bool build_lfsx(BuilderContext& ctx)
 bool build_lfdu(BuilderContext& ctx)
 {
     // Load Floating-point Double with Update
-    ctx.emit_set_flush_mode(false);
     ctx.println("\t{} = {} + {}.u32;",
         ctx.ea(),
         static_cast<int32_t>(ctx.insn.operands[1]),
@@ -311,7 +306,6 @@ bool build_lfdu(BuilderContext& ctx)
 bool build_lfdux(BuilderContext& ctx)
 {
     // Load Floating-point Double with Update Indexed
-    ctx.emit_set_flush_mode(false);
     ctx.println("\t{} = {}.u32 + {}.u32;",
         ctx.ea(),
         ctx.r(ctx.insn.operands[1]),
@@ -326,7 +320,6 @@ bool build_lfdux(BuilderContext& ctx)
 bool build_lfsu(BuilderContext& ctx)
 {
     // Load Floating-point Single with Update (convert to double)
-    ctx.emit_set_flush_mode(false);
     ctx.println("\t{} = {} + {}.u32;",
         ctx.ea(),
         static_cast<int32_t>(ctx.insn.operands[1]),
@@ -343,7 +336,6 @@ bool build_lfsu(BuilderContext& ctx)
 bool build_lfsux(BuilderContext& ctx)
 {
     // Load Floating-point Single with Update Indexed (convert to double)
-    ctx.emit_set_flush_mode(false);
     ctx.println("\t{} = {}.u32 + {}.u32;",
         ctx.ea(),
         ctx.r(ctx.insn.operands[1]),
@@ -479,11 +471,15 @@ bool build_stwcx(BuilderContext& ctx)
     if (ctx.insn.operands[1] != 0)
         ctx.print("{}.u32 + ", ctx.r(ctx.insn.operands[1]));
     ctx.println("{}.u32;", ctx.r(ctx.insn.operands[2]));
-    ctx.println("\t{}.lt = 0;", ctx.cr(0));
-    ctx.println("\t{}.gt = 0;", ctx.cr(0));
+    // eq carries the store itself, so only lt/gt/so can be dropped
+    if (ctx.cr_bit_live(0, 0))
+        ctx.println("\t{}.lt = 0;", ctx.cr(0));
+    if (ctx.cr_bit_live(0, 1))
+        ctx.println("\t{}.gt = 0;", ctx.cr(0));
     ctx.println("\t{}.eq = __sync_bool_compare_and_swap(reinterpret_cast<uint32_t*>(PPC_RAW_ADDR({})), {}.s32, __builtin_bswap32({}.s32));",
         ctx.cr(0), ctx.ea(), ctx.reserved(), ctx.r(ctx.insn.operands[0]));
-    ctx.println("\t{}.so = {}.so;", ctx.cr(0), ctx.xer());
+    if (ctx.cr_bit_live(0, 3))
+        ctx.println("\t{}.so = {}.so;", ctx.cr(0), ctx.xer());
     return true;
 }
 
@@ -494,11 +490,14 @@ bool build_stdcx(BuilderContext& ctx)
     if (ctx.insn.operands[1] != 0)
         ctx.print("{}.u32 + ", ctx.r(ctx.insn.operands[1]));
     ctx.println("{}.u32;", ctx.r(ctx.insn.operands[2]));
-    ctx.println("\t{}.lt = 0;", ctx.cr(0));
-    ctx.println("\t{}.gt = 0;", ctx.cr(0));
+    if (ctx.cr_bit_live(0, 0))
+        ctx.println("\t{}.lt = 0;", ctx.cr(0));
+    if (ctx.cr_bit_live(0, 1))
+        ctx.println("\t{}.gt = 0;", ctx.cr(0));
     ctx.println("\t{}.eq = __sync_bool_compare_and_swap(reinterpret_cast<uint64_t*>(PPC_RAW_ADDR({})), {}.s64, __builtin_bswap64({}.s64));",
         ctx.cr(0), ctx.ea(), ctx.reserved(), ctx.r(ctx.insn.operands[0]));
-    ctx.println("\t{}.so = {}.so;", ctx.cr(0), ctx.xer());
+    if (ctx.cr_bit_live(0, 3))
+        ctx.println("\t{}.so = {}.so;", ctx.cr(0), ctx.xer());
     return true;
 }
 
@@ -535,7 +534,6 @@ bool build_stdx(BuilderContext& ctx)
 
 bool build_stfd(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(false);
     ctx.print("{}", ctx.mmio_check_d_form() ? "\tPPC_MM_STORE_U64(" : "\tPPC_STORE_U64(");
     if (ctx.insn.operands[2] != 0)
         ctx.print("{}.u32 + ", ctx.r(ctx.insn.operands[2]));
@@ -547,7 +545,6 @@ bool build_stfd(BuilderContext& ctx)
 
 bool build_stfdx(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(false);
     ctx.print("{}", ctx.mmio_check_x_form() ? "\tPPC_MM_STORE_U64(" : "\tPPC_STORE_U64(");
     if (ctx.insn.operands[1] != 0)
         ctx.print("{}.u32 + ", ctx.r(ctx.insn.operands[1]));
@@ -557,7 +554,6 @@ bool build_stfdx(BuilderContext& ctx)
 
 bool build_stfiwx(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(false);
     ctx.print("{}", ctx.mmio_check_x_form() ? "\tPPC_MM_STORE_U32(" : "\tPPC_STORE_U32(");
     if (ctx.insn.operands[1] != 0)
         ctx.print("{}.u32 + ", ctx.r(ctx.insn.operands[1]));
@@ -567,7 +563,6 @@ bool build_stfiwx(BuilderContext& ctx)
 
 bool build_stfs(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(false);
     ctx.println("\t{}.f32 = float({}.f64);", ctx.temp(), ctx.f(ctx.insn.operands[0]));
     ctx.print("{}", ctx.mmio_check_d_form() ? "\tPPC_MM_STORE_U32(" : "\tPPC_STORE_U32(");
     if (ctx.insn.operands[2] != 0)
@@ -580,7 +575,6 @@ bool build_stfs(BuilderContext& ctx)
 
 bool build_stfsx(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(false);
     ctx.println("\t{}.f32 = float({}.f64);", ctx.temp(), ctx.f(ctx.insn.operands[0]));
     ctx.print("{}", ctx.mmio_check_x_form() ? "\tPPC_MM_STORE_U32(" : "\tPPC_STORE_U32(");
     if (ctx.insn.operands[1] != 0)
@@ -592,7 +586,6 @@ bool build_stfsx(BuilderContext& ctx)
 bool build_stfdu(BuilderContext& ctx)
 {
     // Store Floating-point Double with Update
-    ctx.emit_set_flush_mode(false);
     ctx.println("\t{} = {} + {}.u32;",
         ctx.ea(),
         static_cast<int32_t>(ctx.insn.operands[1]),
@@ -607,7 +600,6 @@ bool build_stfdu(BuilderContext& ctx)
 bool build_stfsu(BuilderContext& ctx)
 {
     // Store Floating-point Single with Update (convert double to float first)
-    ctx.emit_set_flush_mode(false);
     ctx.println("\t{} = {} + {}.u32;",
         ctx.ea(),
         static_cast<int32_t>(ctx.insn.operands[1]),
@@ -284,6 +284,9 @@ bool build_mtcr(BuilderContext& ctx)
 {
     for (size_t i = 0; i < 32; i++)
     {
+        if (!ctx.cr_bit_live(i / 4, i % 4))
+            continue;
+
         constexpr std::string_view fields[] = { "lt", "gt", "eq", "so" };
         ctx.println("\t{}.{} = ({}.u32 & 0x{:X}) != 0;",
             ctx.cr(i / 4),
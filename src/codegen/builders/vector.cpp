@@ -68,28 +68,24 @@ namespace rex::codegen {
 
 bool build_vaddfp(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(true);
     ctx.emit_vec_fp_binary("add");
     return true;
 }
 
 bool build_vsubfp(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(true);
     ctx.emit_vec_fp_binary("sub");
     return true;
 }
 
 bool build_vmulfp128(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(true);
     ctx.emit_vec_fp_binary("mul");
     return true;
 }
 
 bool build_vmaddfp(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(true);
     ctx.println("\tsimde_mm_store_ps({}.f32, simde_mm_add_ps(simde_mm_mul_ps(simde_mm_load_ps({}.f32), simde_mm_load_ps({}.f32)), simde_mm_load_ps({}.f32)));",
         ctx.v(ctx.insn.operands[0]), ctx.v(ctx.insn.operands[1]), ctx.v(ctx.insn.operands[2]), ctx.v(ctx.insn.operands[3]));
     return true;
@@ -98,7 +94,6 @@ bool build_vmaddfp(BuilderContext& ctx)
 bool build_vnmsubfp(BuilderContext& ctx)
 {
     // vnmsubfp: vD = -(vA * vB - vC) - negation done by XOR with sign bit (0x80000000)
-    ctx.emit_set_flush_mode(true);
     ctx.println("\tsimde_mm_store_ps({}.f32, simde_mm_xor_ps(simde_mm_sub_ps(simde_mm_mul_ps(simde_mm_load_ps({}.f32), simde_mm_load_ps({}.f32)), simde_mm_load_ps({}.f32)), simde_mm_castsi128_ps(simde_mm_set1_epi32(int(0x80000000)))));",
         ctx.v(ctx.insn.operands[0]), ctx.v(ctx.insn.operands[1]), ctx.v(ctx.insn.operands[2]), ctx.v(ctx.insn.operands[3]));
     return true;
@@ -106,14 +101,12 @@ bool build_vnmsubfp(BuilderContext& ctx)
 
 bool build_vmaxfp(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(true);
     ctx.emit_vec_fp_binary("max");
     return true;
 }
 
 bool build_vminfp(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(true);
     ctx.emit_vec_fp_binary("min");
     return true;
 }
@@ -121,7 +114,6 @@ bool build_vminfp(BuilderContext& ctx)
 bool build_vrefp(BuilderContext& ctx)
 {
     // TODO: see if we can use rcp safely
-    ctx.emit_set_flush_mode(true);
     ctx.println("\tsimde_mm_store_ps({}.f32, simde_mm_div_ps(simde_mm_set1_ps(1), simde_mm_load_ps({}.f32)));",
         ctx.v(ctx.insn.operands[0]), ctx.v(ctx.insn.operands[1]));
     return true;
@@ -130,7 +122,6 @@ bool build_vrefp(BuilderContext& ctx)
 bool build_vrsqrtefp(BuilderContext& ctx)
 {
     // TODO: see if we can use rsqrt safely
-    ctx.emit_set_flush_mode(true);
     ctx.println("\tsimde_mm_store_ps({}.f32, simde_mm_div_ps(simde_mm_set1_ps(1), simde_mm_sqrt_ps(simde_mm_load_ps({}.f32))));",
         ctx.v(ctx.insn.operands[0]), ctx.v(ctx.insn.operands[1]));
     return true;
@@ -139,7 +130,6 @@ bool build_vrsqrtefp(BuilderContext& ctx)
 bool build_vexptefp(BuilderContext& ctx)
 {
     // TODO: vectorize
-    ctx.emit_set_flush_mode(true);
     for (size_t i = 0; i < 4; i++)
         ctx.println("\t{}.f32[{}] = exp2f({}.f32[{}]);",
             ctx.v(ctx.insn.operands[0]), i, ctx.v(ctx.insn.operands[1]), i);
@@ -149,7 +139,6 @@ bool build_vexptefp(BuilderContext& ctx)
 bool build_vlogefp(BuilderContext& ctx)
 {
     // TODO: vectorize
-    ctx.emit_set_flush_mode(true);
     for (size_t i = 0; i < 4; i++)
         ctx.println("\t{}.f32[{}] = log2f({}.f32[{}]);",
             ctx.v(ctx.insn.operands[0]), i, ctx.v(ctx.insn.operands[1]), i);
@@ -164,7 +153,6 @@ bool build_vmsum3fp128(BuilderContext& ctx)
 {
     // 3-element dot product accounting for guest->host vector element reversal
     // 0xEF = dot(yzw) with result broadcast to all elements (see constants doc)
-    ctx.emit_set_flush_mode(true);
     ctx.println("\tsimde_mm_store_ps({}.f32, simde_mm_dp_ps(simde_mm_load_ps({}.f32), simde_mm_load_ps({}.f32), 0xEF));",
         ctx.v(ctx.insn.operands[0]), ctx.v(ctx.insn.operands[1]), ctx.v(ctx.insn.operands[2]));
     return true;
@@ -173,7 +161,6 @@ bool build_vmsum3fp128(BuilderContext& ctx)
 bool build_vmsum4fp128(BuilderContext& ctx)
 {
     // 4-element dot product: 0xFF = all 4 elements, result to all (see constants doc)
-    ctx.emit_set_flush_mode(true);
     ctx.println("\tsimde_mm_store_ps({}.f32, simde_mm_dp_ps(simde_mm_load_ps({}.f32), simde_mm_load_ps({}.f32), 0xFF));",
         ctx.v(ctx.insn.operands[0]), ctx.v(ctx.insn.operands[1]), ctx.v(ctx.insn.operands[2]));
     return true;
@@ -185,7 +172,6 @@ bool build_vmsum4fp128(BuilderContext& ctx)
 
 bool build_vrfim(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(true);
     ctx.println("\tsimde_mm_store_ps({}.f32, simde_mm_round_ps(simde_mm_load_ps({}.f32), SIMDE_MM_FROUND_TO_NEG_INF | SIMDE_MM_FROUND_NO_EXC));",
         ctx.v(ctx.insn.operands[0]), ctx.v(ctx.insn.operands[1]));
     return true;
@@ -193,7 +179,6 @@ bool build_vrfim(BuilderContext& ctx)
 
 bool build_vrfin(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(true);
     ctx.println("\tsimde_mm_store_ps({}.f32, simde_mm_round_ps(simde_mm_load_ps({}.f32), SIMDE_MM_FROUND_TO_NEAREST_INT | SIMDE_MM_FROUND_NO_EXC));",
         ctx.v(ctx.insn.operands[0]), ctx.v(ctx.insn.operands[1]));
     return true;
@@ -201,7 +186,6 @@ bool build_vrfin(BuilderContext& ctx)
 
 bool build_vrfip(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(true);
     ctx.println("\tsimde_mm_store_ps({}.f32, simde_mm_round_ps(simde_mm_load_ps({}.f32), SIMDE_MM_FROUND_TO_POS_INF | SIMDE_MM_FROUND_NO_EXC));",
         ctx.v(ctx.insn.operands[0]), ctx.v(ctx.insn.operands[1]));
     return true;
@@ -209,7 +193,6 @@ bool build_vrfip(BuilderContext& ctx)
 
 bool build_vrfiz(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(true);
     ctx.println("\tsimde_mm_store_ps({}.f32, simde_mm_round_ps(simde_mm_load_ps({}.f32), SIMDE_MM_FROUND_TO_ZERO | SIMDE_MM_FROUND_NO_EXC));",
         ctx.v(ctx.insn.operands[0]), ctx.v(ctx.insn.operands[1]));
     return true;
@@ -466,7 +449,6 @@ bool build_vsel(BuilderContext& ctx)
 
 bool build_vcmpbfp(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(true);
     // vcmpbfp: Vector Compare Bounds Floating Point
     // For each element i:
     //   bit 0 (0x80000000) = 1 if vSrcA[i] > vSrcB[i]
@@ -486,17 +468,16 @@ bool build_vcmpbfp(BuilderContext& ctx)
     ctx.println("\tsimde_mm_store_ps({}.f32, simde_mm_or_ps(simde_mm_load_ps({}.f32), simde_mm_load_ps({}.f32)));",
         vD, ctx.v_temp(), vD);
 
-    if (isRecordForm(ctx.insn))
+    if (isRecordForm(ctx.insn) && ctx.cr_field_live(6))
         ctx.println("\t{}.setFromMask(simde_mm_load_ps({}.f32), 0xF);", ctx.cr(6), vD);
     return true;
 }
 
 bool build_vcmpeqfp(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(true);
     ctx.println("\tsimde_mm_store_ps({}.f32, simde_mm_cmpeq_ps(simde_mm_load_ps({}.f32), simde_mm_load_ps({}.f32)));",
         ctx.v(ctx.insn.operands[0]), ctx.v(ctx.insn.operands[1]), ctx.v(ctx.insn.operands[2]));
-    if (isRecordForm(ctx.insn))
+    if (isRecordForm(ctx.insn) && ctx.cr_field_live(6))
         ctx.println("\t{}.setFromMask(simde_mm_load_ps({}.f32), 0xF);", ctx.cr(6), ctx.v(ctx.insn.operands[0]));
     return true;
 }
@@ -505,7 +486,7 @@ bool build_vcmpequb(BuilderContext& ctx)
 {
     ctx.println("\tsimde_mm_store_si128((simde__m128i*){}.u8, simde_mm_cmpeq_epi8(simde_mm_load_si128((simde__m128i*){}.u8), simde_mm_load_si128((simde__m128i*){}.u8)));",
         ctx.v(ctx.insn.operands[0]), ctx.v(ctx.insn.operands[1]), ctx.v(ctx.insn.operands[2]));
-    if (isRecordForm(ctx.insn))
+    if (isRecordForm(ctx.insn) && ctx.cr_field_live(6))
         ctx.println("\t{}.setFromMask(simde_mm_load_si128((simde__m128i*){}.u8), 0xFFFF);", ctx.cr(6), ctx.v(ctx.insn.operands[0]));
     return true;
 }
@@ -514,7 +495,7 @@ bool build_vcmpequh(BuilderContext& ctx)
 {
     ctx.println("\tsimde_mm_store_si128((simde__m128i*){}.u8, simde_mm_cmpeq_epi16(simde_mm_load_si128((simde__m128i*){}.u16), simde_mm_load_si128((simde__m128i*){}.u16)));",
         ctx.v(ctx.insn.operands[0]), ctx.v(ctx.insn.operands[1]), ctx.v(ctx.insn.operands[2]));
-    if (isRecordForm(ctx.insn))
+    if (isRecordForm(ctx.insn) && ctx.cr_field_live(6))
         ctx.println("\t{}.setFromMask(simde_mm_load_si128((simde__m128i*){}.u16), 0xFFFF);", ctx.cr(6), ctx.v(ctx.insn.operands[0]));
     return true;
 }
@@ -523,27 +504,25 @@ bool build_vcmpequw(BuilderContext& ctx)
 {
     ctx.println("\tsimde_mm_store_si128((simde__m128i*){}.u8, simde_mm_cmpeq_epi32(simde_mm_load_si128((simde__m128i*){}.u32), simde_mm_load_si128((simde__m128i*){}.u32)));",
         ctx.v(ctx.insn.operands[0]), ctx.v(ctx.insn.operands[1]), ctx.v(ctx.insn.operands[2]));
-    if (isRecordForm(ctx.insn))
+    if (isRecordForm(ctx.insn) && ctx.cr_field_live(6))
         ctx.println("\t{}.setFromMask(simde_mm_load_ps({}.f32), 0xF);", ctx.cr(6), ctx.v(ctx.insn.operands[0]));
     return true;
 }
 
 bool build_vcmpgefp(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(true);
     ctx.println("\tsimde_mm_store_ps({}.f32, simde_mm_cmpge_ps(simde_mm_load_ps({}.f32), simde_mm_load_ps({}.f32)));",
         ctx.v(ctx.insn.operands[0]), ctx.v(ctx.insn.operands[1]), ctx.v(ctx.insn.operands[2]));
-    if (isRecordForm(ctx.insn))
+    if (isRecordForm(ctx.insn) && ctx.cr_field_live(6))
         ctx.println("\t{}.setFromMask(simde_mm_load_ps({}.f32), 0xF);", ctx.cr(6), ctx.v(ctx.insn.operands[0]));
     return true;
 }
 
 bool build_vcmpgtfp(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(true);
     ctx.println("\tsimde_mm_store_ps({}.f32, simde_mm_cmpgt_ps(simde_mm_load_ps({}.f32), simde_mm_load_ps({}.f32)));",
         ctx.v(ctx.insn.operands[0]), ctx.v(ctx.insn.operands[1]), ctx.v(ctx.insn.operands[2]));
-    if (isRecordForm(ctx.insn))
+    if (isRecordForm(ctx.insn) && ctx.cr_field_live(6))
         ctx.println("\t{}.setFromMask(simde_mm_load_ps({}.f32), 0xF);", ctx.cr(6), ctx.v(ctx.insn.operands[0]));
     return true;
 }
@@ -552,7 +531,7 @@ bool build_vcmpgtub(BuilderContext& ctx)
 {
     ctx.println("\tsimde_mm_store_si128((simde__m128i*){}.u8, simde_mm_cmpgt_epu8(simde_mm_load_si128((simde__m128i*){}.u8), simde_mm_load_si128((simde__m128i*){}.u8)));",
         ctx.v(ctx.insn.operands[0]), ctx.v(ctx.insn.operands[1]), ctx.v(ctx.insn.operands[2]));
-    if (isRecordForm(ctx.insn))
+    if (isRecordForm(ctx.insn) && ctx.cr_field_live(6))
         ctx.println("\t{}.setFromMask(simde_mm_load_si128((simde__m128i*){}.u8), 0xFFFF);", ctx.cr(6), ctx.v(ctx.insn.operands[0]));
     return true;
 }
@@ -561,7 +540,7 @@ bool build_vcmpgtuh(BuilderContext& ctx)
 {
     ctx.println("\tsimde_mm_store_si128((simde__m128i*){}.u8, simde_mm_cmpgt_epu16(simde_mm_load_si128((simde__m128i*){}.u16), simde_mm_load_si128((simde__m128i*){}.u16)));",
         ctx.v(ctx.insn.operands[0]), ctx.v(ctx.insn.operands[1]), ctx.v(ctx.insn.operands[2]));
-    if (isRecordForm(ctx.insn))
+    if (isRecordForm(ctx.insn) && ctx.cr_field_live(6))
         ctx.println("\t{}.setFromMask(simde_mm_load_si128((simde__m128i*){}.u16), 0xFFFF);", ctx.cr(6), ctx.v(ctx.insn.operands[0]));
     return true;
 }
@@ -570,7 +549,7 @@ bool build_vcmpgtsh(BuilderContext& ctx)
 {
     ctx.println("\tsimde_mm_store_si128((simde__m128i*){}.u8, simde_mm_cmpgt_epi16(simde_mm_load_si128((simde__m128i*){}.u16), simde_mm_load_si128((simde__m128i*){}.u16)));",
         ctx.v(ctx.insn.operands[0]), ctx.v(ctx.insn.operands[1]), ctx.v(ctx.insn.operands[2]));
-    if (isRecordForm(ctx.insn))
+    if (isRecordForm(ctx.insn) && ctx.cr_field_live(6))
         ctx.println("\t{}.setFromMask(simde_mm_load_si128((simde__m128i*){}.u16), 0xFFFF);", ctx.cr(6), ctx.v(ctx.insn.operands[0]));
     return true;
 }
@@ -579,7 +558,7 @@ bool build_vcmpgtsw(BuilderContext& ctx)
 {
     ctx.println("\tsimde_mm_store_si128((simde__m128i*){}.u32, simde_mm_cmpgt_epi32(simde_mm_load_si128((simde__m128i*){}.u32), simde_mm_load_si128((simde__m128i*){}.u32)));",
         ctx.v(ctx.insn.operands[0]), ctx.v(ctx.insn.operands[1]), ctx.v(ctx.insn.operands[2]));
-    if (isRecordForm(ctx.insn))
+    if (isRecordForm(ctx.insn) && ctx.cr_field_live(6))
         ctx.println("\t{}.setFromMask(simde_mm_castsi128_ps(simde_mm_load_si128((simde__m128i*){}.u32)), 0xF);", ctx.cr(6), ctx.v(ctx.insn.operands[0]));
     return true;
 }
@@ -590,7 +569,6 @@ bool build_vcmpgtsw(BuilderContext& ctx)
 
 bool build_vctsxs(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(true);
     ctx.print("\tsimde_mm_store_si128((simde__m128i*){}.s32, simde_mm_vctsxs(", ctx.v(ctx.insn.operands[0]));
     if (ctx.insn.operands[2] != 0)
         ctx.println("simde_mm_mul_ps(simde_mm_load_ps({}.f32), simde_mm_set1_ps({}))));",
@@ -602,7 +580,6 @@ bool build_vctsxs(BuilderContext& ctx)
 
 bool build_vcfsx(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(true);
     ctx.print("\tsimde_mm_store_ps({}.f32, ", ctx.v(ctx.insn.operands[0]));
     if (ctx.insn.operands[2] != 0)
     {
@@ -619,7 +596,6 @@ bool build_vcfsx(BuilderContext& ctx)
 
 bool build_vcfux(BuilderContext& ctx)
 {
-    ctx.emit_set_flush_mode(true);
     ctx.print("\tsimde_mm_store_ps({}.f32, ", ctx.v(ctx.insn.operands[0]));
     if (ctx.insn.operands[2] != 0)
     {
@@ -637,7 +613,6 @@ bool build_vcfux(BuilderContext& ctx)
 bool build_vctuxs(BuilderContext& ctx)
 {
     // Vector Convert To Unsigned Fixed-Point Word Saturate
-    ctx.emit_set_flush_mode(true);
     ctx.print("\tsimde_mm_store_si128((simde__m128i*){}.u32, simde_mm_vctuxs(", ctx.v(ctx.insn.operands[0]));
     if (ctx.insn.operands[2] != 0)
         ctx.println("simde_mm_mul_ps(simde_mm_load_ps({}.f32), simde_mm_set1_ps({}))));",
@@ -990,7 +965,6 @@ bool build_vpkd3d128(BuilderContext& ctx)
 {
     // TODO(tomc): vectorize
     // NOTE: handling vector reversal here too
-    ctx.emit_set_flush_mode(true);
     switch (ctx.insn.operands[2])
     {
     case 0: // D3D color
@@ -54,6 +54,15 @@ void RecompilerConfig::Load(const std::string_view& configFilePath)
     crRegistersAsLocalVariables = toml["cr_as_local"].value_or(false);
     nonArgumentRegistersAsLocalVariables = toml["non_argument_as_local"].value_or(false);
     nonVolatileRegistersAsLocalVariables = toml["non_volatile_as_local"].value_or(false);
+    codegenThreads = toml["codegen_threads"].value_or(0u);
+    codegenCache = toml["codegen_cache"].value_or(true);
+    flagLiveness = toml["flag_liveness"].value_or(true);
+    flagLivenessAssumeAbi = toml["flag_liveness_assume_abi"].value_or(false);
+    flushModeAnalysis = toml["flush_mode_analysis"].value_or(false);
+    devirtualizeMaxTargets = toml["devirtualize_max_targets"].value_or(2u);
+    inlineMaxInstructions = toml["inline_max_instructions"].value_or(0u);
+    profileInstrument = toml["profile_instrument"].value_or(false);
+    profileUsePath = toml["profile_use"].value_or<std::string>("");
 
     // Special addresses (user overrides)
     longJmpAddress = toml["longjmp_address"].value_or(0u);
@@ -163,6 +172,51 @@ void RecompilerConfig::Load(const std::string_view& configFilePath)
         }
     }
 
+    // Functions replaced at link time; nothing may be assumed about their code
+    if (auto overriddenArray = toml["overridden_functions"].as_array())
+    {
+        for (auto& entry : *overriddenArray)
+        {
+            if (auto addr = entry.value<int64_t>()) {
+                overriddenFunctions.insert(static_cast<uint32_t>(*addr));
+            }
+        }
+    }
+
+    // Likely targets of indirect calls, checked ahead of the function table lookup
+    if (auto targetArray = toml["indirect_call_targets"].as_array())
+    {
+        for (auto& entry : *targetArray)
+        {
+            auto* table = entry.as_table();
+            if (!table) {
+                REXCODEGEN_ERROR("Invalid [[indirect_call_targets]] entry: expected table");
+                continue;
+            }
+
+            auto address_opt = (*table)["address"].value<uint32_t>();
+            auto targets_array = (*table)["targets"].as_array();
+
+            if (!address_opt) {
+                REXCODEGEN_ERROR("Missing 'address' in [[indirect_call_targets]] entry");
+                continue;
+            }
+            if (!targets_array) {
+                REXCODEGEN_ERROR("Missing 'targets' in [[indirect_call_targets]] entry");
+                continue;
+            }
+
+            auto& targets = indirectCallTargets[*address_opt];
+            for (auto& target : *targets_array)
+            {
+                if (auto target_val = target.value<int64_t>()) {
+                    targets.push_back(static_cast<uint32_t>(*target_val));
+                }
+            }
+            REXCODEGEN_DEBUG("Loaded {} indirect call targets at 0x{:08X}", targets.size(), *address_opt);
+        }
+    }
+
     // Manual switch table definitions (when auto-detection fails)
     if (auto switchTableArray = toml["switch_tables"].as_array())
     {
@@ -285,6 +339,7 @@ void RecompilerConfig::Load(const std::string_view& configFilePath)
         maxJumpExtension = (*analysisTable)["max_jump_extension"].value_or(65536u);
         dataRegionThreshold = (*analysisTable)["data_region_threshold"].value_or(16u);
         largeFunctionThreshold = (*analysisTable)["large_function_threshold"].value_or(1048576u);
+        analysisThreads = (*analysisTable)["threads"].value_or(0u);
 
         // Exception handler function addresses for code region segmentation
         if (auto handlers = (*analysisTable)["exception_handler_funcs"].as_array()) {
@@ -320,6 +375,14 @@ RecompilerConfig::ValidationResult RecompilerConfig::Validate() const {
         }
     }
 
+    // Check indirect call hint alignment
+    for (const auto& [site, targets] : indirectCallTargets) {
+        checkAlignment(site, "Indirect call site");
+        for (uint32_t target : targets) {
+            checkAlignment(target, "Indirect call target");
+        }
+    }
+
     // Check for duplicate function boundaries
     {
         std::map<uint32_t, uint32_t> seen;
@@ -0,0 +1,197 @@
+/**
+ * @file        rexcodegen/devirtualize.cpp
+ * @brief       Likely targets of indirect calls through ctr
+ *
+ * @copyright   Copyright (c) 2026 Tom Clay <tomc@tctechstuff.com>
+ *              All rights reserved.
+ *
+ * @license     BSD 3-Clause License
+ *              See LICENSE file in the project root for full license text.
+ */
+
+#include "devirtualize.h"
+#include "insn_flow.h"
+#include <rex/codegen/codegen_context.h>
+#include <rex/codegen/config.h>
+#include <rex/codegen/function_graph.h>
+#include <rex/logging.h>
+#include <rex/memory/utils.h>
+#include <ppc.h>
+#include <algorithm>
+#include <unordered_map>
+
+using rex::memory::load_and_swap;
+
+namespace rex::codegen {
+
+namespace {
+
+constexpr uint32_t kBctr = 0x4E800420;
+constexpr uint32_t kBctrl = 0x4E800421;
+constexpr uint32_t kMtctrMask = 0xFC1FFFFF;  // All but rS
+constexpr uint32_t kMtctr = 0x7C0903A6;
+constexpr uint32_t kOpLwz = 32;
+constexpr size_t kMaxLookback = 16;
+
+uint32_t RegD(uint32_t instruction) { return (instruction >> 21) & 0x1F; }
+uint32_t RegA(uint32_t instruction) { return (instruction >> 16) & 0x1F; }
+
+} // namespace
+
+bool MayWriteGpr(uint32_t instruction, uint32_t reg)
+{
+    switch (PPC_OP(instruction))
+    {
+    case 36: case 38: case 44: case 47: case 52: case 54: case 62:  // stw stb sth stmw stfs stfd std
+        return false;
+    case 37: case 39: case 45: case 53: case 55:  // Store with update
+        return RegA(instruction) == reg;
+    case 46:  // lmw
+        return RegD(instruction) <= reg;
+    case 20: case 21: case 23: case 24: case 25: case 26: case 27: case 28: case 29: case 30:
+        return RegA(instruction) == reg;  // Rotates and logical immediates write rA
+    case PPC_OP_CTR:
+        return false;  // CR logical ops
+    default:
+        return RegD(instruction) == reg || RegA(instruction) == reg;
+    }
+}
+
+std::optional<uint32_t> FindVtableSlot(std::span<const uint32_t> block, bool requireVtableLoad)
+{
+    if (block.empty())
+        return std::nullopt;
+
+    enum { kWantMtctr, kWantSlotLoad, kWantVtableLoad } want = kWantMtctr;
+    uint32_t reg = 0;
+    uint32_t slot = 0;
+
+    size_t stop = block.size() - 1 > kMaxLookback ? block.size() - 1 - kMaxLookback : 0;
+    for (size_t i = block.size() - 1; i-- > stop;)
+    {
+        uint32_t instruction = load_and_swap<uint32_t>(&block[i]);
+        if (IsBranch(instruction))
+            break;
+
+        bool isLwz = PPC_OP(instruction) == kOpLwz && RegD(instruction) == reg;
+        switch (want)
+        {
+        case kWantMtctr:
+            if ((instruction & kMtctrMask) == kMtctr)
+            {
+                reg = RegD(instruction);
+                want = kWantSlotLoad;
+            }
+            continue;
+        case kWantSlotLoad:
+            if (isLwz)
+            {
+                int16_t offset = static_cast<int16_t>(instruction & 0xFFFF);
+                if (offset < 0 || (offset & 3) || RegA(instruction) == 0)
+                    return std::nullopt;
+                slot = static_cast<uint32_t>(offset);
+                if (!requireVtableLoad)
+                    return slot;
+                reg = RegA(instruction);
+                want = kWantVtableLoad;
+                continue;
+            }
+            break;
+        case kWantVtableLoad:
+            if (isLwz && (instruction & 0xFFFF) == 0)
+                return slot;
+            break;
+        }
+
+        if (MayWriteGpr(instruction, reg))
+            return std::nullopt;
+    }
+    return std::nullopt;
+}
+
+IndirectCallTargets ResolveIndirectCallTargets(const CodegenContext& ctx,
+                                               std::span<const FunctionNode* const> functions,
+                                               const IndirectCallTargets& profileTargets)
+{
+    const auto& config = ctx.Config();
+    const auto& state = ctx.analysisState();
+    if (config.devirtualizeMaxTargets == 0)
+        return {};
+
+    std::unordered_map<uint32_t, const FunctionNode*> emitted;
+    emitted.reserve(functions.size());
+    for (const FunctionNode* fn : functions)
+        emitted.emplace(fn->base(), fn);
+
+    // Direct calls need a definition under the function's own name
+    auto usable = [&](uint32_t target) {
+        auto it = emitted.find(target);
+        return it != emitted.end() && !it->second->isHelper() && target != state.entryPoint;
+    };
+
+    IndirectCallTargets result;
+    size_t hinted = 0;
+    size_t observed = 0;
+    for (const FunctionNode* fn : functions)
+    {
+        for (const auto& block : fn->blocks())
+        {
+            const auto* data = reinterpret_cast<const uint32_t*>(ctx.binary().translate(block.base));
+            if (!data)
+                continue;
+
+            for (size_t i = 0; i < block.size / 4; i++)
+            {
+                uint32_t instruction = load_and_swap<uint32_t>(data + i);
+                if (instruction != kBctr && instruction != kBctrl)
+                    continue;
+
+                uint32_t site = block.base + static_cast<uint32_t>(i * 4);
+                if (instruction == kBctr)
+                {
+                    if (config.switchTables.contains(site))
+                        continue;
+                    if (std::any_of(fn->jumpTables().begin(), fn->jumpTables().end(),
+                                    [&](const JumpTable& jt) { return jt.bctrAddress == site; }))
+                        continue;
+                }
+
+                std::vector<uint32_t> targets;
+                auto add = [&](uint32_t target) {
+                    if (usable(target) && std::find(targets.begin(), targets.end(), target) == targets.end())
+                        targets.push_back(target);
+                };
+
+                if (auto hint = config.indirectCallTargets.find(site); hint != config.indirectCallTargets.end())
+                {
+                    for (uint32_t target : hint->second)
+                        add(target);
+                    hinted++;
+                }
+                else if (auto seen = profileTargets.find(site); seen != profileTargets.end())
+                {
+                    for (uint32_t target : seen->second)
+                        add(target);
+                    observed++;
+                }
+                else if (auto offset = FindVtableSlot({ data, i + 1 }, !state.knownIndirectCalls.contains(site)))
+                {
+                    auto slot = state.vtableSlotTargets.find(*offset);
+                    if (slot == state.vtableSlotTargets.end() || slot->second.size() > config.devirtualizeMaxTargets)
+                        continue;
+                    for (uint32_t target : slot->second)
+                        add(target);
+                }
+
+                if (!targets.empty())
+                    result.emplace(site, std::move(targets));
+            }
+        }
+    }
+
+    REXCODEGEN_DEBUG("Devirtualize: guarding {} indirect calls ({} from config, {} from profile)",
+                     result.size(), hinted, observed);
+    return result;
+}
+
+} // namespace rex::codegen
@@ -0,0 +1,63 @@
+/**
+ * @file        rex/codegen/devirtualize.h
+ * @brief       Likely targets of indirect calls through ctr
+ *
+ * @copyright   Copyright (c) 2026 Tom Clay <tomc@tctechstuff.com>
+ *              All rights reserved.
+ *
+ * @license     BSD 3-Clause License
+ *              See LICENSE file in the project root for full license text.
+ */
+
+#pragma once
+
+#include <rex/codegen/recompiler.h>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+namespace rex::codegen {
+
+class CodegenContext;
+class FunctionNode;
+
+/**
+ * Whether an instruction might write GPR reg.
+ *
+ * Errs towards yes: a false match only loses the guard.
+ *
+ * @param instruction Instruction word in host byte order
+ */
+bool MayWriteGpr(uint32_t instruction, uint32_t reg);
+
+/**
+ * Byte offset of the vtable slot a bctr/bctrl calls through.
+ *
+ * Matches `lwz rV, 0(rObj)`, `lwz rF, slot(rV)`, `mtctr rF` ahead of the
+ * branch in the same block. Anything in between that might write rV or rF
+ * ends the match.
+ *
+ * @param block Instruction words of the block in guest byte order, ending
+ *              with the branch
+ * @param requireVtableLoad If false, the slot load alone is enough (sites
+ *                          listed in [[indirect_calls]])
+ */
+std::optional<uint32_t> FindVtableSlot(std::span<const uint32_t> block, bool requireVtableLoad);
+
+/**
+ * Pick the targets to test ctr against at every unconditional bctr/bctrl.
+ *
+ * Targets from [[indirect_call_targets]] win, then those an execution
+ * profile observed. Otherwise a vtable call whose slot holds at most
+ * devirtualizeMaxTargets distinct functions across every RTTI vtable guards
+ * all of them. The function table lookup stays as the fallback, so a wrong
+ * guess only costs a compare.
+ *
+ * @param functions Functions being emitted; only these can be targets
+ * @param profileTargets Targets observed per site by an execution profile
+ */
+IndirectCallTargets ResolveIndirectCallTargets(const CodegenContext& ctx,
+                                               std::span<const FunctionNode* const> functions,
+                                               const IndirectCallTargets& profileTargets = {});
+
+} // namespace rex::codegen
@@ -0,0 +1,333 @@
+/**
+ * @file        codegen/emit_cache.cpp
+ *
+ * @copyright   Copyright (c) 2026 Tom Clay <tomc@tctechstuff.com>
+ *              All rights reserved.
+ *
+ * @license     BSD 3-Clause License
+ *              See LICENSE file in the project root for full license text.
+ */
+
+#include "emit_cache.h"
+#include "emit_fingerprint.h"
+#include <rex/codegen/function_graph.h>
+#include <rex/logging.h>
+#include <cstring>
+#include <fstream>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <variant>
+#include <xxhash.h>
+
+namespace rex::codegen {
+
+namespace {
+
+constexpr char kMagic[8] = { 'R', 'E', 'X', 'E', 'M', 'I', 'T', '\0' };
+
+struct Hasher {
+    XXH3_state_t* state = XXH3_createState();
+
+    explicit Hasher(uint64_t seed) { XXH3_128bits_reset_withSeed(state, seed); }
+    ~Hasher() { XXH3_freeState(state); }
+    Hasher(const Hasher&) = delete;
+    Hasher& operator=(const Hasher&) = delete;
+
+    template<typename T>
+    void add(const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        XXH3_128bits_update(state, &value, sizeof(value));
+    }
+
+    void add(std::string_view str)
+    {
+        add(str.size());
+        XXH3_128bits_update(state, str.data(), str.size());
+    }
+
+    void addBytes(const void* data, size_t size) { XXH3_128bits_update(state, data, size); }
+};
+
+template<typename T>
+bool ReadValue(std::ifstream& in, T& value)
+{
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+template<typename T>
+void WriteValue(std::ofstream& out, const T& value)
+{
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void HashCallEdges(Hasher& h, const BinaryView& binary, const std::vector<CallEdge>& edges,
+                   const FlushModeExits* flushModeExits, const InlineLeaves* inlineLeaves)
+{
+    h.add(edges.size());
+    for (const auto& edge : edges) {
+        h.add(edge.site);
+        h.add(static_cast<uint8_t>(edge.target.value.index()));
+        if (auto* node = edge.target.asFunction()) {
+            h.add(node->base());
+            h.add(std::string_view(node->name()));
+            if (flushModeExits) {
+                auto exit = flushModeExits->find(node->base());
+                h.add(static_cast<uint8_t>(exit != flushModeExits->end() ? exit->second : FlushModeExit::Unknown));
+            }
+            // An inlined callee's code is part of this function's output
+            bool inlined = inlineLeaves && inlineLeaves->contains(node->base());
+            h.add(inlined);
+            if (inlined) {
+                if (const uint8_t* data = binary.translate(node->base())) {
+                    h.addBytes(data, node->size());
+                }
+            }
+        } else if (auto* import = std::get_if<CallTarget::ToImport>(&edge.target.value)) {
+            h.add(import->address);
+            h.add(std::string_view(import->name));
+        } else if (auto* unresolved = std::get_if<CallTarget::Unresolved>(&edge.target.value)) {
+            h.add(unresolved->address);
+        }
+    }
+}
+
+} // namespace
+
+EmitCache::EmitCache(const CodegenContext& ctx, std::filesystem::path path)
+    : ctx_(ctx), path_(std::move(path))
+{
+}
+
+void EmitCache::Load()
+{
+    entries_.clear();
+
+    std::ifstream in(path_, std::ios::binary);
+    if (!in) {
+        REXCODEGEN_DEBUG("Emit cache: no cache at {}", path_.string());
+        return;
+    }
+
+    in.seekg(0, std::ios::end);
+    const auto fileSize = static_cast<uint64_t>(in.tellg());
+    in.seekg(0);
+
+    char magic[sizeof(kMagic)];
+    uint32_t version = 0;
+    uint32_t count = 0;
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0 ||
+        !ReadValue(in, version) || version != kVersion || !ReadValue(in, count)) {
+        REXCODEGEN_INFO("Emit cache: {} is stale or unreadable, rebuilding", path_.string());
+        return;
+    }
+
+    entries_.reserve(count);
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t base = 0;
+        Entry entry;
+        uint64_t length = 0;
+        if (!ReadValue(in, base) || !ReadValue(in, entry.key.low) ||
+            !ReadValue(in, entry.key.high) || !ReadValue(in, length)) {
+            break;
+        }
+        // A corrupt length must not allocate more than the rest of the file
+        if (length > fileSize - static_cast<uint64_t>(in.tellg())) {
+            break;
+        }
+        entry.body.resize(length);
+        if (!in.read(entry.body.data(), static_cast<std::streamsize>(length))) {
+            break;
+        }
+        entries_.emplace(base, std::move(entry));
+    }
+
+    if (entries_.size() != count) {
+        REXCODEGEN_WARN("Emit cache: {} is truncated, rebuilding", path_.string());
+        entries_.clear();
+    }
+}
+
+void EmitCache::Prepare(const std::vector<const FunctionNode*>& functions,
+                        const FlushModeExits* flushModeExits,
+                        const IndirectCallTargets* indirectCallTargets,
+                        const InlineLeaves* inlineLeaves,
+                        const ExecutionProfile* executionProfile)
+{
+    const uint64_t seed = ComputeGlobalSeed();
+
+    bases_.resize(functions.size());
+    keys_.resize(functions.size());
+    for (size_t i = 0; i < functions.size(); i++) {
+        bases_[i] = functions[i]->base();
+        keys_[i] = ComputeKey(*functions[i], seed, flushModeExits, indirectCallTargets, inlineLeaves,
+                               executionProfile);
+    }
+}
+
+std::optional<std::string> EmitCache::Take(size_t index)
+{
+    auto it = entries_.find(bases_[index]);
+    if (it == entries_.end() || it->second.key != keys_[index]) {
+        return std::nullopt;
+    }
+    return std::move(it->second.body);
+}
+
+bool EmitCache::Save(const std::vector<std::string>& bodies) const
+{
+    auto tempPath = path_;
+    tempPath += ".tmp";
+
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            REXCODEGEN_WARN("Emit cache: failed to open {} for writing", tempPath.string());
+            return false;
+        }
+
+        out.write(kMagic, sizeof(kMagic));
+        WriteValue(out, kVersion);
+        WriteValue(out, static_cast<uint32_t>(bodies.size()));
+        for (size_t i = 0; i < bodies.size(); i++) {
+            WriteValue(out, bases_[i]);
+            WriteValue(out, keys_[i].low);
+            WriteValue(out, keys_[i].high);
+            WriteValue(out, static_cast<uint64_t>(bodies[i].size()));
+            out.write(bodies[i].data(), static_cast<std::streamsize>(bodies[i].size()));
+        }
+
+        if (!out) {
+            REXCODEGEN_WARN("Emit cache: failed writing {}", tempPath.string());
+            return false;
+        }
+    }
+
+    // Rename over the old cache so an interrupted run never leaves a torn file
+    std::error_code ec;
+    std::filesystem::rename(tempPath, path_, ec);
+    if (ec) {
+        REXCODEGEN_WARN("Emit cache: failed to replace {}: {}", path_.string(), ec.message());
+        return false;
+    }
+    return true;
+}
+
+uint64_t EmitCache::ComputeGlobalSeed() const
+{
+    const auto& cfg = ctx_.Config();
+
+    Hasher h(kVersion);
+    h.add(static_cast<uint64_t>(REXCODEGEN_EMIT_FINGERPRINT));
+    h.add(cfg.skipLr);
+    h.add(cfg.ctrAsLocalVariable);
+    h.add(cfg.xerAsLocalVariable);
+    h.add(cfg.reservedRegisterAsLocalVariable);
+    h.add(cfg.skipMsr);
+    h.add(cfg.crRegistersAsLocalVariables);
+    h.add(cfg.nonArgumentRegistersAsLocalVariables);
+    h.add(cfg.nonVolatileRegistersAsLocalVariables);
+    h.add(cfg.generateExceptionHandlers);
+    h.add(cfg.flagLiveness);
+    h.add(cfg.flagLivenessAssumeAbi);
+    h.add(cfg.flushModeAnalysis);
+    h.add(cfg.devirtualizeMaxTargets);
+    h.add(cfg.inlineMaxInstructions);
+    h.add(cfg.profileInstrument);
+    h.add(cfg.longJmpAddress);
+    h.add(cfg.setJmpAddress);
+    h.add(ctx_.analysisState().entryPoint);
+
+    return XXH3_128bits_digest(h.state).low64;
+}
+
+EmitCache::Key EmitCache::ComputeKey(const FunctionNode& fn, uint64_t globalSeed,
+                                     const FlushModeExits* flushModeExits,
+                                     const IndirectCallTargets* indirectCallTargets,
+                                     const InlineLeaves* inlineLeaves,
+                                     const ExecutionProfile* executionProfile) const
+{
+    const auto& cfg = ctx_.Config();
+    const auto& graph = ctx_.graph;
+
+    Hasher h(globalSeed);
+    h.add(fn.base());
+    h.add(fn.size());
+    h.add(std::string_view(fn.name()));
+    if (executionProfile) {
+        h.add(static_cast<uint8_t>(executionProfile->heat(fn.base())));
+    }
+
+    h.add(fn.blocks().size());
+    for (const auto& block : fn.blocks()) {
+        h.add(block.base);
+        h.add(block.size);
+        if (const uint8_t* data = ctx_.binary().translate(block.base)) {
+            h.addBytes(data, block.size);
+        }
+
+        // Config entries that apply at addresses inside this block
+        for (uint32_t addr = block.base; addr < block.end(); addr += 4) {
+            if (auto hook = cfg.midAsmHooks.find(addr); hook != cfg.midAsmHooks.end()) {
+                const auto& m = hook->second;
+                h.add(addr);
+                h.add(std::string_view(m.name));
+                for (const auto& reg : m.registers) {
+                    h.add(std::string_view(reg));
+                }
+                h.add(m.ret);
+                h.add(m.returnOnTrue);
+                h.add(m.returnOnFalse);
+                h.add(m.jumpAddress);
+                h.add(m.jumpAddressOnTrue);
+                h.add(m.jumpAddressOnFalse);
+                h.add(m.afterInstruction);
+            }
+            if (auto table = cfg.switchTables.find(addr); table != cfg.switchTables.end()) {
+                h.add(addr);
+                h.add(table->second.indexRegister);
+                h.addBytes(table->second.targets.data(), table->second.targets.size() * sizeof(uint32_t));
+            }
+            if (indirectCallTargets) {
+                if (auto site = indirectCallTargets->find(addr); site != indirectCallTargets->end()) {
+                    h.add(addr);
+                    for (uint32_t target : site->second) {
+                        h.add(target);
+                        if (const auto* targetFn = graph.getFunction(target)) {
+                            h.add(std::string_view(targetFn->name()));
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    h.add(fn.jumpTables().size());
+    for (const auto& jt : fn.jumpTables()) {
+        h.add(jt.bctrAddress);
+        h.add(jt.indexRegister);
+        h.addBytes(jt.targets.data(), jt.targets.size() * sizeof(uint32_t));
+    }
+
+    HashCallEdges(h, ctx_.binary(), fn.calls(), flushModeExits, inlineLeaves);
+    HashCallEdges(h, ctx_.binary(), fn.tailCalls(), flushModeExits, inlineLeaves);
+
+    if (fn.hasExceptionInfo()) {
+        if (const auto* seh = fn.exceptionInfo()->asSeh()) {
+            h.add(seh->frameSize);
+            h.add(seh->restoreHelper);
+            if (const auto* restoreFn = graph.getFunction(seh->restoreHelper)) {
+                h.add(std::string_view(restoreFn->name()));
+            }
+            for (const auto& scope : seh->scopes) {
+                h.add(scope);
+            }
+        }
+    }
+
+    auto digest = XXH3_128bits_digest(h.state);
+    return Key{ digest.low64, digest.high64 };
+}
+
+} // namespace rex::codegen
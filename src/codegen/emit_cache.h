@@ -0,0 +1,110 @@
+/**
+ * @file        rex/codegen/emit_cache.h
+ * @brief       Persistent per-function emission cache for incremental codegen
+ *
+ * @copyright   Copyright (c) 2026 Tom Clay <tomc@tctechstuff.com>
+ *              All rights reserved.
+ *
+ * @license     BSD 3-Clause License
+ *              See LICENSE file in the project root for full license text.
+ */
+
+#pragma once
+
+#include <rex/codegen/codegen_context.h>
+#include <rex/codegen/recompiler.h>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace rex::codegen {
+
+class FunctionNode;
+
+/**
+ * On-disk cache of emitted C++ bodies, keyed per function.
+ *
+ * The key is an XXH3-128 over everything that feeds emission for one
+ * function: its instruction bytes and block layout, resolved call targets
+ * and the code of those it inlines, jump tables, SEH info, the mid-asm hooks
+ * and switch tables that fall inside it, the flush mode its callees return
+ * in, the targets guarded at its indirect calls, its profile heat, and the
+ * global register-as-local flags, plus a fingerprint of the codegen sources.
+ * A function whose key matches the previous run reuses its stored body
+ * instead of going through the builders again.
+ *
+ * Usage:
+ *   EmitCache cache(ctx, path);
+ *   cache.Load();
+ *   cache.Prepare(functions);
+ *   ... cache.Take(i) per function, emit on miss ...
+ *   cache.Save(bodies);
+ */
+class EmitCache {
+public:
+    /// Bump when the file layout changes. Builder changes are caught by the
+    /// source fingerprint in every key (emit_fingerprint.cmake).
+    static constexpr uint32_t kVersion = 6;
+
+    EmitCache(const CodegenContext& ctx, std::filesystem::path path);
+
+    /// Load the previous run's cache. Missing or stale files yield an empty cache.
+    void Load();
+
+    /**
+     * Compute keys for this run. Index i of later calls refers to functions[i].
+     * @param flushModeExits Solved callee exits emission will use, if any
+     * @param indirectCallTargets Guarded bctr/bctrl targets emission will use, if any
+     * @param inlineLeaves Functions emitted in place of their calls, if any
+     * @param executionProfile Profile deciding hot/cold attributes, if any
+     */
+    void Prepare(const std::vector<const FunctionNode*>& functions,
+                 const FlushModeExits* flushModeExits = nullptr,
+                 const IndirectCallTargets* indirectCallTargets = nullptr,
+                 const InlineLeaves* inlineLeaves = nullptr,
+                 const ExecutionProfile* executionProfile = nullptr);
+
+    /**
+     * Move out the cached body for functions[index] if its key is unchanged.
+     * Safe to call concurrently for distinct indices.
+     */
+    std::optional<std::string> Take(size_t index);
+
+    /**
+     * Replace the on-disk cache with this run's bodies.
+     * @param bodies Emitted bodies, parallel to the functions given to Prepare()
+     * @return false if the file could not be written
+     */
+    bool Save(const std::vector<std::string>& bodies) const;
+
+private:
+    struct Key {
+        uint64_t low = 0;
+        uint64_t high = 0;
+
+        bool operator==(const Key&) const = default;
+    };
+
+    struct Entry {
+        Key key;
+        std::string body;
+    };
+
+    Key ComputeKey(const FunctionNode& fn, uint64_t globalSeed,
+                   const FlushModeExits* flushModeExits,
+                   const IndirectCallTargets* indirectCallTargets,
+                   const InlineLeaves* inlineLeaves,
+                   const ExecutionProfile* executionProfile) const;
+    uint64_t ComputeGlobalSeed() const;
+
+    const CodegenContext& ctx_;
+    std::filesystem::path path_;
+    std::unordered_map<uint32_t, Entry> entries_;  ///< Previous run, by function base
+    std::vector<uint32_t> bases_;                  ///< This run, by index
+    std::vector<Key> keys_;                        ///< This run, by index
+};
+
+} // namespace rex::codegen
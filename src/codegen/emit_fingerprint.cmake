@@ -0,0 +1,23 @@
+# Hash the codegen sources into emit_fingerprint.h so the emit cache drops
+# every stored body whenever the code that produced them changes.
+#
+# Usage: cmake -DOUTPUT=<header> -DSOURCES=<a;b;...> -P emit_fingerprint.cmake
+
+set(_digests "")
+foreach(_source IN LISTS SOURCES)
+    file(SHA256 "${_source}" _digest)
+    string(APPEND _digests "${_digest}")
+endforeach()
+string(SHA256 _fingerprint "${_digests}")
+string(SUBSTRING "${_fingerprint}" 0 16 _fingerprint)
+
+set(_content "#pragma once\n\n// Generated by emit_fingerprint.cmake - do not edit\n#define REXCODEGEN_EMIT_FINGERPRINT 0x${_fingerprint}ull\n")
+
+# Leave the file alone when nothing changed so dependents don't rebuild
+if(EXISTS "${OUTPUT}")
+    file(READ "${OUTPUT}" _existing)
+    if(_existing STREQUAL _content)
+        return()
+    endif()
+endif()
+file(WRITE "${OUTPUT}" "${_content}")
@@ -0,0 +1,112 @@
+/**
+ * @file        rexcodegen/execution_profile.cpp
+ * @brief       Guest execution counts fed back into codegen
+ *
+ * @copyright   Copyright (c) 2026 Tom Clay <tomc@tctechstuff.com>
+ *              All rights reserved.
+ *
+ * @license     BSD 3-Clause License
+ *              See LICENSE file in the project root for full license text.
+ */
+
+#include <rex/codegen/execution_profile.h>
+#include <rex/logging.h>
+#include <fmt/format.h>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace rex::codegen {
+
+Result<ExecutionProfile> ExecutionProfile::Load(const std::filesystem::path& path)
+{
+    std::ifstream in(path);
+    if (!in) {
+        return Err<ExecutionProfile>(ErrorCategory::IO, fmt::format("Cannot open profile {}", path.string()));
+    }
+
+    ExecutionProfile profile;
+    std::string line;
+    size_t lineNumber = 0;
+    while (std::getline(in, line))
+    {
+        lineNumber++;
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        std::istringstream fields(line);
+        std::string kind;
+        fields >> kind;
+
+        if (kind == "entry")
+        {
+            uint32_t function = 0;
+            uint64_t count = 0;
+            if (!(fields >> std::hex >> function >> std::dec >> count))
+                return Err<ExecutionProfile>(ErrorCategory::Format,
+                    fmt::format("{}:{}: malformed entry record", path.string(), lineNumber));
+            profile.entries_[function] += count;
+            profile.totalEntries_ += count;
+        }
+        else if (kind == "indirect")
+        {
+            uint32_t site = 0;
+            uint32_t target = 0;
+            uint64_t count = 0;
+            if (!(fields >> std::hex >> site >> target >> std::dec >> count))
+                return Err<ExecutionProfile>(ErrorCategory::Format,
+                    fmt::format("{}:{}: malformed indirect record", path.string(), lineNumber));
+            auto& record = profile.indirectSites_[site];
+            record.total += count;
+            if (target != 0)
+                record.targets.emplace_back(target, count);
+        }
+    }
+
+    for (auto& [site, record] : profile.indirectSites_)
+    {
+        std::stable_sort(record.targets.begin(), record.targets.end(),
+                         [](const auto& a, const auto& b) { return a.second > b.second; });
+    }
+
+    // Hot functions are the busiest ones that together make up kHotFraction of all calls
+    std::vector<uint64_t> counts;
+    counts.reserve(profile.entries_.size());
+    for (const auto& [function, count] : profile.entries_)
+        counts.push_back(count);
+    std::sort(counts.begin(), counts.end(), std::greater<>());
+
+    const auto hotCalls = static_cast<uint64_t>(static_cast<double>(profile.totalEntries_) * kHotFraction);
+    uint64_t covered = 0;
+    for (uint64_t count : counts)
+    {
+        profile.hotThreshold_ = count;
+        covered += count;
+        if (covered >= hotCalls)
+            break;
+    }
+
+    REXCODEGEN_INFO("Loaded profile {}: {} functions entered {} times, {} indirect call sites",
+                    path.string(), profile.entries_.size(), profile.totalEntries_, profile.indirectSites_.size());
+    return profile;
+}
+
+uint64_t ExecutionProfile::entryCount(uint32_t function) const
+{
+    auto it = entries_.find(function);
+    return it != entries_.end() ? it->second : 0;
+}
+
+FunctionHeat ExecutionProfile::heat(uint32_t function) const
+{
+    if (totalEntries_ == 0)
+        return FunctionHeat::Normal;
+
+    uint64_t count = entryCount(function);
+    if (count == 0)
+        return FunctionHeat::Cold;
+    return count >= hotThreshold_ ? FunctionHeat::Hot : FunctionHeat::Normal;
+}
+
+} // namespace rex::codegen
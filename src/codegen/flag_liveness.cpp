@@ -0,0 +1,219 @@
+/**
+ * @file        rexcodegen/flag_liveness.cpp
+ * @brief       Liveness of condition register bits and XER[CA] within a function
+ *
+ * @copyright   Copyright (c) 2026 Tom Clay <tomc@tctechstuff.com>
+ *              All rights reserved.
+ *
+ * @license     BSD 3-Clause License
+ *              See LICENSE file in the project root for full license text.
+ */
+
+#include "flag_liveness.h"
+#include <rex/codegen/config.h>
+#include <ppc.h>
+#include <ppc-inst.h>
+#include <cstring>
+
+namespace rex::codegen {
+
+namespace {
+
+struct FlagEffect
+{
+    uint64_t use = 0;
+    uint64_t def = 0;
+};
+
+/// Record forms whose builders emit the cr0 update (see emitRecordFormCompare)
+bool WritesCr0OnRecord(int id)
+{
+    switch (id)
+    {
+    case PPC_INST_ADD: case PPC_INST_ADDC: case PPC_INST_ADDE: case PPC_INST_ADDIC:
+    case PPC_INST_ADDME: case PPC_INST_ADDZE: case PPC_INST_DIVDU: case PPC_INST_DIVW:
+    case PPC_INST_DIVWU: case PPC_INST_MULHD: case PPC_INST_MULHDU: case PPC_INST_MULHWU:
+    case PPC_INST_MULLW: case PPC_INST_NEG: case PPC_INST_SUBF: case PPC_INST_SUBFC:
+    case PPC_INST_SUBFE: case PPC_INST_SUBFME: case PPC_INST_SUBFZE:
+    case PPC_INST_AND: case PPC_INST_ANDC: case PPC_INST_CLRLWI: case PPC_INST_EQV:
+    case PPC_INST_EXTSB: case PPC_INST_EXTSH: case PPC_INST_EXTSW: case PPC_INST_NOT:
+    case PPC_INST_OR: case PPC_INST_RLWINM: case PPC_INST_RLWNM: case PPC_INST_ROTLWI:
+    case PPC_INST_SLW: case PPC_INST_SRAW: case PPC_INST_SRAWI: case PPC_INST_SRW:
+    case PPC_INST_XOR: case PPC_INST_MR:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool IsVectorRecordCompare(int id)
+{
+    switch (id)
+    {
+    case PPC_INST_VCMPBFP: case PPC_INST_VCMPBFP128: case PPC_INST_VCMPEQFP:
+    case PPC_INST_VCMPEQFP128: case PPC_INST_VCMPEQUB: case PPC_INST_VCMPEQUH:
+    case PPC_INST_VCMPEQUW: case PPC_INST_VCMPEQUW128: case PPC_INST_VCMPGEFP:
+    case PPC_INST_VCMPGEFP128: case PPC_INST_VCMPGTFP: case PPC_INST_VCMPGTFP128:
+    case PPC_INST_VCMPGTUB: case PPC_INST_VCMPGTUH: case PPC_INST_VCMPGTSH:
+    case PPC_INST_VCMPGTSW:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/// Non-branch effect of one instruction, mirroring what its builder emits.
+void AddDataEffect(const ppc_insn& insn, FlagEffect& effect)
+{
+    int id = insn.opcode->id;
+    bool record = std::strchr(insn.opcode->name, '.') != nullptr;
+
+    switch (id)
+    {
+    case PPC_INST_CMPD: case PPC_INST_CMPDI: case PPC_INST_CMPLD: case PPC_INST_CMPLDI:
+    case PPC_INST_CMPLW: case PPC_INST_CMPLWI: case PPC_INST_CMPW: case PPC_INST_CMPWI:
+    case PPC_INST_FCMPU: case PPC_INST_FCMPO:
+        effect.def |= flags::crField(insn.operands[0]);
+        break;
+
+    case PPC_INST_ANDI: case PPC_INST_ANDIS:
+    case PPC_INST_STWCX: case PPC_INST_STDCX:
+        effect.def |= flags::crField(0);
+        break;
+
+    case PPC_INST_MTCR:
+        effect.def |= flags::kCrAll;
+        break;
+
+    case PPC_INST_MFCR:
+        effect.use |= flags::kCrAll;
+        break;
+
+    case PPC_INST_MFOCRF:
+        for (size_t i = 0; i < 8; i++) {
+            if (insn.operands[1] & (0x80u >> i)) {
+                effect.use |= flags::crField(i);
+                break;
+            }
+        }
+        break;
+
+    // Extended arithmetic reads and writes the carry
+    case PPC_INST_ADDE: case PPC_INST_ADDZE: case PPC_INST_ADDME:
+    case PPC_INST_SUBFE: case PPC_INST_SUBFZE: case PPC_INST_SUBFME:
+        effect.use |= flags::kCa;
+        effect.def |= flags::kCa;
+        break;
+
+    case PPC_INST_ADDC: case PPC_INST_ADDIC: case PPC_INST_SUBFC: case PPC_INST_SUBFIC:
+    case PPC_INST_SRAD: case PPC_INST_SRADI: case PPC_INST_SRAW: case PPC_INST_SRAWI:
+    case PPC_INST_MTXER:
+        effect.def |= flags::kCa;
+        break;
+
+    // No builder yet; assume they observe everything
+    case PPC_INST_MCRF: case PPC_INST_MCRXR: case PPC_INST_MFXER:
+    case PPC_INST_CRAND: case PPC_INST_CRANDC: case PPC_INST_CRCLR: case PPC_INST_CREQV:
+    case PPC_INST_CRMOVE: case PPC_INST_CRNAND: case PPC_INST_CRNOR: case PPC_INST_CRNOT:
+    case PPC_INST_CROR: case PPC_INST_CRORC: case PPC_INST_CRSET: case PPC_INST_CRXOR:
+        effect.use |= flags::kAll;
+        break;
+    }
+
+    if (record)
+    {
+        if (WritesCr0OnRecord(id))
+            effect.def |= flags::crField(0);
+        else if (IsVectorRecordCompare(id))
+            effect.def |= flags::crField(6);
+    }
+}
+
+} // namespace
+
+std::vector<uint64_t> ComputeFlagLiveness(const RecompilerConfig& config,
+                                          std::span<const EmittedInsn> insns,
+                                          std::span<const InsnFlow> flows,
+                                          FlagBoundary boundary)
+{
+    const size_t count = insns.size();
+
+    std::vector<FlagEffect> effects(count);
+    std::vector<uint64_t> liveIn(count, 0);
+    std::vector<uint64_t> liveOut(count, 0);
+    std::vector<bool> hookAfter(count, false);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const EmittedInsn& site = insns[i];
+        FlagEffect& effect = effects[i];
+        if (site.insn.opcode == nullptr)
+            continue;
+
+        const uint32_t instruction = site.insn.instruction;
+        const uint32_t op = PPC_OP(instruction);
+        const InsnFlow& flow = flows[i];
+
+        if (op == PPC_OP_B || op == PPC_OP_BC ||
+            (op == PPC_OP_CTR && (PPC_XOP(instruction) == 16 || PPC_XOP(instruction) == 528)))
+        {
+            const uint32_t bo = PPC_BO(instruction);
+            const uint32_t bi = (instruction >> 16) & 0x1F;
+            if (op != PPC_OP_B && !(bo & 0x10))
+                effect.use |= 1ull << bi;
+
+            if (flow.exits)
+                effect.use |= boundary.exit;
+            else if (flow.calls)
+                effect.use |= boundary.call;
+        }
+        else
+        {
+            AddDataEffect(site.insn, effect);
+        }
+
+        auto hook = config.midAsmHooks.find(site.base);
+        if (hook != config.midAsmHooks.end())
+        {
+            // Hooks take CR and XER by reference and may return or jump anywhere
+            if (hook->second.afterInstruction)
+                hookAfter[i] = true;
+            else
+                effect.use |= flags::kAll;
+        }
+    }
+
+    // Iterate to a fixed point; visiting in reverse converges in a couple of
+    // passes for everything but loop back edges.
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        for (size_t i = count; i-- > 0;)
+        {
+            const FlagEffect& effect = effects[i];
+            const InsnFlow& flow = flows[i];
+            uint64_t out = hookAfter[i] ? flags::kAll : 0;
+            // What the caller reads after a return, or what a tail call
+            // emitted in place (inline leaves) has to leave behind
+            if (flow.exits)
+                out |= boundary.exit;
+            if (flow.fallsThrough)
+                out |= i + 1 < count ? liveIn[i + 1] : boundary.exit;
+            for (size_t successor : flow.successors)
+                out |= liveIn[successor];
+
+            uint64_t in = effect.use | (out & ~effect.def);
+            if (out != liveOut[i] || in != liveIn[i])
+            {
+                liveOut[i] = out;
+                liveIn[i] = in;
+                changed = true;
+            }
+        }
+    }
+
+    return liveOut;
+}
+
+} // namespace rex::codegen
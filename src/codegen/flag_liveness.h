@@ -0,0 +1,69 @@
+/**
+ * @file        rex/codegen/flag_liveness.h
+ * @brief       Liveness of condition register bits and XER[CA] within a function
+ *
+ * @copyright   Copyright (c) 2026 Tom Clay <tomc@tctechstuff.com>
+ *              All rights reserved.
+ *
+ * @license     BSD 3-Clause License
+ *              See LICENSE file in the project root for full license text.
+ */
+
+#pragma once
+
+#include "insn_flow.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace rex::codegen {
+
+struct RecompilerConfig;
+
+/**
+ * Flags tracked by the liveness pass, one bit each in a 64-bit mask.
+ *
+ * Bit 4*N+B is bit B (lt, gt, eq, so) of crN, the same numbering as the BI
+ * field of conditional branches. kFlagCa is XER[CA]. XER[SO] is not tracked:
+ * only mtxer writes it, so it is live almost everywhere.
+ */
+namespace flags {
+    inline constexpr uint64_t kCrAll = 0xFFFFFFFFull;
+    inline constexpr uint64_t kCa = 1ull << 32;
+    inline constexpr uint64_t kAll = kCrAll | kCa;
+
+    /// CR field N (0-7)
+    constexpr uint64_t crField(size_t field) { return 0xFull << (field * 4); }
+
+    /// Nonvolatile CR fields the ABI requires to survive calls (cr2-cr4)
+    inline constexpr uint64_t kCrNonVolatile = crField(2) | crField(3) | crField(4);
+}
+
+/// Flags observed where control leaves the function.
+struct FlagBoundary
+{
+    uint64_t call;  ///< Read by a callee
+    uint64_t exit;  ///< Read after a return or tail call
+};
+
+/**
+ * Compute which flags are read after each instruction.
+ *
+ * Backward dataflow over the instructions in emission order, along the edges
+ * from ComputeInsnFlow(). Anything the pass cannot see through (mid-asm
+ * hooks, instructions without a builder that touch CR or XER) reads every
+ * flag.
+ *
+ * @param insns Instructions in emission order
+ * @param flows Control flow of insns, from ComputeInsnFlow()
+ * @param boundary Flags live at calls and function exits
+ * @return Live-after mask per instruction; boundary.exit for those that
+ *         return or tail call
+ */
+std::vector<uint64_t> ComputeFlagLiveness(const RecompilerConfig& config,
+                                          std::span<const EmittedInsn> insns,
+                                          std::span<const InsnFlow> flows,
+                                          FlagBoundary boundary);
+
+} // namespace rex::codegen
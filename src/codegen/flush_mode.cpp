@@ -0,0 +1,355 @@
+/**
+ * @file        rexcodegen/flush_mode.cpp
+ * @brief       Host flush-mode (FPU vs VMX) state across functions
+ *
+ * @copyright   Copyright (c) 2026 Tom Clay <tomc@tctechstuff.com>
+ *              All rights reserved.
+ *
+ * @license     BSD 3-Clause License
+ *              See LICENSE file in the project root for full license text.
+ */
+
+#include "flush_mode.h"
+#include <rex/codegen/config.h>
+#include <rex/codegen/function_graph.h>
+#include <rex/codegen/recompiler.h>
+#include <ppc-inst.h>
+#include <deque>
+
+namespace rex::codegen {
+
+namespace {
+
+/// Forward dataflow value: the mode on some edge, relative to function entry
+enum class Mode : uint8_t
+{
+    Unreached,
+    Entry,
+    FPU,
+    VMX,
+    Unknown,
+};
+
+Mode Meet(Mode a, Mode b)
+{
+    if (a == Mode::Unreached)
+        return b;
+    if (b == Mode::Unreached || a == b)
+        return a;
+    return Mode::Unknown;
+}
+
+Mode FromCsr(CSRState state)
+{
+    switch (state)
+    {
+    case CSRState::FPU: return Mode::FPU;
+    case CSRState::VMX: return Mode::VMX;
+    default: return Mode::Unknown;
+    }
+}
+
+Mode ApplyCall(const FlushModeFlow::Step& step, Mode in, const FlushModeExits* exits)
+{
+    if (in == Mode::Unreached || step.call == FlushModeFlow::Call::None)
+        return in;
+    if (step.call == FlushModeFlow::Call::Unknown || exits == nullptr)
+        return Mode::Unknown;
+
+    auto it = exits->find(step.callee);
+    if (it == exits->end())
+        return Mode::Unknown;
+
+    switch (it->second)
+    {
+    case FlushModeExit::NoReturn: return Mode::Unreached;
+    case FlushModeExit::Unchanged: return in;
+    case FlushModeExit::FPU: return Mode::FPU;
+    case FlushModeExit::VMX: return Mode::VMX;
+    default: return Mode::Unknown;
+    }
+}
+
+/// Solve one function; fills the mode before each step's builder and returns the exit.
+Mode Solve(const FlushModeFlow& flow, Mode entry, const FlushModeExits* exits, std::vector<Mode>& before)
+{
+    const size_t count = flow.steps.size();
+    std::vector<Mode> in(count, Mode::Unreached);
+    before.assign(count, Mode::Unreached);
+    if (count == 0)
+        return entry;
+    in[0] = entry;
+
+    Mode exit = Mode::Unreached;
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        exit = Mode::Unreached;
+        for (size_t i = 0; i < count; i++)
+        {
+            const auto& step = flow.steps[i];
+            Mode mode = step.unknownBefore && in[i] != Mode::Unreached ? Mode::Unknown : in[i];
+            before[i] = mode;
+
+            if (mode != Mode::Unreached && step.mode != CSRState::Unknown)
+                mode = FromCsr(step.mode);
+
+            if (step.exits)
+                exit = Meet(exit, ApplyCall(step, mode, exits));
+            else
+                mode = ApplyCall(step, mode, exits);
+
+            if (step.hookExits && mode != Mode::Unreached)
+                exit = Meet(exit, Mode::Unknown);
+            if (step.unknownAfter && mode != Mode::Unreached)
+                mode = Mode::Unknown;
+
+            auto propagate = [&](size_t to) {
+                Mode merged = Meet(in[to], mode);
+                if (merged != in[to])
+                {
+                    in[to] = merged;
+                    changed = true;
+                }
+            };
+
+            if (step.fallsThrough)
+            {
+                if (i + 1 < count)
+                    propagate(i + 1);
+                else
+                    exit = Meet(exit, mode);  // falls off the end of the body
+            }
+            for (uint32_t s = step.successorsBegin; s < step.successorsEnd; s++)
+                propagate(flow.successors[s]);
+        }
+    }
+    return flow.unknownExit ? Mode::Unknown : exit;
+}
+
+FlushModeExit ToExit(Mode mode)
+{
+    switch (mode)
+    {
+    case Mode::Unreached: return FlushModeExit::NoReturn;
+    case Mode::Entry: return FlushModeExit::Unchanged;
+    case Mode::FPU: return FlushModeExit::FPU;
+    case Mode::VMX: return FlushModeExit::VMX;
+    default: return FlushModeExit::Unknown;
+    }
+}
+
+} // namespace
+
+CSRState RequiredFlushMode(int id)
+{
+    switch (id)
+    {
+    case PPC_INST_FABS: case PPC_INST_FNABS: case PPC_INST_FNEG: case PPC_INST_FMR:
+    case PPC_INST_FCFID: case PPC_INST_FCTID: case PPC_INST_FCTIDZ: case PPC_INST_FCTIWZ:
+    case PPC_INST_FRSP: case PPC_INST_FCMPU: case PPC_INST_FADD: case PPC_INST_FADDS:
+    case PPC_INST_FSUB: case PPC_INST_FSUBS: case PPC_INST_FMUL: case PPC_INST_FMULS:
+    case PPC_INST_FDIV: case PPC_INST_FDIVS: case PPC_INST_FMADD: case PPC_INST_FMADDS:
+    case PPC_INST_FMSUB: case PPC_INST_FMSUBS: case PPC_INST_FNMADDS: case PPC_INST_FNMSUB:
+    case PPC_INST_FNMSUBS: case PPC_INST_FRES: case PPC_INST_FRSQRTE: case PPC_INST_FSQRT:
+    case PPC_INST_FSQRTS: case PPC_INST_FSEL: case PPC_INST_LFD: case PPC_INST_LFDU:
+    case PPC_INST_LFDUX: case PPC_INST_LFDX: case PPC_INST_LFS: case PPC_INST_LFSU:
+    case PPC_INST_LFSUX: case PPC_INST_LFSX: case PPC_INST_STFD: case PPC_INST_STFDU:
+    case PPC_INST_STFDX: case PPC_INST_STFIWX: case PPC_INST_STFS: case PPC_INST_STFSU:
+    case PPC_INST_STFSX:
+        return CSRState::FPU;
+
+    case PPC_INST_VADDFP: case PPC_INST_VADDFP128: case PPC_INST_VSUBFP:
+    case PPC_INST_VSUBFP128: case PPC_INST_VMULFP128: case PPC_INST_VMADDFP:
+    case PPC_INST_VMADDFP128: case PPC_INST_VMADDCFP128: case PPC_INST_VNMSUBFP:
+    case PPC_INST_VNMSUBFP128: case PPC_INST_VMAXFP: case PPC_INST_VMAXFP128:
+    case PPC_INST_VMINFP: case PPC_INST_VMINFP128: case PPC_INST_VREFP: case PPC_INST_VREFP128:
+    case PPC_INST_VRSQRTEFP: case PPC_INST_VRSQRTEFP128: case PPC_INST_VEXPTEFP:
+    case PPC_INST_VEXPTEFP128: case PPC_INST_VLOGEFP: case PPC_INST_VLOGEFP128:
+    case PPC_INST_VMSUM3FP128: case PPC_INST_VMSUM4FP128: case PPC_INST_VRFIM:
+    case PPC_INST_VRFIM128: case PPC_INST_VRFIN: case PPC_INST_VRFIN128: case PPC_INST_VRFIP:
+    case PPC_INST_VRFIP128: case PPC_INST_VRFIZ: case PPC_INST_VRFIZ128: case PPC_INST_VCMPBFP:
+    case PPC_INST_VCMPBFP128: case PPC_INST_VCMPEQFP: case PPC_INST_VCMPEQFP128:
+    case PPC_INST_VCMPGEFP: case PPC_INST_VCMPGEFP128: case PPC_INST_VCMPGTFP:
+    case PPC_INST_VCMPGTFP128: case PPC_INST_VCTSXS: case PPC_INST_VCFPSXWS128:
+    case PPC_INST_VCTUXS: case PPC_INST_VCFPUXWS128: case PPC_INST_VCFSX:
+    case PPC_INST_VCSXWFP128: case PPC_INST_VCFUX: case PPC_INST_VCUXWFP128:
+    case PPC_INST_VPKD3D128:
+        return CSRState::VMX;
+
+    default:
+        return CSRState::Unknown;
+    }
+}
+
+FlushModeFlow BuildFlushModeFlow(const FunctionNode& fn,
+                                 const RecompilerConfig& config,
+                                 std::span<const EmittedInsn> insns,
+                                 std::span<const InsnFlow> flows)
+{
+    FlushModeFlow result;
+    result.base = fn.base();
+    if (config.generateExceptionHandlers && fn.hasExceptionInfo())
+    {
+        const auto* seh = fn.exceptionInfo()->asSeh();
+        result.unknownExit = seh && !seh->scopes.empty();
+    }
+    // Callers get whatever host code replaces the weak definition
+    if (config.overriddenFunctions.contains(fn.base()))
+        result.unknownExit = true;
+    result.steps.resize(insns.size());
+
+    std::unordered_map<uint32_t, size_t> indexOf;
+    indexOf.reserve(insns.size());
+    for (size_t i = 0; i < insns.size(); i++)
+        indexOf.emplace(insns[i].base, i);
+
+    // Same resolution as BuilderContext::findCallTarget
+    auto findCallTarget = [&](uint32_t site) -> const CallTarget* {
+        for (const auto& edge : fn.calls())
+            if (edge.site == site)
+                return &edge.target;
+        for (const auto& edge : fn.tailCalls())
+            if (edge.site == site)
+                return &edge.target;
+        return nullptr;
+    };
+
+    for (size_t i = 0; i < insns.size(); i++)
+    {
+        const EmittedInsn& site = insns[i];
+        const InsnFlow& flow = flows[i];
+        auto& step = result.steps[i];
+
+        step.mode = site.insn.opcode ? RequiredFlushMode(site.insn.opcode->id) : CSRState::Unknown;
+        step.fallsThrough = flow.fallsThrough;
+        step.exits = flow.exits;
+
+        step.successorsBegin = static_cast<uint32_t>(result.successors.size());
+        for (size_t successor : flow.successors)
+            result.successors.push_back(static_cast<uint32_t>(successor));
+        step.successorsEnd = static_cast<uint32_t>(result.successors.size());
+
+        if (flow.calls)
+        {
+            step.call = FlushModeFlow::Call::Unknown;
+            const CallTarget* target = flow.target != 0 ? findCallTarget(site.base) : nullptr;
+            bool jmp = flow.target != 0 &&
+                (flow.target == config.longJmpAddress || flow.target == config.setJmpAddress);
+            if (target && target->isFunction() && !jmp)
+            {
+                const auto& name = target->asFunction()->name();
+                if (config.nonVolatileRegistersAsLocalVariables &&
+                    (name.find("__rest") == 0 || name.find("__save") == 0))
+                {
+                    step.call = FlushModeFlow::Call::None;  // emitted as nothing
+                }
+                else
+                {
+                    step.call = FlushModeFlow::Call::Callee;
+                    step.callee = target->asFunction()->base();
+                }
+            }
+        }
+
+        // Hooks are host code that may touch MXCSR, return, or jump anywhere
+        auto hook = config.midAsmHooks.find(site.base);
+        if (hook != config.midAsmHooks.end())
+        {
+            const auto& m = hook->second;
+            if (m.afterInstruction)
+                step.unknownAfter = true;
+            else
+                step.unknownBefore = true;
+            step.hookExits = m.ret || m.returnOnTrue || m.returnOnFalse;
+
+            for (uint32_t jump : { m.jumpAddress, m.jumpAddressOnTrue, m.jumpAddressOnFalse })
+            {
+                auto it = jump != 0 ? indexOf.find(jump) : indexOf.end();
+                if (it != indexOf.end())
+                    result.steps[it->second].unknownBefore = true;
+            }
+        }
+    }
+
+    return result;
+}
+
+FlushModeExits SolveFlushModeExits(std::span<const FlushModeFlow> functions)
+{
+    FlushModeExits exits;
+    exits.reserve(functions.size());
+
+    std::unordered_map<uint32_t, size_t> indexOf;
+    std::unordered_map<uint32_t, std::vector<size_t>> callers;
+    indexOf.reserve(functions.size());
+    for (size_t i = 0; i < functions.size(); i++)
+    {
+        exits.emplace(functions[i].base, FlushModeExit::NoReturn);
+        indexOf.emplace(functions[i].base, i);
+    }
+    for (size_t i = 0; i < functions.size(); i++)
+    {
+        for (const auto& step : functions[i].steps)
+        {
+            if (step.call != FlushModeFlow::Call::Callee)
+                continue;
+            auto& list = callers[step.callee];
+            if (list.empty() || list.back() != i)
+                list.push_back(i);
+        }
+    }
+
+    std::deque<size_t> worklist;
+    std::vector<bool> queued(functions.size(), true);
+    for (size_t i = 0; i < functions.size(); i++)
+        worklist.push_back(i);
+
+    std::vector<Mode> before;
+    while (!worklist.empty())
+    {
+        size_t i = worklist.front();
+        worklist.pop_front();
+        queued[i] = false;
+
+        const FlushModeFlow& flow = functions[i];
+        FlushModeExit exit = ToExit(Solve(flow, Mode::Entry, &exits, before));
+        FlushModeExit& current = exits[flow.base];
+        if (exit == current)
+            continue;
+        current = exit;
+
+        auto it = callers.find(flow.base);
+        if (it == callers.end())
+            continue;
+        for (size_t caller : it->second)
+        {
+            if (!queued[caller])
+            {
+                queued[caller] = true;
+                worklist.push_back(caller);
+            }
+        }
+    }
+
+    return exits;
+}
+
+std::vector<CSRState> ComputeFlushModes(const FlushModeFlow& flow, const FlushModeExits* exits)
+{
+    std::vector<Mode> before;
+    Solve(flow, Mode::Unknown, exits, before);
+
+    std::vector<CSRState> modes(before.size(), CSRState::Unknown);
+    for (size_t i = 0; i < before.size(); i++)
+    {
+        if (before[i] == Mode::FPU)
+            modes[i] = CSRState::FPU;
+        else if (before[i] == Mode::VMX)
+            modes[i] = CSRState::VMX;
+    }
+    return modes;
+}
+
+} // namespace rex::codegen
@@ -0,0 +1,96 @@
+/**
+ * @file        rex/codegen/flush_mode.h
+ * @brief       Host flush-mode (FPU vs VMX) state across functions
+ *
+ * @copyright   Copyright (c) 2026 Tom Clay <tomc@tctechstuff.com>
+ *              All rights reserved.
+ *
+ * @license     BSD 3-Clause License
+ *              See LICENSE file in the project root for full license text.
+ */
+
+#pragma once
+
+#include "insn_flow.h"
+#include <rex/codegen/recompiler.h>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace rex::codegen {
+
+class FunctionNode;
+struct RecompilerConfig;
+
+/**
+ * Mode instruction id runs in, or CSRState::Unknown if it doesn't care.
+ *
+ * VMX floating point flushes denormals and scalar FPU code keeps them, so the
+ * recompiler switches MXCSR ahead of either when the mode isn't already known.
+ */
+CSRState RequiredFlushMode(int id);
+
+/// Flush-mode effect of each emitted instruction of one function.
+struct FlushModeFlow
+{
+    enum class Call : uint8_t
+    {
+        None,
+        Callee,   ///< Takes the callee's FlushModeExit
+        Unknown,  ///< Imports, indirect calls, setjmp/longjmp
+    };
+
+    struct Step
+    {
+        CSRState mode = CSRState::Unknown;  ///< RequiredFlushMode() of the instruction
+        bool unknownBefore = false;         ///< Mid-asm hook before it, or one jumps to it
+        bool unknownAfter = false;          ///< Mid-asm hook after it
+        bool fallsThrough = true;
+        bool exits = false;
+        bool hookExits = false;             ///< A mid-asm hook may return from here
+        Call call = Call::None;
+        uint32_t callee = 0;
+        uint32_t successorsBegin = 0;
+        uint32_t successorsEnd = 0;
+    };
+
+    uint32_t base = 0;
+    bool unknownExit = false;  ///< SEH catch blocks, or the function is overridden at link time
+    std::vector<Step> steps;
+    std::vector<uint32_t> successors;
+};
+
+/**
+ * Describe one function for the flush-mode passes.
+ *
+ * @param insns Instructions in emission order
+ * @param flows Control flow of insns, from ComputeInsnFlow()
+ */
+FlushModeFlow BuildFlushModeFlow(const FunctionNode& fn,
+                                 const RecompilerConfig& config,
+                                 std::span<const EmittedInsn> insns,
+                                 std::span<const InsnFlow> flows);
+
+/**
+ * Solve the exit mode of every function over the call graph.
+ *
+ * Starts from NoReturn everywhere and re-solves the callers of any function
+ * whose exit changes, so recursion settles on the most precise fixed point.
+ * Every PPC_WEAK_FUNC can be replaced at link time, so the exits only hold
+ * for functions that aren't: list the rest in config.overriddenFunctions.
+ */
+FlushModeExits SolveFlushModeExits(std::span<const FlushModeFlow> functions);
+
+/**
+ * Compute the mode known on entry to each instruction's builder.
+ *
+ * Functions are entered in an unknown mode: vtables, host callbacks and
+ * indirect calls can reach any of them. Labels take the mode all their
+ * predecessors agree on, and calls take the callee's exit from exits.
+ *
+ * @param exits Solved exits, or nullptr to treat every call as unknown
+ * @return Mode per instruction, parallel to flow.steps
+ */
+std::vector<CSRState> ComputeFlushModes(const FlushModeFlow& flow, const FlushModeExits* exits);
+
+} // namespace rex::codegen
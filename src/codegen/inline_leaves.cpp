@@ -0,0 +1,101 @@
+/**
+ * @file        rexcodegen/inline_leaves.cpp
+ * @brief       Leaf functions emitted in place of their calls
+ *
+ * @copyright   Copyright (c) 2026 Tom Clay <tomc@tctechstuff.com>
+ *              All rights reserved.
+ *
+ * @license     BSD 3-Clause License
+ *              See LICENSE file in the project root for full license text.
+ */
+
+#include "inline_leaves.h"
+#include "insn_flow.h"
+#include "ppc/disasm.h"
+#include <rex/codegen/codegen_context.h>
+#include <rex/codegen/config.h>
+#include <rex/codegen/function_graph.h>
+#include <rex/logging.h>
+#include <rex/memory/utils.h>
+#include <ppc.h>
+#include <unordered_set>
+
+using rex::memory::load_and_swap;
+using rex::codegen::ppc::Disassemble;
+
+namespace rex::codegen {
+
+namespace {
+
+constexpr uint32_t kBlr = 0x4E800020;
+
+bool IsInlineLeaf(const CodegenContext& ctx, const FunctionNode& fn)
+{
+    const auto& config = ctx.Config();
+    if (fn.isImport() || fn.blocks().size() != 1 || !fn.jumpTables().empty() || fn.hasExceptionInfo())
+        return false;
+
+    const auto& block = fn.blocks().front();
+    size_t count = block.size / 4;
+    if (block.base != fn.base() || count < 2 || count - 1 > config.inlineMaxInstructions)
+        return false;
+
+    const auto* data = reinterpret_cast<const uint32_t*>(ctx.binary().translate(block.base));
+    if (!data || load_and_swap<uint32_t>(data + count - 1) != kBlr)
+        return false;
+
+    ppc_insn insn;
+    for (size_t i = 0; i < count - 1; i++)
+    {
+        uint32_t addr = block.base + static_cast<uint32_t>(i * 4);
+        if (IsBranch(load_and_swap<uint32_t>(data + i)) || config.midAsmHooks.contains(addr) ||
+            config.switchTables.contains(addr))
+            return false;
+
+        Disassemble(data + i, 4, addr, insn);
+        if (insn.opcode == nullptr)
+            return false;
+    }
+    return true;
+}
+
+} // namespace
+
+InlineLeaves FindInlineLeaves(const CodegenContext& ctx, std::span<const FunctionNode* const> functions)
+{
+    const auto& config = ctx.Config();
+    if (config.inlineMaxInstructions == 0)
+        return {};
+
+    // SEH handlers are entered by the unwinder with their own frame setup
+    std::unordered_set<uint32_t> handlers;
+    for (const FunctionNode* fn : functions)
+    {
+        if (!fn->hasExceptionInfo())
+            continue;
+        if (const auto* seh = fn->exceptionInfo()->asSeh())
+        {
+            for (const auto& scope : seh->scopes)
+            {
+                handlers.insert(scope.handler);
+                handlers.insert(scope.filter);
+            }
+        }
+    }
+
+    InlineLeaves result;
+    for (const FunctionNode* fn : functions)
+    {
+        if (fn->base() == config.longJmpAddress || fn->base() == config.setJmpAddress ||
+            handlers.contains(fn->base()) || config.overriddenFunctions.contains(fn->base()))
+            continue;
+        if (IsInlineLeaf(ctx, *fn))
+            result.insert(fn->base());
+    }
+
+    REXCODEGEN_DEBUG("Inline: {} leaf functions of at most {} instructions",
+                     result.size(), config.inlineMaxInstructions);
+    return result;
+}
+
+} // namespace rex::codegen
@@ -0,0 +1,36 @@
+/**
+ * @file        rex/codegen/inline_leaves.h
+ * @brief       Leaf functions emitted in place of their calls
+ *
+ * @copyright   Copyright (c) 2026 Tom Clay <tomc@tctechstuff.com>
+ *              All rights reserved.
+ *
+ * @license     BSD 3-Clause License
+ *              See LICENSE file in the project root for full license text.
+ */
+
+#pragma once
+
+#include <rex/codegen/recompiler.h>
+#include <span>
+
+namespace rex::codegen {
+
+class CodegenContext;
+class FunctionNode;
+
+/**
+ * Find the functions small enough to emit in place of a bl or tail call.
+ *
+ * A function qualifies when it is a single straight-line block of at most
+ * inlineMaxInstructions instructions followed by blr: no other branch, no
+ * sc, no mid-asm hook, switch table or exception info, and it is neither an
+ * SEH handler nor listed in overriddenFunctions. Such a body has no way out
+ * but the end, so run on the caller's registers it does exactly what the
+ * call would.
+ *
+ * @param functions Functions being emitted; only these can be inlined
+ */
+InlineLeaves FindInlineLeaves(const CodegenContext& ctx, std::span<const FunctionNode* const> functions);
+
+} // namespace rex::codegen
@@ -0,0 +1,134 @@
+/**
+ * @file        rexcodegen/insn_flow.cpp
+ * @brief       Control flow between the emitted instructions of a function
+ *
+ * @copyright   Copyright (c) 2026 Tom Clay <tomc@tctechstuff.com>
+ *              All rights reserved.
+ *
+ * @license     BSD 3-Clause License
+ *              See LICENSE file in the project root for full license text.
+ */
+
+#include "insn_flow.h"
+#include <rex/codegen/function_graph.h>
+#include <ppc.h>
+#include <unordered_map>
+
+namespace rex::codegen {
+
+bool IsBranch(uint32_t instruction)
+{
+    uint32_t op = PPC_OP(instruction);
+    if (op == PPC_OP_BC || op == PPC_OP_SC || op == PPC_OP_B)
+        return true;
+    return op == PPC_OP_CTR && (PPC_XOP(instruction) == 16 || PPC_XOP(instruction) == 528);
+}
+
+std::vector<InsnFlow> ComputeInsnFlow(const FunctionGraph& graph,
+                                      const FunctionNode& fn,
+                                      std::span<const EmittedInsn> insns)
+{
+    const size_t count = insns.size();
+
+    std::unordered_map<uint32_t, size_t> indexOf;
+    indexOf.reserve(count);
+    for (size_t i = 0; i < count; i++)
+        indexOf.emplace(insns[i].base, i);
+
+    std::vector<InsnFlow> flows(count);
+
+    // Goto within the function, or leave it (b tail calls, bc returns)
+    auto addBranch = [&](InsnFlow& flow, uint32_t base, uint32_t target, bool tailCall) {
+        auto kind = graph.classifyTarget(target, base, false);
+        bool inRange = target >= fn.base() && target < fn.end();
+        auto it = indexOf.find(target);
+        if ((kind == TargetKind::InternalLabel || inRange) && it != indexOf.end())
+            flow.successors.push_back(it->second);
+        if (kind != TargetKind::InternalLabel || it == indexOf.end())
+        {
+            flow.exits = true;
+            if (tailCall && !inRange)
+            {
+                flow.calls = true;
+                flow.target = target;
+            }
+        }
+    };
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const EmittedInsn& site = insns[i];
+        InsnFlow& flow = flows[i];
+        if (site.insn.opcode == nullptr)
+            continue;
+
+        const uint32_t instruction = site.insn.instruction;
+        const uint32_t op = PPC_OP(instruction);
+        const uint32_t bo = PPC_BO(instruction);
+        const bool link = PPC_BL(instruction);
+        const bool conditional = (bo & 0x14) != 0x14;
+
+        if (op == PPC_OP_B)
+        {
+            uint32_t target = site.insn.operands[0];
+            if (link)
+            {
+                // bl to an internal label is the PIC idiom and emits a goto
+                if (graph.classifyTarget(target, site.base, true) == TargetKind::InternalLabel) {
+                    flow.fallsThrough = false;
+                    addBranch(flow, site.base, target, false);
+                } else {
+                    flow.calls = true;
+                    flow.target = target;
+                }
+            }
+            else
+            {
+                flow.fallsThrough = false;
+                addBranch(flow, site.base, target, true);
+            }
+        }
+        else if (op == PPC_OP_BC || (op == PPC_OP_CTR && (PPC_XOP(instruction) == 16 || PPC_XOP(instruction) == 528)))
+        {
+            if (link)
+            {
+                flow.calls = true;
+                if (op == PPC_OP_BC)
+                    flow.target = site.base + PPC_BD(instruction);
+            }
+            else if (op == PPC_OP_BC)
+            {
+                flow.fallsThrough = conditional;
+                addBranch(flow, site.base, site.base + PPC_BD(instruction), false);
+            }
+            else if (PPC_XOP(instruction) == 16)
+            {
+                flow.fallsThrough = conditional;
+                flow.exits = true;
+            }
+            else if (site.jumpTable && !conditional)
+            {
+                flow.fallsThrough = false;
+                for (uint32_t target : site.jumpTable->targets)
+                {
+                    auto it = indexOf.find(target);
+                    if (it != indexOf.end())
+                        flow.successors.push_back(it->second);
+                    else
+                        flow.exits = true;
+                }
+            }
+            else
+            {
+                // Indirect tail call
+                flow.fallsThrough = conditional;
+                flow.exits = true;
+                flow.calls = true;
+            }
+        }
+    }
+
+    return flows;
+}
+
+} // namespace rex::codegen
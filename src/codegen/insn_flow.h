@@ -0,0 +1,69 @@
+/**
+ * @file        rex/codegen/insn_flow.h
+ * @brief       Control flow between the emitted instructions of a function
+ *
+ * @copyright   Copyright (c) 2026 Tom Clay <tomc@tctechstuff.com>
+ *              All rights reserved.
+ *
+ * @license     BSD 3-Clause License
+ *              See LICENSE file in the project root for full license text.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include <dis-asm.h>
+
+namespace rex::codegen {
+
+class FunctionGraph;
+class FunctionNode;
+struct JumpTable;
+
+/// An instruction of the function being emitted, in emission order.
+struct EmittedInsn
+{
+    uint32_t base;
+    const uint32_t* data;
+    ppc_insn insn;
+
+    /// Switch table a bctr dispatches through, or nullptr
+    const JumpTable* jumpTable = nullptr;
+};
+
+/// Where control goes after an emitted instruction, as the generated C++ does it.
+struct InsnFlow
+{
+    bool fallsThrough = true;   ///< Continues with the next emitted instruction
+    bool exits = false;         ///< Returns or tail calls out of the function
+    bool calls = false;         ///< Calls out; before returning when exits is also set
+    uint32_t target = 0;        ///< Direct call or tail call target, 0 if indirect
+    std::vector<size_t> successors;  ///< Emitted instructions branched to
+};
+
+/**
+ * Whether an instruction may leave straight-line code: b, bc, sc, bclr or
+ * bcctr, with or without link.
+ *
+ * @param instruction Instruction word in host byte order
+ */
+bool IsBranch(uint32_t instruction);
+
+/**
+ * Decode the branches of a function's emitted instructions.
+ *
+ * Targets are classified like the control flow builders do: an internal
+ * label is a goto, anything else leaves the function. Conditional forms also
+ * fall through.
+ *
+ * @param insns Instructions in emission order
+ * @return Flow per instruction, parallel to insns
+ */
+std::vector<InsnFlow> ComputeInsnFlow(const FunctionGraph& graph,
+                                      const FunctionNode& fn,
+                                      std::span<const EmittedInsn> insns);
+
+} // namespace rex::codegen
@@ -0,0 +1,75 @@
+/**
+ * @file        rex/codegen/parallel.h
+ * @brief       Minimal worker-pool helpers for codegen and analysis
+ *
+ * @copyright   Copyright (c) 2026 Tom Clay <tomc@tctechstuff.com>
+ *              All rights reserved.
+ *
+ * @license     BSD 3-Clause License
+ *              See LICENSE file in the project root for full license text.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace rex::codegen {
+
+/**
+ * Pick a worker count for a batch of work.
+ * @param requested User setting (0 = hardware concurrency, 1 = serial)
+ * @param workItems Number of independent items in the batch
+ * @param minItemsPerThread Items below which another thread isn't worth starting
+ */
+inline size_t ResolveThreadCount(uint32_t requested, size_t workItems, size_t minItemsPerThread)
+{
+    size_t threadCount = requested;
+    if (threadCount == 0)
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    return std::min(threadCount, std::max<size_t>(1, workItems / minItemsPerThread));
+}
+
+/**
+ * Run `worker` on `threadCount` threads and join them. With a single thread
+ * the worker runs inline on the caller, so serial mode spawns nothing.
+ */
+template<typename Fn>
+void RunWorkers(size_t threadCount, Fn&& worker)
+{
+    if (threadCount <= 1)
+    {
+        worker();
+        return;
+    }
+
+    std::vector<std::jthread> pool;
+    pool.reserve(threadCount);
+    for (size_t t = 0; t < threadCount; t++)
+        pool.emplace_back(worker);
+}
+
+/**
+ * Call fn(i) for every i in [0, count). Workers claim the next unclaimed index
+ * from a shared cursor, so uneven items don't leave threads idle behind a
+ * static split. fn must only touch state owned by index i.
+ */
+template<typename Fn>
+void ParallelFor(size_t count, size_t threadCount, Fn&& fn)
+{
+    std::atomic<size_t> nextIndex{0};
+    RunWorkers(threadCount, [&]()
+    {
+        for (size_t i = nextIndex.fetch_add(1, std::memory_order_relaxed); i < count;
+             i = nextIndex.fetch_add(1, std::memory_order_relaxed))
+        {
+            fn(i);
+        }
+    });
+}
+
+} // namespace rex::codegen
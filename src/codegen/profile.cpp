@@ -0,0 +1,110 @@
+/**
+ * @file        codegen/profile.cpp
+ *
+ * @copyright   Copyright (c) 2026 Tom Clay <tomc@tctechstuff.com>
+ *              All rights reserved.
+ *
+ * @license     BSD 3-Clause License
+ *              See LICENSE file in the project root for full license text.
+ */
+
+#include <rex/codegen/profile.h>
+#include <rex/platform.h>
+#include <rex/logging.h>
+#include <fmt/format.h>
+#include <iterator>
+
+#if REX_PLATFORM_WIN32
+#include <rex/platform/win.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace rex::codegen {
+
+CodegenProfile::Phase::Phase(CodegenProfile& profile, std::string_view name)
+    : profile_(&profile), start_(std::chrono::steady_clock::now())
+{
+    record_.name = std::string(name);
+}
+
+void CodegenProfile::Phase::stop()
+{
+    if (stopped_) {
+        return;
+    }
+    stopped_ = true;
+
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start_;
+    record_.wallMs = elapsed.count();
+    record_.peakRssBytes = peakRssBytes();
+    REXCODEGEN_DEBUG("Profile: {} took {:.1f}ms", record_.name, record_.wallMs);
+    profile_->phases_.push_back(std::move(record_));
+}
+
+double CodegenProfile::totalMs() const
+{
+    double total = 0.0;
+    for (const auto& phase : phases_) {
+        total += phase.wallMs;
+    }
+    return total;
+}
+
+std::string CodegenProfile::toJson() const
+{
+    std::string json = "{\n  \"phases\": [";
+    auto out = std::back_inserter(json);
+
+    for (size_t i = 0; i < phases_.size(); i++) {
+        const auto& p = phases_[i];
+        double seconds = p.wallMs / 1000.0;
+        auto rate = [seconds](uint64_t count) {
+            return seconds > 0.0 ? static_cast<double>(count) / seconds : 0.0;
+        };
+
+        fmt::format_to(out, "{}\n    {{\"name\": \"{}\", \"wall_ms\": {:.3f}, \"peak_rss_bytes\": {}",
+                       i == 0 ? "" : ",", p.name, p.wallMs, p.peakRssBytes);
+        if (p.instructions != 0) {
+            fmt::format_to(out, ", \"instructions\": {}, \"instructions_per_sec\": {:.0f}",
+                           p.instructions, rate(p.instructions));
+        }
+        if (p.functions != 0) {
+            fmt::format_to(out, ", \"functions\": {}, \"functions_per_sec\": {:.0f}",
+                           p.functions, rate(p.functions));
+        }
+        if (p.bytesWritten != 0) {
+            fmt::format_to(out, ", \"bytes_written\": {}, \"bytes_per_sec\": {:.0f}",
+                           p.bytesWritten, rate(p.bytesWritten));
+        }
+        json += '}';
+    }
+
+    fmt::format_to(out, "\n  ],\n  \"total_ms\": {:.3f},\n  \"peak_rss_bytes\": {}\n}}\n",
+                   totalMs(), peakRssBytes());
+    return json;
+}
+
+uint64_t CodegenProfile::peakRssBytes()
+{
+#if REX_PLATFORM_WIN32
+    PROCESS_MEMORY_COUNTERS counters{};
+    if (K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.PeakWorkingSetSize;
+    }
+    return 0;
+#else
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#if REX_PLATFORM_MAC
+    return static_cast<uint64_t>(usage.ru_maxrss);         // bytes on macOS
+#else
+    return static_cast<uint64_t>(usage.ru_maxrss) * 1024;  // kilobytes on Linux
+#endif
+#endif
+}
+
+} // namespace rex::codegen
@@ -38,31 +38,37 @@ Result<void> Recompile(CodegenContext& ctx, bool force) {
     REXLOG_INFO("Output path: {}", output_path.string());
     std::filesystem::create_directories(output_path);
 
-    // Clean up old generated files
+    REXLOG_INFO("Starting code generation...");
+
+    Recompiler recompiler;
+    recompiler.ctx_ = &ctx;
+
+    if (!recompiler.recompile(force)) {
+        return Err(ErrorCategory::Validation,
+                   "Code generation failed.");
+    }
+
+    // Remove generated files this run no longer produces. Files that were
+    // regenerated with identical content are left alone so their mtime (and
+    // the downstream build) stays untouched.
     std::string prefix = config.projectName + "_";
     for (const auto& entry : std::filesystem::directory_iterator(output_path)) {
         auto ext = entry.path().extension();
         if (ext == ".cpp" || ext == ".h" || ext == ".cmake") {
             std::string filename = entry.path().filename().string();
+            if (recompiler.generatedFiles.contains(filename)) {
+                continue;
+            }
             if (filename == "sources.cmake" ||
                 filename.starts_with(prefix) ||
                 filename.starts_with("ppc_recomp") || filename.starts_with("ppc_func_mapping") ||
                 filename.starts_with("function_table_init") || filename.starts_with("ppc_config")) {
+                REXLOG_DEBUG("Removing stale generated file: {}", filename);
                 std::filesystem::remove(entry.path());
             }
         }
     }
 
-    REXLOG_INFO("Old files cleaned up, starting code generation...");
-
-    Recompiler recompiler;
-    recompiler.ctx_ = &ctx;
-
-    if (!recompiler.recompile(force)) {
-        return Err(ErrorCategory::Validation,
-                   "Code generation failed.");
-    }
-
     REXLOG_INFO("Code generation complete");
     return Ok();
 }
@@ -10,9 +10,11 @@
 
 //TODO(tomc): This file should probably be refactored away. Its quite old and very fragmented from newer components.
 #include <rex/time/chrono.h>
+#include <cassert>
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <filesystem>
 #include <list>
 #include <memory>
@@ -26,6 +28,12 @@
 #include <rex/codegen/recompiled_function.h>
 #include "builders.h"
 #include "builder_context.h"
+#include "devirtualize.h"
+#include "emit_cache.h"
+#include "flag_liveness.h"
+#include "flush_mode.h"
+#include "inline_leaves.h"
+#include "parallel.h"
 #include "ppc/disasm.h"
 #include <rex/runtime.h>
 #include <rex/runtime/xex_module.h>
@@ -57,9 +65,37 @@ struct IMAGE_CE_RUNTIME_FUNCTION {
 };
 #pragma pack(pop)
 static_assert(sizeof(IMAGE_CE_RUNTIME_FUNCTION) == 8);
+
+// Look for mtctr within 3 instructions before bctr
+// mtctr rX = 0x7CXX03A6 (where XX = RS << 5)
+// nop = 0x60000000
+// Pattern can have 0, 1, or 2 nops between mtctr and bctr
+bool IsMtctrBctrSequence(const uint32_t* bctr)
+{
+    constexpr uint32_t MTCTR_MASK = 0xFC1FFFFF;
+    constexpr uint32_t MTCTR_OPCODE = 0x7C0003A6;
+    constexpr uint32_t NOP = 0x60000000;
+
+    for (int i = 1; i <= 3; i++) {
+        uint32_t prev_insn = rex::memory::load_and_swap<uint32_t>(bctr - i);
+        if ((prev_insn & MTCTR_MASK) == MTCTR_OPCODE) {
+            // Found mtctr - verify all instructions between are nops
+            for (int j = 1; j < i; j++) {
+                if (rex::memory::load_and_swap<uint32_t>(bctr - j) != NOP) {
+                    return false;
+                }
+            }
+            return true;
+        } else if (prev_insn != NOP) {
+            return false;  // Non-nop, non-mtctr - stop searching
+        }
+    }
+    return false;
+}
 }
 
 #include <algorithm>
+#include <atomic>
 #include <set>
 #include <sstream>
 #include <unordered_set>
@@ -77,6 +113,7 @@ namespace rex::codegen {
 constexpr size_t kOutputBufferReserveSize = 32 * 1024 * 1024;  // 32 MB
 constexpr size_t kFunctionsPerOutputFile = 500;
 constexpr size_t kProgressLogFrequency = 100;
+constexpr size_t kMinFunctionsPerWorker = 64;  // Below this, thread startup costs more than it saves
 
 Recompiler::Recompiler() = default;
 Recompiler::~Recompiler() = default;
@@ -88,7 +125,8 @@ bool Recompiler::recompile(
     const uint32_t* data,
     std::unordered_map<uint32_t, JumpTable>::iterator& switchTable,
     RecompilerLocalVariables& localVariables,
-    CSRState& csrState)
+    CSRState& csrState,
+    uint64_t liveFlags)
 {
     println("\t// {} {}", insn.opcode->name, insn.op_str);
 
@@ -367,15 +405,21 @@ bool Recompiler::recompile(
         data,
         localVariables,
         csrState,
-        switchTable
+        switchTable,
+        liveFlags
     };
 
+    if (CSRState mode = RequiredFlushMode(id); mode != CSRState::Unknown)
+        ctx.emit_set_flush_mode(mode == CSRState::VMX);
+
     if (!DispatchInstruction(id, ctx))
         return false;
 
 
-    // Validate that RC bit instructions generate condition register updates
-    if (strchr(insn.opcode->name, '.'))
+    // Validate that RC bit instructions generate condition register updates,
+    // unless liveness found nothing reads the field
+    size_t recordField = std::strncmp(insn.opcode->name, "vcmp", 4) == 0 ? 6 : 0;
+    if (strchr(insn.opcode->name, '.') && (liveFlags & flags::crField(recordField)))
     {
         int lastLine = out.find_last_of('\n', out.size() - 2);
         if (out.find("cr0", lastLine + 1) == std::string::npos && out.find("cr6", lastLine + 1) == std::string::npos)
@@ -539,8 +583,20 @@ bool Recompiler::recompile(const FunctionNode& fn)
     // Use weak/alias pattern - allows functions to be overridden at link time
     // The weak symbol 'name' aliases to '__imp__name', so overriding 'name' takes precedence
     println("__attribute__((alias(\"__imp__{}\"))) PPC_WEAK_FUNC({});", name, name);
-    println("PPC_FUNC_IMPL(__imp__{}) {{", name);
+    const char* impl = "PPC_FUNC_IMPL";
+    if (executionProfile)
+    {
+        switch (executionProfile->heat(fn.base()))
+        {
+        case FunctionHeat::Hot: impl = "PPC_FUNC_IMPL_HOT"; break;
+        case FunctionHeat::Cold: impl = "PPC_FUNC_IMPL_COLD"; break;
+        case FunctionHeat::Normal: break;
+        }
+    }
+    println("{}(__imp__{}) {{", impl, name);
     println("\tPPC_FUNC_PROLOGUE();");
+    if (config().profileInstrument)
+        println("\tPPC_PROFILE_ENTRY(0x{:X});", fn.base());
 
     auto switchTable = config().switchTables.end();
     bool allRecompiled = true;
@@ -552,105 +608,71 @@ bool Recompiler::recompile(const FunctionNode& fn)
     tempString.reserve(4096);  // Pre-allocate for typical function body
     std::swap(out, tempString);  // Save current output, body will be written to out
 
-    ppc_insn insn;
     std::unordered_set<size_t> emittedLabels;  // Track emitted labels to avoid duplicates
 
-    // Second pass: recompile all blocks
-    for (const auto& block : fn.blocks())
+    // Decode every instruction once, in emission order, ahead of the passes
+    // that need the whole function
+    std::vector<EmittedInsn> insns = decodeFunction(fn, true);
+    std::vector<InsnFlow> flows = ComputeInsnFlow(graph(), fn, insns);
+
+    std::vector<uint64_t> liveFlags;
+    if (config().flagLiveness)
     {
-        auto base = block.base;
-        auto end = block.end();
-        auto* data = reinterpret_cast<const uint32_t*>(binary().translate(block.base));
-        if (!data) {
-            REXCODEGEN_WARN("Block 0x{:08X} in function 0x{:08X} has no mapped data - skipping",
-                           block.base, fn.base());
-            continue;
-        }
+        // Local CR fields and XER die with the function. Otherwise the ABI has
+        // callees ignore the caller's flags and preserve only cr2-cr4.
+        uint64_t outside = flags::kAll;
+        if (config().crRegistersAsLocalVariables)
+            outside &= ~flags::kCrAll;
+        if (config().xerAsLocalVariable)
+            outside &= ~flags::kCa;
 
-        while (base < end)
+        FlagBoundary boundary{ outside, outside };
+        if (config().flagLivenessAssumeAbi)
         {
-            // Only emit each label once
-            if (labels.find(base) != labels.end() && emittedLabels.insert(base).second)
-            {
-                println("loc_{:X}:", base);
+            boundary.call = 0;
+            boundary.exit &= flags::kCrNonVolatile;
+        }
+        liveFlags = ComputeFlagLiveness(config(), insns, flows, boundary);
+    }
 
-                // Anyone could jump to this label so we wouldn't know what the CSR state would be.
-                csrState = CSRState::Unknown;
-            }
+    std::vector<CSRState> flushModes;
+    if (config().flushModeAnalysis)
+        flushModes = ComputeFlushModes(BuildFlushModeFlow(fn, config(), insns, flows), flushModeExits.get());
 
-            if (switchTable == config().switchTables.end())
-                switchTable = config().switchTables.find(base);
+    // Second pass: recompile all blocks
+    for (size_t i = 0; i < insns.size(); i++)
+    {
+        const EmittedInsn& site = insns[i];
+        const uint32_t base = site.base;
 
-            Disassemble(data, 4, base, insn);
+        // Only emit each label once
+        if (labels.find(base) != labels.end() && emittedLabels.insert(base).second)
+        {
+            println("loc_{:X}:", base);
 
-            if (insn.opcode == nullptr)
-            {
-                println("\t// {}", insn.op_str);
-                // Warn about undecoded non-zero instructions (likely unimplemented opcodes)
-                if (*data != 0)
-                    REXCODEGEN_WARN( "Unable to decode instruction {:X} at {:X}", *data, base);
-            }
-            else
-            {
-                // Check for potential jump table that wasn't detected during analysis
-                if (insn.opcode->id == PPC_INST_BCTR &&
-                    switchTable == config().switchTables.end() &&
-                    ctx_ != nullptr) {
-
-                    // Look for mtctr within 3 instructions before bctr
-                    // mtctr rX = 0x7CXX03A6 (where XX = RS << 5)
-                    // nop = 0x60000000
-                    // Pattern can have 0, 1, or 2 nops between mtctr and bctr
-                    bool is_switch_pattern = false;
-                    constexpr uint32_t MTCTR_MASK = 0xFC1FFFFF;
-                    constexpr uint32_t MTCTR_OPCODE = 0x7C0003A6;
-                    constexpr uint32_t NOP = 0x60000000;
-
-                    for (int i = 1; i <= 3 && !is_switch_pattern; i++) {
-                        uint32_t prev_insn = load_and_swap<uint32_t>(data - i);
-                        if ((prev_insn & MTCTR_MASK) == MTCTR_OPCODE) {
-                            // Found mtctr - verify all instructions between are nops
-                            is_switch_pattern = true;
-                            for (int j = 1; j < i; j++) {
-                                if (load_and_swap<uint32_t>(data - j) != NOP) {
-                                    is_switch_pattern = false;
-                                    break;
-                                }
-                            }
-                        } else if (prev_insn != NOP) {
-                            break;  // Non-nop, non-mtctr - stop searching
-                        }
-                    }
+            // Anyone could jump to this label so we wouldn't know what the CSR state would be.
+            csrState = CSRState::Unknown;
+        }
 
-                    if (is_switch_pattern) {
-                        // Try to detect jump table
-                        FunctionScanner scanner(binary());
-                        auto jt_opt = scanner.detect_jump_table(base);
-                        if (jt_opt.has_value()) {
-                            // Add to config and use it
-                            config().switchTables.emplace(base, std::move(*jt_opt));
-                            switchTable = config().switchTables.find(base);
-                            // Also add labels for code generation
-                            for (auto label : switchTable->second.targets) {
-                                labels.emplace(label);
-                            }
-                            REXCODEGEN_INFO("Late-detected jump table at 0x{:08X} with {} entries",
-                                            base, switchTable->second.targets.size());
-                        } else {
-                           
-                        }
-                    }
-                }
+        // Unless every way here agrees on it, including the calls before
+        if (!flushModes.empty())
+            csrState = flushModes[i];
 
-                if (!recompile(fn, base, insn, data, switchTable, localVariables, csrState))
-                {
-                    REXCODEGEN_WARN( "Unrecognized instruction at 0x{:X}: {}", base, insn.opcode->name);
-                    allRecompiled = false;
-                }
-            }
+        if (switchTable == config().switchTables.end())
+            switchTable = config().switchTables.find(base);
 
-            base += 4;
-            ++data;
+        if (site.insn.opcode == nullptr)
+        {
+            println("\t// {}", site.insn.op_str);
+            // Warn about undecoded non-zero instructions (likely unimplemented opcodes)
+            if (*site.data != 0)
+                REXCODEGEN_WARN( "Unable to decode instruction {:X} at {:X}", *site.data, base);
+        }
+        else if (!recompile(fn, base, site.insn, site.data, switchTable, localVariables, csrState,
+                            liveFlags.empty() ? flags::kAll : liveFlags[i]))
+        {
+            REXCODEGEN_WARN( "Unrecognized instruction at 0x{:X}: {}", base, site.insn.opcode->name);
+            allRecompiled = false;
         }
     }
 
@@ -764,6 +786,36 @@ bool Recompiler::recompile(const FunctionNode& fn)
     return allRecompiled;
 }
 
+bool Recompiler::recompileInline(const FunctionNode& callee,
+                                 RecompilerLocalVariables& localVariables,
+                                 CSRState& csrState,
+                                 uint64_t liveAfter)
+{
+    // Everything but the blr; control just carries on in the caller
+    std::vector<EmittedInsn> insns = decodeFunction(callee);
+    insns.pop_back();
+
+    // The body has to produce whatever the caller reads after the call
+    std::vector<uint64_t> liveFlags;
+    if (config().flagLiveness)
+        liveFlags = ComputeFlagLiveness(config(), insns, ComputeInsnFlow(graph(), callee, insns), { 0, liveAfter });
+
+    auto switchTable = config().switchTables.end();
+    bool allRecompiled = true;
+    for (size_t i = 0; i < insns.size(); i++)
+    {
+        const EmittedInsn& site = insns[i];
+        if (!recompile(callee, site.base, site.insn, site.data, switchTable, localVariables, csrState,
+                       liveFlags.empty() ? flags::kAll : liveFlags[i]))
+        {
+            REXCODEGEN_WARN("Unrecognized instruction at 0x{:X} inlined from {}: {}",
+                            site.base, callee.name(), site.insn.opcode->name);
+            allRecompiled = false;
+        }
+    }
+    return allRecompiled;
+}
+
 bool Recompiler::recompile(bool force)
 {
     // Block code generation if validation failed (unless --force)
@@ -773,6 +825,7 @@ bool Recompiler::recompile(bool force)
     }
 
     REXCODEGEN_TRACE( "Recompile: starting");
+    auto phase = ctx_->profile.begin("Recompile");
     out.reserve(kOutputBufferReserveSize);
 
     // Build sorted function list from graph for code generation
@@ -940,6 +993,24 @@ bool Recompiler::recompile(bool force)
 
     // TODO: Add fancy single-line progress indicator
     REXCODEGEN_INFO("Recompiling {} functions...", functions.size());
+    analyzeFunctions(functions);
+
+    std::optional<EmitCache> cache;
+    if (config().codegenCache)
+    {
+        cache.emplace(*ctx_, ctx_->configDir() / config().outDirectoryPath /
+                             fmt::format(".{}_emit.cache", projectName));
+        cache->Load();
+        cache->Prepare(functions, flushModeExits.get(), indirectCallTargets.get(), inlineLeaves.get(),
+                       executionProfile.get());
+    }
+
+    auto bodies = emitFunctions(functions, cache ? &*cache : nullptr);
+    phase.setFunctions(functions.size());
+    if (cache)
+        cache->Save(bodies);
+
+    // Stitch bodies back in order so file contents match a serial run
     for (size_t i = 0; i < functions.size(); i++)
     {
         if ((i % kFunctionsPerOutputFile) == 0)
@@ -948,7 +1019,8 @@ bool Recompiler::recompile(bool force)
             println("#include \"{}_init.h\"\n", projectName);
         }
 
-        recompile(*functions[i]);
+        out += bodies[i];
+        std::string().swap(bodies[i]);
     }
 
     SaveCurrentOutData();
@@ -974,11 +1046,237 @@ bool Recompiler::recompile(bool force)
         SaveCurrentOutData("sources.cmake");
     }
 
+    uint64_t generatedBytes = 0;
+    for (const auto& [filename, content] : pendingWrites)
+        generatedBytes += content.size();
+    phase.setBytesWritten(generatedBytes);
+    phase.stop();
+
     // Write all buffered files to disk
     FlushPendingWrites();
     return true;
 }
 
+std::vector<EmittedInsn> Recompiler::decodeFunction(const FunctionNode& fn, bool warnUnmapped) const
+{
+    std::vector<EmittedInsn> insns;
+    const JumpTable* pendingTable = nullptr;
+    for (const auto& block : fn.blocks())
+    {
+        auto* data = reinterpret_cast<const uint32_t*>(binary().translate(block.base));
+        if (!data) {
+            if (warnUnmapped)
+                REXCODEGEN_WARN("Block 0x{:08X} in function 0x{:08X} has no mapped data - skipping",
+                               block.base, fn.base());
+            continue;
+        }
+
+        for (uint32_t base = block.base; base < block.end(); base += 4, ++data)
+        {
+            EmittedInsn& site = insns.emplace_back();
+            site.base = base;
+            site.data = data;
+            Disassemble(data, 4, base, site.insn);
+
+            if (pendingTable == nullptr) {
+                auto configTable = config().switchTables.find(base);
+                if (configTable != config().switchTables.end())
+                    pendingTable = &configTable->second;
+            }
+
+            if (site.insn.opcode == nullptr || site.insn.opcode->id != PPC_INST_BCTR)
+                continue;
+
+            // Emission workers share config(), so every table must already be
+            // there from detectLateSwitchTables
+            assert((pendingTable != nullptr || !IsMtctrBctrSequence(data) ||
+                    !FunctionScanner(binary()).detect_jump_table(base).has_value()) &&
+                   "Jump table missed by detectLateSwitchTables");
+
+            // Same lookup order as build_bctr: config first, then auto-detected
+            site.jumpTable = pendingTable;
+            if (site.jumpTable == nullptr) {
+                for (const auto& autoJt : fn.jumpTables()) {
+                    if (autoJt.bctrAddress == base) {
+                        site.jumpTable = &autoJt;
+                        break;
+                    }
+                }
+            }
+            pendingTable = nullptr;
+        }
+    }
+    return insns;
+}
+
+void Recompiler::detectLateSwitchTables(const std::vector<const FunctionNode*>& functions)
+{
+    FunctionScanner scanner(binary());
+
+    for (const auto* fn : functions)
+    {
+        for (const auto& block : fn->blocks())
+        {
+            auto* data = reinterpret_cast<const uint32_t*>(binary().translate(block.base));
+            if (!data) continue;
+
+            ppc_insn insn;
+            for (uint32_t addr = block.base; addr < block.end(); addr += 4, ++data)
+            {
+                Disassemble(data, 4, addr, insn);
+                if (insn.opcode == nullptr || insn.opcode->id != PPC_INST_BCTR)
+                    continue;
+                if (config().switchTables.contains(addr) || !IsMtctrBctrSequence(data))
+                    continue;
+
+                auto jt_opt = scanner.detect_jump_table(addr);
+                if (jt_opt.has_value()) {
+                    REXCODEGEN_INFO("Late-detected jump table at 0x{:08X} with {} entries",
+                                    addr, jt_opt->targets.size());
+                    config().switchTables.emplace(addr, std::move(*jt_opt));
+                }
+            }
+        }
+    }
+}
+
+void Recompiler::analyzeFunctions(std::vector<const FunctionNode*>& functions)
+{
+    detectLateSwitchTables(functions);
+    profileCallTargets.clear();
+    if (!config().profileUsePath.empty())
+        applyExecutionProfile(functions);
+    if (config().flushModeAnalysis)
+        analyzeFlushModes(functions);
+    if (config().devirtualizeMaxTargets != 0)
+        indirectCallTargets = std::make_shared<const IndirectCallTargets>(ResolveIndirectCallTargets(*ctx_, functions, profileCallTargets));
+    // Inlined bodies would never reach their PPC_PROFILE_ENTRY
+    if (config().inlineMaxInstructions != 0 && !config().profileInstrument)
+        inlineLeaves = std::make_shared<const InlineLeaves>(FindInlineLeaves(*ctx_, functions));
+}
+
+void Recompiler::analyzeFlushModes(const std::vector<const FunctionNode*>& functions)
+{
+    std::vector<FlushModeFlow> flows(functions.size());
+    size_t threadCount = ResolveThreadCount(config().codegenThreads, functions.size(), kMinFunctionsPerWorker);
+    ParallelFor(functions.size(), threadCount, [&](size_t i)
+    {
+        auto insns = decodeFunction(*functions[i]);
+        flows[i] = BuildFlushModeFlow(*functions[i], config(), insns,
+                                      ComputeInsnFlow(graph(), *functions[i], insns));
+    });
+
+    auto exits = std::make_shared<FlushModeExits>(SolveFlushModeExits(flows));
+    size_t known = std::count_if(exits->begin(), exits->end(), [](const auto& entry) {
+        return entry.second != FlushModeExit::Unknown;
+    });
+    REXCODEGEN_DEBUG("Flush mode: {} of {} functions return in a known mode", known, exits->size());
+    flushModeExits = std::move(exits);
+}
+
+void Recompiler::applyExecutionProfile(std::vector<const FunctionNode*>& functions)
+{
+    auto profile = ExecutionProfile::Load(ctx_->configDir() / config().profileUsePath);
+    if (!profile)
+    {
+        REXCODEGEN_WARN("Ignoring execution profile: {}", profile.error().what());
+        return;
+    }
+
+    // Observed targets beat the vtable guess, but not [[indirect_call_targets]]
+    // (see ResolveIndirectCallTargets). Targets taking under 1/16 of a site's
+    // calls aren't worth a compare.
+    size_t sites = 0;
+    for (const auto& [site, record] : profile->indirectSites())
+    {
+        if (config().devirtualizeMaxTargets == 0 || config().indirectCallTargets.contains(site))
+            continue;
+
+        std::vector<uint32_t> targets;
+        for (const auto& [target, count] : record.targets)
+        {
+            if (targets.size() == config().devirtualizeMaxTargets || count * 16 < record.total)
+                break;
+            targets.push_back(target);
+        }
+        if (!targets.empty())
+        {
+            profileCallTargets.emplace(site, std::move(targets));
+            sites++;
+        }
+    }
+
+    // Hot functions first, busiest first, so they share output files and
+    // end up next to each other in the binary. The rest keep address order.
+    std::stable_sort(functions.begin(), functions.end(), [&](const FunctionNode* a, const FunctionNode* b) {
+        bool hotA = profile->heat(a->base()) == FunctionHeat::Hot;
+        bool hotB = profile->heat(b->base()) == FunctionHeat::Hot;
+        if (hotA != hotB)
+            return hotA;
+        return hotA && profile->entryCount(a->base()) > profile->entryCount(b->base());
+    });
+
+    size_t hot = std::count_if(functions.begin(), functions.end(), [&](const FunctionNode* fn) {
+        return profile->heat(fn->base()) == FunctionHeat::Hot;
+    });
+    REXCODEGEN_INFO("Profile: {} hot functions, {} indirect call sites with observed targets", hot, sites);
+    executionProfile = std::make_shared<const ExecutionProfile>(std::move(*profile));
+}
+
+std::vector<std::string> Recompiler::emitFunctions(const std::vector<const FunctionNode*>& functions,
+                                                   EmitCache* cache)
+{
+    std::vector<std::string> bodies(functions.size());
+
+    size_t threadCount = ResolveThreadCount(config().codegenThreads, functions.size(), kMinFunctionsPerWorker);
+
+    // Workers pull the next unclaimed function from a shared cursor, so a few
+    // huge functions don't leave the rest of the pool idle behind a static split.
+    std::atomic<size_t> nextIndex{0};
+    std::atomic<size_t> emitted{0};
+    std::atomic<size_t> reused{0};
+
+    REXCODEGEN_DEBUG("Emitting functions on {} threads", threadCount);
+    RunWorkers(threadCount, [&]()
+    {
+        Recompiler emitter;
+        emitter.runtime = runtime;
+        emitter.flushModeExits = flushModeExits;
+        emitter.indirectCallTargets = indirectCallTargets;
+        emitter.inlineLeaves = inlineLeaves;
+        emitter.executionProfile = executionProfile;
+        emitter.ctx_ = ctx_;
+
+        for (size_t i = nextIndex.fetch_add(1, std::memory_order_relaxed); i < functions.size();
+             i = nextIndex.fetch_add(1, std::memory_order_relaxed))
+        {
+            if (cache)
+            {
+                if (auto cached = cache->Take(i))
+                {
+                    bodies[i] = std::move(*cached);
+                    reused.fetch_add(1, std::memory_order_relaxed);
+                    continue;
+                }
+            }
+
+            emitter.out.reserve(4096);
+            emitter.recompile(*functions[i]);
+            bodies[i] = std::move(emitter.out);
+            emitter.out = std::string();
+
+            size_t done = emitted.fetch_add(1, std::memory_order_relaxed) + 1;
+            if ((done % (kProgressLogFrequency * 100)) == 0)
+                REXCODEGEN_DEBUG("Emitted {}/{} functions", done, functions.size());
+        }
+    });
+
+    if (cache)
+        REXCODEGEN_INFO("Emit cache: reused {} of {} functions", reused.load(), functions.size());
+
+    return bodies;
+}
+
 void Recompiler::SaveCurrentOutData(const std::string_view& name)
 {
     if (!out.empty())
@@ -1002,6 +1300,10 @@ void Recompiler::SaveCurrentOutData(const std::string_view& name)
 
 void Recompiler::FlushPendingWrites()
 {
+    auto phase = ctx_->profile.begin("FlushPendingWrites");
+    uint64_t bytesWritten = 0;
+
+    generatedFiles.clear();
     std::filesystem::path outputPath = ctx_->configDir() / config().outDirectoryPath;
 
     for (const auto& [filename, content] : pendingWrites)
@@ -1009,6 +1311,7 @@ void Recompiler::FlushPendingWrites()
         std::string filePath = (outputPath / filename).string();
         REXCODEGEN_TRACE("flush_pending_writes: filePath={}", filePath);
 
+        generatedFiles.insert(filename);
         bool shouldWrite = true;
 
         FILE* f = fopen(filePath.c_str(), "rb");
@@ -1039,11 +1342,13 @@ void Recompiler::FlushPendingWrites()
             }
             fwrite(content.data(), 1, content.size(), f);
             fclose(f);
+            bytesWritten += content.size();
             REXCODEGEN_TRACE("Wrote {} bytes to {}", content.size(), filePath);
         }
     }
 
     pendingWrites.clear();
+    phase.setBytesWritten(bytesWritten);
 }
 
 } // namespace rexglue::codegen
@@ -91,6 +91,14 @@ void AnalyzeTestBinary(
                 ctx.graph.addUnresolvedJumpToFunction(
                     fnAddr, pc, decoded.branch_target.value(), true, false);
             }
+            // Unconditional b to another test function = tail call
+            else if (decoded.is_branch() && !decoded.is_conditional() &&
+                     decoded.branch_target.has_value() &&
+                     ctx.graph.getFunction(decoded.branch_target.value()) &&
+                     decoded.branch_target.value() != fnAddr) {
+                ctx.graph.addUnresolvedJumpToFunction(
+                    fnAddr, pc, decoded.branch_target.value(), false, false);
+            }
         }
     }
 }
@@ -32,6 +32,28 @@ void TestModule::Load(uint32_t base_address, const uint8_t* data, size_t size) {
     });
 }
 
+void TestModule::SetExceptionDirectory(uint32_t address, uint32_t size) {
+    if (binary_sections_.empty() || address < base_address_ || address >= base_address_ + size_) {
+        return;
+    }
+    exception_dir_address_ = address;
+    exception_dir_size_ = size;
+
+    auto& text = binary_sections_.front();
+    uint32_t textSize = address - base_address_;
+    const uint8_t* pdataData = text.host_data + textSize;
+    text.virtual_size = textSize;
+
+    binary_sections_.push_back(runtime::BinarySection{
+        ".pdata",
+        address,
+        size_ - textSize,
+        pdataData,
+        false,  // executable
+        false   // writable
+    });
+}
+
 bool TestModule::ContainsAddress(uint32_t address) {
     return address >= base_address_ && address < base_address_ + size_;
 }
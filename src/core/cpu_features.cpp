@@ -0,0 +1,108 @@
+/**
+ * @file        cpu_features.cpp
+ * @brief       Host CPU instruction set extensions
+ *
+ * @copyright   Copyright (c) 2026 Tom Clay <tomc@tctechstuff.com>
+ *              All rights reserved.
+ *
+ * @license     BSD 3-Clause License
+ *              See LICENSE file in the project root for full license text.
+ */
+
+#include <rex/cpu_features.h>
+#include <rex/platform.h>
+
+#include <cstdint>
+
+#if REX_ARCH_AMD64 && !REX_COMPILER_MSVC
+#include <cpuid.h>
+#endif
+#if REX_ARCH_ARM64 && REX_PLATFORM_WIN32
+#include <rex/platform/win.h>
+#endif
+#if REX_ARCH_ARM64 && REX_PLATFORM_LINUX
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#endif
+
+namespace rex {
+
+namespace {
+
+#if REX_ARCH_AMD64
+
+void QueryCpuid(uint32_t leaf, uint32_t subleaf, uint32_t regs[4]) {
+#if REX_COMPILER_MSVC
+  int info[4];
+  __cpuidex(info, int(leaf), int(subleaf));
+  for (int i = 0; i < 4; ++i) {
+    regs[i] = uint32_t(info[i]);
+  }
+#else
+  if (!__get_cpuid_count(leaf, subleaf, &regs[0], &regs[1], &regs[2],
+                         &regs[3])) {
+    regs[0] = regs[1] = regs[2] = regs[3] = 0;
+  }
+#endif
+}
+
+uint64_t QueryXcr0() {
+#if REX_COMPILER_MSVC
+  return _xgetbv(0);
+#else
+  uint32_t eax, edx;
+  __asm__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+  return (uint64_t(edx) << 32) | eax;
+#endif
+}
+
+#endif  // REX_ARCH_AMD64
+
+CpuFeatures DetectCpuFeatures() {
+  CpuFeatures features;
+#if REX_ARCH_AMD64
+  uint32_t leaf1[4], leaf7[4];
+  QueryCpuid(1, 0, leaf1);
+  QueryCpuid(7, 0, leaf7);
+  // AVX state must also be enabled by the OS (OSXSAVE + XCR0).
+  bool osxsave = leaf1[2] & (1u << 27);
+  uint64_t xcr0 = osxsave ? QueryXcr0() : 0;
+  bool ymm = (xcr0 & 0x6) == 0x6;
+  bool zmm = (xcr0 & 0xE6) == 0xE6;
+  features.ssse3 = leaf1[2] & (1u << 9);
+  features.sse41 = leaf1[2] & (1u << 19);
+  features.pclmul = leaf1[2] & (1u << 1);
+  features.aes = leaf1[2] & (1u << 25);
+  features.sha1 = features.sha256 = leaf7[1] & (1u << 29);
+  features.avx2 = ymm && (leaf7[1] & (1u << 5));
+  features.avx512f = zmm && (leaf7[1] & (1u << 16));
+  features.avx512bw = zmm && (leaf7[1] & (1u << 30));
+  features.bmi2 = leaf7[1] & (1u << 8);
+#elif REX_ARCH_ARM64
+#if REX_PLATFORM_MAC
+  // Every Apple ARM64 CPU has the ARMv8 crypto and CRC extensions.
+  features.crc32 = features.aes = features.sha1 = features.sha256 = true;
+#elif REX_PLATFORM_WIN32
+  features.crc32 =
+      IsProcessorFeaturePresent(PF_ARM_V8_CRC32_INSTRUCTIONS_AVAILABLE);
+  features.aes = features.sha1 = features.sha256 =
+      IsProcessorFeaturePresent(PF_ARM_V8_CRYPTO_INSTRUCTIONS_AVAILABLE);
+#elif REX_PLATFORM_LINUX
+  unsigned long hwcap = getauxval(AT_HWCAP);
+  features.crc32 = hwcap & HWCAP_CRC32;
+  features.aes = hwcap & HWCAP_AES;
+  features.sha1 = hwcap & HWCAP_SHA1;
+  features.sha256 = hwcap & HWCAP_SHA2;
+#endif
+#endif
+  return features;
+}
+
+}  // namespace
+
+const CpuFeatures& GetCpuFeatures() {
+  static const CpuFeatures features = DetectCpuFeatures();
+  return features;
+}
+
+}  // namespace rex
@@ -0,0 +1,760 @@
+/**
+ * @file        crypto.cpp
+ * @brief       CRC32, SHA-1, SHA-256 and AES-128 with CPU-accelerated paths
+ *
+ * @copyright   Copyright (c) 2026 Tom Clay <tomc@tctechstuff.com>
+ *              All rights reserved.
+ *
+ * @license     BSD 3-Clause License
+ *              See LICENSE file in the project root for full license text.
+ */
+
+#include <rex/crypto.h>
+#include <rex/cpu_features.h>
+#include <rex/cvar.h>
+#include <rex/platform.h>
+
+#include <array>
+#include <utility>
+
+#if REX_ARCH_ARM64
+#include <arm_acle.h>
+#include <arm_neon.h>
+#endif
+
+#include "thirdparty/crypto/rijndael-alg-fst.c"
+#include "thirdparty/crypto/rijndael-alg-fst.h"
+
+REXCVAR_DEFINE_BOOL(crypto_hardware, true,
+    "Use CPU CRC32/SHA/AES instructions for kernel crypto and XEX loading",
+    "CPU");
+
+namespace rex::crypto {
+
+namespace {
+
+#if REX_ARCH_AMD64 && !REX_COMPILER_MSVC
+#define REX_TARGET_CLMUL __attribute__((target("sse4.1,pclmul")))
+#define REX_TARGET_SHA __attribute__((target("sse4.1,sha")))
+#define REX_TARGET_AES __attribute__((target("sse4.1,aes")))
+#elif REX_ARCH_ARM64 && REX_COMPILER_CLANG
+#define REX_TARGET_CRC __attribute__((target("crc")))
+#define REX_TARGET_SHA __attribute__((target("sha2")))
+#define REX_TARGET_AES __attribute__((target("aes")))
+#elif REX_ARCH_ARM64 && !REX_COMPILER_MSVC
+#define REX_TARGET_CRC __attribute__((target("+crc")))
+#define REX_TARGET_SHA __attribute__((target("+crypto")))
+#define REX_TARGET_AES __attribute__((target("+crypto")))
+#else
+#define REX_TARGET_CLMUL
+#define REX_TARGET_CRC
+#define REX_TARGET_SHA
+#define REX_TARGET_AES
+#endif
+
+// Which primitives have an accelerated path on this CPU. The x86-64 paths
+// also use SSE4.1.
+struct CryptoFeatures {
+    bool crc32 = false;
+    bool sha1 = false;
+    bool sha256 = false;
+    bool aes = false;
+};
+
+CryptoFeatures DetectCryptoFeatures() {
+    const rex::CpuFeatures& cpu = rex::GetCpuFeatures();
+    CryptoFeatures features;
+#if REX_ARCH_AMD64
+    features.crc32 = cpu.sse41 && cpu.pclmul;
+    features.sha1 = cpu.sse41 && cpu.sha1;
+    features.sha256 = cpu.sse41 && cpu.sha256;
+    features.aes = cpu.sse41 && cpu.aes;
+#else
+    features.crc32 = cpu.crc32;
+    features.sha1 = cpu.sha1;
+    features.sha256 = cpu.sha256;
+    features.aes = cpu.aes;
+#endif
+    return features;
+}
+
+const CryptoFeatures& GetCryptoFeatures() {
+    static const CryptoFeatures features = DetectCryptoFeatures();
+    return features;
+}
+
+bool UseHardware(bool CryptoFeatures::*feature) {
+    return REXCVAR_GET(crypto_hardware) && GetCryptoFeatures().*feature;
+}
+
+uint32_t LoadLE32(const uint8_t* p) {
+    uint32_t value;
+    std::memcpy(&value, p, 4);
+    return value;
+}
+
+uint32_t LoadBE32(const uint8_t* p) {
+    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | p[3];
+}
+
+uint32_t Rotl(uint32_t value, int shift) {
+    return (value << shift) | (value >> (32 - shift));
+}
+
+uint32_t Rotr(uint32_t value, int shift) {
+    return (value >> shift) | (value << (32 - shift));
+}
+
+// CRC-32 ---------------------------------------------------------------------
+
+// Table k advances a byte through k further zero bytes, so 16 input bytes can
+// be folded with 16 independent lookups (slice-by-16).
+constexpr auto kCrc32Tables = [] {
+    std::array<std::array<uint32_t, 256>, 16> tables{};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+        }
+        tables[0][i] = crc;
+    }
+    for (size_t k = 1; k < 16; ++k) {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t prev = tables[k - 1][i];
+            tables[k][i] = (prev >> 8) ^ tables[0][prev & 0xFF];
+        }
+    }
+    return tables;
+}();
+
+// Works on the inverted CRC register, as do the hardware paths.
+uint32_t Crc32Portable(uint32_t crc, const uint8_t* p, size_t length) {
+    const auto& t = kCrc32Tables;
+    for (; length >= 16; p += 16, length -= 16) {
+        uint32_t a = LoadLE32(p) ^ crc;
+        uint32_t b = LoadLE32(p + 4);
+        uint32_t c = LoadLE32(p + 8);
+        uint32_t d = LoadLE32(p + 12);
+        crc = t[15][a & 0xFF] ^ t[14][(a >> 8) & 0xFF] ^ t[13][(a >> 16) & 0xFF] ^
+              t[12][a >> 24] ^ t[11][b & 0xFF] ^ t[10][(b >> 8) & 0xFF] ^
+              t[9][(b >> 16) & 0xFF] ^ t[8][b >> 24] ^ t[7][c & 0xFF] ^
+              t[6][(c >> 8) & 0xFF] ^ t[5][(c >> 16) & 0xFF] ^ t[4][c >> 24] ^
+              t[3][d & 0xFF] ^ t[2][(d >> 8) & 0xFF] ^ t[1][(d >> 16) & 0xFF] ^
+              t[0][d >> 24];
+    }
+    for (; length; ++p, --length) {
+        crc = t[0][(crc ^ *p) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+#if REX_ARCH_AMD64
+
+REX_TARGET_CLMUL __m128i Load128(const uint8_t* p) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+}
+
+REX_TARGET_CLMUL __m128i Fold128(__m128i x, __m128i k, __m128i data) {
+    __m128i lo = _mm_clmulepi64_si128(x, k, 0x00);
+    __m128i hi = _mm_clmulepi64_si128(x, k, 0x11);
+    return _mm_xor_si128(_mm_xor_si128(hi, lo), data);
+}
+
+// Folds four 128-bit lanes at a time with carry-less multiplies, then
+// Barrett-reduces to 32 bits. Constants are x^n mod P(x) for the reflected
+// IEEE polynomial (Intel, "Fast CRC Computation Using PCLMULQDQ").
+// `length` must be a multiple of 16 and at least 64.
+REX_TARGET_CLMUL uint32_t Crc32Clmul(uint32_t crc, const uint8_t* p, size_t length) {
+    const __m128i k1k2 = _mm_set_epi64x(0x01C6E41596, 0x0154442BD4);
+    const __m128i k3k4 = _mm_set_epi64x(0x00CCAA009E, 0x01751997D0);
+    const __m128i k5k0 = _mm_set_epi64x(0, 0x0163CD6124);
+    const __m128i poly = _mm_set_epi64x(0x01F7011641, 0x01DB710641);
+    const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+
+    __m128i x1 = _mm_xor_si128(Load128(p), _mm_cvtsi32_si128(int(crc)));
+    __m128i x2 = Load128(p + 16);
+    __m128i x3 = Load128(p + 32);
+    __m128i x4 = Load128(p + 48);
+    p += 64;
+    length -= 64;
+    for (; length >= 64; p += 64, length -= 64) {
+        x1 = Fold128(x1, k1k2, Load128(p));
+        x2 = Fold128(x2, k1k2, Load128(p + 16));
+        x3 = Fold128(x3, k1k2, Load128(p + 32));
+        x4 = Fold128(x4, k1k2, Load128(p + 48));
+    }
+    x1 = Fold128(x1, k3k4, x2);
+    x1 = Fold128(x1, k3k4, x3);
+    x1 = Fold128(x1, k3k4, x4);
+    for (; length >= 16; p += 16, length -= 16) {
+        x1 = Fold128(x1, k3k4, Load128(p));
+    }
+
+    // 128 -> 64 bits.
+    __m128i x2r = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2r);
+    x2r = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, mask32);
+    x1 = _mm_xor_si128(_mm_clmulepi64_si128(x1, k5k0, 0x00), x2r);
+
+    // Barrett reduction to 32 bits.
+    __m128i t = _mm_clmulepi64_si128(_mm_and_si128(x1, mask32), poly, 0x10);
+    t = _mm_clmulepi64_si128(_mm_and_si128(t, mask32), poly, 0x00);
+    return uint32_t(_mm_extract_epi32(_mm_xor_si128(x1, t), 1));
+}
+
+uint32_t Crc32Hardware(uint32_t crc, const uint8_t* p, size_t length) {
+    if (length >= 64) {
+        size_t bulk = length & ~size_t(15);
+        crc = Crc32Clmul(crc, p, bulk);
+        p += bulk;
+        length -= bulk;
+    }
+    return Crc32Portable(crc, p, length);
+}
+
+#elif REX_ARCH_ARM64
+
+REX_TARGET_CRC uint32_t Crc32Hardware(uint32_t crc, const uint8_t* p, size_t length) {
+    for (; length >= 8; p += 8, length -= 8) {
+        uint64_t value;
+        std::memcpy(&value, p, 8);
+        crc = __crc32d(crc, value);
+    }
+    for (; length; ++p, --length) {
+        crc = __crc32b(crc, *p);
+    }
+    return crc;
+}
+
+#endif
+
+// SHA-1 ----------------------------------------------------------------------
+
+void Sha1Portable(uint32_t state[5], const uint8_t* blocks, size_t block_count) {
+    for (; block_count; --block_count, blocks += 64) {
+        uint32_t w[80];
+        for (int i = 0; i < 16; ++i) {
+            w[i] = LoadBE32(blocks + i * 4);
+        }
+        for (int i = 16; i < 80; ++i) {
+            w[i] = Rotl(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+        }
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3], e = state[4];
+        for (int i = 0; i < 80; ++i) {
+            uint32_t f, k;
+            if (i < 20) {
+                f = (b & c) | (~b & d);
+                k = 0x5A827999;
+            } else if (i < 40) {
+                f = b ^ c ^ d;
+                k = 0x6ED9EBA1;
+            } else if (i < 60) {
+                f = (b & c) | (b & d) | (c & d);
+                k = 0x8F1BBCDC;
+            } else {
+                f = b ^ c ^ d;
+                k = 0xCA62C1D6;
+            }
+            uint32_t temp = Rotl(a, 5) + f + e + k + w[i];
+            e = d;
+            d = c;
+            c = Rotl(b, 30);
+            b = a;
+            a = temp;
+        }
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+    }
+}
+
+// SHA-256 --------------------------------------------------------------------
+
+alignas(16) constexpr uint32_t kSha256K[64] = {
+    0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1, 0x923F82A4,
+    0xAB1C5ED5, 0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3, 0x72BE5D74, 0x80DEB1FE,
+    0x9BDC06A7, 0xC19BF174, 0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC, 0x2DE92C6F,
+    0x4A7484AA, 0x5CB0A9DC, 0x76F988DA, 0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7,
+    0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967, 0x27B70A85, 0x2E1B2138, 0x4D2C6DFC,
+    0x53380D13, 0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85, 0xA2BFE8A1, 0xA81A664B,
+    0xC24B8B70, 0xC76C51A3, 0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070, 0x19A4C116,
+    0x1E376C08, 0x2748774C, 0x34B0BCB5, 0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+    0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208, 0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7,
+    0xC67178F2,
+};
+
+void Sha256Portable(uint32_t state[8], const uint8_t* blocks, size_t block_count) {
+    for (; block_count; --block_count, blocks += 64) {
+        uint32_t w[64];
+        for (int i = 0; i < 16; ++i) {
+            w[i] = LoadBE32(blocks + i * 4);
+        }
+        for (int i = 16; i < 64; ++i) {
+            uint32_t s0 = Rotr(w[i - 15], 7) ^ Rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            uint32_t s1 = Rotr(w[i - 2], 17) ^ Rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+        uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+        for (int i = 0; i < 64; ++i) {
+            uint32_t s1 = Rotr(e, 6) ^ Rotr(e, 11) ^ Rotr(e, 25);
+            uint32_t ch = (e & f) ^ (~e & g);
+            uint32_t temp1 = h + s1 + ch + kSha256K[i] + w[i];
+            uint32_t s0 = Rotr(a, 2) ^ Rotr(a, 13) ^ Rotr(a, 22);
+            uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+            uint32_t temp2 = s0 + maj;
+            h = g;
+            g = f;
+            f = e;
+            e = d + temp1;
+            d = c;
+            c = b;
+            b = a;
+            a = temp1 + temp2;
+        }
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+        state[5] += f;
+        state[6] += g;
+        state[7] += h;
+    }
+}
+
+#if REX_ARCH_AMD64
+
+// SHA-NI kernels, after Intel's reference code. Each 4-round group is a
+// template instantiated once per group index, so the message schedule stays
+// in registers and the SHA1RNDS4 function selector is an immediate.
+
+template <int i>
+REX_TARGET_SHA inline void Sha1Group(__m128i& abcd, __m128i (&e)[2], __m128i (&msg)[4]) {
+    __m128i cur = msg[i % 4];
+    __m128i& e_cur = e[i % 2];
+    e_cur = i == 0 ? _mm_add_epi32(e_cur, cur) : _mm_sha1nexte_epu32(e_cur, cur);
+    e[(i + 1) % 2] = abcd;
+    if constexpr (i >= 3 && i <= 18) {
+        msg[(i + 1) % 4] = _mm_sha1msg2_epu32(msg[(i + 1) % 4], cur);
+    }
+    abcd = _mm_sha1rnds4_epu32(abcd, e_cur, i / 5);
+    if constexpr (i >= 1 && i <= 16) {
+        msg[(i + 3) % 4] = _mm_sha1msg1_epu32(msg[(i + 3) % 4], cur);
+    }
+    if constexpr (i >= 2 && i <= 17) {
+        msg[(i + 2) % 4] = _mm_xor_si128(msg[(i + 2) % 4], cur);
+    }
+}
+
+template <size_t... I>
+REX_TARGET_SHA inline void Sha1Groups(__m128i& abcd, __m128i (&e)[2], __m128i (&msg)[4],
+                                      std::index_sequence<I...>) {
+    (Sha1Group<int(I)>(abcd, e, msg), ...);
+}
+
+REX_TARGET_SHA void Sha1Hardware(uint32_t state[5], const uint8_t* blocks,
+                                 size_t block_count) {
+    const __m128i byte_swap = _mm_set_epi64x(0x0001020304050607, 0x08090A0B0C0D0E0F);
+    __m128i abcd = _mm_shuffle_epi32(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(state)), 0x1B);
+    __m128i e0 = _mm_set_epi32(int(state[4]), 0, 0, 0);
+    for (; block_count; --block_count, blocks += 64) {
+        __m128i abcd_save = abcd;
+        __m128i msg[4];
+        for (int i = 0; i < 4; ++i) {
+            msg[i] = _mm_shuffle_epi8(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(blocks + i * 16)),
+                byte_swap);
+        }
+        __m128i e[2] = {e0, e0};
+        Sha1Groups(abcd, e, msg, std::make_index_sequence<20>());
+        e0 = _mm_sha1nexte_epu32(e[0], e0);
+        abcd = _mm_add_epi32(abcd, abcd_save);
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), _mm_shuffle_epi32(abcd, 0x1B));
+    state[4] = uint32_t(_mm_extract_epi32(e0, 3));
+}
+
+template <int i>
+REX_TARGET_SHA inline void Sha256Group(__m128i& state0, __m128i& state1,
+                                       __m128i (&msg)[4]) {
+    __m128i cur = msg[i % 4];
+    __m128i wk = _mm_add_epi32(
+        cur, _mm_load_si128(reinterpret_cast<const __m128i*>(kSha256K + i * 4)));
+    state1 = _mm_sha256rnds2_epu32(state1, state0, wk);
+    if constexpr (i >= 3 && i <= 14) {
+        __m128i& next = msg[(i + 1) % 4];
+        next = _mm_add_epi32(next, _mm_alignr_epi8(cur, msg[(i + 3) % 4], 4));
+        next = _mm_sha256msg2_epu32(next, cur);
+    }
+    state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(wk, 0x0E));
+    if constexpr (i >= 1 && i <= 12) {
+        msg[(i + 3) % 4] = _mm_sha256msg1_epu32(msg[(i + 3) % 4], cur);
+    }
+}
+
+template <size_t... I>
+REX_TARGET_SHA inline void Sha256Groups(__m128i& state0, __m128i& state1, __m128i (&msg)[4],
+                                        std::index_sequence<I...>) {
+    (Sha256Group<int(I)>(state0, state1, msg), ...);
+}
+
+REX_TARGET_SHA void Sha256Hardware(uint32_t state[8], const uint8_t* blocks,
+                                   size_t block_count) {
+    const __m128i byte_swap = _mm_set_epi64x(0x0C0D0E0F08090A0B, 0x0405060700010203);
+    __m128i tmp = _mm_shuffle_epi32(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(state)), 0xB1);  // CDAB
+    __m128i state1 = _mm_shuffle_epi32(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(state + 4)), 0x1B);  // EFGH
+    __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);  // ABEF
+    state1 = _mm_blend_epi16(state1, tmp, 0xF0);       // CDGH
+    for (; block_count; --block_count, blocks += 64) {
+        __m128i abef_save = state0;
+        __m128i cdgh_save = state1;
+        __m128i msg[4];
+        for (int i = 0; i < 4; ++i) {
+            msg[i] = _mm_shuffle_epi8(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(blocks + i * 16)),
+                byte_swap);
+        }
+        Sha256Groups(state0, state1, msg, std::make_index_sequence<16>());
+        state0 = _mm_add_epi32(state0, abef_save);
+        state1 = _mm_add_epi32(state1, cdgh_save);
+    }
+    tmp = _mm_shuffle_epi32(state0, 0x1B);        // FEBA
+    state1 = _mm_shuffle_epi32(state1, 0xB1);     // DCHG
+    state0 = _mm_blend_epi16(tmp, state1, 0xF0);  // DCBA
+    state1 = _mm_alignr_epi8(state1, tmp, 8);     // EFGH
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), state0);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state + 4), state1);
+}
+
+#elif REX_ARCH_ARM64
+
+REX_TARGET_SHA void Sha1Hardware(uint32_t state[5], const uint8_t* blocks,
+                                 size_t block_count) {
+    uint32x4_t abcd = vld1q_u32(state);
+    uint32_t e0 = state[4];
+    for (; block_count; --block_count, blocks += 64) {
+        uint32x4_t abcd_save = abcd;
+        uint32_t e0_save = e0;
+        uint32x4_t msg[4];
+        for (int i = 0; i < 4; ++i) {
+            msg[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(blocks + i * 16)));
+        }
+        for (int i = 0; i < 20; ++i) {
+            static constexpr uint32_t kK[4] = {0x5A827999, 0x6ED9EBA1, 0x8F1BBCDC,
+                                               0xCA62C1D6};
+            uint32x4_t wk = vaddq_u32(msg[i % 4], vdupq_n_u32(kK[i / 5]));
+            uint32_t e1 = vsha1h_u32(vgetq_lane_u32(abcd, 0));
+            if (i < 5) {
+                abcd = vsha1cq_u32(abcd, e0, wk);
+            } else if (i < 10 || i >= 15) {
+                abcd = vsha1pq_u32(abcd, e0, wk);
+            } else {
+                abcd = vsha1mq_u32(abcd, e0, wk);
+            }
+            e0 = e1;
+            if (i < 16) {
+                msg[i % 4] = vsha1su1q_u32(
+                    vsha1su0q_u32(msg[i % 4], msg[(i + 1) % 4], msg[(i + 2) % 4]),
+                    msg[(i + 3) % 4]);
+            }
+        }
+        abcd = vaddq_u32(abcd, abcd_save);
+        e0 += e0_save;
+    }
+    vst1q_u32(state, abcd);
+    state[4] = e0;
+}
+
+REX_TARGET_SHA void Sha256Hardware(uint32_t state[8], const uint8_t* blocks,
+                                   size_t block_count) {
+    uint32x4_t state0 = vld1q_u32(state);
+    uint32x4_t state1 = vld1q_u32(state + 4);
+    for (; block_count; --block_count, blocks += 64) {
+        uint32x4_t abef_save = state0;
+        uint32x4_t cdgh_save = state1;
+        uint32x4_t msg[4];
+        for (int i = 0; i < 4; ++i) {
+            msg[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(blocks + i * 16)));
+        }
+        for (int i = 0; i < 16; ++i) {
+            uint32x4_t wk = vaddq_u32(msg[i % 4], vld1q_u32(kSha256K + i * 4));
+            if (i < 12) {
+                msg[i % 4] = vsha256su1q_u32(vsha256su0q_u32(msg[i % 4], msg[(i + 1) % 4]),
+                                             msg[(i + 2) % 4], msg[(i + 3) % 4]);
+            }
+            uint32x4_t state0_prev = state0;
+            state0 = vsha256hq_u32(state0, state1, wk);
+            state1 = vsha256h2q_u32(state1, state0_prev, wk);
+        }
+        state0 = vaddq_u32(state0, abef_save);
+        state1 = vaddq_u32(state1, cdgh_save);
+    }
+    vst1q_u32(state, state0);
+    vst1q_u32(state + 4, state1);
+}
+
+#endif
+
+// AES-128 --------------------------------------------------------------------
+
+#if REX_ARCH_AMD64
+
+// Round keys are stored as big-endian words; byte-swapping each word gives the
+// in-memory order AES-NI expects.
+REX_TARGET_AES __m128i LoadRoundKey(const uint32_t* words) {
+    const __m128i byte_swap = _mm_set_epi64x(0x0C0D0E0F08090A0B, 0x0405060700010203);
+    return _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(words)),
+                            byte_swap);
+}
+
+REX_TARGET_AES void AesEncryptCbcHardware(const uint32_t* keys, uint8_t iv[16],
+                                          const uint8_t* in, uint8_t* out,
+                                          size_t length) {
+    __m128i rk[11];
+    for (int r = 0; r < 11; ++r) {
+        rk[r] = LoadRoundKey(keys + r * 4);
+    }
+    __m128i feed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(iv));
+    for (size_t n = 0; n < length; n += 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + n));
+        block = _mm_xor_si128(_mm_xor_si128(block, feed), rk[0]);
+        for (int r = 1; r < 10; ++r) {
+            block = _mm_aesenc_si128(block, rk[r]);
+        }
+        feed = _mm_aesenclast_si128(block, rk[10]);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + n), feed);
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(iv), feed);
+}
+
+// Blocks decrypt independently in CBC, so four are kept in flight to cover
+// the AESDEC latency.
+REX_TARGET_AES void AesDecryptCbcHardware(const uint32_t* keys, uint8_t iv[16],
+                                          const uint8_t* in, uint8_t* out,
+                                          size_t length) {
+    __m128i rk[11];
+    for (int r = 0; r < 11; ++r) {
+        rk[r] = LoadRoundKey(keys + r * 4);
+    }
+    auto load = [in](size_t offset) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + offset));
+    };
+    __m128i feed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(iv));
+    size_t n = 0;
+    for (; n + 64 <= length; n += 64) {
+        __m128i c0 = load(n), c1 = load(n + 16), c2 = load(n + 32), c3 = load(n + 48);
+        __m128i b0 = _mm_xor_si128(c0, rk[0]);
+        __m128i b1 = _mm_xor_si128(c1, rk[0]);
+        __m128i b2 = _mm_xor_si128(c2, rk[0]);
+        __m128i b3 = _mm_xor_si128(c3, rk[0]);
+        for (int r = 1; r < 10; ++r) {
+            b0 = _mm_aesdec_si128(b0, rk[r]);
+            b1 = _mm_aesdec_si128(b1, rk[r]);
+            b2 = _mm_aesdec_si128(b2, rk[r]);
+            b3 = _mm_aesdec_si128(b3, rk[r]);
+        }
+        b0 = _mm_xor_si128(_mm_aesdeclast_si128(b0, rk[10]), feed);
+        b1 = _mm_xor_si128(_mm_aesdeclast_si128(b1, rk[10]), c0);
+        b2 = _mm_xor_si128(_mm_aesdeclast_si128(b2, rk[10]), c1);
+        b3 = _mm_xor_si128(_mm_aesdeclast_si128(b3, rk[10]), c2);
+        feed = c3;
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + n), b0);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + n + 16), b1);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + n + 32), b2);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + n + 48), b3);
+    }
+    for (; n < length; n += 16) {
+        __m128i ct = load(n);
+        __m128i b = _mm_xor_si128(ct, rk[0]);
+        for (int r = 1; r < 10; ++r) {
+            b = _mm_aesdec_si128(b, rk[r]);
+        }
+        b = _mm_xor_si128(_mm_aesdeclast_si128(b, rk[10]), feed);
+        feed = ct;
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + n), b);
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(iv), feed);
+}
+
+#elif REX_ARCH_ARM64
+
+REX_TARGET_AES uint8x16_t LoadRoundKey(const uint32_t* words) {
+    return vrev32q_u8(vreinterpretq_u8_u32(vld1q_u32(words)));
+}
+
+REX_TARGET_AES void AesEncryptCbcHardware(const uint32_t* keys, uint8_t iv[16],
+                                          const uint8_t* in, uint8_t* out,
+                                          size_t length) {
+    uint8x16_t rk[11];
+    for (int r = 0; r < 11; ++r) {
+        rk[r] = LoadRoundKey(keys + r * 4);
+    }
+    uint8x16_t feed = vld1q_u8(iv);
+    for (size_t n = 0; n < length; n += 16) {
+        uint8x16_t block = veorq_u8(vld1q_u8(in + n), feed);
+        for (int r = 0; r < 9; ++r) {
+            block = vaesmcq_u8(vaeseq_u8(block, rk[r]));
+        }
+        feed = veorq_u8(vaeseq_u8(block, rk[9]), rk[10]);
+        vst1q_u8(out + n, feed);
+    }
+    vst1q_u8(iv, feed);
+}
+
+REX_TARGET_AES void AesDecryptCbcHardware(const uint32_t* keys, uint8_t iv[16],
+                                          const uint8_t* in, uint8_t* out,
+                                          size_t length) {
+    uint8x16_t rk[11];
+    for (int r = 0; r < 11; ++r) {
+        rk[r] = LoadRoundKey(keys + r * 4);
+    }
+    uint8x16_t feed = vld1q_u8(iv);
+    size_t n = 0;
+    for (; n + 64 <= length; n += 64) {
+        uint8x16_t ct[4], b[4];
+        for (int j = 0; j < 4; ++j) {
+            b[j] = ct[j] = vld1q_u8(in + n + j * 16);
+        }
+        for (int r = 0; r < 9; ++r) {
+            for (int j = 0; j < 4; ++j) {
+                b[j] = vaesimcq_u8(vaesdq_u8(b[j], rk[r]));
+            }
+        }
+        for (int j = 0; j < 4; ++j) {
+            b[j] = veorq_u8(veorq_u8(vaesdq_u8(b[j], rk[9]), rk[10]), feed);
+            feed = ct[j];
+            vst1q_u8(out + n + j * 16, b[j]);
+        }
+    }
+    for (; n < length; n += 16) {
+        uint8x16_t ct = vld1q_u8(in + n);
+        uint8x16_t b = ct;
+        for (int r = 0; r < 9; ++r) {
+            b = vaesimcq_u8(vaesdq_u8(b, rk[r]));
+        }
+        b = veorq_u8(veorq_u8(vaesdq_u8(b, rk[9]), rk[10]), feed);
+        feed = ct;
+        vst1q_u8(out + n, b);
+    }
+    vst1q_u8(iv, feed);
+}
+
+#endif
+
+void AesEncryptCbcPortable(const uint32_t* keys, uint8_t iv[16], const uint8_t* in,
+                           uint8_t* out, size_t length) {
+    for (size_t n = 0; n < length; n += 16) {
+        for (size_t i = 0; i < 16; ++i) {
+            iv[i] ^= in[n + i];
+        }
+        rijndaelEncrypt(keys, 10, iv, iv);
+        std::memcpy(out + n, iv, 16);
+    }
+}
+
+void AesDecryptCbcPortable(const uint32_t* keys, uint8_t iv[16], const uint8_t* in,
+                           uint8_t* out, size_t length) {
+    for (size_t n = 0; n < length; n += 16) {
+        uint8_t ct[16];
+        std::memcpy(ct, in + n, 16);
+        rijndaelDecrypt(keys, 10, ct, out + n);
+        for (size_t i = 0; i < 16; ++i) {
+            out[n + i] ^= iv[i];
+        }
+        std::memcpy(iv, ct, 16);
+    }
+}
+
+}  // namespace
+
+bool HasHardwareCrc32() {
+    return GetCryptoFeatures().crc32;
+}
+
+bool HasHardwareSha1() {
+    return GetCryptoFeatures().sha1;
+}
+
+bool HasHardwareSha256() {
+    return GetCryptoFeatures().sha256;
+}
+
+bool HasHardwareAes() {
+    return GetCryptoFeatures().aes;
+}
+
+uint32_t Crc32(uint32_t crc, const void* data, size_t length) {
+    auto p = static_cast<const uint8_t*>(data);
+#if REX_ARCH_AMD64 || REX_ARCH_ARM64
+    if (UseHardware(&CryptoFeatures::crc32)) {
+        return ~Crc32Hardware(~crc, p, length);
+    }
+#endif
+    return ~Crc32Portable(~crc, p, length);
+}
+
+void Sha1Compress(uint32_t state[5], const uint8_t* blocks, size_t block_count) {
+#if REX_ARCH_AMD64 || REX_ARCH_ARM64
+    if (UseHardware(&CryptoFeatures::sha1)) {
+        Sha1Hardware(state, blocks, block_count);
+        return;
+    }
+#endif
+    Sha1Portable(state, blocks, block_count);
+}
+
+void Sha256Compress(uint32_t state[8], const uint8_t* blocks, size_t block_count) {
+#if REX_ARCH_AMD64 || REX_ARCH_ARM64
+    if (UseHardware(&CryptoFeatures::sha256)) {
+        Sha256Hardware(state, blocks, block_count);
+        return;
+    }
+#endif
+    Sha256Portable(state, blocks, block_count);
+}
+
+Aes128::Aes128(const uint8_t key[16]) {
+    rijndaelKeySetupEnc(encrypt_keys_, key, 128);
+    rijndaelKeySetupDec(decrypt_keys_, key, 128);
+}
+
+void Aes128::EncryptBlock(const uint8_t in[16], uint8_t out[16]) const {
+    uint8_t iv[16] = {};
+    EncryptCbc(iv, in, out, 16);
+}
+
+void Aes128::DecryptBlock(const uint8_t in[16], uint8_t out[16]) const {
+    uint8_t iv[16] = {};
+    DecryptCbc(iv, in, out, 16);
+}
+
+void Aes128::EncryptCbc(uint8_t iv[16], const uint8_t* in, uint8_t* out,
+                        size_t length) const {
+#if REX_ARCH_AMD64 || REX_ARCH_ARM64
+    if (UseHardware(&CryptoFeatures::aes)) {
+        AesEncryptCbcHardware(encrypt_keys_, iv, in, out, length);
+        return;
+    }
+#endif
+    AesEncryptCbcPortable(encrypt_keys_, iv, in, out, length);
+}
+
+void Aes128::DecryptCbc(uint8_t iv[16], const uint8_t* in, uint8_t* out,
+                        size_t length) const {
+#if REX_ARCH_AMD64 || REX_ARCH_ARM64
+    if (UseHardware(&CryptoFeatures::aes)) {
+        AesDecryptCbcHardware(decrypt_keys_, iv, in, out, length);
+        return;
+    }
+#endif
+    AesDecryptCbcPortable(decrypt_keys_, iv, in, out, length);
+}
+
+}  // namespace rex::crypto
@@ -11,9 +11,12 @@
 
 #include <rex/logging.h>
 #include <rex/cvar.h>
+#include <rex/thread/spsc_ring.h>
 #include <vector>
 #include <mutex>
 #include <algorithm>
+#include <condition_variable>
+#include <thread>
 #include <unordered_map>
 #include <cctype>
 
@@ -26,6 +29,9 @@ REXCVAR_DEFINE_STRING(log_file, "", "Log", "Log file path (empty = no file loggi
 REXCVAR_DEFINE_BOOL(log_verbose, false, "Log", "Enable verbose logging (sets level to trace)")
     .debug_only();
 
+REXCVAR_DEFINE_BOOL(log_async, false, "Log", "Format and write log messages on a background thread")
+    .lifecycle(rex::cvar::Lifecycle::kInitOnly);
+
 namespace rex {
 
 namespace {
@@ -42,8 +48,164 @@ namespace {
 
     // Stored configuration
     LogConfig g_config;
+
+    void PublishLevel(LogCategory category, spdlog::level::level_enum level) {
+        detail::g_category_levels[static_cast<size_t>(category)].store(
+            static_cast<int>(level), std::memory_order_relaxed);
+    }
+
+    //-------------------------------------------------------------------------
+    // Async backend
+    //-------------------------------------------------------------------------
+
+    constexpr size_t kAsyncRecordsPerThread = 1024;
+
+    using AsyncRing = thread::SpscRing<detail::AsyncLogRecord>;
+    thread::ThreadRings<AsyncRing> g_async_rings;
+
+    // Statements between BeginAsyncRecord() and CommitAsyncRecord(). The
+    // final drain waits for these, so a statement that saw async logging on
+    // is never queued after it.
+    std::atomic<int> g_async_in_flight{0};
+
+    std::mutex g_writer_lock;
+    std::condition_variable g_writer_cond;
+    bool g_writer_shutdown = false;
+    bool g_writer_kicked = false;
+    std::thread g_writer_thread;
+
+    void KickWriter() {
+        {
+            std::lock_guard<std::mutex> lock(g_writer_lock);
+            g_writer_kicked = true;
+        }
+        g_writer_cond.notify_one();
+    }
+
+    // Formats a record and hands it to its logger's sinks. Returns true if
+    // the logger wants a flush at this level.
+    bool WriteRecord(detail::AsyncLogRecord& record, spdlog::memory_buf_t& buffer) {
+        buffer.clear();
+        record.format(record, buffer);
+        auto& logger = g_loggers[static_cast<size_t>(record.category)];
+        if (!logger) {
+            return false;
+        }
+        spdlog::details::log_msg msg(
+            record.time, record.loc, logger->name(), record.level,
+            spdlog::string_view_t(buffer.data(), buffer.size()));
+        msg.thread_id = record.thread_id;
+        for (auto& sink : logger->sinks()) {
+            if (sink->should_log(record.level)) {
+                sink->log(msg);
+            }
+        }
+        return record.level >= logger->flush_level();
+    }
+
+    // Formats and writes every queued record and frees the rings of threads
+    // that have ended. Each thread's messages stay in order.
+    void DrainAsync() {
+        spdlog::memory_buf_t buffer;
+        std::array<bool, static_cast<size_t>(LogCategory::Count)> needs_flush{};
+        g_async_rings.Drain([&](AsyncRing& ring) {
+            ring.Drain([&](detail::AsyncLogRecord& record) {
+                // Flushed once per batch rather than per message.
+                needs_flush[static_cast<size_t>(record.category)] |=
+                    WriteRecord(record, buffer);
+            });
+        });
+        for (size_t i = 0; i < needs_flush.size(); ++i) {
+            if (needs_flush[i] && g_loggers[i]) {
+                g_loggers[i]->flush();
+            }
+        }
+    }
+
+    void AsyncWriterMain() {
+        std::unique_lock<std::mutex> lock(g_writer_lock);
+        while (!g_writer_shutdown) {
+            g_writer_cond.wait_for(lock, std::chrono::milliseconds(50),
+                                   [] { return g_writer_kicked || g_writer_shutdown; });
+            g_writer_kicked = false;
+            lock.unlock();
+            DrainAsync();
+            lock.lock();
+        }
+    }
+
+    void StartAsyncWriter() {
+        g_writer_shutdown = false;
+        g_writer_thread = std::thread(AsyncWriterMain);
+        detail::g_async_logging.store(true, std::memory_order_relaxed);
+    }
+
+    void StopAsyncWriter() {
+        if (!g_writer_thread.joinable()) {
+            return;
+        }
+        detail::g_async_logging.store(false, std::memory_order_seq_cst);
+        // Statements already past the check finish queueing while the writer
+        // still runs; later ones see the flag and log synchronously.
+        while (g_async_in_flight.load(std::memory_order_seq_cst) != 0) {
+            std::this_thread::yield();
+        }
+        {
+            std::lock_guard<std::mutex> lock(g_writer_lock);
+            g_writer_shutdown = true;
+        }
+        g_writer_cond.notify_all();
+        g_writer_thread.join();
+        DrainAsync();
+    }
+}
+
+namespace detail {
+
+spdlog::logger* GetLoggerRaw(LogCategory category) {
+    if (!g_initialized) {
+        InitLogging();
+    }
+    return g_loggers[static_cast<size_t>(category)].get();
+}
+
+AsyncLogRecord* BeginAsyncRecord() {
+    g_async_in_flight.fetch_add(1, std::memory_order_seq_cst);
+    AsyncRing* ring = nullptr;
+    if (g_async_logging.load(std::memory_order_seq_cst)) {
+        ring = g_async_rings.Get(
+            [] { return std::make_unique<AsyncRing>(kAsyncRecordsPerThread); });
+    }
+    if (!ring) {
+        // The writer is stopping, or this thread's ring is already gone.
+        g_async_in_flight.fetch_sub(1, std::memory_order_release);
+        return nullptr;
+    }
+    while (true) {
+        if (auto* record = ring->Begin()) {
+            return record;
+        }
+        // Full: never drop, wait for the writer to make room. It keeps
+        // running until this statement is committed.
+        KickWriter();
+        std::this_thread::yield();
+    }
+}
+
+void CommitAsyncRecord() {
+    g_async_rings.Current()->Commit();
+    g_async_in_flight.fetch_sub(1, std::memory_order_release);
+}
+
+void WriteRecordNow(AsyncLogRecord& record) {
+    spdlog::memory_buf_t buffer;
+    if (WriteRecord(record, buffer)) {
+        g_loggers[static_cast<size_t>(record.category)]->flush();
+    }
 }
 
+}  // namespace detail
+
 void InitLogging(const LogConfig& config) {
     std::lock_guard<std::mutex> lock(g_init_mutex);
 
@@ -53,6 +215,7 @@ void InitLogging(const LogConfig& config) {
             auto level = config.category_levels[i].value_or(config.default_level);
             if (g_loggers[i]) {
                 g_loggers[i]->set_level(level);
+                PublishLevel(static_cast<LogCategory>(i), level);
             }
         }
         g_config = config;
@@ -99,6 +262,7 @@ void InitLogging(const LogConfig& config) {
         // Register with spdlog for global access
         spdlog::register_logger(logger);
         g_loggers[i] = logger;
+        PublishLevel(cat, level);
     }
 
     // Set core as default logger for spdlog
@@ -106,6 +270,10 @@ void InitLogging(const LogConfig& config) {
 
     g_initialized = true;
 
+    if (REXCVAR_GET(log_async)) {
+        StartAsyncWriter();
+    }
+
     REXLOG_DEBUG("Rex logging initialized with {} categories",
                  static_cast<size_t>(LogCategory::Count));
 }
@@ -122,6 +290,8 @@ void ShutdownLogging() {
 
     if (!g_initialized) return;
 
+    StopAsyncWriter();
+
     // Flush all loggers
     for (auto& logger : g_loggers) {
         if (logger) {
@@ -136,10 +306,25 @@ void ShutdownLogging() {
     for (auto& logger : g_loggers) {
         logger.reset();
     }
+    for (auto& level : detail::g_category_levels) {
+        level.store(spdlog::level::trace, std::memory_order_relaxed);
+    }
     g_sinks.clear();
     g_initialized = false;
 }
 
+void FlushLogging() {
+    if (!g_initialized) return;
+    if (detail::g_async_logging.load(std::memory_order_relaxed)) {
+        DrainAsync();
+    }
+    for (auto& logger : g_loggers) {
+        if (logger) {
+            logger->flush();
+        }
+    }
+}
+
 std::shared_ptr<spdlog::logger> GetLogger(LogCategory category) {
     if (!g_initialized) {
         InitLogging();
@@ -154,13 +339,15 @@ std::shared_ptr<spdlog::logger> GetLogger() {
 void SetCategoryLevel(LogCategory category, spdlog::level::level_enum level) {
     if (auto logger = g_loggers[static_cast<size_t>(category)]) {
         logger->set_level(level);
+        PublishLevel(category, level);
     }
 }
 
 void SetAllLevels(spdlog::level::level_enum level) {
-    for (auto& logger : g_loggers) {
-        if (logger) {
-            logger->set_level(level);
+    for (size_t i = 0; i < g_loggers.size(); ++i) {
+        if (g_loggers[i]) {
+            g_loggers[i]->set_level(level);
+            PublishLevel(static_cast<LogCategory>(i), level);
         }
     }
 }
@@ -10,6 +10,7 @@
  */
 
 #include <rex/memory/utils.h>
+#include <rex/cpu_features.h>
 #include <rex/platform.h>
 #include <rex/cvar.h>
 
@@ -23,6 +24,9 @@ REXCVAR_DEFINE_BOOL(writable_executable_memory, true,
 #endif
 
 #include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <initializer_list>
 
 namespace rex {
 namespace memory {
@@ -31,14 +35,10 @@ bool IsWritableExecutableMemoryPreferred() {
   return REXCVAR_GET(writable_executable_memory);
 }
 
-// TODO(benvanik): fancy AVX versions.
+// Based on the volk byteswap kernels:
 // https://github.com/gnuradio/volk/blob/master/kernels/volk/volk_16u_byteswap.h
 // https://github.com/gnuradio/volk/blob/master/kernels/volk/volk_32u_byteswap.h
 // https://github.com/gnuradio/volk/blob/master/kernels/volk/volk_64u_byteswap.h
-// Original links:
-// https://gnuradio.org/redmine/projects/gnuradio/repository/revisions/cb32b70b79f430456208a2cd521d028e0ece5d5b/entry/volk/kernels/volk/volk_16u_byteswap.h
-// https://gnuradio.org/redmine/projects/gnuradio/repository/revisions/f2bc76cc65ffba51a141950f98e75364e49df874/entry/volk/kernels/volk/volk_32u_byteswap.h
-// https://gnuradio.org/redmine/projects/gnuradio/repository/revisions/2c4c371885c31222362f70a1cd714415d1398021/entry/volk/kernels/volk/volk_64u_byteswap.h
 
 void copy_128_aligned(void* dest, const void* src, size_t count) {
   std::memcpy(dest, src, count * 16);
@@ -46,180 +46,265 @@ void copy_128_aligned(void* dest, const void* src, size_t count) {
 
 #if REX_ARCH_AMD64
 
-// This works around a GCC bug
-// https://gcc.gnu.org/bugzilla/show_bug.cgi?id=100801
-// TODO(Joel Linn): Remove this when fixed GCC versions are common place.
-#if REX_COMPILER_GNUC
-#define REX_WORKAROUND_CONSTANT_RETURN_IF(x) \
-  if (__builtin_constant_p(x) && (x)) return;
+// Every copy_and_swap variant is a fixed byte permutation within each
+// element, so one pshufb kernel per vector width covers all of them. The
+// widest kernel the CPU (and OS) supports is picked on first use.
+
+#if REX_COMPILER_MSVC
+#define REX_TARGET_SSSE3
+#define REX_TARGET_AVX2
+#define REX_TARGET_AVX512
 #else
-#define REX_WORKAROUND_CONSTANT_RETURN_IF(x)
+#define REX_TARGET_SSSE3 __attribute__((target("ssse3")))
+#define REX_TARGET_AVX2 __attribute__((target("avx2")))
+#define REX_TARGET_AVX512 __attribute__((target("avx512f,avx512bw,bmi2")))
 #endif
-void copy_and_swap_16_aligned(void* dest_ptr, const void* src_ptr,
-                              size_t count) {
-  assert_zero(reinterpret_cast<uintptr_t>(dest_ptr) & 0xF);
-  assert_zero(reinterpret_cast<uintptr_t>(src_ptr) & 0xF);
 
-  auto dest = reinterpret_cast<uint16_t*>(dest_ptr);
-  auto src = reinterpret_cast<const uint16_t*>(src_ptr);
+namespace {
+
+// pshufb control for one 16-byte lane, plus the element size it repeats at.
+struct SwapPattern {
+  alignas(16) uint8_t lane[16];
+  size_t element_size;
+};
+
+constexpr SwapPattern MakeSwapPattern(std::initializer_list<uint8_t> element) {
+  SwapPattern pattern{};
+  pattern.element_size = element.size();
+  for (size_t i = 0; i < 16; ++i) {
+    pattern.lane[i] =
+        uint8_t(i - i % element.size() + element.begin()[i % element.size()]);
+  }
+  return pattern;
+}
+
+constexpr SwapPattern kSwap16 = MakeSwapPattern({1, 0});
+constexpr SwapPattern kSwap32 = MakeSwapPattern({3, 2, 1, 0});
+constexpr SwapPattern kSwap64 = MakeSwapPattern({7, 6, 5, 4, 3, 2, 1, 0});
+constexpr SwapPattern kSwap16In32 = MakeSwapPattern({2, 3, 0, 1});
+
+// Residual bytes; `size` is a whole number of elements. Each element is read
+// whole before it is written so dest may equal src.
+void CopyAndSwapTail(uint8_t* dest, const uint8_t* src, size_t size,
+                     const SwapPattern& pattern) {
+  uint8_t element[8];
+  for (size_t i = 0; i < size; i += pattern.element_size) {
+    std::memcpy(element, src + i, pattern.element_size);
+    for (size_t j = 0; j < pattern.element_size; ++j) {
+      dest[i + j] = element[pattern.lane[j]];
+    }
+  }
+}
+
+REX_TARGET_SSSE3 void CopyAndSwapSSSE3(uint8_t* dest, const uint8_t* src,
+                                       size_t size,
+                                       const SwapPattern& pattern) {
   __m128i shufmask =
-      _mm_set_epi8(0x0E, 0x0F, 0x0C, 0x0D, 0x0A, 0x0B, 0x08, 0x09, 0x06, 0x07,
-                   0x04, 0x05, 0x02, 0x03, 0x00, 0x01);
+      _mm_load_si128(reinterpret_cast<const __m128i*>(pattern.lane));
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i),
+                     _mm_shuffle_epi8(input, shufmask));
+  }
+  CopyAndSwapTail(dest + i, src + i, size - i, pattern);
+}
 
+REX_TARGET_AVX2 void CopyAndSwapAVX2(uint8_t* dest, const uint8_t* src,
+                                     size_t size, const SwapPattern& pattern) {
+  __m128i lane = _mm_load_si128(reinterpret_cast<const __m128i*>(pattern.lane));
+  __m256i shufmask = _mm256_broadcastsi128_si256(lane);
   size_t i = 0;
-  for (i = 0; i + 8 <= count; i += 8) {
-    __m128i input = _mm_load_si128(reinterpret_cast<const __m128i*>(&src[i]));
-    __m128i output = _mm_shuffle_epi8(input, shufmask);
-    _mm_store_si128(reinterpret_cast<__m128i*>(&dest[i]), output);
+  for (; i + 64 <= size; i += 64) {
+    __m256i input0 =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    __m256i input1 =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 32));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + i),
+                        _mm256_shuffle_epi8(input0, shufmask));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + i + 32),
+                        _mm256_shuffle_epi8(input1, shufmask));
   }
-  REX_WORKAROUND_CONSTANT_RETURN_IF(count % 8 == 0);
-  for (; i < count; ++i) {  // handle residual elements
-    dest[i] = byte_swap(src[i]);
+  if (i + 32 <= size) {
+    __m256i input =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + i),
+                        _mm256_shuffle_epi8(input, shufmask));
+    i += 32;
   }
+  if (i + 16 <= size) {
+    __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i),
+                     _mm_shuffle_epi8(input, lane));
+    i += 16;
+  }
+  CopyAndSwapTail(dest + i, src + i, size - i, pattern);
 }
 
-void copy_and_swap_16_unaligned(void* dest_ptr, const void* src_ptr,
-                                size_t count) {
-  auto dest = reinterpret_cast<uint16_t*>(dest_ptr);
-  auto src = reinterpret_cast<const uint16_t*>(src_ptr);
-  __m128i shufmask =
-      _mm_set_epi8(0x0E, 0x0F, 0x0C, 0x0D, 0x0A, 0x0B, 0x08, 0x09, 0x06, 0x07,
-                   0x04, 0x05, 0x02, 0x03, 0x00, 0x01);
-
-  size_t i;
-  for (i = 0; i + 8 <= count; i += 8) {
-    __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&src[i]));
-    __m128i output = _mm_shuffle_epi8(input, shufmask);
-    _mm_storeu_si128(reinterpret_cast<__m128i*>(&dest[i]), output);
+REX_TARGET_AVX512 void CopyAndSwapAVX512(uint8_t* dest, const uint8_t* src,
+                                         size_t size,
+                                         const SwapPattern& pattern) {
+  __m512i shufmask = _mm512_broadcast_i32x4(
+      _mm_load_si128(reinterpret_cast<const __m128i*>(pattern.lane)));
+  size_t i = 0;
+  for (; i + 64 <= size; i += 64) {
+    __m512i input = _mm512_loadu_si512(src + i);
+    _mm512_storeu_si512(dest + i, _mm512_shuffle_epi8(input, shufmask));
   }
-  REX_WORKAROUND_CONSTANT_RETURN_IF(count % 8 == 0);
-  for (; i < count; ++i) {  // handle residual elements
-    dest[i] = byte_swap(src[i]);
+  if (i < size) {
+    // Masked tail: no scalar loop, and no access past the end.
+    __mmask64 mask = _bzhi_u64(~uint64_t(0), unsigned(size - i));
+    __m512i input = _mm512_maskz_loadu_epi8(mask, src + i);
+    _mm512_mask_storeu_epi8(dest + i, mask,
+                            _mm512_shuffle_epi8(input, shufmask));
   }
 }
 
-void copy_and_swap_32_aligned(void* dest_ptr, const void* src_ptr,
+using CopyAndSwapFn = void (*)(uint8_t* dest, const uint8_t* src, size_t size,
+                               const SwapPattern& pattern);
+
+void CopyAndSwapScalar(uint8_t* dest, const uint8_t* src, size_t size,
+                       const SwapPattern& pattern) {
+  CopyAndSwapTail(dest, src, size, pattern);
+}
+
+SwapKernel DetectSwapKernel() {
+  const CpuFeatures& cpu = GetCpuFeatures();
+  if (!cpu.ssse3) {
+    return SwapKernel::kScalar;
+  }
+  if (cpu.avx512f && cpu.avx512bw && cpu.bmi2) {
+    return SwapKernel::kAVX512;
+  }
+  if (cpu.avx2) {
+    return SwapKernel::kAVX2;
+  }
+  return SwapKernel::kSSSE3;
+}
+
+SwapKernel DetectedSwapKernel() {
+  static const SwapKernel kernel = DetectSwapKernel();
+  return kernel;
+}
+
+CopyAndSwapFn SwapKernelFn(SwapKernel kernel) {
+  switch (kernel) {
+    case SwapKernel::kAVX512:
+      return CopyAndSwapAVX512;
+    case SwapKernel::kAVX2:
+      return CopyAndSwapAVX2;
+    case SwapKernel::kSSSE3:
+      return CopyAndSwapSSSE3;
+    default:
+      return CopyAndSwapScalar;
+  }
+}
+
+void CopyAndSwapResolve(uint8_t* dest, const uint8_t* src, size_t size,
+                        const SwapPattern& pattern);
+
+// Constant-initialized so copies made during static initialization work.
+std::atomic<CopyAndSwapFn> copy_and_swap_fn_{CopyAndSwapResolve};
+
+void CopyAndSwapResolve(uint8_t* dest, const uint8_t* src, size_t size,
+                        const SwapPattern& pattern) {
+  CopyAndSwapFn fn = SwapKernelFn(DetectedSwapKernel());
+  CopyAndSwapFn expected = CopyAndSwapResolve;
+  copy_and_swap_fn_.compare_exchange_strong(expected, fn,
+                                            std::memory_order_relaxed);
+  fn(dest, src, size, pattern);
+}
+
+inline void CopyAndSwap(void* dest, const void* src, size_t size,
+                        const SwapPattern& pattern) {
+  copy_and_swap_fn_.load(std::memory_order_relaxed)(
+      static_cast<uint8_t*>(dest), static_cast<const uint8_t*>(src), size,
+      pattern);
+}
+
+}  // namespace
+
+bool IsSwapKernelSupported(SwapKernel kernel) {
+  return kernel != SwapKernel::kNEON && kernel <= DetectedSwapKernel();
+}
+
+SwapKernel GetSwapKernel() {
+  CopyAndSwapFn fn = copy_and_swap_fn_.load(std::memory_order_relaxed);
+  for (auto kernel : {SwapKernel::kAVX512, SwapKernel::kAVX2,
+                      SwapKernel::kSSSE3}) {
+    if (fn == SwapKernelFn(kernel)) {
+      return kernel;
+    }
+  }
+  return fn == CopyAndSwapResolve ? DetectedSwapKernel() : SwapKernel::kScalar;
+}
+
+bool SetSwapKernel(SwapKernel kernel) {
+  if (!IsSwapKernelSupported(kernel)) {
+    return false;
+  }
+  copy_and_swap_fn_.store(SwapKernelFn(kernel), std::memory_order_relaxed);
+  return true;
+}
+
+void copy_and_swap_16_aligned(void* dest_ptr, const void* src_ptr,
                               size_t count) {
   assert_zero(reinterpret_cast<uintptr_t>(dest_ptr) & 0xF);
   assert_zero(reinterpret_cast<uintptr_t>(src_ptr) & 0xF);
+  CopyAndSwap(dest_ptr, src_ptr, count * 2, kSwap16);
+}
 
-  auto dest = reinterpret_cast<uint32_t*>(dest_ptr);
-  auto src = reinterpret_cast<const uint32_t*>(src_ptr);
-  __m128i shufmask =
-      _mm_set_epi8(0x0C, 0x0D, 0x0E, 0x0F, 0x08, 0x09, 0x0A, 0x0B, 0x04, 0x05,
-                   0x06, 0x07, 0x00, 0x01, 0x02, 0x03);
-
-  size_t i;
-  for (i = 0; i + 4 <= count; i += 4) {
-    __m128i input = _mm_load_si128(reinterpret_cast<const __m128i*>(&src[i]));
-    __m128i output = _mm_shuffle_epi8(input, shufmask);
-    _mm_store_si128(reinterpret_cast<__m128i*>(&dest[i]), output);
-  }
-  REX_WORKAROUND_CONSTANT_RETURN_IF(count % 4 == 0);
-  for (; i < count; ++i) {  // handle residual elements
-    dest[i] = byte_swap(src[i]);
-  }
+void copy_and_swap_16_unaligned(void* dest_ptr, const void* src_ptr,
+                                size_t count) {
+  CopyAndSwap(dest_ptr, src_ptr, count * 2, kSwap16);
+}
+
+void copy_and_swap_32_aligned(void* dest_ptr, const void* src_ptr,
+                              size_t count) {
+  assert_zero(reinterpret_cast<uintptr_t>(dest_ptr) & 0xF);
+  assert_zero(reinterpret_cast<uintptr_t>(src_ptr) & 0xF);
+  CopyAndSwap(dest_ptr, src_ptr, count * 4, kSwap32);
 }
 
 void copy_and_swap_32_unaligned(void* dest_ptr, const void* src_ptr,
                                 size_t count) {
-  auto dest = reinterpret_cast<uint32_t*>(dest_ptr);
-  auto src = reinterpret_cast<const uint32_t*>(src_ptr);
-  __m128i shufmask =
-      _mm_set_epi8(0x0C, 0x0D, 0x0E, 0x0F, 0x08, 0x09, 0x0A, 0x0B, 0x04, 0x05,
-                   0x06, 0x07, 0x00, 0x01, 0x02, 0x03);
-
-  size_t i;
-  for (i = 0; i + 4 <= count; i += 4) {
-    __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&src[i]));
-    __m128i output = _mm_shuffle_epi8(input, shufmask);
-    _mm_storeu_si128(reinterpret_cast<__m128i*>(&dest[i]), output);
-  }
-  REX_WORKAROUND_CONSTANT_RETURN_IF(count % 4 == 0);
-  for (; i < count; ++i) {  // handle residual elements
-    dest[i] = byte_swap(src[i]);
-  }
+  CopyAndSwap(dest_ptr, src_ptr, count * 4, kSwap32);
 }
 
 void copy_and_swap_64_aligned(void* dest_ptr, const void* src_ptr,
                               size_t count) {
   assert_zero(reinterpret_cast<uintptr_t>(dest_ptr) & 0xF);
   assert_zero(reinterpret_cast<uintptr_t>(src_ptr) & 0xF);
-
-  auto dest = reinterpret_cast<uint64_t*>(dest_ptr);
-  auto src = reinterpret_cast<const uint64_t*>(src_ptr);
-  __m128i shufmask =
-      _mm_set_epi8(0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x00, 0x01,
-                   0x02, 0x03, 0x04, 0x05, 0x06, 0x07);
-
-  size_t i;
-  for (i = 0; i + 2 <= count; i += 2) {
-    __m128i input = _mm_load_si128(reinterpret_cast<const __m128i*>(&src[i]));
-    __m128i output = _mm_shuffle_epi8(input, shufmask);
-    _mm_store_si128(reinterpret_cast<__m128i*>(&dest[i]), output);
-  }
-  REX_WORKAROUND_CONSTANT_RETURN_IF(count % 2 == 0);
-  for (; i < count; ++i) {  // handle residual elements
-    dest[i] = byte_swap(src[i]);
-  }
+  CopyAndSwap(dest_ptr, src_ptr, count * 8, kSwap64);
 }
 
 void copy_and_swap_64_unaligned(void* dest_ptr, const void* src_ptr,
                                 size_t count) {
-  auto dest = reinterpret_cast<uint64_t*>(dest_ptr);
-  auto src = reinterpret_cast<const uint64_t*>(src_ptr);
-  __m128i shufmask =
-      _mm_set_epi8(0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x00, 0x01,
-                   0x02, 0x03, 0x04, 0x05, 0x06, 0x07);
-
-  size_t i;
-  for (i = 0; i + 2 <= count; i += 2) {
-    __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&src[i]));
-    __m128i output = _mm_shuffle_epi8(input, shufmask);
-    _mm_storeu_si128(reinterpret_cast<__m128i*>(&dest[i]), output);
-  }
-  REX_WORKAROUND_CONSTANT_RETURN_IF(count % 2 == 0);
-  for (; i < count; ++i) {  // handle residual elements
-    dest[i] = byte_swap(src[i]);
-  }
+  CopyAndSwap(dest_ptr, src_ptr, count * 8, kSwap64);
 }
 
 void copy_and_swap_16_in_32_aligned(void* dest_ptr, const void* src_ptr,
                                     size_t count) {
-  auto dest = reinterpret_cast<uint32_t*>(dest_ptr);
-  auto src = reinterpret_cast<const uint32_t*>(src_ptr);
-  size_t i;
-  for (i = 0; i + 4 <= count; i += 4) {
-    __m128i input = _mm_load_si128(reinterpret_cast<const __m128i*>(&src[i]));
-    __m128i output =
-        _mm_or_si128(_mm_slli_epi32(input, 16), _mm_srli_epi32(input, 16));
-    _mm_store_si128(reinterpret_cast<__m128i*>(&dest[i]), output);
-  }
-  REX_WORKAROUND_CONSTANT_RETURN_IF(count % 4 == 0);
-  for (; i < count; ++i) {  // handle residual elements
-    dest[i] = (src[i] >> 16) | (src[i] << 16);
-  }
+  CopyAndSwap(dest_ptr, src_ptr, count * 4, kSwap16In32);
 }
 
 void copy_and_swap_16_in_32_unaligned(void* dest_ptr, const void* src_ptr,
                                       size_t count) {
-  auto dest = reinterpret_cast<uint32_t*>(dest_ptr);
-  auto src = reinterpret_cast<const uint32_t*>(src_ptr);
-  size_t i;
-  for (i = 0; i + 4 <= count; i += 4) {
-    __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&src[i]));
-    __m128i output =
-        _mm_or_si128(_mm_slli_epi32(input, 16), _mm_srli_epi32(input, 16));
-    _mm_storeu_si128(reinterpret_cast<__m128i*>(&dest[i]), output);
-  }
-  REX_WORKAROUND_CONSTANT_RETURN_IF(count % 4 == 0);
-  for (; i < count; ++i) {  // handle residual elements
-    dest[i] = (src[i] >> 16) | (src[i] << 16);
-  }
+  CopyAndSwap(dest_ptr, src_ptr, count * 4, kSwap16In32);
 }
 
 #elif REX_ARCH_ARM64
 
+// NEON is part of the AArch64 baseline, so there is nothing to dispatch and
+// no scalar kernel to pin.
+bool IsSwapKernelSupported(SwapKernel kernel) {
+  return kernel == SwapKernel::kNEON;
+}
+
+SwapKernel GetSwapKernel() { return SwapKernel::kNEON; }
+
+bool SetSwapKernel(SwapKernel kernel) { return kernel == SwapKernel::kNEON; }
+
 // Although NEON offers vector rev instructions (like vrev32q_u8), they are
 // slower in benchmarks. Also, using uint8x16xN_t wasn't any faster in the
 // benchmarks, hence we use just use one SIMD register to minimize residual
@@ -330,20 +415,43 @@ void copy_and_swap_16_in_32_aligned(void* dst, const void* src, size_t count) {
 
 void copy_and_swap_16_in_32_unaligned(void* dst_ptr, const void* src_ptr,
                                       size_t count) {
-  auto dst = reinterpret_cast<uint16_t*>(dst_ptr);
-  auto src = reinterpret_cast<const uint16_t*>(src_ptr);
+  auto dst = reinterpret_cast<uint8_t*>(dst_ptr);
+  auto src = reinterpret_cast<const uint8_t*>(src_ptr);
+
+  const uint8x16_t tbl_idx =
+      vcombine_u8(vcreate_u8(UINT64_C(0x0504070601000302)),
+                  vcreate_u8(UINT64_C(0x0D0C0F0E09080B0A)));
+
+  while (count >= 4) {
+    uint8x16_t data = vld1q_u8(src);
+    data = vqtbl1q_u8(data, tbl_idx);
+    vst1q_u8(dst, data);
+
+    count -= 4;
+    dst += 16;
+    src += 16;
+  }
+
   while (count > 0) {
-    uint16_t word0 = *src++;
-    uint16_t word1 = *src++;
-    *dst++ = word1;
-    *dst++ = word0;
+    uint32_t value = load<uint32_t>(src);
+    store<uint32_t>(dst, (value >> 16) | (value << 16));
 
     count--;
+    dst += 4;
+    src += 4;
   }
 }
 
 #else
 
+bool IsSwapKernelSupported(SwapKernel kernel) {
+  return kernel == SwapKernel::kScalar;
+}
+
+SwapKernel GetSwapKernel() { return SwapKernel::kScalar; }
+
+bool SetSwapKernel(SwapKernel kernel) { return kernel == SwapKernel::kScalar; }
+
 // Generic routines.
 void copy_and_swap_16_aligned(void* dest, const void* src, size_t count) {
   return copy_and_swap_16_unaligned(dest, src, count);
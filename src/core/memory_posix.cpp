@@ -26,6 +26,51 @@
 #include <rex/platform.h>
 #include <rex/string.h>
 
+#if REX_PLATFORM_LINUX
+#include <linux/userfaultfd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+
+// Newer than some distributions' kernel headers - the values are kernel ABI.
+#ifndef UFFD_USER_MODE_ONLY
+#define UFFD_USER_MODE_ONLY 1
+#endif
+#ifndef UFFD_FEATURE_WP_HUGETLBFS_SHMEM
+#define UFFD_FEATURE_WP_HUGETLBFS_SHMEM (1 << 12)
+#endif
+#ifndef UFFD_FEATURE_WP_UNPOPULATED
+#define UFFD_FEATURE_WP_UNPOPULATED (1 << 13)
+#endif
+#ifndef UFFD_FEATURE_WP_ASYNC
+#define UFFD_FEATURE_WP_ASYNC (1 << 15)
+#endif
+#ifndef PAGEMAP_SCAN
+struct page_region {
+  uint64_t start;
+  uint64_t end;
+  uint64_t categories;
+};
+struct pm_scan_arg {
+  uint64_t size;
+  uint64_t flags;
+  uint64_t start;
+  uint64_t end;
+  uint64_t walk_end;
+  uint64_t vec;
+  uint64_t vec_len;
+  uint64_t max_pages;
+  uint64_t category_inverted;
+  uint64_t category_mask;
+  uint64_t category_anyof_mask;
+  uint64_t return_mask;
+};
+#define PAGEMAP_SCAN _IOWR('f', 16, struct pm_scan_arg)
+#define PAGE_IS_WRITTEN (1 << 1)
+#define PM_SCAN_WP_MATCHING (1 << 0)
+#define PM_SCAN_CHECK_WPASYNC (1 << 1)
+#endif
+#endif  // REX_PLATFORM_LINUX
+
 #if REX_PLATFORM_ANDROID
 #include <dlfcn.h>
 #include <linux/ashmem.h>
@@ -411,5 +456,93 @@ bool UnmapFileView(FileMappingHandle handle, void* base_address,
   return munmap(base_address, length) == 0;
 }
 
+std::unique_ptr<WriteWatch> WriteWatch::Create() {
+  // User mode only is allowed for unprivileged processes by default.
+  int userfault_fd = int(syscall(SYS_userfaultfd,
+                                 O_CLOEXEC | O_NONBLOCK | UFFD_USER_MODE_ONLY));
+  if (userfault_fd < 0) {
+    return nullptr;
+  }
+  // Asynchronous write protection resolves write faults in the kernel, only
+  // clearing the protection bit, so nothing ever needs to read the
+  // userfaultfd. Guest memory is a shared memory mapping.
+  uffdio_api api = {};
+  api.api = UFFD_API;
+  api.features = UFFD_FEATURE_WP_ASYNC | UFFD_FEATURE_WP_HUGETLBFS_SHMEM |
+                 UFFD_FEATURE_WP_UNPOPULATED;
+  if (ioctl(userfault_fd, UFFDIO_API, &api) != 0) {
+    close(userfault_fd);
+    return nullptr;
+  }
+  int pagemap_fd = open("/proc/self/pagemap", O_RDONLY | O_CLOEXEC);
+  if (pagemap_fd < 0) {
+    close(userfault_fd);
+    return nullptr;
+  }
+  // PAGEMAP_SCAN is newer than asynchronous write protection - check for it
+  // with an empty scan.
+  pm_scan_arg scan = {};
+  scan.size = sizeof(scan);
+  if (ioctl(pagemap_fd, PAGEMAP_SCAN, &scan) < 0) {
+    close(pagemap_fd);
+    close(userfault_fd);
+    return nullptr;
+  }
+  return std::unique_ptr<WriteWatch>(new WriteWatch(userfault_fd, pagemap_fd));
+}
+
+WriteWatch::~WriteWatch() {
+  close(pagemap_fd_);
+  close(userfault_fd_);
+}
+
+bool WriteWatch::Register(void* base_address, size_t length) {
+  uffdio_register register_range = {};
+  register_range.range.start = uint64_t(base_address);
+  register_range.range.len = length;
+  register_range.mode = UFFDIO_REGISTER_MODE_WP;
+  return ioctl(userfault_fd_, UFFDIO_REGISTER, &register_range) == 0;
+}
+
+bool WriteWatch::Arm(void* base_address, size_t length) {
+  uffdio_writeprotect write_protect = {};
+  write_protect.range.start = uint64_t(base_address);
+  write_protect.range.len = length;
+  write_protect.mode = UFFDIO_WRITEPROTECT_MODE_WP;
+  return ioctl(userfault_fd_, UFFDIO_WRITEPROTECT, &write_protect) == 0;
+}
+
+bool WriteWatch::CollectWritten(
+    void* base_address, size_t length,
+    std::vector<std::pair<size_t, size_t>>& written_out) {
+  uint64_t base = uint64_t(base_address);
+  page_region regions[64];
+  pm_scan_arg scan = {};
+  scan.size = sizeof(scan);
+  // Written pages lose write protection - take them and protect them again.
+  scan.flags = PM_SCAN_WP_MATCHING | PM_SCAN_CHECK_WPASYNC;
+  scan.start = base;
+  scan.end = base + length;
+  scan.vec = uint64_t(regions);
+  scan.vec_len = rex::countof(regions);
+  scan.category_mask = PAGE_IS_WRITTEN;
+  scan.return_mask = PAGE_IS_WRITTEN;
+  while (true) {
+    int region_count = ioctl(pagemap_fd_, PAGEMAP_SCAN, &scan);
+    if (region_count < 0) {
+      return false;
+    }
+    for (int i = 0; i < region_count; ++i) {
+      written_out.emplace_back(size_t(regions[i].start - base),
+                               size_t(regions[i].end - regions[i].start));
+    }
+    // The walk stops early when out of regions.
+    if (scan.walk_end >= scan.end) {
+      return true;
+    }
+    scan.start = scan.walk_end;
+  }
+}
+
 }  // namespace memory
 }  // namespace rex
@@ -247,5 +247,15 @@ bool UnmapFileView(FileMappingHandle handle, void* base_address,
   return UnmapViewOfFile(base_address) ? true : false;
 }
 
+// MEM_WRITE_WATCH only works for VirtualAlloc memory, not file mapping views.
+std::unique_ptr<WriteWatch> WriteWatch::Create() { return nullptr; }
+WriteWatch::~WriteWatch() = default;
+bool WriteWatch::Register(void*, size_t) { return false; }
+bool WriteWatch::Arm(void*, size_t) { return false; }
+bool WriteWatch::CollectWritten(void*, size_t,
+                                std::vector<std::pair<size_t, size_t>>&) {
+  return false;
+}
+
 }  // namespace memory
 }  // namespace rex
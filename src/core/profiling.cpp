@@ -0,0 +1,398 @@
+/**
+ * @file        core/profiling.cpp
+ * @brief       Profiler ring buffers and Chrome trace event writer
+ *
+ * @copyright   Copyright (c) 2026 Tom Clay <tomc@tctechstuff.com>
+ *              All rights reserved.
+ *
+ * @license     BSD 3-Clause License
+ *              See LICENSE file in the project root for full license text.
+ */
+
+#include <rex/profiling.h>
+#include <rex/cvar.h>
+#include <rex/logging.h>
+#include <rex/thread.h>
+#include <rex/thread/spsc_ring.h>
+
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fmt/format.h>
+
+REXCVAR_DEFINE_BOOL(profiler, false, "Profiling",
+                    "Record CPU zones and counters to a Chrome trace event file");
+
+REXCVAR_DEFINE_STRING(profiler_output, "rex_profile.json", "Profiling",
+                      "Trace event file written while the profiler is enabled");
+
+REXCVAR_DEFINE_UINT32(profiler_thread_events, 65536, "Profiling",
+                      "Events buffered per thread; further events are dropped until the writer catches up")
+    .range(1024, 16777216)
+    .lifecycle(rex::cvar::Lifecycle::kRequiresRestart);
+
+namespace rex::debug {
+
+namespace {
+    struct Event {
+        enum class Type : uint32_t {
+            kZone,
+            kCounter,
+            kFrame,
+        };
+        Type type;
+        const char* category;
+        const char* name;
+        uint64_t timestamp_ns;
+        // Zone end time, counter value or frame number.
+        int64_t value;
+    };
+
+    // Written only by its thread, drained only by the writer.
+    class ThreadBuffer {
+     public:
+        ThreadBuffer(uint32_t thread_id, size_t capacity)
+            : thread_id_(thread_id), events_(capacity) {}
+
+        uint32_t thread_id() const { return thread_id_; }
+
+        void Push(const Event& event) {
+            if (!events_.TryPush(event)) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        template <typename Fn>
+        void Drain(Fn&& fn) {
+            events_.Drain(fn);
+        }
+
+        uint64_t size() const { return events_.size(); }
+
+        uint64_t TakeDropped() {
+            return dropped_.exchange(0, std::memory_order_relaxed);
+        }
+
+        void SetName(const char* name) {
+            std::lock_guard<std::mutex> lock(name_lock_);
+            name_ = name ? name : "";
+            name_dirty_ = true;
+        }
+        void MarkNameDirty() {
+            std::lock_guard<std::mutex> lock(name_lock_);
+            name_dirty_ = !name_.empty();
+        }
+        // Returns true and the name if it changed since the last call.
+        bool TakeName(std::string* out_name) {
+            std::lock_guard<std::mutex> lock(name_lock_);
+            if (!name_dirty_) {
+                return false;
+            }
+            name_dirty_ = false;
+            *out_name = name_;
+            return true;
+        }
+
+     private:
+        uint32_t thread_id_;
+        rex::thread::SpscRing<Event> events_;
+        std::atomic<uint64_t> dropped_{0};
+
+        std::mutex name_lock_;
+        std::string name_;
+        bool name_dirty_ = false;
+    };
+
+    // Guards the output file. Taken before g_buffers' own lock.
+    std::mutex g_lock;
+    rex::thread::ThreadRings<ThreadBuffer> g_buffers;
+    std::atomic<uint32_t> g_next_thread_id{1};
+    std::atomic<int64_t> g_frame{0};
+
+    // Counter values, updated without a lock. A name claims a slot of this
+    // open-addressed table on first use and keeps it. Names are compared by
+    // content so the same literal from different translation units shares a
+    // value.
+    struct CounterSlot {
+        std::atomic<const char*> name{nullptr};
+        std::atomic<int64_t> value{0};
+    };
+    constexpr size_t kMaxCounters = 1024;
+    CounterSlot g_counters[kMaxCounters];
+    std::atomic<bool> g_counters_full_warned{false};
+
+    FILE* g_file = nullptr;
+    bool g_first_event = true;
+    uint64_t g_start_ns = 0;
+    uint64_t g_dropped = 0;
+
+    std::mutex g_writer_lock;
+    std::condition_variable g_writer_cond;
+    bool g_writer_shutdown = false;
+    std::unique_ptr<rex::thread::Thread> g_writer_thread;
+
+    // Serializes set_enabled against itself.
+    std::mutex g_control_lock;
+
+    // Null while the thread's thread_local destructors run after its buffer
+    // was retired.
+    ThreadBuffer* GetThreadBuffer() {
+        return g_buffers.Get([] {
+            return std::make_unique<ThreadBuffer>(
+                g_next_thread_id.fetch_add(1, std::memory_order_relaxed),
+                REXCVAR_GET(profiler_thread_events));
+        });
+    }
+
+    void PushEvent(const Event& event) {
+        if (auto* buffer = GetThreadBuffer()) {
+            buffer->Push(event);
+        }
+    }
+
+    std::atomic<int64_t>* FindCounter(const char* name) {
+        size_t hash = std::hash<std::string_view>{}(name);
+        for (size_t i = 0; i < kMaxCounters; ++i) {
+            auto& slot = g_counters[(hash + i) & (kMaxCounters - 1)];
+            const char* slot_name = slot.name.load(std::memory_order_acquire);
+            // On failure slot_name is reloaded with whoever claimed it.
+            if (!slot_name && slot.name.compare_exchange_strong(
+                                  slot_name, name, std::memory_order_acq_rel)) {
+                return &slot.value;
+            }
+            if (slot_name == name || std::strcmp(slot_name, name) == 0) {
+                return &slot.value;
+            }
+        }
+        if (!g_counters_full_warned.exchange(true, std::memory_order_relaxed)) {
+            REXLOG_WARN("Profiler: more than {} counters; dropping {}", kMaxCounters, name);
+        }
+        return nullptr;
+    }
+
+    void AppendJsonString(std::string& out, std::string_view value) {
+        out.push_back('"');
+        for (char c : value) {
+            switch (c) {
+                case '"': out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        fmt::format_to(std::back_inserter(out), "\\u{:04x}", int(c));
+                    } else {
+                        out.push_back(c);
+                    }
+                    break;
+            }
+        }
+        out.push_back('"');
+    }
+
+    double ToMicroseconds(uint64_t timestamp_ns) {
+        return double(int64_t(timestamp_ns - g_start_ns)) / 1000.0;
+    }
+
+    void FormatEvent(std::string& out, uint32_t tid, const Event& event) {
+        out += g_first_event ? "\n" : ",\n";
+        g_first_event = false;
+        switch (event.type) {
+            case Event::Type::kZone:
+                out += "{\"name\":";
+                AppendJsonString(out, event.name);
+                out += ",\"cat\":";
+                AppendJsonString(out, event.category);
+                fmt::format_to(std::back_inserter(out),
+                               ",\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}",
+                               tid, ToMicroseconds(event.timestamp_ns),
+                               double(uint64_t(event.value) - event.timestamp_ns) / 1000.0);
+                break;
+            case Event::Type::kCounter:
+                out += "{\"name\":";
+                AppendJsonString(out, event.name);
+                fmt::format_to(std::back_inserter(out),
+                               ",\"ph\":\"C\",\"pid\":1,\"tid\":{},\"ts\":{:.3f},\"args\":{{\"value\":{}}}}}",
+                               tid, ToMicroseconds(event.timestamp_ns), event.value);
+                break;
+            case Event::Type::kFrame:
+                fmt::format_to(std::back_inserter(out),
+                               "{{\"name\":\"Frame\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":{},"
+                               "\"ts\":{:.3f},\"args\":{{\"frame\":{}}}}}",
+                               tid, ToMicroseconds(event.timestamp_ns), event.value);
+                break;
+        }
+    }
+
+    // Moves every buffered event to the file (or discards them when there is
+    // no file), and frees the buffers of threads that have ended.
+    void DrainAll() {
+        std::lock_guard<std::mutex> lock(g_lock);
+        std::string out;
+        std::string thread_name;
+        g_buffers.Drain([&](ThreadBuffer& buffer) {
+            uint32_t tid = buffer.thread_id();
+            if (g_file && buffer.TakeName(&thread_name)) {
+                out += g_first_event ? "\n" : ",\n";
+                g_first_event = false;
+                fmt::format_to(std::back_inserter(out),
+                               "{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},"
+                               "\"args\":{{\"name\":",
+                               tid);
+                AppendJsonString(out, thread_name);
+                out += "}}";
+            }
+            buffer.Drain([&](const Event& event) {
+                if (g_file) {
+                    FormatEvent(out, tid, event);
+                }
+            });
+            g_dropped += buffer.TakeDropped();
+            if (g_file && out.size() >= 1024 * 1024) {
+                fwrite(out.data(), 1, out.size(), g_file);
+                out.clear();
+            }
+        });
+        if (g_file && !out.empty()) {
+            fwrite(out.data(), 1, out.size(), g_file);
+        }
+    }
+
+    void WriterThread() {
+        std::unique_lock<std::mutex> lock(g_writer_lock);
+        while (!g_writer_shutdown) {
+            g_writer_cond.wait_for(lock, std::chrono::milliseconds(100));
+            lock.unlock();
+            DrainAll();
+            lock.lock();
+        }
+    }
+}  // namespace
+
+void Profiler::Initialize() {
+    set_enabled(REXCVAR_GET(profiler));
+    rex::cvar::RegisterChangeCallback("profiler", [](std::string_view, std::string_view value) {
+        set_enabled(value == "true" || value == "1");
+    });
+}
+
+void Profiler::Shutdown() {
+    set_enabled(false);
+}
+
+void Profiler::set_enabled(bool enabled) {
+    std::lock_guard<std::mutex> control_lock(g_control_lock);
+    if (enabled == (g_writer_thread != nullptr)) {
+        return;
+    }
+
+    if (enabled) {
+        // Throw away anything left from an earlier session.
+        DrainAll();
+
+        std::string path = REXCVAR_GET(profiler_output);
+        FILE* file = std::fopen(path.c_str(), "wb");
+        if (!file) {
+            REXLOG_ERROR("Profiler: failed to open {}", path);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(g_lock);
+            g_file = file;
+            g_first_event = true;
+            g_dropped = 0;
+            g_start_ns = Now();
+            fputs("[", g_file);
+            // Thread names are written again for the new file.
+            g_buffers.ForEach([](ThreadBuffer& buffer) { buffer.MarkNameDirty(); });
+        }
+
+        g_writer_shutdown = false;
+        g_writer_thread = rex::thread::Thread::Create({}, WriterThread);
+        g_writer_thread->set_name("Profiler Writer");
+        enabled_.store(true, std::memory_order_relaxed);
+        REXLOG_INFO("Profiler: recording to {}", path);
+    } else {
+        enabled_.store(false, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(g_writer_lock);
+            g_writer_shutdown = true;
+        }
+        g_writer_cond.notify_all();
+        rex::thread::Wait(g_writer_thread.get(), false);
+        g_writer_thread.reset();
+
+        DrainAll();
+        std::lock_guard<std::mutex> lock(g_lock);
+        fputs("\n]\n", g_file);
+        fclose(g_file);
+        g_file = nullptr;
+        if (g_dropped) {
+            REXLOG_WARN("Profiler: dropped {} events; raise profiler_thread_events", g_dropped);
+        }
+    }
+}
+
+void Profiler::ThreadEnter(const char* name) {
+    if (auto* buffer = GetThreadBuffer()) {
+        buffer->SetName(name);
+    }
+}
+
+void Profiler::ThreadExit() {
+    g_buffers.Retire();
+}
+
+void Profiler::Flip() {
+    int64_t frame = g_frame.fetch_add(1, std::memory_order_relaxed);
+    if (is_enabled()) {
+        PushEvent({Event::Type::kFrame, nullptr, nullptr, Now(), frame});
+    }
+}
+
+void Profiler::Flush() {
+    if (!is_enabled()) {
+        return;
+    }
+    DrainAll();
+    std::lock_guard<std::mutex> lock(g_lock);
+    if (g_file) {
+        fflush(g_file);
+    }
+}
+
+uint64_t Profiler::pending_events() {
+    uint64_t count = 0;
+    g_buffers.ForEach([&](ThreadBuffer& buffer) { count += buffer.size(); });
+    return count;
+}
+
+void Profiler::RecordZone(const char* category, const char* name,
+                          uint64_t start_ns, uint64_t end_ns) {
+    PushEvent({Event::Type::kZone, category, name, start_ns, int64_t(end_ns)});
+}
+
+void Profiler::SetCounter(const char* name, int64_t value) {
+    auto* counter = FindCounter(name);
+    if (!counter) {
+        return;
+    }
+    counter->store(value, std::memory_order_relaxed);
+    PushEvent({Event::Type::kCounter, nullptr, name, Now(), value});
+}
+
+void Profiler::AddCounter(const char* name, int64_t delta) {
+    auto* counter = FindCounter(name);
+    if (!counter) {
+        return;
+    }
+    int64_t value = counter->fetch_add(delta, std::memory_order_relaxed) + delta;
+    PushEvent({Event::Type::kCounter, nullptr, name, Now(), value});
+}
+
+}  // namespace rex::debug
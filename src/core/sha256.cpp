@@ -1,22 +1,38 @@
 /**
  * SHA256 hashing utilities implementation
  *
- * Uses picosha2 header-only library for SHA256 computation.
+ * Hex-string wrappers over rex::crypto::Sha256.
  */
 
 #include <rex/sha256.h>
 
-#include <fstream>
-#include <sstream>
+#include <rex/crypto.h>
 
-#include "thirdparty/picosha2/picosha2.h"
+#include <fstream>
 
 namespace rex::util {
 
+namespace {
+
+std::string HexDigest(crypto::Sha256& hash) {
+    static constexpr char kHex[] = "0123456789abcdef";
+    uint8_t digest[crypto::Sha256::kDigestSize];
+    hash.Final(digest);
+    std::string hex;
+    hex.reserve(sizeof(digest) * 2);
+    for (uint8_t byte : digest) {
+        hex.push_back(kHex[byte >> 4]);
+        hex.push_back(kHex[byte & 0xF]);
+    }
+    return hex;
+}
+
+}  // namespace
+
 std::string sha256(std::string_view data) {
-    std::string hash_hex;
-    picosha2::hash256_hex_string(data.begin(), data.end(), hash_hex);
-    return hash_hex;
+    crypto::Sha256 hash;
+    hash.Update(data.data(), data.size());
+    return HexDigest(hash);
 }
 
 std::string sha256_file(const std::filesystem::path& path) {
@@ -24,9 +40,12 @@ std::string sha256_file(const std::filesystem::path& path) {
     if (!file) {
         return "";
     }
-    std::ostringstream ss;
-    ss << file.rdbuf();
-    return sha256(ss.str());
+    crypto::Sha256 hash;
+    char chunk[64 * 1024];
+    while (file.read(chunk, sizeof(chunk)) || file.gcount() > 0) {
+        hash.Update(chunk, size_t(file.gcount()));
+    }
+    return HexDigest(hash);
 }
 
 }  // namespace rex::util
@@ -33,11 +33,15 @@ typedef HANDLE (*SetThreadDescriptionFn)(HANDLE hThread,
 #include <sched.h>
 #include <signal.h>
 #include <sys/eventfd.h>
+#if REX_PLATFORM_LINUX
+#include <sys/prctl.h>
+#endif
 #include <sys/syscall.h>
 #include <sys/time.h>
 #include <sys/types.h>
 #include <unistd.h>
 #include <array>
+#include <csignal>
 #include <cstddef>
 #include <ctime>
 #include <memory>
@@ -163,20 +167,116 @@ void MaybeYield() {
 
 void SyncMemory() { MemoryBarrier(); }
 
+namespace {
+
+// PreciseSleepUntil asks the high-resolution waitable timer to fire this much
+// before the deadline and spins off the remainder.
+constexpr auto kPreciseSpinMargin = std::chrono::microseconds(500);
+
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+HANDLE CreateHighResolutionTimer(bool manual_reset) {
+  DWORD flags = manual_reset ? CREATE_WAITABLE_TIMER_MANUAL_RESET : 0;
+  HANDLE handle = CreateWaitableTimerExW(
+      nullptr, nullptr, flags | CREATE_WAITABLE_TIMER_HIGH_RESOLUTION,
+      TIMER_ALL_ACCESS);
+  if (!handle) {
+    // Pre-1803 Windows: fall back to a regular waitable timer.
+    handle = CreateWaitableTimerExW(nullptr, nullptr, flags, TIMER_ALL_ACCESS);
+  }
+  return handle;
+}
+
+HANDLE GetSleepTimer() {
+  struct SleepTimer {
+    SleepTimer() { handle = CreateHighResolutionTimer(false); }
+    ~SleepTimer() {
+      if (handle) {
+        CloseHandle(handle);
+      }
+    }
+    HANDLE handle;
+  };
+  thread_local SleepTimer timer;
+  return timer.handle;
+}
+
+// Waits until spin_margin before the deadline, then spins to it. Returns false
+// if an APC was delivered while waiting.
+bool SleepUntilImpl(std::chrono::steady_clock::time_point deadline,
+                    bool alertable, std::chrono::microseconds spin_margin) {
+  using std::chrono::steady_clock;
+  auto now = steady_clock::now();
+  if (deadline - now <= spin_margin) {
+    // Still give pending APCs their chance, as SleepEx(0, TRUE) would.
+    if (alertable && SleepEx(0, TRUE) == WAIT_IO_COMPLETION) {
+      return false;
+    }
+  }
+  while (deadline - now > spin_margin) {
+    auto wake = deadline - spin_margin;
+    HANDLE timer = GetSleepTimer();
+    LARGE_INTEGER due_time;
+    // Negative values are relative, in 100ns units.
+    due_time.QuadPart =
+        -std::chrono::ceil<rex::chrono::hundrednanoseconds>(wake - now)
+             .count();
+    DWORD result;
+    if (timer &&
+        SetWaitableTimer(timer, &due_time, 0, nullptr, nullptr, FALSE)) {
+      result = WaitForSingleObjectEx(timer, INFINITE, alertable);
+    } else {
+      auto remaining = std::chrono::ceil<std::chrono::milliseconds>(wake - now);
+      result = SleepEx(static_cast<DWORD>(remaining.count()), alertable);
+    }
+    if (result == WAIT_IO_COMPLETION) {
+      return false;
+    }
+    now = steady_clock::now();
+  }
+  while (now < deadline) {
+    YieldProcessor();
+    now = steady_clock::now();
+  }
+  return true;
+}
+
+}  // namespace
+
 void Sleep(std::chrono::microseconds duration) {
-  if (duration.count() < 100) {
+  if (duration <= std::chrono::microseconds::zero()) {
     MaybeYield();
-  } else {
-    ::Sleep(static_cast<DWORD>(duration.count() / 1000));
+    return;
   }
+  SleepUntil(std::chrono::steady_clock::now() + duration);
+}
+
+void SleepUntil(std::chrono::steady_clock::time_point deadline) {
+  SleepUntilImpl(deadline, false, std::chrono::microseconds::zero());
 }
 
 SleepResult AlertableSleep(std::chrono::microseconds duration) {
-  if (SleepEx(static_cast<DWORD>(duration.count() / 1000), TRUE) ==
-      WAIT_IO_COMPLETION) {
-    return SleepResult::kAlerted;
-  }
-  return SleepResult::kSuccess;
+  return AlertableSleepUntil(std::chrono::steady_clock::now() + duration);
+}
+
+SleepResult AlertableSleepUntil(
+    std::chrono::steady_clock::time_point deadline) {
+  return SleepUntilImpl(deadline, true, std::chrono::microseconds::zero())
+             ? SleepResult::kSuccess
+             : SleepResult::kAlerted;
+}
+
+void PreciseSleepUntil(std::chrono::steady_clock::time_point deadline) {
+  SleepUntilImpl(deadline, false, kPreciseSpinMargin);
+}
+
+SleepResult AlertablePreciseSleepUntil(
+    std::chrono::steady_clock::time_point deadline) {
+  return SleepUntilImpl(deadline, true, kPreciseSpinMargin)
+             ? SleepResult::kSuccess
+             : SleepResult::kAlerted;
 }
 
 TlsHandle AllocateTlsHandle() { return TlsAlloc(); }
@@ -437,7 +537,7 @@ class Win32Timer : public Win32Handle<Timer> {
 };
 
 std::unique_ptr<Timer> Timer::CreateManualResetTimer() {
-  HANDLE handle = CreateWaitableTimer(NULL, TRUE, NULL);
+  HANDLE handle = CreateHighResolutionTimer(true);
   if (handle) {
     return std::make_unique<Win32Timer>(handle);
   } else {
@@ -447,7 +547,7 @@ std::unique_ptr<Timer> Timer::CreateManualResetTimer() {
 }
 
 std::unique_ptr<Timer> Timer::CreateSynchronizationTimer() {
-  HANDLE handle = CreateWaitableTimer(NULL, FALSE, NULL);
+  HANDLE handle = CreateHighResolutionTimer(false);
   if (handle) {
     return std::make_unique<Win32Timer>(handle);
   } else {
@@ -677,27 +777,116 @@ void MaybeYield() {
 
 void SyncMemory() { __sync_synchronize(); }
 
-void Sleep(std::chrono::microseconds duration) {
-  timespec rqtp = DurationToTimeSpec(duration);
-  timespec rmtp = {};
-  auto p_rqtp = &rqtp;
-  auto p_rmtp = &rmtp;
-  int ret = 0;
-  do {
-    ret = nanosleep(p_rqtp, p_rmtp);
-    // Swap requested for remaining in case of signal interruption
-    // in which case, we start sleeping again for the remainder
-    std::swap(p_rqtp, p_rmtp);
-  } while (ret == -1 && errno == EINTR);
-}
-
-// TODO(bwrsandman) Implement by allowing alert interrupts from IO operations
+namespace {
+
+// PreciseSleepUntil asks clock_nanosleep() to wake this much before the
+// deadline and spins off the remainder, so wake-ups land within a few
+// microseconds of the deadline instead of a timer-slack period after it.
+constexpr auto kPreciseSpinMargin = std::chrono::microseconds(50);
+
+// Returns false if the sleep was interrupted by a signal.
+bool NanosleepUntil(std::chrono::steady_clock::time_point deadline) {
+#if REX_PLATFORM_LINUX
+  // steady_clock is CLOCK_MONOTONIC, so its epoch can be used directly.
+  timespec rqtp = DurationToTimeSpec(deadline.time_since_epoch());
+  return clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &rqtp, nullptr) !=
+         EINTR;
+#else
+  auto remaining = deadline - std::chrono::steady_clock::now();
+  if (remaining <= std::chrono::steady_clock::duration::zero()) {
+    return true;
+  }
+  timespec rqtp = DurationToTimeSpec(remaining);
+  return nanosleep(&rqtp, nullptr) == 0 || errno != EINTR;
+#endif
+}
+
 thread_local bool alertable_state_ = false;
-SleepResult AlertableSleep(std::chrono::microseconds duration) {
+// Set by the signal handler when it dispatches a user callback.
+thread_local volatile std::sig_atomic_t alerted_ = 0;
+
+// Sleeps until spin_margin before the deadline, then spins to it. Returns
+// false if the thread was alerted while alertable_state_ was set.
+bool SleepUntilImpl(std::chrono::steady_clock::time_point deadline,
+                    std::chrono::microseconds spin_margin) {
+  using std::chrono::steady_clock;
+#if REX_PLATFORM_LINUX
+  if (spin_margin > std::chrono::microseconds::zero()) {
+    // The default 50us timer slack would swallow the whole spin margin.
+    thread_local bool timer_slack_reduced = false;
+    if (!timer_slack_reduced) {
+      prctl(PR_SET_TIMERSLACK, 1UL, 0UL, 0UL, 0UL);
+      timer_slack_reduced = true;
+    }
+  }
+#endif
+  while (true) {
+    auto now = steady_clock::now();
+    if (now >= deadline) {
+      return true;
+    }
+    if (deadline - now > spin_margin) {
+      if (!NanosleepUntil(deadline - spin_margin) && alerted_) {
+        return false;
+      }
+      continue;
+    }
+    // Spin out the tail. The pause keeps the sibling hyperthread usable.
+    while (steady_clock::now() < deadline) {
+      if (alerted_) {
+        return false;
+      }
+#if REX_ARCH_AMD64
+      _mm_pause();
+#elif REX_ARCH_ARM64
+      __asm__ volatile("yield");
+#endif
+    }
+    return true;
+  }
+}
+
+SleepResult AlertableSleepUntilImpl(
+    std::chrono::steady_clock::time_point deadline,
+    std::chrono::microseconds spin_margin) {
+  alerted_ = 0;
   alertable_state_ = true;
-  Sleep(duration);
+  bool completed = SleepUntilImpl(deadline, spin_margin);
   alertable_state_ = false;
-  return SleepResult::kSuccess;
+  alerted_ = 0;
+  return completed ? SleepResult::kSuccess : SleepResult::kAlerted;
+}
+
+}  // namespace
+
+void Sleep(std::chrono::microseconds duration) {
+  if (duration <= std::chrono::microseconds::zero()) {
+    MaybeYield();
+    return;
+  }
+  SleepUntil(std::chrono::steady_clock::now() + duration);
+}
+
+void SleepUntil(std::chrono::steady_clock::time_point deadline) {
+  SleepUntilImpl(deadline, std::chrono::microseconds::zero());
+}
+
+SleepResult AlertableSleep(std::chrono::microseconds duration) {
+  return AlertableSleepUntil(std::chrono::steady_clock::now() + duration);
+}
+
+SleepResult AlertableSleepUntil(
+    std::chrono::steady_clock::time_point deadline) {
+  return AlertableSleepUntilImpl(deadline, std::chrono::microseconds::zero());
+}
+
+void PreciseSleepUntil(std::chrono::steady_clock::time_point deadline) {
+  SleepUntilImpl(deadline, kPreciseSpinMargin);
+}
+
+SleepResult AlertablePreciseSleepUntil(
+    std::chrono::steady_clock::time_point deadline) {
+  return AlertableSleepUntilImpl(deadline, kPreciseSpinMargin);
 }
 
 TlsHandle AllocateTlsHandle() {
@@ -722,93 +911,118 @@ bool SetTlsValue(TlsHandle handle, uintptr_t value) {
                              reinterpret_cast<void*>(value)) == 0;
 }
 
+// All handle state is guarded by one process-wide mutex so WaitMultiple can
+// test and consume several handles atomically. Blocking, however, is per
+// waiter: each blocked thread parks on its own condition variable and links
+// itself into the waiter list of every handle it is waiting on, so a Signal()
+// only wakes threads waiting on that handle instead of every waiter in the
+// process.
 class PosixConditionBase {
  public:
   virtual bool Signal() = 0;
 
   WaitResult Wait(std::chrono::milliseconds timeout) {
-    bool executed;
-    auto predicate = [this] { return this->signaled(); };
-    auto lock = std::unique_lock<std::mutex>(mutex_);
-    if (predicate()) {
-      executed = true;
-    } else {
-      if (timeout == std::chrono::milliseconds::max()) {
-        cond_.wait(lock, predicate);
-        executed = true;  // Did not time out;
-      } else {
-        executed = cond_.wait_for(lock, timeout, predicate);
-      }
-    }
-    if (executed) {
-      post_execution();
-      return WaitResult::kSuccess;
-    } else {
-      return WaitResult::kTimeout;
-    }
+    PosixConditionBase* handles[] = {this};
+    return WaitForHandles(handles, 1, true, timeout).first;
   }
 
   static std::pair<WaitResult, size_t> WaitMultiple(
       std::vector<PosixConditionBase*>&& handles, bool wait_all,
       std::chrono::milliseconds timeout) {
     assert_true(handles.size() > 0);
+    return WaitForHandles(handles.data(), handles.size(), wait_all, timeout);
+  }
 
-    // Construct a condition for all or any depending on wait_all
-    std::function<bool()> predicate;
-    {
-      using iter_t = std::vector<PosixConditionBase*>::const_iterator;
-      const auto predicate_inner = [](auto h) { return h->signaled(); };
-      const auto operation =
-          wait_all ? std::all_of<iter_t, decltype(predicate_inner)>
-                   : std::any_of<iter_t, decltype(predicate_inner)>;
-      predicate = [&handles, operation, predicate_inner] {
-        return operation(handles.cbegin(), handles.cend(), predicate_inner);
-      };
+  // There is no single native object behind a handle; the condition itself is
+  // the identity.
+  virtual void* native_handle() const {
+    return const_cast<PosixConditionBase*>(this);
+  }
+
+ protected:
+  // A thread blocked in WaitForHandles. Lives on the waiting thread's stack.
+  struct Waiter {
+    std::condition_variable cond;
+  };
+
+  inline virtual bool signaled() const = 0;
+  inline virtual void post_execution() = 0;
+
+  // Wakes the threads waiting on this handle. Caller must hold mutex_.
+  void NotifyWaiters() {
+    for (auto waiter : waiters_) {
+      waiter->cond.notify_one();
     }
+  }
+
+  static std::mutex mutex_;
+
+ private:
+  static std::pair<WaitResult, size_t> WaitForHandles(
+      PosixConditionBase* const* handles, size_t count, bool wait_all,
+      std::chrono::milliseconds timeout) {
+    const auto predicate = [handles, count, wait_all] {
+      const auto is_signaled = [](auto h) { return h->signaled(); };
+      return wait_all ? std::all_of(handles, handles + count, is_signaled)
+                      : std::any_of(handles, handles + count, is_signaled);
+    };
 
     // TODO(bwrsandman, Triang3l) This is controversial, see issue #1677
     // This will probably cause a deadlock on the next thread doing any waiting
     // if the thread is suspended between locking and waiting
-    std::unique_lock<std::mutex> lock(PosixConditionBase::mutex_);
+    std::unique_lock<std::mutex> lock(mutex_);
 
-    bool wait_success = true;
-    // If the timeout is infinite, wait without timeout.
-    // The predicate will be checked before beginning the wait
-    if (timeout == std::chrono::milliseconds::max()) {
-      PosixConditionBase::cond_.wait(lock, predicate);
-    } else {
-      // Wait with timeout.
-      wait_success =
-          PosixConditionBase::cond_.wait_for(lock, timeout, predicate);
+    if (!predicate()) {
+      if (timeout == std::chrono::milliseconds(0)) {
+        return std::make_pair<WaitResult, size_t>(WaitResult::kTimeout, 0);
+      }
+
+      Waiter waiter;
+      for (size_t i = 0; i < count; ++i) {
+        handles[i]->waiters_.push_back(&waiter);
+      }
+
+      bool wait_success = true;
+      // If the timeout is infinite, wait without timeout.
+      if (timeout == std::chrono::milliseconds::max()) {
+        waiter.cond.wait(lock, predicate);
+      } else {
+        wait_success = waiter.cond.wait_for(lock, timeout, predicate);
+      }
+
+      for (size_t i = 0; i < count; ++i) {
+        handles[i]->RemoveWaiter(&waiter);
+      }
+      if (!wait_success) {
+        return std::make_pair<WaitResult, size_t>(WaitResult::kTimeout, 0);
+      }
     }
-    if (wait_success) {
-      auto first_signaled = std::numeric_limits<size_t>::max();
-      for (auto i = 0u; i < handles.size(); ++i) {
-        if (handles[i]->signaled()) {
-          if (first_signaled > i) {
-            first_signaled = i;
-          }
-          handles[i]->post_execution();
-          if (!wait_all) break;
+
+    auto first_signaled = std::numeric_limits<size_t>::max();
+    for (size_t i = 0; i < count; ++i) {
+      if (handles[i]->signaled()) {
+        if (first_signaled > i) {
+          first_signaled = i;
         }
+        handles[i]->post_execution();
+        if (!wait_all) break;
       }
-      assert_true(std::numeric_limits<size_t>::max() != first_signaled);
-      return std::make_pair(WaitResult::kSuccess, first_signaled);
-    } else {
-      return std::make_pair<WaitResult, size_t>(WaitResult::kTimeout, 0);
     }
+    assert_true(std::numeric_limits<size_t>::max() != first_signaled);
+    return std::make_pair(WaitResult::kSuccess, first_signaled);
   }
 
-  virtual void* native_handle() const { return cond_.native_handle(); }
+  void RemoveWaiter(Waiter* waiter) {
+    auto it = std::find(waiters_.begin(), waiters_.end(), waiter);
+    assert_true(it != waiters_.end());
+    *it = waiters_.back();
+    waiters_.pop_back();
+  }
 
- protected:
-  inline virtual bool signaled() const = 0;
-  inline virtual void post_execution() = 0;
-  static std::condition_variable cond_;
-  static std::mutex mutex_;
+  // Threads currently blocked on this handle. Guarded by mutex_.
+  std::vector<Waiter*> waiters_;
 };
 
-std::condition_variable PosixConditionBase::cond_;
 std::mutex PosixConditionBase::mutex_;
 
 // There really is no native POSIX handle for a single wait/signal construct
@@ -828,7 +1042,7 @@ class PosixCondition<Event> : public PosixConditionBase {
   bool Signal() override {
     auto lock = std::unique_lock<std::mutex>(mutex_);
     signal_ = true;
-    cond_.notify_all();
+    NotifyWaiters();
     return true;
   }
 
@@ -861,7 +1075,7 @@ class PosixCondition<Semaphore> : public PosixConditionBase {
       auto lock = std::unique_lock<std::mutex>(mutex_);
       if (out_previous_count) *out_previous_count = count_;
       count_ += release_count;
-      cond_.notify_all();
+      NotifyWaiters();
       return true;
     }
     return false;
@@ -869,10 +1083,7 @@ class PosixCondition<Semaphore> : public PosixConditionBase {
 
  private:
   inline bool signaled() const override { return count_ > 0; }
-  inline void post_execution() override {
-    count_--;
-    cond_.notify_all();
-  }
+  inline void post_execution() override { count_--; }
   uint32_t count_;
   const uint32_t maximum_count_;
 };
@@ -895,7 +1106,7 @@ class PosixCondition<Mutant> : public PosixConditionBase {
       --count_;
       // Free to be acquired by another thread
       if (count_ == 0) {
-        cond_.notify_all();
+        NotifyWaiters();
       }
       return true;
     }
@@ -927,7 +1138,7 @@ class PosixCondition<Timer> : public PosixConditionBase {
   bool Signal() override {
     std::lock_guard<std::mutex> lock(mutex_);
     signal_ = true;
-    cond_.notify_all();
+    NotifyWaiters();
     return true;
   }
 
@@ -1271,7 +1482,7 @@ class PosixCondition<Thread> : public PosixConditionBase {
 
       exit_code_ = exit_code;
       signaled_ = true;
-      cond_.notify_all();
+      NotifyWaiters();
     }
     if (is_current_thread) {
       pthread_exit(reinterpret_cast<void*>(exit_code));
@@ -1640,7 +1851,7 @@ void* PosixCondition<Thread>::ThreadStartRoutine(void* parameter) {
   std::unique_lock<std::mutex> lock(mutex_);
   thread->handle_.exit_code_ = 0;
   thread->handle_.signaled_ = true;
-  cond_.notify_all();
+  thread->handle_.NotifyWaiters();
 
   current_thread_ = nullptr;
   return nullptr;
@@ -1709,6 +1920,7 @@ static void signal_handler(int signal, siginfo_t* info, void* /*context*/) {
           static_cast<PosixCondition<Thread>*>(info->si_value.sival_ptr);
       if (alertable_state_) {
         p_thread->CallUserCallback();
+        alerted_ = 1;
       }
     } break;
 #if REX_PLATFORM_ANDROID
@@ -12,6 +12,7 @@
 #include "stfs_container_device.h"
 
 #include <algorithm>
+#include <cstring>
 #include <queue>
 #include <vector>
 
@@ -75,16 +76,16 @@ StfsContainerDevice::Error StfsContainerDevice::OpenFiles() {
   // Map the file containing the STFS Header and read it.
   REXFS_INFO("Loading STFS header file: {}", rex::path_to_utf8(host_path_));
 
-  auto header_file = rex::filesystem::OpenFile(host_path_, "rb");
+  auto header_file =
+      memory::MappedMemory::Open(host_path_, memory::MappedMemory::Mode::kRead);
   if (!header_file) {
     REXFS_ERROR("Error opening STFS header file.");
     return Error::kErrorReadError;
   }
 
-  auto header_result = ReadHeaderAndVerify(header_file);
+  auto header_result = ReadHeaderAndVerify(header_file.get());
   if (header_result != Error::kSuccess) {
     REXFS_ERROR("Error reading STFS header: {}", static_cast<int>(header_result));
-    fclose(header_file);
     files_total_size_ = 0;
     return header_result;
   }
@@ -94,7 +95,7 @@ StfsContainerDevice::Error StfsContainerDevice::OpenFiles() {
   // NOTE: data_file_count is 0 for STFS and 1 for SVOD
   if (header_.metadata.data_file_count <= 1) {
     REXFS_INFO("STFS container is a single file.");
-    files_.emplace(std::make_pair(0, header_file));
+    files_.emplace(0, std::move(header_file));
     return Error::kSuccess;
   }
 
@@ -124,17 +125,16 @@ StfsContainerDevice::Error StfsContainerDevice::OpenFiles() {
   for (size_t i = 0; i < fragment_files.size(); i++) {
     auto& fragment = fragment_files.at(i);
     auto path = fragment.path / fragment.name;
-    auto file = rex::filesystem::OpenFile(path, "rb");
+    auto file =
+        memory::MappedMemory::Open(path, memory::MappedMemory::Mode::kRead);
     if (!file) {
       REXFS_INFO("Failed to map SVOD file {}.", rex::path_to_utf8(path));
       CloseFiles();
       return Error::kErrorReadError;
     }
 
-    rex::filesystem::Seek(file, 0L, SEEK_END);
-    files_total_size_ += rex::filesystem::Tell(file);
-    // no need to seek back, any reads from this file will seek first anyway
-    files_.emplace(std::make_pair(i, file));
+    files_total_size_ += file->size();
+    files_.emplace(i, std::move(file));
   }
   REXFS_INFO("SVOD successfully mapped {} files.", fragment_files.size());
   return Error::kSuccess;
@@ -142,7 +142,7 @@ StfsContainerDevice::Error StfsContainerDevice::OpenFiles() {
 
 void StfsContainerDevice::CloseFiles() {
   for (auto& file : files_) {
-    fclose(file.second);
+    file.second->Close();
   }
   files_.clear();
   files_total_size_ = 0;
@@ -162,20 +162,15 @@ Entry* StfsContainerDevice::ResolvePath(const std::string_view path) {
 }
 
 StfsContainerDevice::Error StfsContainerDevice::ReadHeaderAndVerify(
-    FILE* header_file) {
+    const memory::MappedMemory* header_file) {
   // Check size of the file is enough to store an STFS header
-  rex::filesystem::Seek(header_file, 0L, SEEK_END);
-  files_total_size_ = rex::filesystem::Tell(header_file);
-  rex::filesystem::Seek(header_file, 0L, SEEK_SET);
-
+  files_total_size_ = header_file->size();
   if (sizeof(StfsHeader) > files_total_size_) {
     return Error::kErrorTooSmall;
   }
 
   // Read header & check signature
-  if (fread(&header_, sizeof(StfsHeader), 1, header_file) != 1) {
-    return Error::kErrorReadError;
-  }
+  std::memcpy(&header_, header_file->data(), sizeof(StfsHeader));
 
   if (!header_.header.is_magic_valid()) {
     // Unexpected format.
@@ -196,14 +191,26 @@ StfsContainerDevice::Error StfsContainerDevice::ReadHeaderAndVerify(
   return Error::kSuccess;
 }
 
+const uint8_t* StfsContainerDevice::DataAt(size_t file_index, size_t offset,
+                                           size_t length) const {
+  auto it = files_.find(file_index);
+  if (it == files_.end()) {
+    return nullptr;
+  }
+  auto& file = it->second;
+  if (offset > file->size() || length > file->size() - offset) {
+    return nullptr;
+  }
+  return file->data() + offset;
+}
+
 StfsContainerDevice::Error StfsContainerDevice::ReadSVOD() {
   // SVOD Systems can have different layouts. The root block is
   // denoted by the magic "MICROSOFT*XBOX*MEDIA" and is always in
   // the first "actual" data fragment of the system.
-  auto& svod_header = files_.at(0);
   const char* MEDIA_MAGIC = "MICROSOFT*XBOX*MEDIA";
 
-  uint8_t magic_buf[20];
+  const uint8_t* magic_buf;
   size_t magic_offset;
 
   // Check for EDGF layout
@@ -213,9 +220,8 @@ StfsContainerDevice::Error StfsContainerDevice::ReadSVOD() {
     // We can expect the magic block to be located immediately after the hash
     // blocks. We also offset block address calculation by 0x1000 by shifting
     // block indices by +0x2.
-    rex::filesystem::Seek(svod_header, 0x2000, SEEK_SET);
-    if (fread(magic_buf, 1, countof(magic_buf), svod_header) !=
-        countof(magic_buf)) {
+    magic_buf = DataAt(0, 0x2000, 20);
+    if (!magic_buf) {
       REXFS_ERROR("ReadSVOD failed to read SVOD magic at 0x2000");
       return Error::kErrorReadError;
     }
@@ -230,9 +236,8 @@ StfsContainerDevice::Error StfsContainerDevice::ReadSVOD() {
       return Error::kErrorFileMismatch;
     }
   } else {
-    rex::filesystem::Seek(svod_header, 0x12000, SEEK_SET);
-    if (fread(magic_buf, 1, countof(magic_buf), svod_header) !=
-        countof(magic_buf)) {
+    magic_buf = DataAt(0, 0x12000, 20);
+    if (!magic_buf) {
       REXFS_ERROR("ReadSVOD failed to read SVOD magic at 0x12000");
       return Error::kErrorReadError;
     }
@@ -246,8 +251,8 @@ StfsContainerDevice::Error StfsContainerDevice::ReadSVOD() {
 
       // Check for XSF Header
       const char* XSF_MAGIC = "XSF";
-      rex::filesystem::Seek(svod_header, 0x2000, SEEK_SET);
-      if (fread(magic_buf, 1, 3, svod_header) != 3) {
+      magic_buf = DataAt(0, 0x2000, 3);
+      if (!magic_buf) {
         REXFS_ERROR("ReadSVOD failed to read SVOD XSF magic at 0x2000");
         return Error::kErrorReadError;
       }
@@ -261,9 +266,8 @@ StfsContainerDevice::Error StfsContainerDevice::ReadSVOD() {
         REXFS_INFO("SVOD magic block found at 0x12000");
       }
     } else {
-      rex::filesystem::Seek(svod_header, 0xD000, SEEK_SET);
-      if (fread(magic_buf, 1, countof(magic_buf), svod_header) !=
-          countof(magic_buf)) {
+      magic_buf = DataAt(0, 0xD000, 20);
+      if (!magic_buf) {
         REXFS_ERROR("ReadSVOD failed to read SVOD magic at 0xD000");
         return Error::kErrorReadError;
       }
@@ -294,8 +298,6 @@ StfsContainerDevice::Error StfsContainerDevice::ReadSVOD() {
   }
 
   // Parse the root directory
-  rex::filesystem::Seek(svod_header, magic_offset + 0x14, SEEK_SET);
-
   struct {
     uint32_t block;
     uint32_t size;
@@ -304,11 +306,13 @@ StfsContainerDevice::Error StfsContainerDevice::ReadSVOD() {
   } root_data;
   static_assert_size(root_data, 0x10);
 
-  if (fread(&root_data, sizeof(root_data), 1, svod_header) != 1) {
+  auto root_data_ptr = DataAt(0, magic_offset + 0x14, sizeof(root_data));
+  if (!root_data_ptr) {
     REXFS_ERROR("ReadSVOD failed to read root block data at 0x{:X}",
            magic_offset + 0x14);
     return Error::kErrorReadError;
   }
+  std::memcpy(&root_data, root_data_ptr, sizeof(root_data));
 
   uint64_t root_creation_timestamp =
       decode_fat_timestamp(root_data.creation_date, root_data.creation_time);
@@ -338,9 +342,6 @@ StfsContainerDevice::Error StfsContainerDevice::ReadEntrySVOD(
   entry_address += true_ordinal_offset;
 
   // Read directory entry
-  auto& file = files_.at(entry_file);
-  rex::filesystem::Seek(file, entry_address, SEEK_SET);
-
 #pragma pack(push, 1)
   struct {
     uint16_t node_l;
@@ -353,21 +354,24 @@ StfsContainerDevice::Error StfsContainerDevice::ReadEntrySVOD(
   static_assert_size(dir_entry, 0xE);
 #pragma pack(pop)
 
-  if (fread(&dir_entry, sizeof(dir_entry), 1, file) != 1) {
+  auto dir_entry_ptr = DataAt(entry_file, entry_address, sizeof(dir_entry));
+  if (!dir_entry_ptr) {
     REXFS_ERROR("ReadEntrySVOD failed to read directory entry at 0x{:X}",
            entry_address);
     return Error::kErrorReadError;
   }
+  std::memcpy(&dir_entry, dir_entry_ptr, sizeof(dir_entry));
 
-  auto name_buffer = std::make_unique<char[]>(dir_entry.name_length);
-  if (fread(name_buffer.get(), 1, dir_entry.name_length, file) !=
-      dir_entry.name_length) {
+  auto name_buffer = DataAt(entry_file, entry_address + sizeof(dir_entry),
+                            dir_entry.name_length);
+  if (!name_buffer) {
     REXFS_ERROR("ReadEntrySVOD failed to read directory entry name at 0x{:X}",
            entry_address);
     return Error::kErrorReadError;
   }
 
-  auto name = std::string(name_buffer.get(), dir_entry.name_length);
+  auto name = std::string(reinterpret_cast<const char*>(name_buffer),
+                          dir_entry.name_length);
 
   // Read the left node
   if (dir_entry.node_l) {
@@ -421,8 +425,6 @@ StfsContainerDevice::Error StfsContainerDevice::ReadEntrySVOD(
       uint32_t block_index = dir_entry.data_block;
       size_t remaining_size = rex::round_up(dir_entry.length, 0x800);
 
-      size_t last_record = -1;
-      size_t last_offset = -1;
       while (remaining_size) {
         const size_t BLOCK_SIZE = 0x800;
 
@@ -432,16 +434,7 @@ StfsContainerDevice::Error StfsContainerDevice::ReadEntrySVOD(
         block_index++;
         remaining_size -= BLOCK_SIZE;
 
-        if (offset - last_offset == 0x800) {
-          // Consecutive, so append to last entry.
-          entry->block_list_[last_record].length += BLOCK_SIZE;
-          last_offset = offset;
-          continue;
-        }
-
-        entry->block_list_.push_back({file_index, offset, BLOCK_SIZE});
-        last_record = entry->block_list_.size() - 1;
-        last_offset = offset;
+        entry->AppendBlock(file_index, offset, BLOCK_SIZE);
       }
     }
   }
@@ -521,8 +514,6 @@ void StfsContainerDevice::BlockToOffsetSVOD(size_t block, size_t* out_address,
 }
 
 StfsContainerDevice::Error StfsContainerDevice::ReadSTFS() {
-  auto& file = files_.at(0);
-
   auto root_entry = new StfsContainerEntry(this, nullptr, "", &files_);
   root_entry->attributes_ = kFileAttributeDirectory;
   root_entry_ = std::unique_ptr<Entry>(root_entry);
@@ -530,22 +521,20 @@ StfsContainerDevice::Error StfsContainerDevice::ReadSTFS() {
   std::vector<StfsContainerEntry*> all_entries;
 
   // Load all listings.
-  StfsDirectoryBlock directory;
-
   auto& descriptor = header_.metadata.volume_descriptor.stfs;
   uint32_t table_block_index = descriptor.file_table_block_number();
   size_t n = 0;
   for (n = 0; n < descriptor.file_table_block_count; n++) {
     auto offset = BlockToOffsetSTFS(table_block_index);
-    rex::filesystem::Seek(file, offset, SEEK_SET);
-
-    if (fread(&directory, sizeof(StfsDirectoryBlock), 1, file) != 1) {
+    auto directory = reinterpret_cast<const StfsDirectoryBlock*>(
+        DataAt(0, offset, sizeof(StfsDirectoryBlock)));
+    if (!directory) {
       REXFS_ERROR("ReadSTFS failed to read directory block at 0x{:X}", offset);
       return Error::kErrorReadError;
     }
 
     for (size_t m = 0; m < kEntriesPerDirectoryBlock; m++) {
-      auto& dir_entry = directory.entries[m];
+      auto& dir_entry = directory->entries[m];
 
       if (dir_entry.name[0] == 0) {
         // Done.
@@ -589,13 +578,18 @@ StfsContainerDevice::Error StfsContainerDevice::ReadSTFS() {
       if (entry->attributes() & X_FILE_ATTRIBUTE_NORMAL) {
         uint32_t block_index = dir_entry.start_block_number();
         size_t remaining_size = dir_entry.length;
+        size_t block_count = 0;
         while (remaining_size && block_index != kEndOfChain) {
           size_t block_size =
               std::min(static_cast<size_t>(kBlockSize), remaining_size);
           size_t offset = BlockToOffsetSTFS(block_index);
-          entry->block_list_.push_back({0, offset, block_size});
+          entry->AppendBlock(0, offset, block_size);
           remaining_size -= block_size;
+          block_count++;
           auto block_hash = GetBlockHash(block_index);
+          if (!block_hash) {
+            break;
+          }
           block_index = block_hash->level0_next_block();
         }
 
@@ -611,12 +605,11 @@ StfsContainerDevice::Error StfsContainerDevice::ReadSTFS() {
 
         // Check that the number of blocks retrieved from hash entries matches
         // the block count read from the file entry
-        if (entry->block_list_.size() != dir_entry.allocated_data_blocks()) {
+        if (block_count != dir_entry.allocated_data_blocks()) {
           REXFS_WARN(
               "STFS failed to read correct block-chain for entry {}, read {} "
               "blocks, expected {}",
-              entry->name_, entry->block_list_.size(),
-              dir_entry.allocated_data_blocks());
+              entry->name_, block_count, dir_entry.allocated_data_blocks());
           assert_always();
         }
       }
@@ -625,6 +618,9 @@ StfsContainerDevice::Error StfsContainerDevice::ReadSTFS() {
     }
 
     auto block_hash = GetBlockHash(table_block_index);
+    if (!block_hash) {
+      return Error::kErrorReadError;
+    }
     table_block_index = block_hash->level0_next_block();
     if (table_block_index == kEndOfChain) {
       break;
@@ -698,92 +694,69 @@ size_t StfsContainerDevice::BlockToHashBlockOffsetSTFS(
   return rex::round_up(header_.header.header_size, kBlockSize) + (block << 12);
 }
 
-const StfsHashEntry* StfsContainerDevice::GetBlockHash(uint32_t block_index) {
-  auto& file = files_.at(0);
+const StfsHashTable* StfsContainerDevice::HashTableAt(size_t offset) const {
+  auto table = reinterpret_cast<const StfsHashTable*>(
+      DataAt(0, offset, sizeof(StfsHashTable)));
+  if (!table) {
+    REXFS_ERROR("GetBlockHash failed to read hash table at 0x{:X}", offset);
+  }
+  return table;
+}
 
+const StfsHashEntry* StfsContainerDevice::GetBlockHash(
+    uint32_t block_index) const {
   auto& descriptor = header_.metadata.volume_descriptor.stfs;
 
   // Offset for selecting the secondary hash block, in packages that have them
   uint32_t secondary_table_offset =
       descriptor.flags.bits.root_active_index ? kBlockSize : 0;
 
-  auto hash_offset_lv0 = BlockToHashBlockOffsetSTFS(block_index, 0);
-  if (!cached_hash_tables_.count(hash_offset_lv0)) {
-    // If this is read_only_format then it doesn't contain secondary blocks, no
-    // need to check upper hash levels
-    if (descriptor.flags.bits.read_only_format) {
-      secondary_table_offset = 0;
-    } else {
-      // Not a read-only package, need to check each levels active index flag to
-      // see if we need to use secondary block or not
-
-      // Check level1 table if package has it
-      if (descriptor.total_block_count > kBlocksPerHashLevel[0]) {
-        auto hash_offset_lv1 = BlockToHashBlockOffsetSTFS(block_index, 1);
-
-        if (!cached_hash_tables_.count(hash_offset_lv1)) {
-          // Check level2 table if package has it
-          if (descriptor.total_block_count > kBlocksPerHashLevel[1]) {
-            auto hash_offset_lv2 = BlockToHashBlockOffsetSTFS(block_index, 2);
-
-            if (!cached_hash_tables_.count(hash_offset_lv2)) {
-              rex::filesystem::Seek(
-                  file, hash_offset_lv2 + secondary_table_offset, SEEK_SET);
-
-              StfsHashTable table_lv2;
-              if (fread(&table_lv2, sizeof(StfsHashTable), 1, file) != 1) {
-                REXFS_ERROR("GetBlockHash failed to read level2 hash table at 0x{:X}",
-                       hash_offset_lv2 + secondary_table_offset);
-                return nullptr;
-              }
-              cached_hash_tables_[hash_offset_lv2] = table_lv2;
-            }
-
-            auto record =
-                (block_index / kBlocksPerHashLevel[1]) % kBlocksPerHashLevel[0];
-            auto record_data =
-                &cached_hash_tables_[hash_offset_lv2].entries[record];
-            secondary_table_offset =
-                record_data->levelN_active_index() ? kBlockSize : 0;
-          }
-
-          rex::filesystem::Seek(file, hash_offset_lv1 + secondary_table_offset,
-                               SEEK_SET);
-
-          StfsHashTable table_lv1;
-          if (fread(&table_lv1, sizeof(StfsHashTable), 1, file) != 1) {
-            REXFS_ERROR("GetBlockHash failed to read level1 hash table at 0x{:X}",
-                   hash_offset_lv1 + secondary_table_offset);
-            return nullptr;
-          }
-          cached_hash_tables_[hash_offset_lv1] = table_lv1;
+  // If this is read_only_format then it doesn't contain secondary blocks, no
+  // need to check upper hash levels
+  if (descriptor.flags.bits.read_only_format) {
+    secondary_table_offset = 0;
+  } else {
+    // Not a read-only package, need to check each levels active index flag to
+    // see if we need to use secondary block or not
+
+    // Check level1 table if package has it
+    if (descriptor.total_block_count > kBlocksPerHashLevel[0]) {
+      // Check level2 table if package has it
+      if (descriptor.total_block_count > kBlocksPerHashLevel[1]) {
+        auto table_lv2 =
+            HashTableAt(BlockToHashBlockOffsetSTFS(block_index, 2) +
+                        secondary_table_offset);
+        if (!table_lv2) {
+          return nullptr;
         }
 
         auto record =
-            (block_index / kBlocksPerHashLevel[0]) % kBlocksPerHashLevel[0];
-        auto record_data =
-            &cached_hash_tables_[hash_offset_lv1].entries[record];
+            (block_index / kBlocksPerHashLevel[1]) % kBlocksPerHashLevel[0];
         secondary_table_offset =
-            record_data->levelN_active_index() ? kBlockSize : 0;
+            table_lv2->entries[record].levelN_active_index() ? kBlockSize : 0;
       }
-    }
 
-    rex::filesystem::Seek(file, hash_offset_lv0 + secondary_table_offset,
-                         SEEK_SET);
+      auto table_lv1 = HashTableAt(BlockToHashBlockOffsetSTFS(block_index, 1) +
+                                   secondary_table_offset);
+      if (!table_lv1) {
+        return nullptr;
+      }
 
-    StfsHashTable table_lv0;
-    if (fread(&table_lv0, sizeof(StfsHashTable), 1, file) != 1) {
-      REXFS_ERROR("GetBlockHash failed to read level0 hash table at 0x{:X}",
-          (hash_offset_lv0 + secondary_table_offset));
-      return nullptr;
+      auto record =
+          (block_index / kBlocksPerHashLevel[0]) % kBlocksPerHashLevel[0];
+      secondary_table_offset =
+          table_lv1->entries[record].levelN_active_index() ? kBlockSize : 0;
     }
-    cached_hash_tables_[hash_offset_lv0] = table_lv0;
   }
 
-  auto record = block_index % kBlocksPerHashLevel[0];
-  auto record_data = &cached_hash_tables_[hash_offset_lv0].entries[record];
+  auto table_lv0 = HashTableAt(BlockToHashBlockOffsetSTFS(block_index, 0) +
+                               secondary_table_offset);
+  if (!table_lv0) {
+    return nullptr;
+  }
 
-  return record_data;
+  auto record = block_index % kBlocksPerHashLevel[0];
+  return &table_lv0->entries[record];
 }
 
 XContentPackageType StfsContainerDevice::ReadMagic(
@@ -14,9 +14,9 @@
 #include <map>
 #include <memory>
 #include <string>
-#include <unordered_map>
 
 #include <rex/math.h>
+#include <rex/memory/mapped_memory.h>
 #include <rex/string/util.h>
 #include <rex/filesystem/device.h>
 #include "stfs_xbox.h"
@@ -108,7 +108,11 @@ class StfsContainerDevice : public Device {
   Error OpenFiles();
   void CloseFiles();
 
-  Error ReadHeaderAndVerify(FILE* header_file);
+  Error ReadHeaderAndVerify(const memory::MappedMemory* header_file);
+
+  // Returns a pointer to [offset, offset + length) of the given data file, or
+  // nullptr if the range is not entirely inside it.
+  const uint8_t* DataAt(size_t file_index, size_t offset, size_t length) const;
 
   Error ReadSVOD();
   Error ReadEntrySVOD(uint32_t sector, uint32_t ordinal,
@@ -122,12 +126,13 @@ class StfsContainerDevice : public Device {
   size_t BlockToHashBlockOffsetSTFS(uint32_t block_index,
                                     uint32_t hash_level) const;
 
-  const StfsHashEntry* GetBlockHash(uint32_t block_index);
+  const StfsHashTable* HashTableAt(size_t offset) const;
+  const StfsHashEntry* GetBlockHash(uint32_t block_index) const;
 
   std::string name_;
   std::filesystem::path host_path_;
 
-  std::map<size_t, FILE*> files_;
+  std::map<size_t, std::unique_ptr<memory::MappedMemory>> files_;
   size_t files_total_size_;
 
   size_t svod_base_offset_;
@@ -137,8 +142,6 @@ class StfsContainerDevice : public Device {
   SvodLayoutType svod_layout_;
   uint32_t blocks_per_hash_table_;
   uint32_t block_step[2];
-
-  std::unordered_map<size_t, StfsHashTable> cached_hash_tables_;
 };
 
 }  // namespace rex::filesystem
@@ -13,6 +13,8 @@
 #include <rex/math.h>
 #include "stfs_container_file.h"
 
+#include <algorithm>
+#include <cstring>
 #include <map>
 
 namespace rex::filesystem {
@@ -43,4 +45,94 @@ X_STATUS StfsContainerEntry::Open(uint32_t desired_access, File** out_file) {
   return X_STATUS_SUCCESS;
 }
 
+std::unique_ptr<memory::MappedMemory> StfsContainerEntry::OpenMapped(
+    memory::MappedMemory::Mode mode, size_t offset, size_t length) {
+  if (mode != memory::MappedMemory::Mode::kRead) {
+    // Only allow reads.
+    return nullptr;
+  }
+  if (offset >= size_) {
+    return nullptr;
+  }
+
+  size_t real_length = std::min(length ? length : size_, size_ - offset);
+  size_t index = FindBlock(offset);
+  if (index == block_list_.size()) {
+    return nullptr;
+  }
+  auto& record = block_list_[index];
+  size_t record_offset = offset - block_starts_[index];
+  if (real_length > record.length - record_offset) {
+    // Not contiguous in the container.
+    return nullptr;
+  }
+
+  auto& file = files_->at(record.file);
+  if (record.offset + record_offset + real_length > file->size()) {
+    return nullptr;
+  }
+  return file->Slice(record.offset + record_offset, real_length);
+}
+
+size_t StfsContainerEntry::FindBlock(size_t byte_offset) const {
+  // First record starting after byte_offset; the one before it holds it.
+  auto it = std::upper_bound(block_starts_.begin(), block_starts_.end(),
+                             byte_offset);
+  if (it == block_starts_.begin()) {
+    return block_list_.size();
+  }
+  size_t index = size_t(it - block_starts_.begin()) - 1;
+  if (byte_offset - block_starts_[index] >= block_list_[index].length) {
+    return block_list_.size();
+  }
+  return index;
+}
+
+size_t StfsContainerEntry::Read(void* buffer, size_t length,
+                                size_t byte_offset) const {
+  uint8_t* p = reinterpret_cast<uint8_t*>(buffer);
+  size_t bytes_read = 0;
+  for (size_t i = FindBlock(byte_offset); i < block_list_.size() && length;
+       i++) {
+    auto& record = block_list_[i];
+    size_t read_offset = byte_offset - block_starts_[i];
+    size_t read_length = std::min(record.length - read_offset, length);
+
+    auto& file = files_->at(record.file);
+    size_t src_offset = record.offset + read_offset;
+    if (src_offset >= file->size()) {
+      break;
+    }
+    size_t available = std::min(read_length, file->size() - src_offset);
+    std::memcpy(p, file->data() + src_offset, available);
+    bytes_read += available;
+    if (available != read_length) {
+      // Truncated container.
+      break;
+    }
+
+    p += read_length;
+    byte_offset += read_length;
+    length -= read_length;
+  }
+  return bytes_read;
+}
+
+void StfsContainerEntry::AppendBlock(size_t file, size_t offset,
+                                     size_t length) {
+  if (!block_list_.empty()) {
+    auto& last = block_list_.back();
+    if (last.file == file && last.offset + last.length == offset) {
+      // Consecutive, so append to last record.
+      last.length += length;
+      return;
+    }
+  }
+  block_starts_.push_back(
+      block_list_.empty()
+          ? 0
+          : block_starts_.back() + block_list_.back().length);
+  block_list_.push_back({file, offset, length});
+}
+
 }  // namespace rex::filesystem
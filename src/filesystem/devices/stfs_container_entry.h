@@ -12,14 +12,17 @@
 #pragma once
 
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
+#include <rex/memory/mapped_memory.h>
 #include <rex/filesystem/entry.h>
 #include <rex/filesystem/file.h>
 
 namespace rex::filesystem {
-typedef std::map<size_t, FILE*> MultiFileHandles;
+typedef std::map<size_t, std::unique_ptr<memory::MappedMemory>>
+    MultiFileHandles;
 
 class StfsContainerDevice;
 
@@ -41,6 +44,14 @@ class StfsContainerEntry : public Entry {
 
   X_STATUS Open(uint32_t desired_access, File** out_file) override;
 
+  // Only files stored as a single contiguous run can be mapped whole.
+  bool can_map() const override { return block_list_.size() == 1; }
+  // Maps [offset, offset + length) of the file data directly out of the
+  // container. Fails if the range spans more than one block record.
+  std::unique_ptr<memory::MappedMemory> OpenMapped(
+      memory::MappedMemory::Mode mode, size_t offset,
+      size_t length) override;
+
   struct BlockRecord {
     size_t file;
     size_t offset;
@@ -48,14 +59,29 @@ class StfsContainerEntry : public Entry {
   };
   const std::vector<BlockRecord>& block_list() const { return block_list_; }
 
+  // File data offset at which block_list()[index] begins.
+  size_t block_start(size_t index) const { return block_starts_[index]; }
+  // Index of the block record holding byte_offset of the file data, or
+  // block_list().size() if it is past the end.
+  size_t FindBlock(size_t byte_offset) const;
+
+  // Copies up to length bytes from byte_offset of the file data. Returns the
+  // number of bytes copied.
+  size_t Read(void* buffer, size_t length, size_t byte_offset) const;
+
  private:
   friend class StfsContainerDevice;
 
+  // Appends a block to the list, extending the last record if it continues it.
+  void AppendBlock(size_t file, size_t offset, size_t length);
+
   MultiFileHandles* files_;
   size_t data_offset_;
   size_t data_size_;
   size_t block_;
   std::vector<BlockRecord> block_list_;
+  // Prefix sums of block_list_ lengths, one per record.
+  std::vector<size_t> block_starts_;
 };
 
 }  // namespace rex::filesystem
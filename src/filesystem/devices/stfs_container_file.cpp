@@ -12,9 +12,7 @@
 #include "stfs_container_file.h"
 
 #include <algorithm>
-#include <cmath>
 
-#include <rex/math.h>
 #include "stfs_container_entry.h"
 
 namespace rex::filesystem {
@@ -34,38 +32,8 @@ X_STATUS StfsContainerFile::ReadSync(void* buffer, size_t buffer_length,
     return X_STATUS_END_OF_FILE;
   }
 
-  size_t src_offset = 0;
-  uint8_t* p = reinterpret_cast<uint8_t*>(buffer);
-  size_t remaining_length =
-      std::min(buffer_length, entry_->size() - byte_offset);
-
-  *out_bytes_read = 0;
-  for (size_t i = 0; i < entry_->block_list().size(); i++) {
-    auto& record = entry_->block_list()[i];
-    if (src_offset + record.length <= byte_offset) {
-      // Doesn't begin in this region. Skip it.
-      src_offset += record.length;
-      continue;
-    }
-
-    size_t read_offset =
-        (byte_offset > src_offset) ? byte_offset - src_offset : 0;
-    size_t read_length =
-        std::min(record.length - read_offset, remaining_length);
-
-    auto& file = entry_->files()->at(record.file);
-    rex::filesystem::Seek(file, record.offset + read_offset, SEEK_SET);
-    auto num_read = fread(p, 1, read_length, file);
-
-    *out_bytes_read += num_read;
-    p += num_read;
-    src_offset += record.length;
-    remaining_length -= read_length;
-    if (remaining_length == 0) {
-      break;
-    }
-  }
-
+  size_t read_length = std::min(buffer_length, entry_->size() - byte_offset);
+  *out_bytes_read = entry_->Read(buffer, read_length, byte_offset);
   return X_STATUS_SUCCESS;
 }
 
@@ -562,6 +562,10 @@ uint32_t CommandProcessor::ExecutePrimaryBuffer(uint32_t read_index,
 
   trace_writer_.WritePrimaryBufferStart(start_ptr, write_index - read_index);
 
+  // Let the caches see what the CPU has written before this submission if
+  // the writes are only recorded, not trapped.
+  memory_->PollPhysicalMemoryWrites();
+
   // Execute commands!
   memory::RingBuffer reader(memory_->TranslatePhysical(primary_buffer_ptr_),
                     primary_buffer_size_);
@@ -983,6 +987,7 @@ bool CommandProcessor::ExecutePacketType3_WAIT_REG_MEM(memory::RingBuffer* reade
                 : register_file_->values[poll_reg_addr];
 
   bool matched = false;
+  bool waited = false;
   do {
     uint32_t value = value_ref;
     if (is_memory) {
@@ -1024,6 +1029,7 @@ bool CommandProcessor::ExecutePacketType3_WAIT_REG_MEM(memory::RingBuffer* reade
     }
     if (!matched) {
       // Wait.
+      waited = true;
       if (wait >= 0x100) {
         PrepareForWait();
         if (!REXCVAR_GET(vsync)) {
@@ -1045,6 +1051,11 @@ bool CommandProcessor::ExecutePacketType3_WAIT_REG_MEM(memory::RingBuffer* reade
     }
   } while (!matched);
 
+  if (waited) {
+    // The CPU may have prepared more data for the following commands.
+    memory_->PollPhysicalMemoryWrites();
+  }
+
   return true;
 }
 
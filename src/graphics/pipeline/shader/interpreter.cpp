@@ -28,12 +28,17 @@ void ShaderInterpreter::Execute() {
   // For more consistency between invocations in case of a malformed shader.
   state_.Reset();
 
+  ExecuteControlFlow(0);
+}
+
+void ShaderInterpreter::ExecuteControlFlow(uint32_t cf_index_first) {
   const uint32_t* bool_constants =
       &register_file_[XE_GPU_REG_SHADER_CONSTANT_BOOL_000_031];
 
   bool exec_ended = false;
-  uint32_t cf_index_next = 1;
-  for (uint32_t cf_index = 0; !exec_ended; cf_index = cf_index_next) {
+  uint32_t cf_index_next = cf_index_first + 1;
+  for (uint32_t cf_index = cf_index_first; !exec_ended;
+       cf_index = cf_index_next) {
     cf_index_next = cf_index + 1;
 
     const uint32_t* cf_pair = &ucode_[3 * (cf_index >> 1)];
@@ -265,6 +270,11 @@ const std::array<float, 4> ShaderInterpreter::GetFloatConstant(
     index += relative_address_is_a0 ? state_.address_register
                                     : state_.GetLoopAddress();
   }
+  return GetFloatConstant(index);
+}
+
+const std::array<float, 4> ShaderInterpreter::GetFloatConstant(
+    int32_t index) const {
   if (index < 0) {
     return std::array<float, 4>();
   }
@@ -1015,8 +1025,19 @@ void ShaderInterpreter::ExecuteVertexFetchInstruction(
         instr.stride() * vertex_index + fetch_constant.address;
   }
 
+  float result[4];
+  LoadVertexFetchResult(instr, fetch_constant, state_.vfetch_address_dwords,
+                        result);
+  StoreFetchResult(instr.dest(), instr.is_dest_relative(), instr.dest_swizzle(),
+                   result);
+}
+
+void ShaderInterpreter::LoadVertexFetchResult(
+    ucode::VertexFetchInstruction instr,
+    const xenos::xe_gpu_vertex_fetch_t& fetch_constant,
+    uint32_t address_dwords, float* result) const {
   // TODO(Triang3l): Find the default values for unused components.
-  float result[4] = {};
+  std::memset(result, 0, sizeof(float) * 4);
   uint32_t dest_swizzle = instr.dest_swizzle();
   uint32_t used_result_components = 0b0000;
   for (uint32_t i = 0; i < 4; ++i) {
@@ -1033,7 +1054,7 @@ void ShaderInterpreter::ExecuteVertexFetchInstruction(
         reinterpret_cast<const uint32_t*>(memory_.physical_membase());
     uint32_t buffer_end_dwords = fetch_constant.address + fetch_constant.size;
     uint32_t dword_0_address_dwords =
-        uint32_t(int32_t(state_.vfetch_address_dwords) + instr.offset());
+        uint32_t(int32_t(address_dwords) + instr.offset());
     for (uint32_t i = 0; i < 4; ++i) {
       if (!(needed_dwords & (UINT32_C(1) << i))) {
         continue;
@@ -1222,9 +1243,6 @@ void ShaderInterpreter::ExecuteVertexFetchInstruction(
       result[i] *= exp_adjust_factor;
     }
   }
-
-  StoreFetchResult(instr.dest(), instr.is_dest_relative(), instr.dest_swizzle(),
-                   result);
 }
 
 }  // namespace rex::graphics
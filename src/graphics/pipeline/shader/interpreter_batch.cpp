@@ -0,0 +1,1360 @@
+/**
+ ******************************************************************************
+ * Xenia : Xbox 360 Emulator Research Project                                 *
+ ******************************************************************************
+ * Copyright 2022 Ben Vanik. All rights reserved.                             *
+ * Released under the BSD license - see LICENSE in the root for more details. *
+ ******************************************************************************
+ *
+ * @modified    Tom Clay, 2026 - Adapted for ReXGlue runtime
+ */
+
+#include <rex/graphics/pipeline/shader/interpreter.h>
+
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include <rex/assert.h>
+#include <rex/math.h>
+#include <rex/memory.h>
+#include <rex/graphics/registers.h>
+#include <rex/graphics/xenos.h>
+
+// Multi-vertex execution of the ucode. The shader is decoded once into a flat
+// list of control flow and exec instructions, with the ALU operand fields and
+// write masks unpacked. Vertices are then processed in lanes of structure-of-
+// arrays registers, with the per-lane loops of fixed length so that the
+// compiler turns them into SIMD operations. Control flow depending on the bool
+// and loop constants is the same for all lanes; predicated execs and
+// instructions are masked per lane. The behavior is meant to match Execute
+// exactly, including its handling of malformed shaders.
+
+namespace rex::graphics {
+
+struct ShaderInterpreter::DecodedAluSource {
+  // Temporary register or float constant index.
+  uint32_t reg;
+  bool is_temp;
+  // +aL for temporary registers, +a0 or +aL for constants.
+  bool is_relative;
+  bool is_a0_relative;
+  uint32_t absolute_mask;
+  uint32_t negate_bit;
+  // Source component for each operand component.
+  uint8_t components[4];
+};
+
+struct ShaderInterpreter::DecodedAluInstruction {
+  ucode::AluVectorOpcode vector_opcode;
+  ucode::AluScalarOpcode scalar_opcode;
+  bool executes_vector_op;
+  bool vector_operand_used[3];
+  DecodedAluSource vector_sources[3];
+  // 0 - none, 1 - r#/c#.w or r#/c#.wx in scalar_sources[0], 2 - c#.w in
+  // scalar_sources[0] and r#.x in scalar_sources[1].
+  uint32_t scalar_operand_count;
+  uint32_t scalar_component_count;
+  DecodedAluSource scalar_sources[2];
+  uint32_t vector_result_write_mask;
+  uint32_t scalar_result_write_mask;
+  uint32_t constant_0_write_mask;
+  uint32_t constant_1_write_mask;
+  uint32_t vector_dest;
+  uint32_t scalar_dest;
+  bool is_export;
+  bool is_vector_dest_relative;
+  bool is_scalar_dest_relative;
+  bool vector_clamp;
+  bool scalar_clamp;
+};
+
+struct ShaderInterpreter::DecodedFetchInstruction {
+  ucode::VertexFetchInstruction vertex_fetch;
+  bool is_vertex_fetch;
+  bool is_dest_relative;
+  uint32_t dest;
+  uint32_t dest_swizzle;
+};
+
+struct ShaderInterpreter::Program {
+  struct ControlFlow {
+    ucode::ControlFlowInstruction instruction;
+    // For execs, the index of the first instruction in `instructions`.
+    uint32_t instructions_first;
+  };
+
+  struct Instruction {
+    bool is_fetch;
+    bool is_predicated;
+    bool predicate_condition;
+    DecodedAluInstruction alu;
+    DecodedFetchInstruction fetch;
+  };
+
+  // Indexed like the control flow instructions in the ucode.
+  std::vector<ControlFlow> control_flow;
+  std::vector<Instruction> instructions;
+};
+
+namespace {
+
+// Direct3D 9 behavior (0 or denormal * anything = +0), for operands with
+// denormals already flushed.
+inline float MulD3D9(float a, float b) { return (a && b) ? a * b : 0.0f; }
+
+inline bool IsLaneActive(uint32_t lane_mask, uint32_t lane) {
+  return ((lane_mask >> lane) & 1) != 0;
+}
+
+}  // namespace
+
+ShaderInterpreter::ShaderInterpreter(const RegisterFile& register_file,
+                                     const memory::Memory& memory)
+    : register_file_(register_file), memory_(memory) {}
+
+ShaderInterpreter::~ShaderInterpreter() = default;
+
+void ShaderInterpreter::SetShader(const Shader& shader) {
+  assert_true(CanInterpretShader(shader));
+  SetShader(shader.type(), shader.ucode_dwords());
+  auto program_it = programs_.find(shader.ucode_data_hash());
+  if (program_it == programs_.end()) {
+    program_it =
+        programs_.emplace(shader.ucode_data_hash(), DecodeProgram(shader))
+            .first;
+  }
+  program_ = program_it->second.get();
+}
+
+std::unique_ptr<ShaderInterpreter::Program> ShaderInterpreter::DecodeProgram(
+    const Shader& shader) {
+  assert_true(shader.is_ucode_analyzed());
+  const uint32_t* ucode = shader.ucode_dwords();
+  size_t ucode_instruction_count = shader.ucode_dword_count() / 3;
+
+  auto decode_alu_source = [](const ucode::AluInstruction& instr,
+                              uint32_t operand, DecodedAluSource& source) {
+    uint32_t src_reg = instr.src_reg(operand);
+    source.is_temp = instr.src_is_temp(operand);
+    if (source.is_temp) {
+      source.reg = ucode::AluInstruction::src_temp_reg(src_reg);
+      source.is_relative =
+          ucode::AluInstruction::is_src_temp_relative(src_reg);
+      source.is_a0_relative = false;
+      source.absolute_mask =
+          ucode::AluInstruction::is_src_temp_value_absolute(src_reg)
+              ? ~(UINT32_C(1) << 31)
+              : ~UINT32_C(0);
+    } else {
+      source.reg = src_reg;
+      source.is_relative = instr.src_const_is_addressed(operand);
+      source.is_a0_relative = instr.is_const_address_register_relative();
+      source.absolute_mask = ~UINT32_C(0);
+    }
+    source.negate_bit = uint32_t(instr.src_negate(operand)) << 31;
+    uint32_t swizzle = instr.src_swizzle(operand);
+    for (uint32_t i = 0; i < 4; ++i) {
+      source.components[i] = uint8_t(
+          ucode::AluInstruction::GetSwizzledComponentIndex(swizzle, i));
+    }
+  };
+
+  auto program = std::make_unique<Program>();
+  program->control_flow.resize(size_t(shader.cf_pair_index_bound()) * 2);
+  for (uint32_t cf_pair_index = 0; cf_pair_index < shader.cf_pair_index_bound();
+       ++cf_pair_index) {
+    ucode::ControlFlowInstruction cf_ab[2];
+    ucode::UnpackControlFlowInstructions(&ucode[3 * cf_pair_index], cf_ab);
+    for (uint32_t i = 0; i < 2; ++i) {
+      Program::ControlFlow& cf = program->control_flow[cf_pair_index * 2 + i];
+      cf.instruction = cf_ab[i];
+      cf.instructions_first = uint32_t(program->instructions.size());
+      if (!ucode::IsControlFlowOpcodeExec(cf_ab[i].opcode())) {
+        continue;
+      }
+      const ucode::ControlFlowExecInstruction& cf_exec = cf_ab[i].exec;
+      if (cf_exec.address() + cf_exec.count() > ucode_instruction_count) {
+        // Malformed - leave it to Execute, which reads the ucode directly.
+        return nullptr;
+      }
+      for (uint32_t exec_index = 0; exec_index < cf_exec.count();
+           ++exec_index) {
+        const uint32_t* exec_instruction =
+            &ucode[3 * (cf_exec.address() + exec_index)];
+        Program::Instruction& instruction =
+            program->instructions.emplace_back();
+        std::memset(&instruction, 0, sizeof(instruction));
+        instruction.is_fetch = (cf_exec.sequence() >> (exec_index << 1)) & 0b01;
+        if (instruction.is_fetch) {
+          const ucode::FetchInstruction& fetch_instr =
+              *reinterpret_cast<const ucode::FetchInstruction*>(
+                  exec_instruction);
+          instruction.is_predicated = fetch_instr.is_predicated();
+          instruction.predicate_condition = fetch_instr.predicate_condition();
+          DecodedFetchInstruction& fetch = instruction.fetch;
+          fetch.vertex_fetch = fetch_instr.vertex_fetch();
+          fetch.is_vertex_fetch =
+              fetch_instr.opcode() == ucode::FetchOpcode::kVertexFetch;
+          fetch.dest = fetch_instr.dest();
+          fetch.is_dest_relative = fetch_instr.is_dest_relative();
+          fetch.dest_swizzle = fetch_instr.dest_swizzle();
+          continue;
+        }
+
+        const ucode::AluInstruction& alu_instr =
+            *reinterpret_cast<const ucode::AluInstruction*>(exec_instruction);
+        instruction.is_predicated = alu_instr.is_predicated();
+        instruction.predicate_condition = alu_instr.predicate_condition();
+        DecodedAluInstruction& alu = instruction.alu;
+        alu.vector_opcode = alu_instr.vector_opcode();
+        alu.scalar_opcode = alu_instr.scalar_opcode();
+        const ucode::AluVectorOpcodeInfo& vector_opcode_info =
+            ucode::GetAluVectorOpcodeInfo(alu.vector_opcode);
+        alu.vector_result_write_mask = alu_instr.GetVectorOpResultWriteMask();
+        alu.executes_vector_op = alu.vector_result_write_mask ||
+                                 vector_opcode_info.changed_state;
+        for (uint32_t j = 0; j < 3; ++j) {
+          alu.vector_operand_used[j] =
+              vector_opcode_info.operand_components_used[j] != 0;
+          if (alu.vector_operand_used[j]) {
+            decode_alu_source(alu_instr, 1 + j, alu.vector_sources[j]);
+          }
+        }
+
+        const ucode::AluScalarOpcodeInfo& scalar_opcode_info =
+            ucode::GetAluScalarOpcodeInfo(alu.scalar_opcode);
+        alu.scalar_operand_count = scalar_opcode_info.operand_count;
+        uint32_t scalar_src_swizzle = alu_instr.src_swizzle(3);
+        switch (alu.scalar_operand_count) {
+          case 1: {
+            // r#/c#.w or r#/c#.wx.
+            DecodedAluSource& source = alu.scalar_sources[0];
+            decode_alu_source(alu_instr, 3, source);
+            alu.scalar_component_count =
+                scalar_opcode_info.single_operand_is_two_component ? 2 : 1;
+            for (uint32_t j = 0; j < alu.scalar_component_count; ++j) {
+              source.components[j] = uint8_t(
+                  ucode::AluInstruction::GetSwizzledComponentIndex(
+                      scalar_src_swizzle, (3 + j) & 3));
+            }
+          } break;
+          case 2: {
+            alu.scalar_component_count = 2;
+            uint32_t negate_bit = uint32_t(alu_instr.src_negate(3)) << 31;
+            // c#.w.
+            DecodedAluSource& constant_source = alu.scalar_sources[0];
+            constant_source.reg = alu_instr.src_reg(3);
+            constant_source.is_temp = false;
+            constant_source.is_relative = alu_instr.src_const_is_addressed(3);
+            constant_source.is_a0_relative =
+                alu_instr.is_const_address_register_relative();
+            constant_source.absolute_mask = ~UINT32_C(0);
+            constant_source.negate_bit = negate_bit;
+            constant_source.components[0] =
+                uint8_t(ucode::AluInstruction::GetSwizzledComponentIndex(
+                    scalar_src_swizzle, 3));
+            // r#.x.
+            DecodedAluSource& temp_source = alu.scalar_sources[1];
+            temp_source.reg = alu_instr.scalar_const_reg_op_src_temp_reg();
+            temp_source.is_temp = true;
+            temp_source.is_relative = false;
+            temp_source.is_a0_relative = false;
+            temp_source.absolute_mask = ~UINT32_C(0);
+            temp_source.negate_bit = negate_bit;
+            temp_source.components[0] =
+                uint8_t(ucode::AluInstruction::GetSwizzledComponentIndex(
+                    scalar_src_swizzle, 0));
+          } break;
+          default:
+            break;
+        }
+
+        alu.scalar_result_write_mask = alu_instr.GetScalarOpResultWriteMask();
+        alu.constant_0_write_mask = alu_instr.GetConstant0WriteMask();
+        alu.constant_1_write_mask = alu_instr.GetConstant1WriteMask();
+        alu.vector_dest = alu_instr.vector_dest();
+        alu.scalar_dest = alu_instr.scalar_dest();
+        alu.is_export = alu_instr.is_export();
+        alu.is_vector_dest_relative = alu_instr.is_vector_dest_relative();
+        alu.is_scalar_dest_relative = alu_instr.is_scalar_dest_relative();
+        alu.vector_clamp = alu_instr.vector_clamp();
+        alu.scalar_clamp = alu_instr.scalar_clamp();
+      }
+    }
+  }
+  return program;
+}
+
+namespace {
+
+// Forwards the exports of one lane executed by Execute's control flow loop to
+// a batch export sink.
+class LaneExportSink : public ShaderInterpreter::ExportSink {
+ public:
+  explicit LaneExportSink(ShaderInterpreter::BatchExportSink* batch_export_sink)
+      : batch_export_sink_(batch_export_sink) {}
+
+  void set_lane(uint32_t lane) { lane_ = lane; }
+
+  void AllocExport(ucode::AllocType type, uint32_t size) override {
+    if (batch_export_sink_) {
+      batch_export_sink_->AllocExport(type, size);
+    }
+  }
+  void Export(ucode::ExportRegister export_register, const float* value,
+              uint32_t value_mask) override {
+    if (!batch_export_sink_) {
+      return;
+    }
+    float lane_value[4][ShaderInterpreter::kMaxBatchLanes];
+    for (uint32_t i = 0; i < 4; ++i) {
+      lane_value[i][lane_] = value[i];
+    }
+    batch_export_sink_->Export(export_register, lane_value, value_mask,
+                               UINT32_C(1) << lane_);
+  }
+
+ private:
+  ShaderInterpreter::BatchExportSink* batch_export_sink_;
+  uint32_t lane_ = 0;
+};
+
+}  // namespace
+
+void ShaderInterpreter::ExecuteBatch(uint32_t lane_count) {
+  assert_true(lane_count && lane_count <= kMaxBatchLanes);
+  lane_count = std::min(lane_count, kMaxBatchLanes);
+  if (!lane_count) {
+    return;
+  }
+
+  // For more consistency between invocations in case of a malformed shader.
+  state_.Reset();
+  batch_state_.Reset();
+
+  uint32_t lane_mask = (UINT32_C(1) << lane_count) - 1;
+  if (!program_) {
+    ExecuteLanesFromControlFlow(0, lane_mask);
+    return;
+  }
+  if (lane_count <= 4) {
+    ExecuteBatchLanes<4>(lane_mask);
+  } else if (lane_count <= 8) {
+    ExecuteBatchLanes<8>(lane_mask);
+  } else {
+    ExecuteBatchLanes<16>(lane_mask);
+  }
+}
+
+template <uint32_t Lanes>
+void ShaderInterpreter::ExecuteBatchLanes(uint32_t lane_mask) {
+  const Program& program = *program_;
+
+  const uint32_t* bool_constants =
+      &register_file_[XE_GPU_REG_SHADER_CONSTANT_BOOL_000_031];
+  auto get_bool_constant = [bool_constants](uint32_t bool_address) {
+    return (bool_constants[bool_address >> 5] &
+            (UINT32_C(1) << (bool_address & 31))) != 0;
+  };
+
+  // Lanes that haven't reached the end of the shader. With kCondExecPred*End,
+  // only the lanes executing the exec end.
+  uint32_t live_lanes = lane_mask;
+  uint32_t cf_index_next = 1;
+  for (uint32_t cf_index = 0; live_lanes; cf_index = cf_index_next) {
+    cf_index_next = cf_index + 1;
+
+    if (cf_index >= program.control_flow.size()) {
+      // Outside the instructions found by the ucode analysis.
+      ExecuteLanesFromControlFlow(cf_index, live_lanes);
+      return;
+    }
+    const Program::ControlFlow& cf = program.control_flow[cf_index];
+    const ucode::ControlFlowInstruction& cf_instr = cf.instruction;
+    uint32_t predicate_true_lanes = batch_state_.predicate & live_lanes;
+    uint32_t predicate_false_lanes = ~batch_state_.predicate & live_lanes;
+
+    ucode::ControlFlowOpcode cf_opcode = cf_instr.opcode();
+    switch (cf_opcode) {
+      case ucode::ControlFlowOpcode::kNop: {
+      } break;
+
+      case ucode::ControlFlowOpcode::kExec:
+      case ucode::ControlFlowOpcode::kExecEnd:
+      case ucode::ControlFlowOpcode::kCondExec:
+      case ucode::ControlFlowOpcode::kCondExecEnd:
+      case ucode::ControlFlowOpcode::kCondExecPred:
+      case ucode::ControlFlowOpcode::kCondExecPredEnd:
+      case ucode::ControlFlowOpcode::kCondExecPredClean:
+      case ucode::ControlFlowOpcode::kCondExecPredCleanEnd: {
+        uint32_t exec_lanes = live_lanes;
+        switch (cf_opcode) {
+          case ucode::ControlFlowOpcode::kCondExec:
+          case ucode::ControlFlowOpcode::kCondExecEnd:
+          case ucode::ControlFlowOpcode::kCondExecPredClean:
+          case ucode::ControlFlowOpcode::kCondExecPredCleanEnd: {
+            const ucode::ControlFlowCondExecInstruction& cf_cond_exec =
+                cf_instr.cond_exec;
+            if (cf_cond_exec.condition() !=
+                get_bool_constant(cf_cond_exec.bool_address())) {
+              exec_lanes = 0;
+            }
+          } break;
+          case ucode::ControlFlowOpcode::kCondExecPred:
+          case ucode::ControlFlowOpcode::kCondExecPredEnd: {
+            exec_lanes = cf_instr.cond_exec_pred.condition()
+                             ? predicate_true_lanes
+                             : predicate_false_lanes;
+          } break;
+          default:
+            break;
+        }
+        if (!exec_lanes) {
+          continue;
+        }
+
+        const ucode::ControlFlowExecInstruction& cf_exec = cf_instr.exec;
+        for (uint32_t exec_index = 0; exec_index < cf_exec.count();
+             ++exec_index) {
+          const Program::Instruction& instruction =
+              program.instructions[cf.instructions_first + exec_index];
+          uint32_t instruction_lanes = exec_lanes;
+          if (instruction.is_predicated) {
+            instruction_lanes &= instruction.predicate_condition
+                                     ? batch_state_.predicate
+                                     : ~batch_state_.predicate;
+            if (!instruction_lanes) {
+              continue;
+            }
+          }
+          if (instruction.is_fetch) {
+            ExecuteBatchFetchInstruction(instruction.fetch, instruction_lanes);
+          } else {
+            ExecuteBatchAluInstruction<Lanes>(instruction.alu,
+                                              instruction_lanes);
+          }
+        }
+
+        if (ucode::DoesControlFlowOpcodeEndShader(cf_opcode)) {
+          live_lanes &= ~exec_lanes;
+        }
+      } break;
+
+      case ucode::ControlFlowOpcode::kLoopStart: {
+        const ucode::ControlFlowLoopStartInstruction& cf_loop_start =
+            cf_instr.loop_start;
+        assert_true(state_.loop_stack_depth < 4);
+        if (++state_.loop_stack_depth > 4) {
+          cf_index_next = cf_loop_start.address();
+          continue;
+        }
+        auto loop_constant = register_file_.Get<xenos::LoopConstant>(
+            XE_GPU_REG_SHADER_CONSTANT_LOOP_00 + cf_loop_start.loop_id());
+        state_.loop_constants[state_.loop_stack_depth] = loop_constant;
+        uint32_t& loop_iterator_ref =
+            state_.loop_iterators[state_.loop_stack_depth];
+        if (!cf_loop_start.is_repeat()) {
+          loop_iterator_ref = 0;
+        }
+        if (loop_iterator_ref >= loop_constant.count) {
+          cf_index_next = cf_loop_start.address();
+          continue;
+        }
+        ++state_.loop_stack_depth;
+      } break;
+
+      case ucode::ControlFlowOpcode::kLoopEnd: {
+        assert_not_zero(state_.loop_stack_depth);
+        if (!state_.loop_stack_depth) {
+          continue;
+        }
+        assert_true(state_.loop_stack_depth <= 4);
+        if (state_.loop_stack_depth > 4) {
+          --state_.loop_stack_depth;
+          continue;
+        }
+        const ucode::ControlFlowLoopEndInstruction& cf_loop_end =
+            cf_instr.loop_end;
+        bool is_break = false;
+        if (cf_loop_end.is_predicated_break()) {
+          uint32_t break_lanes = cf_loop_end.condition() ? predicate_true_lanes
+                                                         : predicate_false_lanes;
+          if (break_lanes && break_lanes != live_lanes) {
+            ExecuteLanesFromControlFlow(cf_index, live_lanes);
+            return;
+          }
+          is_break = break_lanes != 0;
+        }
+        xenos::LoopConstant loop_constant =
+            state_.loop_constants[state_.loop_stack_depth - 1];
+        uint32_t loop_iterator =
+            ++state_.loop_iterators[state_.loop_stack_depth - 1];
+        if (loop_iterator < loop_constant.count && !is_break) {
+          cf_index_next = cf_loop_end.address();
+          continue;
+        }
+        --state_.loop_stack_depth;
+      } break;
+
+      case ucode::ControlFlowOpcode::kCondCall: {
+        assert_true(state_.call_stack_depth < 4);
+        if (state_.call_stack_depth >= 4) {
+          continue;
+        }
+        const ucode::ControlFlowCondCallInstruction& cf_cond_call =
+            cf_instr.cond_call;
+        if (!cf_cond_call.is_unconditional()) {
+          if (cf_cond_call.is_predicated()) {
+            uint32_t call_lanes = cf_cond_call.condition()
+                                      ? predicate_true_lanes
+                                      : predicate_false_lanes;
+            if (call_lanes && call_lanes != live_lanes) {
+              ExecuteLanesFromControlFlow(cf_index, live_lanes);
+              return;
+            }
+            if (!call_lanes) {
+              continue;
+            }
+          } else if (cf_cond_call.condition() !=
+                     get_bool_constant(cf_cond_call.bool_address())) {
+            continue;
+          }
+        }
+        state_.call_return_addresses[state_.call_stack_depth++] = cf_index + 1;
+        cf_index_next = cf_cond_call.address();
+      } break;
+
+      case ucode::ControlFlowOpcode::kReturn: {
+        // No stack depth assertion - skipping the return is a well-defined
+        // behavior for `return` outside a function call.
+        if (!state_.call_stack_depth) {
+          continue;
+        }
+        cf_index_next = state_.call_return_addresses[--state_.call_stack_depth];
+      } break;
+
+      case ucode::ControlFlowOpcode::kCondJmp: {
+        const ucode::ControlFlowCondJmpInstruction& cf_cond_jmp =
+            cf_instr.cond_jmp;
+        if (!cf_cond_jmp.is_unconditional()) {
+          if (cf_cond_jmp.is_predicated()) {
+            uint32_t jmp_lanes = cf_cond_jmp.condition()
+                                     ? predicate_true_lanes
+                                     : predicate_false_lanes;
+            if (jmp_lanes && jmp_lanes != live_lanes) {
+              ExecuteLanesFromControlFlow(cf_index, live_lanes);
+              return;
+            }
+            if (!jmp_lanes) {
+              continue;
+            }
+          } else if (cf_cond_jmp.condition() !=
+                     get_bool_constant(cf_cond_jmp.bool_address())) {
+            continue;
+          }
+        }
+        cf_index_next = cf_cond_jmp.address();
+      } break;
+
+      case ucode::ControlFlowOpcode::kAlloc: {
+        if (batch_export_sink_) {
+          const ucode::ControlFlowAllocInstruction& cf_alloc = cf_instr.alloc;
+          batch_export_sink_->AllocExport(cf_alloc.alloc_type(),
+                                          cf_alloc.size());
+        }
+      } break;
+
+      case ucode::ControlFlowOpcode::kMarkVsFetchDone: {
+      } break;
+
+      default:
+        assert_unhandled_case(cf_opcode);
+    }
+  }
+}
+
+void ShaderInterpreter::ExecuteLanesFromControlFlow(uint32_t cf_index,
+                                                    uint32_t lane_mask) {
+  State shared_state = state_;
+  ExportSink* export_sink = export_sink_;
+  LaneExportSink lane_export_sink(batch_export_sink_);
+  export_sink_ = &lane_export_sink;
+  uint32_t lanes_remaining = lane_mask;
+  uint32_t lane;
+  while (rex::bit_scan_forward(lanes_remaining, &lane)) {
+    lanes_remaining &= ~(UINT32_C(1) << lane);
+    state_ = shared_state;
+    state_.vfetch_full_last = batch_state_.vfetch_full_last[lane];
+    state_.vfetch_address_dwords = batch_state_.vfetch_address_dwords[lane];
+    state_.previous_scalar = batch_state_.previous_scalar[lane];
+    state_.address_register = batch_state_.address_register[lane];
+    state_.predicate = IsLaneActive(batch_state_.predicate, lane);
+    for (uint32_t i = 0; i < xenos::kMaxShaderTempRegisters; ++i) {
+      for (uint32_t j = 0; j < 4; ++j) {
+        temp_registers_[i][j] = batch_temp_registers_[i][j][lane];
+      }
+    }
+    lane_export_sink.set_lane(lane);
+    ExecuteControlFlow(cf_index);
+    for (uint32_t i = 0; i < xenos::kMaxShaderTempRegisters; ++i) {
+      for (uint32_t j = 0; j < 4; ++j) {
+        batch_temp_registers_[i][j][lane] = temp_registers_[i][j];
+      }
+    }
+  }
+  export_sink_ = export_sink;
+}
+
+template <uint32_t Lanes>
+void ShaderInterpreter::LoadBatchAluSource(
+    const DecodedAluSource& source, uint32_t component_count,
+    float (*value)[kMaxBatchLanes]) const {
+  if (source.is_temp) {
+    const float(*src)[kMaxBatchLanes] =
+        batch_temp_registers_[GetTempRegisterIndex(source.reg,
+                                                   source.is_relative)];
+    for (uint32_t i = 0; i < component_count; ++i) {
+      const float* src_component = src[source.components[i]];
+      for (uint32_t lane = 0; lane < Lanes; ++lane) {
+        value[i][lane] = src_component[lane];
+      }
+    }
+  } else if (source.is_relative && source.is_a0_relative) {
+    for (uint32_t lane = 0; lane < Lanes; ++lane) {
+      std::array<float, 4> constant = GetFloatConstant(
+          int32_t(source.reg) + batch_state_.address_register[lane]);
+      for (uint32_t i = 0; i < component_count; ++i) {
+        value[i][lane] = constant[source.components[i]];
+      }
+    }
+  } else {
+    std::array<float, 4> constant =
+        GetFloatConstant(source.reg, source.is_relative, false);
+    for (uint32_t i = 0; i < component_count; ++i) {
+      float constant_component = constant[source.components[i]];
+      for (uint32_t lane = 0; lane < Lanes; ++lane) {
+        value[i][lane] = constant_component;
+      }
+    }
+  }
+  for (uint32_t i = 0; i < component_count; ++i) {
+    for (uint32_t lane = 0; lane < Lanes; ++lane) {
+      // FlushDenormal, then the absolute value and negation.
+      uint32_t bits = rex::memory::Reinterpret<uint32_t>(value[i][lane]);
+      bits &= (bits & UINT32_C(0x7F800000)) ? ~UINT32_C(0) : (UINT32_C(1) << 31);
+      value[i][lane] = rex::memory::Reinterpret<float>(
+          (bits & source.absolute_mask) ^ source.negate_bit);
+    }
+  }
+}
+
+template <uint32_t Lanes>
+void ShaderInterpreter::ExecuteBatchAluInstruction(
+    const DecodedAluInstruction& instr, uint32_t lane_mask) {
+  // Predicate and a0 results, stored for the lanes in lane_mask.
+  uint32_t new_predicate = 0;
+  bool predicate_changed = false;
+  alignas(64) int32_t new_address_register[kMaxBatchLanes];
+  bool address_register_changed = false;
+  auto commit_state = [&]() {
+    if (predicate_changed) {
+      batch_state_.predicate =
+          (batch_state_.predicate & ~lane_mask) | (new_predicate & lane_mask);
+      predicate_changed = false;
+    }
+    if (address_register_changed) {
+      for (uint32_t lane = 0; lane < Lanes; ++lane) {
+        if (IsLaneActive(lane_mask, lane)) {
+          batch_state_.address_register[lane] = new_address_register[lane];
+        }
+      }
+      address_register_changed = false;
+    }
+  };
+
+  // Vector operation.
+  alignas(64) float vector_result[4][kMaxBatchLanes] = {};
+  if (instr.executes_vector_op) {
+    alignas(64) float operands[3][4][kMaxBatchLanes];
+    for (uint32_t i = 0; i < 3; ++i) {
+      if (instr.vector_operand_used[i]) {
+        LoadBatchAluSource<Lanes>(instr.vector_sources[i], 4, operands[i]);
+      }
+    }
+    const float(*a)[kMaxBatchLanes] = operands[0];
+    const float(*b)[kMaxBatchLanes] = operands[1];
+    const float(*c)[kMaxBatchLanes] = operands[2];
+    auto per_component = [&](auto op) {
+      for (uint32_t i = 0; i < 4; ++i) {
+        for (uint32_t lane = 0; lane < Lanes; ++lane) {
+          vector_result[i][lane] = op(i, lane);
+        }
+      }
+    };
+    auto per_lane = [&](auto op) {
+      for (uint32_t lane = 0; lane < Lanes; ++lane) {
+        vector_result[0][lane] = op(lane);
+      }
+    };
+    auto set_predicate_push = [&](auto compare) {
+      for (uint32_t lane = 0; lane < Lanes; ++lane) {
+        new_predicate |=
+            uint32_t(a[3][lane] == 0.0f && compare(b[3][lane], 0.0f)) << lane;
+        vector_result[0][lane] =
+            (a[0][lane] == 0.0f && compare(b[0][lane], 0.0f))
+                ? 0.0f
+                : a[0][lane] + 1.0f;
+      }
+      predicate_changed = true;
+    };
+
+    bool replicate_vector_result_x = false;
+    switch (instr.vector_opcode) {
+      case ucode::AluVectorOpcode::kAdd: {
+        per_component([&](uint32_t i, uint32_t lane) {
+          return a[i][lane] + b[i][lane];
+        });
+      } break;
+      case ucode::AluVectorOpcode::kMul: {
+        per_component([&](uint32_t i, uint32_t lane) {
+          return MulD3D9(a[i][lane], b[i][lane]);
+        });
+      } break;
+      case ucode::AluVectorOpcode::kMax: {
+        per_component([&](uint32_t i, uint32_t lane) {
+          return std::isgreaterequal(a[i][lane], b[i][lane]) ? a[i][lane]
+                                                             : b[i][lane];
+        });
+      } break;
+      case ucode::AluVectorOpcode::kMin: {
+        per_component([&](uint32_t i, uint32_t lane) {
+          return std::isless(a[i][lane], b[i][lane]) ? a[i][lane] : b[i][lane];
+        });
+      } break;
+      case ucode::AluVectorOpcode::kSeq: {
+        per_component([&](uint32_t i, uint32_t lane) {
+          return float(a[i][lane] == b[i][lane]);
+        });
+      } break;
+      case ucode::AluVectorOpcode::kSgt: {
+        per_component([&](uint32_t i, uint32_t lane) {
+          return float(std::isgreater(a[i][lane], b[i][lane]));
+        });
+      } break;
+      case ucode::AluVectorOpcode::kSge: {
+        per_component([&](uint32_t i, uint32_t lane) {
+          return float(std::isgreaterequal(a[i][lane], b[i][lane]));
+        });
+      } break;
+      case ucode::AluVectorOpcode::kSne: {
+        per_component([&](uint32_t i, uint32_t lane) {
+          return float(a[i][lane] != b[i][lane]);
+        });
+      } break;
+      case ucode::AluVectorOpcode::kFrc: {
+        per_component([&](uint32_t i, uint32_t lane) {
+          return a[i][lane] - std::floor(a[i][lane]);
+        });
+      } break;
+      case ucode::AluVectorOpcode::kTrunc: {
+        per_component(
+            [&](uint32_t i, uint32_t lane) { return std::trunc(a[i][lane]); });
+      } break;
+      case ucode::AluVectorOpcode::kFloor: {
+        per_component(
+            [&](uint32_t i, uint32_t lane) { return std::floor(a[i][lane]); });
+      } break;
+      case ucode::AluVectorOpcode::kMad: {
+        // Doing the addition rather than conditional assignment even for zero
+        // operands because +0 + -0 must be +0.
+        per_component([&](uint32_t i, uint32_t lane) {
+          return MulD3D9(a[i][lane], b[i][lane]) + c[i][lane];
+        });
+      } break;
+      case ucode::AluVectorOpcode::kCndEq: {
+        per_component([&](uint32_t i, uint32_t lane) {
+          return a[i][lane] == 0.0f ? b[i][lane] : c[i][lane];
+        });
+      } break;
+      case ucode::AluVectorOpcode::kCndGe: {
+        per_component([&](uint32_t i, uint32_t lane) {
+          return std::isgreaterequal(a[i][lane], 0.0f) ? b[i][lane]
+                                                       : c[i][lane];
+        });
+      } break;
+      case ucode::AluVectorOpcode::kCndGt: {
+        per_component([&](uint32_t i, uint32_t lane) {
+          return std::isgreater(a[i][lane], 0.0f) ? b[i][lane] : c[i][lane];
+        });
+      } break;
+      case ucode::AluVectorOpcode::kDp4: {
+        // Doing the addition even for zero operands because +0 + -0 must be
+        // +0.
+        per_lane([&](uint32_t lane) {
+          float dot = 0.0f;
+          for (uint32_t i = 0; i < 4; ++i) {
+            dot += MulD3D9(a[i][lane], b[i][lane]);
+          }
+          return dot;
+        });
+        replicate_vector_result_x = true;
+      } break;
+      case ucode::AluVectorOpcode::kDp3: {
+        per_lane([&](uint32_t lane) {
+          float dot = 0.0f;
+          for (uint32_t i = 0; i < 3; ++i) {
+            dot += MulD3D9(a[i][lane], b[i][lane]);
+          }
+          return dot;
+        });
+        replicate_vector_result_x = true;
+      } break;
+      case ucode::AluVectorOpcode::kDp2Add: {
+        per_lane([&](uint32_t lane) {
+          float dot = 0.0f;
+          for (uint32_t i = 0; i < 2; ++i) {
+            dot += MulD3D9(a[i][lane], b[i][lane]);
+          }
+          return dot + c[0][lane];
+        });
+        replicate_vector_result_x = true;
+      } break;
+      case ucode::AluVectorOpcode::kCube: {
+        for (uint32_t lane = 0; lane < Lanes; ++lane) {
+          // Operand [0] is .z_xy.
+          float x = a[2][lane];
+          float y = a[3][lane];
+          float z = a[0][lane];
+          float x_abs = std::abs(x), y_abs = std::abs(y), z_abs = std::abs(z);
+          // Result is T coordinate, S coordinate, 2 * major axis, face ID.
+          if (z_abs >= x_abs && z_abs >= y_abs) {
+            bool z_negative = std::isless(z, 0.0f);
+            vector_result[0][lane] = -y;
+            vector_result[1][lane] = z_negative ? -x : x;
+            vector_result[2][lane] = z;
+            vector_result[3][lane] = z_negative ? 5.0f : 4.0f;
+          } else if (y_abs >= x_abs) {
+            bool y_negative = std::isless(y, 0.0f);
+            vector_result[0][lane] = y_negative ? -z : z;
+            vector_result[1][lane] = x;
+            vector_result[2][lane] = y;
+            vector_result[3][lane] = y_negative ? 3.0f : 2.0f;
+          } else {
+            bool x_negative = std::isless(x, 0.0f);
+            vector_result[0][lane] = -y;
+            vector_result[1][lane] = x_negative ? z : -z;
+            vector_result[2][lane] = x;
+            vector_result[3][lane] = x_negative ? 1.0f : 0.0f;
+          }
+          vector_result[2][lane] *= 2.0f;
+        }
+      } break;
+      case ucode::AluVectorOpcode::kMax4: {
+        per_lane([&](uint32_t lane) {
+          if (std::isgreaterequal(a[0][lane], a[1][lane]) &&
+              std::isgreaterequal(a[0][lane], a[2][lane]) &&
+              std::isgreaterequal(a[0][lane], a[3][lane])) {
+            return a[0][lane];
+          }
+          if (std::isgreaterequal(a[1][lane], a[2][lane]) &&
+              std::isgreaterequal(a[1][lane], a[3][lane])) {
+            return a[1][lane];
+          }
+          return std::isgreaterequal(a[2][lane], a[3][lane]) ? a[2][lane]
+                                                             : a[3][lane];
+        });
+        replicate_vector_result_x = true;
+      } break;
+      case ucode::AluVectorOpcode::kSetpEqPush: {
+        set_predicate_push([](float x, float) { return x == 0.0f; });
+        replicate_vector_result_x = true;
+      } break;
+      case ucode::AluVectorOpcode::kSetpNePush: {
+        set_predicate_push([](float x, float) { return x != 0.0f; });
+        replicate_vector_result_x = true;
+      } break;
+      case ucode::AluVectorOpcode::kSetpGtPush: {
+        set_predicate_push(
+            [](float x, float zero) { return std::isgreater(x, zero); });
+        replicate_vector_result_x = true;
+      } break;
+      case ucode::AluVectorOpcode::kSetpGePush: {
+        set_predicate_push(
+            [](float x, float zero) { return std::isgreaterequal(x, zero); });
+        replicate_vector_result_x = true;
+      } break;
+      // Not implementing pixel kill currently, the interpreter is currently
+      // used only for vertex shaders.
+      case ucode::AluVectorOpcode::kKillEq: {
+        per_lane([&](uint32_t lane) {
+          return float(a[0][lane] == b[0][lane] || a[1][lane] == b[1][lane] ||
+                       a[2][lane] == b[2][lane] || a[3][lane] == b[3][lane]);
+        });
+        replicate_vector_result_x = true;
+      } break;
+      case ucode::AluVectorOpcode::kKillGt: {
+        per_lane([&](uint32_t lane) {
+          return float(std::isgreater(a[0][lane], b[0][lane]) ||
+                       std::isgreater(a[1][lane], b[1][lane]) ||
+                       std::isgreater(a[2][lane], b[2][lane]) ||
+                       std::isgreater(a[3][lane], b[3][lane]));
+        });
+        replicate_vector_result_x = true;
+      } break;
+      case ucode::AluVectorOpcode::kKillGe: {
+        per_lane([&](uint32_t lane) {
+          return float(std::isgreaterequal(a[0][lane], b[0][lane]) ||
+                       std::isgreaterequal(a[1][lane], b[1][lane]) ||
+                       std::isgreaterequal(a[2][lane], b[2][lane]) ||
+                       std::isgreaterequal(a[3][lane], b[3][lane]));
+        });
+        replicate_vector_result_x = true;
+      } break;
+      case ucode::AluVectorOpcode::kKillNe: {
+        per_lane([&](uint32_t lane) {
+          return float(a[0][lane] != b[0][lane] || a[1][lane] != b[1][lane] ||
+                       a[2][lane] != b[2][lane] || a[3][lane] != b[3][lane]);
+        });
+        replicate_vector_result_x = true;
+      } break;
+      case ucode::AluVectorOpcode::kDst: {
+        for (uint32_t lane = 0; lane < Lanes; ++lane) {
+          vector_result[0][lane] = 1.0f;
+          vector_result[1][lane] = MulD3D9(a[1][lane], b[1][lane]);
+          vector_result[2][lane] = a[2][lane];
+          vector_result[3][lane] = b[3][lane];
+        }
+      } break;
+      case ucode::AluVectorOpcode::kMaxA: {
+        for (uint32_t lane = 0; lane < Lanes; ++lane) {
+          new_address_register[lane] = int32_t(std::floor(
+              rex::clamp_float(a[3][lane], -256.0f, 255.0f) + 0.5f));
+        }
+        address_register_changed = true;
+        per_component([&](uint32_t i, uint32_t lane) {
+          return std::isgreaterequal(a[i][lane], b[i][lane]) ? a[i][lane]
+                                                             : b[i][lane];
+        });
+      } break;
+      default: {
+        assert_unhandled_case(instr.vector_opcode);
+      }
+    }
+    if (replicate_vector_result_x) {
+      for (uint32_t i = 1; i < 4; ++i) {
+        for (uint32_t lane = 0; lane < Lanes; ++lane) {
+          vector_result[i][lane] = vector_result[0][lane];
+        }
+      }
+    }
+    // The scalar operands may be relative to the new a0.
+    commit_state();
+  }
+
+  // Scalar operation.
+  alignas(64) float scalar_operands[2][kMaxBatchLanes];
+  switch (instr.scalar_operand_count) {
+    case 1:
+      LoadBatchAluSource<Lanes>(instr.scalar_sources[0],
+                                instr.scalar_component_count, scalar_operands);
+      break;
+    case 2:
+      LoadBatchAluSource<Lanes>(instr.scalar_sources[0], 1,
+                                &scalar_operands[0]);
+      LoadBatchAluSource<Lanes>(instr.scalar_sources[1], 1,
+                                &scalar_operands[1]);
+      break;
+    default:
+      break;
+  }
+  const float* s0 = scalar_operands[0];
+  const float* s1 = scalar_operands[1];
+  const float* previous = batch_state_.previous_scalar;
+  alignas(64) float scalar_result[kMaxBatchLanes];
+  auto per_lane = [&](auto op) {
+    for (uint32_t lane = 0; lane < Lanes; ++lane) {
+      scalar_result[lane] = op(lane);
+    }
+  };
+  // For setp: the predicate, and the previous scalar from it.
+  auto set_predicate = [&](auto compare, auto result) {
+    for (uint32_t lane = 0; lane < Lanes; ++lane) {
+      bool predicate = compare(lane);
+      new_predicate |= uint32_t(predicate) << lane;
+      scalar_result[lane] = result(lane, predicate);
+    }
+    predicate_changed = true;
+  };
+  auto set_address_register = [&](bool round) {
+    for (uint32_t lane = 0; lane < Lanes; ++lane) {
+      new_address_register[lane] = int32_t(
+          std::floor(rex::clamp_float(s0[lane], -256.0f, 255.0f) +
+                     (round ? 0.5f : 0.0f)));
+    }
+    address_register_changed = true;
+  };
+  // Clamping infinite reciprocals to the largest finite value or to zero.
+  auto clamp_infinity = [](float value, float clamped) {
+    if (value == -INFINITY) {
+      return -clamped;
+    }
+    if (value == INFINITY) {
+      return clamped;
+    }
+    return value;
+  };
+  new_predicate = 0;
+  switch (instr.scalar_opcode) {
+    case ucode::AluScalarOpcode::kAdds:
+    case ucode::AluScalarOpcode::kAddsc0:
+    case ucode::AluScalarOpcode::kAddsc1: {
+      per_lane([&](uint32_t lane) { return s0[lane] + s1[lane]; });
+    } break;
+    case ucode::AluScalarOpcode::kAddsPrev: {
+      per_lane([&](uint32_t lane) { return s0[lane] + previous[lane]; });
+    } break;
+    case ucode::AluScalarOpcode::kMuls:
+    case ucode::AluScalarOpcode::kMulsc0:
+    case ucode::AluScalarOpcode::kMulsc1: {
+      per_lane([&](uint32_t lane) { return MulD3D9(s0[lane], s1[lane]); });
+    } break;
+    case ucode::AluScalarOpcode::kMulsPrev: {
+      per_lane(
+          [&](uint32_t lane) { return MulD3D9(s0[lane], previous[lane]); });
+    } break;
+    case ucode::AluScalarOpcode::kMulsPrev2: {
+      per_lane([&](uint32_t lane) {
+        if (previous[lane] == -FLT_MAX || !std::isfinite(previous[lane]) ||
+            !std::isfinite(s1[lane]) || std::islessequal(s1[lane], 0.0f)) {
+          return -FLT_MAX;
+        }
+        return MulD3D9(s0[lane], previous[lane]);
+      });
+    } break;
+    case ucode::AluScalarOpcode::kMaxs: {
+      per_lane([&](uint32_t lane) {
+        return std::isgreaterequal(s0[lane], s1[lane]) ? s0[lane] : s1[lane];
+      });
+    } break;
+    case ucode::AluScalarOpcode::kMins: {
+      per_lane([&](uint32_t lane) {
+        return std::isless(s0[lane], s1[lane]) ? s0[lane] : s1[lane];
+      });
+    } break;
+    case ucode::AluScalarOpcode::kSeqs: {
+      per_lane([&](uint32_t lane) { return float(s0[lane] == 0.0f); });
+    } break;
+    case ucode::AluScalarOpcode::kSgts: {
+      per_lane(
+          [&](uint32_t lane) { return float(std::isgreater(s0[lane], 0.0f)); });
+    } break;
+    case ucode::AluScalarOpcode::kSges: {
+      per_lane([&](uint32_t lane) {
+        return float(std::isgreaterequal(s0[lane], 0.0f));
+      });
+    } break;
+    case ucode::AluScalarOpcode::kSnes: {
+      per_lane([&](uint32_t lane) { return float(s0[lane] != 0.0f); });
+    } break;
+    case ucode::AluScalarOpcode::kFrcs: {
+      per_lane([&](uint32_t lane) { return s0[lane] - std::floor(s0[lane]); });
+    } break;
+    case ucode::AluScalarOpcode::kTruncs: {
+      per_lane([&](uint32_t lane) { return std::trunc(s0[lane]); });
+    } break;
+    case ucode::AluScalarOpcode::kFloors: {
+      per_lane([&](uint32_t lane) { return std::floor(s0[lane]); });
+    } break;
+    case ucode::AluScalarOpcode::kExp: {
+      per_lane([&](uint32_t lane) { return std::exp2(s0[lane]); });
+    } break;
+    case ucode::AluScalarOpcode::kLogc: {
+      per_lane([&](uint32_t lane) {
+        float result = std::log2(s0[lane]);
+        return result == -INFINITY ? -FLT_MAX : result;
+      });
+    } break;
+    case ucode::AluScalarOpcode::kLog: {
+      per_lane([&](uint32_t lane) { return std::log2(s0[lane]); });
+    } break;
+    case ucode::AluScalarOpcode::kRcpc: {
+      per_lane([&](uint32_t lane) {
+        return clamp_infinity(1.0f / s0[lane], FLT_MAX);
+      });
+    } break;
+    case ucode::AluScalarOpcode::kRcpf: {
+      per_lane(
+          [&](uint32_t lane) { return clamp_infinity(1.0f / s0[lane], 0.0f); });
+    } break;
+    case ucode::AluScalarOpcode::kRcp: {
+      per_lane([&](uint32_t lane) { return 1.0f / s0[lane]; });
+    } break;
+    case ucode::AluScalarOpcode::kRsqc: {
+      per_lane([&](uint32_t lane) {
+        return clamp_infinity(1.0f / std::sqrt(s0[lane]), FLT_MAX);
+      });
+    } break;
+    case ucode::AluScalarOpcode::kRsqf: {
+      per_lane([&](uint32_t lane) {
+        return clamp_infinity(1.0f / std::sqrt(s0[lane]), 0.0f);
+      });
+    } break;
+    case ucode::AluScalarOpcode::kRsq: {
+      per_lane([&](uint32_t lane) { return 1.0f / std::sqrt(s0[lane]); });
+    } break;
+    case ucode::AluScalarOpcode::kMaxAs:
+    case ucode::AluScalarOpcode::kMaxAsf: {
+      set_address_register(instr.scalar_opcode ==
+                           ucode::AluScalarOpcode::kMaxAs);
+      per_lane([&](uint32_t lane) {
+        return std::isgreaterequal(s0[lane], s1[lane]) ? s0[lane] : s1[lane];
+      });
+    } break;
+    case ucode::AluScalarOpcode::kSubs:
+    case ucode::AluScalarOpcode::kSubsc0:
+    case ucode::AluScalarOpcode::kSubsc1: {
+      per_lane([&](uint32_t lane) { return s0[lane] - s1[lane]; });
+    } break;
+    case ucode::AluScalarOpcode::kSubsPrev: {
+      per_lane([&](uint32_t lane) { return s0[lane] - previous[lane]; });
+    } break;
+    case ucode::AluScalarOpcode::kSetpEq: {
+      set_predicate([&](uint32_t lane) { return s0[lane] == 0.0f; },
+                    [](uint32_t, bool p) { return float(!p); });
+    } break;
+    case ucode::AluScalarOpcode::kSetpNe: {
+      set_predicate([&](uint32_t lane) { return s0[lane] != 0.0f; },
+                    [](uint32_t, bool p) { return float(!p); });
+    } break;
+    case ucode::AluScalarOpcode::kSetpGt: {
+      set_predicate(
+          [&](uint32_t lane) { return std::isgreater(s0[lane], 0.0f); },
+          [](uint32_t, bool p) { return float(!p); });
+    } break;
+    case ucode::AluScalarOpcode::kSetpGe: {
+      set_predicate(
+          [&](uint32_t lane) { return std::isgreaterequal(s0[lane], 0.0f); },
+          [](uint32_t, bool p) { return float(!p); });
+    } break;
+    case ucode::AluScalarOpcode::kSetpInv: {
+      set_predicate([&](uint32_t lane) { return s0[lane] == 1.0f; },
+                    [&](uint32_t lane, bool p) {
+                      return p ? 0.0f
+                               : (s0[lane] == 0.0f ? 1.0f : s0[lane]);
+                    });
+    } break;
+    case ucode::AluScalarOpcode::kSetpPop: {
+      set_predicate(
+          [&](uint32_t lane) {
+            return std::islessequal(s0[lane] - 1.0f, 0.0f);
+          },
+          [&](uint32_t lane, bool p) { return p ? 0.0f : s0[lane] - 1.0f; });
+    } break;
+    case ucode::AluScalarOpcode::kSetpClr: {
+      set_predicate([](uint32_t) { return false; },
+                    [](uint32_t, bool) { return FLT_MAX; });
+    } break;
+    case ucode::AluScalarOpcode::kSetpRstr: {
+      set_predicate([&](uint32_t lane) { return s0[lane] == 0.0f; },
+                    [&](uint32_t lane, bool p) { return p ? 0.0f : s0[lane]; });
+    } break;
+    // Not implementing pixel kill currently, the interpreter is currently used
+    // only for vertex shaders.
+    case ucode::AluScalarOpcode::kKillsEq: {
+      per_lane([&](uint32_t lane) { return float(s0[lane] == 0.0f); });
+    } break;
+    case ucode::AluScalarOpcode::kKillsGt: {
+      per_lane(
+          [&](uint32_t lane) { return float(std::isgreater(s0[lane], 0.0f)); });
+    } break;
+    case ucode::AluScalarOpcode::kKillsGe: {
+      per_lane([&](uint32_t lane) {
+        return float(std::isgreaterequal(s0[lane], 0.0f));
+      });
+    } break;
+    case ucode::AluScalarOpcode::kKillsNe: {
+      per_lane([&](uint32_t lane) { return float(s0[lane] != 0.0f); });
+    } break;
+    case ucode::AluScalarOpcode::kKillsOne: {
+      per_lane([&](uint32_t lane) { return float(s0[lane] == 1.0f); });
+    } break;
+    case ucode::AluScalarOpcode::kSqrt: {
+      per_lane([&](uint32_t lane) { return std::sqrt(s0[lane]); });
+    } break;
+    case ucode::AluScalarOpcode::kSin: {
+      per_lane([&](uint32_t lane) { return std::sin(s0[lane]); });
+    } break;
+    case ucode::AluScalarOpcode::kCos: {
+      per_lane([&](uint32_t lane) { return std::cos(s0[lane]); });
+    } break;
+    case ucode::AluScalarOpcode::kRetainPrev: {
+      per_lane([&](uint32_t lane) { return previous[lane]; });
+    } break;
+    default: {
+      assert_unhandled_case(instr.scalar_opcode);
+      per_lane([&](uint32_t lane) { return previous[lane]; });
+    }
+  }
+  commit_state();
+  for (uint32_t lane = 0; lane < Lanes; ++lane) {
+    if (IsLaneActive(lane_mask, lane)) {
+      batch_state_.previous_scalar[lane] = scalar_result[lane];
+    }
+  }
+
+  if (instr.vector_clamp) {
+    for (uint32_t i = 0; i < 4; ++i) {
+      for (uint32_t lane = 0; lane < Lanes; ++lane) {
+        vector_result[i][lane] = rex::saturate(vector_result[i][lane]);
+      }
+    }
+  }
+  if (instr.scalar_clamp) {
+    for (uint32_t lane = 0; lane < Lanes; ++lane) {
+      scalar_result[lane] = rex::saturate(scalar_result[lane]);
+    }
+  }
+
+  if (instr.is_export) {
+    if (batch_export_sink_) {
+      alignas(64) float export_value[4][kMaxBatchLanes];
+      for (uint32_t i = 0; i < 4; ++i) {
+        uint32_t export_component_bit = UINT32_C(1) << i;
+        const float* export_source = nullptr;
+        float export_constant = 0.0f;
+        if (instr.vector_result_write_mask & export_component_bit) {
+          export_source = vector_result[i];
+        } else if (instr.scalar_result_write_mask & export_component_bit) {
+          export_source = scalar_result;
+        } else if (instr.constant_1_write_mask & export_component_bit) {
+          export_constant = 1.0f;
+        }
+        for (uint32_t lane = 0; lane < Lanes; ++lane) {
+          export_value[i][lane] =
+              export_source ? export_source[lane] : export_constant;
+        }
+      }
+      batch_export_sink_->Export(
+          ucode::ExportRegister(instr.vector_dest), export_value,
+          instr.vector_result_write_mask | instr.scalar_result_write_mask |
+              instr.constant_0_write_mask | instr.constant_1_write_mask,
+          lane_mask);
+    }
+  } else {
+    if (instr.vector_result_write_mask) {
+      float(*vector_dest)[kMaxBatchLanes] =
+          batch_temp_registers_[GetTempRegisterIndex(
+              instr.vector_dest, instr.is_vector_dest_relative)];
+      for (uint32_t i = 0; i < 4; ++i) {
+        if (!(instr.vector_result_write_mask & (UINT32_C(1) << i))) {
+          continue;
+        }
+        for (uint32_t lane = 0; lane < Lanes; ++lane) {
+          vector_dest[i][lane] = IsLaneActive(lane_mask, lane)
+                                     ? vector_result[i][lane]
+                                     : vector_dest[i][lane];
+        }
+      }
+    }
+    if (instr.scalar_result_write_mask) {
+      float(*scalar_dest)[kMaxBatchLanes] =
+          batch_temp_registers_[GetTempRegisterIndex(
+              instr.scalar_dest, instr.is_scalar_dest_relative)];
+      for (uint32_t i = 0; i < 4; ++i) {
+        if (!(instr.scalar_result_write_mask & (UINT32_C(1) << i))) {
+          continue;
+        }
+        for (uint32_t lane = 0; lane < Lanes; ++lane) {
+          scalar_dest[i][lane] = IsLaneActive(lane_mask, lane)
+                                     ? scalar_result[lane]
+                                     : scalar_dest[i][lane];
+        }
+      }
+    }
+  }
+}
+
+void ShaderInterpreter::ExecuteBatchFetchInstruction(
+    const DecodedFetchInstruction& instr, uint32_t lane_mask) {
+  uint32_t lanes_remaining = lane_mask;
+  uint32_t lane;
+  if (!instr.is_vertex_fetch) {
+    // Not supporting texture fetching (very complex).
+    float zero_result[4] = {};
+    while (rex::bit_scan_forward(lanes_remaining, &lane)) {
+      lanes_remaining &= ~(UINT32_C(1) << lane);
+      StoreBatchFetchResult(instr.dest, instr.is_dest_relative,
+                            instr.dest_swizzle, zero_result, lane);
+    }
+    return;
+  }
+
+  // Vertex fetches are gathers from different addresses in each lane.
+  const ucode::VertexFetchInstruction& vfetch = instr.vertex_fetch;
+  const float* src_lanes = nullptr;
+  if (!vfetch.is_mini_fetch()) {
+    src_lanes = batch_temp_registers_[GetTempRegisterIndex(
+        vfetch.src(), vfetch.is_src_relative())][vfetch.src_swizzle()];
+  }
+  while (rex::bit_scan_forward(lanes_remaining, &lane)) {
+    lanes_remaining &= ~(UINT32_C(1) << lane);
+    if (!vfetch.is_mini_fetch()) {
+      batch_state_.vfetch_full_last[lane] = vfetch;
+    }
+    xenos::xe_gpu_vertex_fetch_t fetch_constant = register_file_.GetVertexFetch(
+        batch_state_.vfetch_full_last[lane].fetch_constant_index());
+    if (src_lanes) {
+      // Get the part of the address that depends on vfetch_full data.
+      uint32_t vertex_index =
+          uint32_t(std::floor(src_lanes[lane] +
+                              (vfetch.is_index_rounded() ? 0.5f : 0.0f)));
+      batch_state_.vfetch_address_dwords[lane] =
+          vfetch.stride() * vertex_index + fetch_constant.address;
+    }
+    float result[4];
+    LoadVertexFetchResult(vfetch, fetch_constant,
+                          batch_state_.vfetch_address_dwords[lane], result);
+    StoreBatchFetchResult(instr.dest, instr.is_dest_relative,
+                          instr.dest_swizzle, result, lane);
+  }
+}
+
+void ShaderInterpreter::StoreBatchFetchResult(uint32_t dest,
+                                              bool is_dest_relative,
+                                              uint32_t swizzle,
+                                              const float* value,
+                                              uint32_t lane) {
+  float(*dest_data)[kMaxBatchLanes] =
+      batch_temp_registers_[GetTempRegisterIndex(dest, is_dest_relative)];
+  for (uint32_t i = 0; i < 4; ++i) {
+    ucode::FetchDestinationSwizzle component_swizzle =
+        ucode::GetFetchDestinationComponentSwizzle(swizzle, i);
+    switch (component_swizzle) {
+      case ucode::FetchDestinationSwizzle::kX:
+        dest_data[i][lane] = value[0];
+        break;
+      case ucode::FetchDestinationSwizzle::kY:
+        dest_data[i][lane] = value[1];
+        break;
+      case ucode::FetchDestinationSwizzle::kZ:
+        dest_data[i][lane] = value[2];
+        break;
+      case ucode::FetchDestinationSwizzle::kW:
+        dest_data[i][lane] = value[3];
+        break;
+      case ucode::FetchDestinationSwizzle::k1:
+        dest_data[i][lane] = 1.0f;
+        break;
+      case ucode::FetchDestinationSwizzle::kKeep:
+        break;
+      default:
+        // ucode::FetchDestinationSwizzle::k0 or the invalid swizzle 6.
+        dest_data[i][lane] = 0.0f;
+        break;
+    }
+  }
+}
+
+}  // namespace rex::graphics
@@ -188,6 +188,26 @@ void TracePlayer::PlayTraceOnThread(const uint8_t* trace_data,
         trace_ptr += cmd->encoded_length;
         break;
       }
+      case TraceCommandType::kMemoryReference: {
+        auto cmd = reinterpret_cast<const MemoryReferenceCommand*>(trace_ptr);
+        trace_ptr += sizeof(*cmd);
+        if (cmd->memory_type != TraceCommandType::kMemoryRead) {
+          // Same as kMemoryWrite.
+          break;
+        }
+        auto source = ResolveMemoryReference(cmd);
+        if (!source) {
+          assert_always();
+          break;
+        }
+        DecompressMemory(source->encoding_format, source + 1,
+                         source->encoded_length,
+                         memory->TranslatePhysical(cmd->base_ptr),
+                         cmd->decoded_length);
+        command_processor->TracePlaybackWroteMemory(cmd->base_ptr,
+                                                    cmd->decoded_length);
+        break;
+      }
       case TraceCommandType::kEdramSnapshot: {
         auto cmd = reinterpret_cast<const EdramSnapshotCommand*>(trace_ptr);
         trace_ptr += sizeof(*cmd);
@@ -13,7 +13,7 @@
 
 #include <cinttypes>
 
-#include <snappy.h"
+#include "snappy.h"
 #include <rex/filesystem.h>
 #include <rex/logging.h>
 #include <rex/memory/mapped_memory.h>
@@ -200,6 +200,11 @@ void TraceReader::ParseTrace() {
         trace_ptr += sizeof(*cmd) + cmd->encoded_length;
         break;
       }
+      case TraceCommandType::kMemoryReference: {
+        auto cmd = reinterpret_cast<const MemoryReferenceCommand*>(trace_ptr);
+        trace_ptr += sizeof(*cmd);
+        break;
+      }
       case TraceCommandType::kEdramSnapshot: {
         auto cmd = reinterpret_cast<const EdramSnapshotCommand*>(trace_ptr);
         trace_ptr += sizeof(*cmd) + cmd->encoded_length;
@@ -238,6 +243,25 @@ void TraceReader::ParseTrace() {
   }
 }
 
+const MemoryCommand* TraceReader::ResolveMemoryReference(
+    const MemoryReferenceCommand* cmd) const {
+  if (cmd->source_offset + sizeof(MemoryCommand) > trace_size_) {
+    return nullptr;
+  }
+  auto source = reinterpret_cast<const MemoryCommand*>(trace_data_ +
+                                                       cmd->source_offset);
+  if (source->type != TraceCommandType::kMemoryRead &&
+      source->type != TraceCommandType::kMemoryWrite) {
+    return nullptr;
+  }
+  if (source->encoded_length >
+      trace_size_ - cmd->source_offset - sizeof(MemoryCommand)) {
+    return nullptr;
+  }
+  assert_true(source->decoded_length == cmd->decoded_length);
+  return source;
+}
+
 bool TraceReader::DecompressMemory(MemoryEncodingFormat encoding_format,
                                    const void* src, size_t src_size, void* dest,
                                    size_t dest_size) {
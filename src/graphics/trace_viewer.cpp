@@ -400,6 +400,12 @@ void TraceViewer::DrawPacketDisassemblerUI() {
         // ImGui::BulletText("MemoryWrite");
         break;
       }
+      case TraceCommandType::kMemoryReference: {
+        auto cmd = reinterpret_cast<const MemoryReferenceCommand*>(trace_ptr);
+        trace_ptr += sizeof(*cmd);
+        // ImGui::BulletText("MemoryReference");
+        break;
+      }
       case TraceCommandType::kEdramSnapshot: {
         auto cmd = reinterpret_cast<const EdramSnapshotCommand*>(trace_ptr);
         trace_ptr += sizeof(*cmd) + cmd->encoded_length;
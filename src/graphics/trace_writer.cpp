@@ -11,19 +11,21 @@
 
 #include <rex/graphics/trace_writer.h>
 
+#include <algorithm>
 #include <cstring>
 #include <memory>
 
  // TODO(tomc): Enable on other platforms once the RTTI linking issue is resolved
 #ifdef _WIN32
 #define REX_TRACE_USE_SNAPPY 1
-#include "snappy-sinksource.h"
 #include "snappy.h"
 #endif
 
 #include <rex/assert.h>
 #include <rex/filesystem.h>
 #include <rex/logging.h>
+#include <rex/memory.h>
+#include <rex/xxhash.h>
 #include <rex/graphics/registers.h>
 #include <rex/graphics/xenos.h>
 
@@ -32,7 +34,7 @@ namespace rex::graphics {
 TraceWriter::TraceWriter(uint8_t* membase)
     : membase_(membase), file_(nullptr) {}
 
-TraceWriter::~TraceWriter() = default;
+TraceWriter::~TraceWriter() { Close(); }
 
 bool TraceWriter::Open(const std::filesystem::path& path, uint32_t title_id) {
   Close();
@@ -62,23 +64,50 @@ bool TraceWriter::Open(const std::filesystem::path& path, uint32_t title_id) {
   std::memset(header.build_commit_sha, 0, sizeof(header.build_commit_sha));
   std::strncpy(header.build_commit_sha, "rexglue-dev", sizeof(header.build_commit_sha) - 1);
   header.title_id = title_id;
-  fwrite(&header, sizeof(header), 1, file_);
+  file_offset_ = 0;
+  WriteFile(&header, sizeof(header));
 
   cached_memory_reads_.clear();
+  written_payloads_.clear();
+  payload_order_.clear();
+  next_payload_id_ = 0;
+  payload_offsets_.clear();
+  current_buffer_ = std::make_unique<Buffer>();
+
+  // Start the writer thread.
+  writer_thread_shutdown_ = false;
+  writer_thread_ =
+      rex::thread::Thread::Create({}, [this]() { WriterThread(); });
+  assert_not_null(writer_thread_);
+  writer_thread_->set_name("GPU Trace Writer");
   return true;
 }
 
 void TraceWriter::Flush() {
   if (file_) {
-    fflush(file_);
+    SubmitBuffer(true);
   }
 }
 
 void TraceWriter::Close() {
   if (file_) {
+    SubmitBuffer(true);
+    {
+      std::lock_guard<std::mutex> lock(queue_lock_);
+      writer_thread_shutdown_ = true;
+    }
+    queue_cond_.notify_all();
+    rex::thread::Wait(writer_thread_.get(), false);
+    writer_thread_.reset();
+
     cached_memory_reads_.clear();
+    written_payloads_.clear();
+    payload_order_.clear();
+    next_payload_id_ = 0;
+    payload_offsets_.clear();
+    current_buffer_.reset();
+    free_buffers_.clear();
 
-    fflush(file_);
     fclose(file_);
     file_ = nullptr;
     REXGPU_INFO("TraceWriter: Closed trace file");
@@ -94,7 +123,7 @@ void TraceWriter::WritePrimaryBufferStart(uint32_t base_ptr, uint32_t count) {
       base_ptr,
       0,
   };
-  fwrite(&cmd, 1, sizeof(cmd), file_);
+  Append(cmd);
 }
 
 void TraceWriter::WritePrimaryBufferEnd() {
@@ -104,7 +133,7 @@ void TraceWriter::WritePrimaryBufferEnd() {
   PrimaryBufferEndCommand cmd = {
       TraceCommandType::kPrimaryBufferEnd,
   };
-  fwrite(&cmd, 1, sizeof(cmd), file_);
+  Append(cmd);
 }
 
 void TraceWriter::WriteIndirectBufferStart(uint32_t base_ptr, uint32_t count) {
@@ -116,7 +145,7 @@ void TraceWriter::WriteIndirectBufferStart(uint32_t base_ptr, uint32_t count) {
       base_ptr,
       0,
   };
-  fwrite(&cmd, 1, sizeof(cmd), file_);
+  Append(cmd);
 }
 
 void TraceWriter::WriteIndirectBufferEnd() {
@@ -126,7 +155,7 @@ void TraceWriter::WriteIndirectBufferEnd() {
   IndirectBufferEndCommand cmd = {
       TraceCommandType::kIndirectBufferEnd,
   };
-  fwrite(&cmd, 1, sizeof(cmd), file_);
+  Append(cmd);
 }
 
 void TraceWriter::WritePacketStart(uint32_t base_ptr, uint32_t count) {
@@ -138,8 +167,8 @@ void TraceWriter::WritePacketStart(uint32_t base_ptr, uint32_t count) {
       base_ptr,
       count,
   };
-  fwrite(&cmd, 1, sizeof(cmd), file_);
-  fwrite(membase_ + base_ptr, 4, count, file_);
+  Append(cmd);
+  Append(membase_ + base_ptr, 4 * count);
 }
 
 void TraceWriter::WritePacketEnd() {
@@ -149,7 +178,7 @@ void TraceWriter::WritePacketEnd() {
   PacketEndCommand cmd = {
       TraceCommandType::kPacketEnd,
   };
-  fwrite(&cmd, 1, sizeof(cmd), file_);
+  Append(cmd);
 }
 
 void TraceWriter::WriteMemoryRead(uint32_t base_ptr, size_t length,
@@ -194,94 +223,60 @@ void TraceWriter::WriteMemoryWrite(uint32_t base_ptr, size_t length,
                      host_ptr);
 }
 
-#if REX_TRACE_USE_SNAPPY
-class SnappySink : public snappy::Sink {
- public:
-  SnappySink(FILE* file) : file_(file) {}
-
-  void Append(const char* bytes, size_t n) override {
-    fwrite(bytes, 1, n, file_);
+void TraceWriter::WriteMemoryCommand(TraceCommandType type, uint32_t base_ptr,
+                                     size_t length, const void* host_ptr) {
+  if (!host_ptr) {
+    host_ptr = membase_ + base_ptr;
   }
 
- private:
-  FILE* file_ = nullptr;
-};
-#endif
+  bool dedup = length >= kDedupThreshold;
+  XXH128_hash_t hash = {};
+  if (dedup) {
+    // Seeded with the length so equal prefixes of different sizes differ.
+    hash = XXH3_128bits_withSeed(host_ptr, length, length);
+    auto it = written_payloads_.find(hash);
+    if (it != written_payloads_.end()) {
+      MemoryReferenceCommand cmd = {};
+      cmd.type = TraceCommandType::kMemoryReference;
+      cmd.memory_type = type;
+      cmd.base_ptr = base_ptr;
+      cmd.decoded_length = static_cast<uint32_t>(length);
+      cmd.source_offset = it->second;
+      Append(cmd);
+      return;
+    }
+  }
 
-void TraceWriter::WriteMemoryCommand(TraceCommandType type, uint32_t base_ptr,
-                                     size_t length, const void* host_ptr) {
   MemoryCommand cmd = {};
   cmd.type = type;
   cmd.base_ptr = base_ptr;
   cmd.encoding_format = MemoryEncodingFormat::kNone;
   cmd.encoded_length = cmd.decoded_length = static_cast<uint32_t>(length);
-
-  if (!host_ptr) {
-    host_ptr = membase_ + cmd.base_ptr;
-  }
-
-#if REX_TRACE_USE_SNAPPY
-  bool compress = compress_output_ && length > compression_threshold_;
-  if (compress) {
-    // Write the header now so we reserve space in the buffer.
-    long header_position = std::ftell(file_);
-    cmd.encoding_format = MemoryEncodingFormat::kSnappy;
-    fwrite(&cmd, 1, sizeof(cmd), file_);
-
-    // Stream the content right to the buffer.
-    snappy::ByteArraySource snappy_source(
-        reinterpret_cast<const char*>(host_ptr), cmd.decoded_length);
-    SnappySink snappy_sink(file_);
-    cmd.encoded_length =
-        static_cast<uint32_t>(snappy::Compress(&snappy_source, &snappy_sink));
-
-    // Seek back and overwrite the header with our final size.
-    std::fseek(file_, header_position, SEEK_SET);
-    fwrite(&cmd, 1, sizeof(cmd), file_);
-    std::fseek(file_, header_position + sizeof(cmd) + cmd.encoded_length,
-               SEEK_SET);
-  } else
-#endif
-  {
-    // Uncompressed - write buffer directly to the file.
-    cmd.encoding_format = MemoryEncodingFormat::kNone;
-    fwrite(&cmd, 1, sizeof(cmd), file_);
-    fwrite(host_ptr, 1, cmd.decoded_length, file_);
+  Append(cmd);
+  if (dedup) {
+    if (payload_order_.size() >= kMaxDedupPayloads) {
+      written_payloads_.erase(payload_order_.front());
+      payload_order_.pop_front();
+    }
+    auto id = next_payload_id_++;
+    written_payloads_.emplace(hash, id);
+    payload_order_.push_back(hash);
+    current_buffer_->payloads.emplace_back(
+        current_buffer_->data.size() - sizeof(cmd), id);
   }
+  Append(host_ptr, length);
 }
 
 void TraceWriter::WriteEdramSnapshot(const void* snapshot) {
+  if (!file_) {
+    return;
+  }
   EdramSnapshotCommand cmd = {};
   cmd.type = TraceCommandType::kEdramSnapshot;
-
-#if REX_TRACE_USE_SNAPPY
-  if (compress_output_) {
-    // Write the header now so we reserve space in the buffer.
-    long header_position = std::ftell(file_);
-    cmd.encoding_format = MemoryEncodingFormat::kSnappy;
-    fwrite(&cmd, 1, sizeof(cmd), file_);
-
-    // Stream the content right to the buffer.
-    snappy::ByteArraySource snappy_source(
-        reinterpret_cast<const char*>(snapshot), xenos::kEdramSizeBytes);
-    SnappySink snappy_sink(file_);
-    cmd.encoded_length =
-        static_cast<uint32_t>(snappy::Compress(&snappy_source, &snappy_sink));
-
-    // Seek back and overwrite the header with our final size.
-    std::fseek(file_, header_position, SEEK_SET);
-    fwrite(&cmd, 1, sizeof(cmd), file_);
-    std::fseek(file_, header_position + sizeof(cmd) + cmd.encoded_length,
-               SEEK_SET);
-  } else
-#endif
-  {
-    // Uncompressed - write buffer directly to the file.
-    cmd.encoding_format = MemoryEncodingFormat::kNone;
-    cmd.encoded_length = xenos::kEdramSizeBytes;
-    fwrite(&cmd, 1, sizeof(cmd), file_);
-    fwrite(snapshot, 1, xenos::kEdramSizeBytes, file_);
-  }
+  cmd.encoding_format = MemoryEncodingFormat::kNone;
+  cmd.encoded_length = xenos::kEdramSizeBytes;
+  Append(cmd);
+  Append(snapshot, xenos::kEdramSizeBytes);
 }
 
 void TraceWriter::WriteEvent(EventCommand::Type event_type) {
@@ -292,101 +287,240 @@ void TraceWriter::WriteEvent(EventCommand::Type event_type) {
       TraceCommandType::kEvent,
       event_type,
   };
-  fwrite(&cmd, 1, sizeof(cmd), file_);
+  Append(cmd);
 }
 
 void TraceWriter::WriteRegisters(uint32_t first_register,
                                  const uint32_t* register_values,
                                  uint32_t register_count,
                                  bool execute_callbacks_on_play) {
+  if (!file_) {
+    return;
+  }
   RegistersCommand cmd = {};
   cmd.type = TraceCommandType::kRegisters;
   cmd.first_register = first_register;
   cmd.register_count = register_count;
   cmd.execute_callbacks = execute_callbacks_on_play;
-
-  uint32_t uncompressed_length = uint32_t(sizeof(uint32_t) * register_count);
-#if REX_TRACE_USE_SNAPPY
-  if (compress_output_) {
-    // Write the header now so we reserve space in the buffer.
-    long header_position = std::ftell(file_);
-    cmd.encoding_format = MemoryEncodingFormat::kSnappy;
-    fwrite(&cmd, 1, sizeof(cmd), file_);
-
-    // Stream the content right to the buffer.
-    snappy::ByteArraySource snappy_source(
-        reinterpret_cast<const char*>(register_values), uncompressed_length);
-    SnappySink snappy_sink(file_);
-    cmd.encoded_length =
-        static_cast<uint32_t>(snappy::Compress(&snappy_source, &snappy_sink));
-
-    // Seek back and overwrite the header with our final size.
-    std::fseek(file_, header_position, SEEK_SET);
-    fwrite(&cmd, 1, sizeof(cmd), file_);
-    std::fseek(file_, header_position + sizeof(cmd) + cmd.encoded_length,
-               SEEK_SET);
-  } else
-#endif
-  {
-    // Uncompressed - write the values directly to the file.
-    cmd.encoding_format = MemoryEncodingFormat::kNone;
-    cmd.encoded_length = uncompressed_length;
-    fwrite(&cmd, 1, sizeof(cmd), file_);
-    fwrite(register_values, 1, uncompressed_length, file_);
-  }
+  cmd.encoding_format = MemoryEncodingFormat::kNone;
+  cmd.encoded_length = uint32_t(sizeof(uint32_t) * register_count);
+  Append(cmd);
+  Append(register_values, cmd.encoded_length);
 }
 
 void TraceWriter::WriteGammaRamp(
     const reg::DC_LUT_30_COLOR* gamma_ramp_256_entry_table,
     const reg::DC_LUT_PWL_DATA* gamma_ramp_pwl_rgb,
     uint32_t gamma_ramp_rw_component) {
-  GammaRampCommand cmd = {};
-  cmd.type = TraceCommandType::kGammaRamp;
-  cmd.rw_component = uint8_t(gamma_ramp_rw_component);
-
+  if (!file_) {
+    return;
+  }
   constexpr uint32_t k256EntryTableUncompressedLength =
       sizeof(reg::DC_LUT_30_COLOR) * 256;
   constexpr uint32_t kPWLUncompressedLength =
       sizeof(reg::DC_LUT_PWL_DATA) * 3 * 128;
-  constexpr uint32_t kUncompressedLength =
+
+  GammaRampCommand cmd = {};
+  cmd.type = TraceCommandType::kGammaRamp;
+  cmd.rw_component = uint8_t(gamma_ramp_rw_component);
+  cmd.encoding_format = MemoryEncodingFormat::kNone;
+  cmd.encoded_length =
       k256EntryTableUncompressedLength + kPWLUncompressedLength;
-#if REX_TRACE_USE_SNAPPY
-  if (compress_output_) {
-    // Write the header now so we reserve space in the buffer.
-    long header_position = std::ftell(file_);
-    cmd.encoding_format = MemoryEncodingFormat::kSnappy;
-    fwrite(&cmd, 1, sizeof(cmd), file_);
+  Append(cmd);
+  Append(gamma_ramp_256_entry_table, k256EntryTableUncompressedLength);
+  Append(gamma_ramp_pwl_rgb, kPWLUncompressedLength);
+}
+
+void TraceWriter::Append(const void* data, size_t length) {
+  auto& buffer_data = current_buffer_->data;
+  auto src = reinterpret_cast<const uint8_t*>(data);
+  buffer_data.insert(buffer_data.end(), src, src + length);
+}
+
+void TraceWriter::BeginCommand() {
+  // The writer thread parses whole commands, so buffers are only handed off
+  // between them.
+  if (current_buffer_->data.size() >= kSubmitThreshold) {
+    SubmitBuffer(false);
+  }
+}
 
-    // Stream the content right to the buffer.
+void TraceWriter::SubmitBuffer(bool flush) {
+  std::unique_lock<std::mutex> lock(queue_lock_);
+  // Apply backpressure rather than letting the queue grow without bound if
+  // the disk can't keep up.
+  queue_cond_.wait(lock, [this]() {
+    return queued_buffers_.size() < kMaxQueuedBuffers;
+  });
+  current_buffer_->flush = flush;
+  queued_buffers_.push_back(std::move(current_buffer_));
+  if (!free_buffers_.empty()) {
+    current_buffer_ = std::move(free_buffers_.back());
+    free_buffers_.pop_back();
+  } else {
+    current_buffer_ = std::make_unique<Buffer>();
+  }
+  lock.unlock();
+  queue_cond_.notify_all();
+}
+
+void TraceWriter::WriterThread() {
+  while (true) {
+    std::unique_ptr<Buffer> buffer;
     {
-      std::unique_ptr<char[]> gamma_ramps(new char[kUncompressedLength]);
-      std::memcpy(gamma_ramps.get(), gamma_ramp_256_entry_table,
-                  k256EntryTableUncompressedLength);
-      std::memcpy(gamma_ramps.get() + k256EntryTableUncompressedLength,
-                  gamma_ramp_pwl_rgb, kPWLUncompressedLength);
-      snappy::ByteArraySource snappy_source(gamma_ramps.get(),
-                                            kUncompressedLength);
-      SnappySink snappy_sink(file_);
-      cmd.encoded_length =
-          static_cast<uint32_t>(snappy::Compress(&snappy_source, &snappy_sink));
+      std::unique_lock<std::mutex> lock(queue_lock_);
+      queue_cond_.wait(lock, [this]() {
+        return !queued_buffers_.empty() || writer_thread_shutdown_;
+      });
+      if (queued_buffers_.empty()) {
+        // Shutting down and everything has been written.
+        return;
+      }
+      buffer = std::move(queued_buffers_.front());
+      queued_buffers_.pop_front();
     }
 
-    // Seek back and overwrite the header with our final size.
-    std::fseek(file_, header_position, SEEK_SET);
-    fwrite(&cmd, 1, sizeof(cmd), file_);
-    std::fseek(file_, header_position + sizeof(cmd) + cmd.encoded_length,
-               SEEK_SET);
-  } else
-#endif
-  {
-    // Uncompressed - write the values directly to the file.
-    cmd.encoding_format = MemoryEncodingFormat::kNone;
-    cmd.encoded_length = kUncompressedLength;
-    fwrite(&cmd, 1, sizeof(cmd), file_);
-    fwrite(gamma_ramp_256_entry_table, 1, k256EntryTableUncompressedLength,
-           file_);
-    fwrite(gamma_ramp_pwl_rgb, 1, kPWLUncompressedLength, file_);
+    WriteBuffer(*buffer);
+    if (buffer->flush) {
+      fflush(file_);
+    }
+
+    buffer->data.clear();
+    buffer->payloads.clear();
+    buffer->flush = false;
+    {
+      std::lock_guard<std::mutex> lock(queue_lock_);
+      free_buffers_.push_back(std::move(buffer));
+    }
+    queue_cond_.notify_all();
+  }
+}
+
+void TraceWriter::WriteBuffer(Buffer& buffer) {
+  const uint8_t* data = buffer.data.data();
+  size_t size = buffer.data.size();
+  auto next_payload = buffer.payloads.begin();
+
+  // Commands that pass through unchanged are written in runs.
+  size_t run_start = 0;
+  auto flush_run = [&](size_t end) {
+    WriteFile(data + run_start, end - run_start);
+  };
+
+  size_t offset = 0;
+  while (offset < size) {
+    auto type = static_cast<TraceCommandType>(memory::load<uint32_t>(data + offset));
+    switch (type) {
+      case TraceCommandType::kPrimaryBufferStart:
+      case TraceCommandType::kIndirectBufferStart:
+      case TraceCommandType::kPacketStart: {
+        // The three start commands share a layout.
+        PacketStartCommand cmd;
+        std::memcpy(&cmd, data + offset, sizeof(cmd));
+        offset += sizeof(cmd) + cmd.count * 4;
+        break;
+      }
+      case TraceCommandType::kPrimaryBufferEnd:
+      case TraceCommandType::kIndirectBufferEnd:
+      case TraceCommandType::kPacketEnd:
+        offset += sizeof(PacketEndCommand);
+        break;
+      case TraceCommandType::kEvent:
+        offset += sizeof(EventCommand);
+        break;
+      case TraceCommandType::kMemoryReference: {
+        MemoryReferenceCommand cmd;
+        std::memcpy(&cmd, data + offset, sizeof(cmd));
+        flush_run(offset);
+        assert_true(cmd.source_offset < payload_offsets_.size());
+        cmd.source_offset = payload_offsets_[cmd.source_offset];
+        WriteFile(&cmd, sizeof(cmd));
+        offset += sizeof(cmd);
+        run_start = offset;
+        break;
+      }
+      case TraceCommandType::kMemoryRead:
+      case TraceCommandType::kMemoryWrite: {
+        MemoryCommand cmd;
+        std::memcpy(&cmd, data + offset, sizeof(cmd));
+        flush_run(offset);
+        if (next_payload != buffer.payloads.end() &&
+            next_payload->first == offset) {
+          assert_true(next_payload->second == payload_offsets_.size());
+          payload_offsets_.push_back(file_offset_);
+          ++next_payload;
+        }
+        offset += sizeof(cmd);
+        WritePayload(cmd, data + offset, cmd.decoded_length,
+                     cmd.decoded_length > compression_threshold_);
+        offset += cmd.decoded_length;
+        run_start = offset;
+        break;
+      }
+      case TraceCommandType::kEdramSnapshot: {
+        EdramSnapshotCommand cmd;
+        std::memcpy(&cmd, data + offset, sizeof(cmd));
+        flush_run(offset);
+        offset += sizeof(cmd);
+        WritePayload(cmd, data + offset, cmd.encoded_length, true);
+        offset += cmd.encoded_length;
+        run_start = offset;
+        break;
+      }
+      case TraceCommandType::kRegisters: {
+        RegistersCommand cmd;
+        std::memcpy(&cmd, data + offset, sizeof(cmd));
+        flush_run(offset);
+        offset += sizeof(cmd);
+        WritePayload(cmd, data + offset, cmd.encoded_length, true);
+        offset += cmd.encoded_length;
+        run_start = offset;
+        break;
+      }
+      case TraceCommandType::kGammaRamp: {
+        GammaRampCommand cmd;
+        std::memcpy(&cmd, data + offset, sizeof(cmd));
+        flush_run(offset);
+        offset += sizeof(cmd);
+        WritePayload(cmd, data + offset, cmd.encoded_length, true);
+        offset += cmd.encoded_length;
+        run_start = offset;
+        break;
+      }
+      default:
+        assert_unhandled_case(type);
+        return;
+    }
   }
+  flush_run(size);
+}
+
+template <typename T>
+void TraceWriter::WritePayload(T cmd, const uint8_t* data, uint32_t length,
+                               bool compress) {
+#if REX_TRACE_USE_SNAPPY
+  if (compress_output_ && compress) {
+    compressed_data_.resize(snappy::MaxCompressedLength(length));
+    size_t compressed_length = 0;
+    snappy::RawCompress(reinterpret_cast<const char*>(data), length,
+                        compressed_data_.data(), &compressed_length);
+    cmd.encoding_format = MemoryEncodingFormat::kSnappy;
+    cmd.encoded_length = static_cast<uint32_t>(compressed_length);
+    WriteFile(&cmd, sizeof(cmd));
+    WriteFile(compressed_data_.data(), compressed_length);
+    return;
+  }
+#else
+  (void)compress;
+#endif
+  // Uncompressed - the command was already serialized that way.
+  WriteFile(&cmd, sizeof(cmd));
+  WriteFile(data, length);
+}
+
+void TraceWriter::WriteFile(const void* data, size_t length) {
+  fwrite(data, 1, length, file_);
+  file_offset_ += length;
 }
 
 }  // namespace rex::graphics
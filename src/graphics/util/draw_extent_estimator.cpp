@@ -14,6 +14,7 @@
 #include <algorithm>
 #include <cfloat>
 #include <cstdint>
+#include <optional>
 
 #include <rex/assert.h>
 #include <rex/cvar.h>
@@ -63,22 +64,39 @@ REXCVAR_DEFINE_BOOL(execute_unclipped_draw_vs_on_cpu_with_scissor, false,
 namespace rex::graphics {
 
 void DrawExtentEstimator::PositionYExportSink::Export(
-    ucode::ExportRegister export_register, const float* value,
-    uint32_t value_mask) {
+    ucode::ExportRegister export_register,
+    const float (*value)[ShaderInterpreter::kMaxBatchLanes],
+    uint32_t value_mask, uint32_t lane_mask) {
+  auto store = [lane_mask](uint32_t& lanes, float* values,
+                           const float* value_lanes) {
+    lanes |= lane_mask;
+    for (uint32_t lane = 0; lane < ShaderInterpreter::kMaxBatchLanes; ++lane) {
+      if (lane_mask & (UINT32_C(1) << lane)) {
+        values[lane] = value_lanes[lane];
+      }
+    }
+  };
   if (export_register == ucode::ExportRegister::kVSPosition) {
     if (value_mask & 0b0010) {
-      position_y_ = value[1];
+      store(position_y_lanes_, position_y_, value[1]);
     }
     if (value_mask & 0b1000) {
-      position_w_ = value[3];
+      store(position_w_lanes_, position_w_, value[3]);
     }
   } else if (export_register ==
              ucode::ExportRegister::kVSPointSizeEdgeFlagKillVertex) {
     if (value_mask & 0b0001) {
-      point_size_ = value[0];
+      store(point_size_lanes_, point_size_, value[0]);
     }
     if (value_mask & 0b0100) {
-      vertex_kill_ = rex::memory::Reinterpret<uint32_t>(value[2]);
+      vertex_kill_lanes_ |= lane_mask;
+      for (uint32_t lane = 0; lane < ShaderInterpreter::kMaxBatchLanes;
+           ++lane) {
+        if (lane_mask & (UINT32_C(1) << lane)) {
+          vertex_kill_[lane] =
+              rex::memory::Reinterpret<uint32_t>(value[2][lane]);
+        }
+      }
     }
   }
 }
@@ -181,7 +199,66 @@ uint32_t DrawExtentEstimator::EstimateVertexMaxY(const Shader& vertex_shader) {
   shader_interpreter_.SetShader(vertex_shader);
 
   PositionYExportSink position_y_export_sink;
-  shader_interpreter_.SetExportSink(&position_y_export_sink);
+  shader_interpreter_.SetBatchExportSink(&position_y_export_sink);
+  // Vertices are executed in batches, with the index in r0.x of each lane.
+  float* batch_vertex_indices = shader_interpreter_.batch_temp_register(0, 0);
+  uint32_t batch_vertex_count = 0;
+  auto execute_batch = [&]() {
+    position_y_export_sink.Reset();
+    shader_interpreter_.ExecuteBatch(batch_vertex_count);
+
+    for (uint32_t lane = 0; lane < batch_vertex_count; ++lane) {
+      std::optional<uint32_t> vertex_kill =
+          position_y_export_sink.vertex_kill(lane);
+      if (vertex_kill.has_value() &&
+          (vertex_kill.value() & ~(UINT32_C(1) << 31))) {
+        continue;
+      }
+      std::optional<float> position_y = position_y_export_sink.position_y(lane);
+      if (!position_y.has_value()) {
+        continue;
+      }
+      float vertex_y = position_y.value();
+      if (!pa_cl_vte_cntl.vtx_xy_fmt) {
+        std::optional<float> position_w =
+            position_y_export_sink.position_w(lane);
+        if (!position_w.has_value()) {
+          continue;
+        }
+        vertex_y /= position_w.value();
+      }
+
+      vertex_y = vertex_y * viewport_y_scale + viewport_y_offset;
+
+      if (vgt_draw_initiator.prim_type == xenos::PrimitiveType::kPointList) {
+        float point_radius_y;
+        std::optional<float> point_size =
+            position_y_export_sink.point_size(lane);
+        if (point_size.has_value()) {
+          // Vertex-specified diameter. Clamped effectively as a signed integer
+          // in the hardware, -NaN, -Infinity ... -0 to the minimum, +Infinity,
+          // +NaN to the maximum.
+          point_radius_y =
+              0.5f *
+              rex::memory::Reinterpret<float>(std::min(
+                  point_vertex_max_diameter_float,
+                  std::max(point_vertex_min_diameter_float,
+                           rex::memory::Reinterpret<int32_t>(
+                               point_size.value()))));
+        } else {
+          // Constant radius.
+          point_radius_y = point_constant_radius_y;
+        }
+        vertex_y += point_radius_y;
+      }
+
+      // std::max is `a < b ? b : a`, thus in case of NaN, the first argument
+      // is always returned - max_y, which is initialized to a normalized
+      // value.
+      max_y = std::max(max_y, vertex_y);
+    }
+    batch_vertex_count = 0;
+  };
   for (uint32_t i = 0; i < vgt_draw_initiator.num_indices; ++i) {
     uint32_t vertex_index;
     if (vgt_draw_initiator.source_select == xenos::SourceSelect::kDMA) {
@@ -208,53 +285,15 @@ uint32_t DrawExtentEstimator::EstimateVertexMaxY(const Shader& vertex_shader) {
         std::min(max_index,
                  std::max(min_index, (vertex_index + index_offset) & 0xFFFFFF));
 
-    position_y_export_sink.Reset();
-
-    shader_interpreter_.temp_registers()[0] = float(vertex_index);
-    shader_interpreter_.Execute();
-
-    if (position_y_export_sink.vertex_kill().has_value() &&
-        (position_y_export_sink.vertex_kill().value() & ~(UINT32_C(1) << 31))) {
-      continue;
-    }
-    if (!position_y_export_sink.position_y().has_value()) {
-      continue;
-    }
-    float vertex_y = position_y_export_sink.position_y().value();
-    if (!pa_cl_vte_cntl.vtx_xy_fmt) {
-      if (!position_y_export_sink.position_w().has_value()) {
-        continue;
-      }
-      vertex_y /= position_y_export_sink.position_w().value();
-    }
-
-    vertex_y = vertex_y * viewport_y_scale + viewport_y_offset;
-
-    if (vgt_draw_initiator.prim_type == xenos::PrimitiveType::kPointList) {
-      float point_radius_y;
-      if (position_y_export_sink.point_size().has_value()) {
-        // Vertex-specified diameter. Clamped effectively as a signed integer in
-        // the hardware, -NaN, -Infinity ... -0 to the minimum, +Infinity, +NaN
-        // to the maximum.
-        point_radius_y =
-            0.5f *
-            rex::memory::Reinterpret<float>(std::min(
-                point_vertex_max_diameter_float,
-                std::max(point_vertex_min_diameter_float,
-                         rex::memory::Reinterpret<int32_t>(
-                             position_y_export_sink.point_size().value()))));
-      } else {
-        // Constant radius.
-        point_radius_y = point_constant_radius_y;
-      }
-      vertex_y += point_radius_y;
+    batch_vertex_indices[batch_vertex_count++] = float(vertex_index);
+    if (batch_vertex_count == ShaderInterpreter::kMaxBatchLanes) {
+      execute_batch();
     }
-
-    // std::max is `a < b ? b : a`, thus in case of NaN, the first argument is
-    // always returned - max_y, which is initialized to a normalized value.
-    max_y = std::max(max_y, vertex_y);
   }
-  shader_interpreter_.SetExportSink(nullptr);
+  if (batch_vertex_count) {
+    execute_batch();
+  }
+  shader_interpreter_.SetBatchExportSink(nullptr);
 
   int32_t max_y_24p8 = ui::FloatToD3D11Fixed16p8(max_y);
   // 16p8 range is -32768 to 32767+255/256, but it's stored as uint32_t here,
@@ -11,10 +11,12 @@
 
 #include <rex/kernel/kernel_state.h>
 
+#include <algorithm>
 #include <string>
 
 #include <fmt/format.h>
 #include <rex/assert.h>
+#include <rex/cvar.h>
 #include <rex/stream.h>
 #include <rex/logging.h>
 #include <rex/string.h>
@@ -28,15 +30,23 @@
 #include <rex/kernel/xboxkrnl/module.h>
 #include <rex/kernel/xboxkrnl/ordinals.h>
 #include <rex/runtime/processor.h>
+#include <rex/thread/timer_queue.h>
 #include <rex/kernel/xevent.h>
 #include <rex/kernel/xmodule.h>
 #include <rex/kernel/xnotifylistener.h>
 #include <rex/kernel/xobject.h>
 #include <rex/kernel/xthread.h>
 
+REXCVAR_DEFINE_UINT32(io_threads, 0,
+    "Kernel",
+    "Host threads servicing overlapped file I/O (0 = auto)")
+    .lifecycle(rex::cvar::Lifecycle::kRequiresRestart);
+
 namespace rex::kernel {
 
 constexpr uint32_t kDeferredOverlappedDelayMillis = 100;
+// Deferred completions mostly wait on the guest or the user, not the host.
+constexpr uint32_t kDeferredOverlappedThreads = 2;
 
 // This is a global object initialized with the XboxkrnlModule.
 // It references the current kernel state object that all kernel methods should
@@ -48,7 +58,6 @@ KernelState* kernel_state() { return shared_kernel_state_; }
 KernelState::KernelState(Runtime* emulator)
     : emulator_(emulator),
       memory_(emulator->memory()),
-      dispatch_thread_running_(false),
       dpc_list_(emulator->memory()) {
   processor_ = emulator->processor();
   file_system_ = emulator->file_system();
@@ -98,12 +107,17 @@ void KernelState::SetupInputDrivers() {
 KernelState::~KernelState() {
   SetExecutableModule(nullptr);
 
-  if (dispatch_thread_running_) {
-    dispatch_thread_running_ = false;
-    dispatch_cond_.notify_all();
-    dispatch_thread_->Wait(0, 0, 0, nullptr);
+  // Deferred completions still waiting on the timer queue finish without
+  // touching guest state; they need their pool, so drain them first.
+  deferred_shutdown_ = true;
+  for (uint32_t pending = deferred_pending_.load(); pending;
+       pending = deferred_pending_.load()) {
+    deferred_pending_.wait(pending);
   }
 
+  ShutdownWorkerPool(deferred_pool_);
+  ShutdownWorkerPool(io_pool_);
+
   executable_module_.reset();
   user_modules_.clear();
   kernel_modules_.clear();
@@ -390,37 +404,6 @@ void KernelState::SetExecutableModule(object_ref<UserModule> module) {
         variable_ptr, executable_module_->path(),
         xboxkrnl::XboxkrnlModule::kExLoadedImageNameSize);
   }
-
-  // Spin up deferred dispatch worker.
-  // TODO(benvanik): move someplace more appropriate (out of ctor, but around
-  // here).
-  if (!dispatch_thread_running_) {
-    dispatch_thread_running_ = true;
-    dispatch_thread_ =
-        object_ref<XHostThread>(new XHostThread(this, 128 * 1024, 0, [this]() {
-          auto global_lock = global_critical_region_.AcquireDeferred();
-          while (dispatch_thread_running_) {
-            global_lock.lock();
-            if (dispatch_queue_.empty()) {
-              dispatch_cond_.wait(global_lock);
-              if (!dispatch_thread_running_) {
-                global_lock.unlock();
-                break;
-              }
-            }
-            auto fn = std::move(dispatch_queue_.front());
-            dispatch_queue_.pop_front();
-            REXKRNL_DEBUG("Dispatch thread processing queued item ({} remaining)", dispatch_queue_.size());
-            global_lock.unlock();
-
-            fn();
-            REXKRNL_DEBUG("Dispatch thread completed item");
-          }
-          return 0;
-        }));
-    dispatch_thread_->set_name("Kernel Dispatch");
-    dispatch_thread_->Create();
-  }
 }
 
 void KernelState::LoadKernelModule(object_ref<KernelModule> kernel_module) {
@@ -774,29 +757,116 @@ void KernelState::CompleteOverlappedDeferredEx(
   auto ptr = memory()->TranslateVirtual(overlapped_ptr);
   XOverlappedSetResult(ptr, X_ERROR_IO_PENDING);
   XOverlappedSetContext(ptr, XThread::GetCurrentThreadHandle());
-  auto global_lock = global_critical_region_.Acquire();
-  dispatch_queue_.push_back([this, overlapped_ptr,
-                             completion_callback = std::move(completion_callback),
-                             pre_callback = std::move(pre_callback),
-                             post_callback = std::move(post_callback)]() mutable {
-    REXKRNL_DEBUG("Deferred overlapped {:08X}: running pre_callback", overlapped_ptr);
-    if (pre_callback) {
-      pre_callback();
+
+  // Every request gets its own due time on the timer queue and completes on
+  // the deferred pool, so queued requests wait out their delays concurrently
+  // instead of one after another.
+  deferred_pending_.fetch_add(1, std::memory_order_relaxed);
+  auto complete = [this, overlapped_ptr,
+                   completion_callback = std::move(completion_callback),
+                   post_callback = std::move(post_callback)]() mutable {
+    if (!deferred_shutdown_) {
+      uint32_t extended_error, length;
+      REXKRNL_DEBUG("Deferred overlapped {:08X}: running completion", overlapped_ptr);
+      auto result = completion_callback(extended_error, length);
+      REXKRNL_DEBUG("Deferred overlapped {:08X}: completing with result {:08X}", overlapped_ptr, result);
+      CompleteOverlappedEx(overlapped_ptr, result, extended_error, length);
+      if (post_callback) {
+        REXKRNL_DEBUG("Deferred overlapped {:08X}: running post_callback", overlapped_ptr);
+        post_callback();
+      }
     }
-    REXKRNL_DEBUG("Deferred overlapped {:08X}: sleeping {}ms", overlapped_ptr, kDeferredOverlappedDelayMillis);
-    rex::thread::Sleep(
-        std::chrono::milliseconds(kDeferredOverlappedDelayMillis));
-    uint32_t extended_error, length;
-    REXKRNL_DEBUG("Deferred overlapped {:08X}: running completion", overlapped_ptr);
-    auto result = completion_callback(extended_error, length);
-    REXKRNL_DEBUG("Deferred overlapped {:08X}: completing with result {:08X}", overlapped_ptr, result);
-    CompleteOverlappedEx(overlapped_ptr, result, extended_error, length);
-    if (post_callback) {
-      REXKRNL_DEBUG("Deferred overlapped {:08X}: running post_callback", overlapped_ptr);
-      post_callback();
+    FinishDeferredOverlapped();
+  };
+  auto schedule = [this, complete = std::move(complete)]() mutable {
+    // The delay starts once pre_callback, if any, has finished.
+    auto due = std::chrono::steady_clock::now() +
+               std::chrono::milliseconds(kDeferredOverlappedDelayMillis);
+    // Timer queue callbacks share one thread, so only hand off from there.
+    rex::thread::QueueTimerOnce(
+        [this, complete = std::move(complete)](void*) mutable {
+          QueueWork(deferred_pool_, kDeferredOverlappedThreads,
+                    std::move(complete));
+        },
+        nullptr, due);
+  };
+  if (pre_callback) {
+    QueueWork(deferred_pool_, kDeferredOverlappedThreads,
+              [overlapped_ptr, pre_callback = std::move(pre_callback),
+               schedule = std::move(schedule)]() mutable {
+                REXKRNL_DEBUG("Deferred overlapped {:08X}: running pre_callback",
+                              overlapped_ptr);
+                pre_callback();
+                schedule();
+              });
+  } else {
+    schedule();
+  }
+}
+
+void KernelState::FinishDeferredOverlapped() {
+  if (deferred_pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    deferred_pending_.notify_all();
+  }
+}
+
+void KernelState::QueueIoWork(std::move_only_function<void()> fn) {
+  uint32_t thread_count = REXCVAR_GET(io_threads);
+  if (!thread_count) {
+    thread_count =
+        std::clamp(rex::thread::logical_processor_count() / 2, 2u, 4u);
+  }
+  QueueWork(io_pool_, thread_count, std::move(fn));
+}
+
+void KernelState::QueueWork(WorkerPool& pool, uint32_t thread_count,
+                            std::move_only_function<void()> fn) {
+  std::unique_lock<std::mutex> lock(pool.mutex);
+  if (!pool.running && pool.threads.empty()) {
+    pool.running = true;
+    for (uint32_t i = 0; i < thread_count; ++i) {
+      auto thread = object_ref<XHostThread>(
+          new XHostThread(this, 128 * 1024, 0, [this, &pool]() {
+            WorkerThreadMain(pool);
+            return 0;
+          }));
+      thread->set_name(fmt::format("{} {}", pool.name, i));
+      thread->Create();
+      pool.threads.push_back(std::move(thread));
+    }
+  }
+  pool.queue.push_back(std::move(fn));
+  lock.unlock();
+  pool.cond.notify_one();
+}
+
+void KernelState::WorkerThreadMain(WorkerPool& pool) {
+  std::unique_lock<std::mutex> lock(pool.mutex);
+  while (true) {
+    pool.cond.wait(lock,
+                   [&pool] { return !pool.queue.empty() || !pool.running; });
+    if (pool.queue.empty()) {
+      // Only reached when shutting down.
+      break;
     }
-  });
-  dispatch_cond_.notify_all();
+    auto fn = std::move(pool.queue.front());
+    pool.queue.pop_front();
+    lock.unlock();
+    fn();
+    lock.lock();
+  }
+}
+
+void KernelState::ShutdownWorkerPool(WorkerPool& pool) {
+  {
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    pool.running = false;
+  }
+  pool.cond.notify_all();
+  for (auto& thread : pool.threads) {
+    thread->Wait(0, 0, 0, nullptr);
+  }
+  pool.threads.clear();
 }
 
 bool KernelState::Save(stream::ByteStream* stream) {
@@ -204,6 +204,11 @@ void Runtime::Shutdown() {
     instance_ = nullptr;
   }
 
+  // Before guest code is torn down, so the counts cover the whole session
+  if (processor_) {
+    processor_->SaveProfile();
+  }
+
   // Destroy in reverse order
   if (graphics_system_) {
     graphics_system_->Shutdown();
@@ -13,6 +13,9 @@
 
 #include <algorithm>
 #include <cstring>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include <rex/stream.h>
 #include <rex/logging.h>
@@ -21,39 +24,52 @@
 
 namespace rex::kernel::util {
 
-ObjectTable::ObjectTable() {}
+ObjectTable::ObjectTable()
+    : pages_(std::make_unique<std::unique_ptr<ObjectTableEntry[]>[]>(
+          kMaxPages)) {}
 
 ObjectTable::~ObjectTable() { Reset(); }
 
 void ObjectTable::Reset() {
-  auto global_lock = global_critical_region_.Acquire();
+  std::vector<XObject*> objects;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    uint32_t capacity = table_capacity_.load(std::memory_order_relaxed);
+    for (uint32_t n = 0; n < capacity; n++) {
+      ObjectTableEntry& entry = EntryAt(n);
+      if (auto object = entry.object.exchange(nullptr)) {
+        objects.push_back(object);
+      }
+    }
 
-  // Release all objects.
-  for (uint32_t n = 0; n < table_capacity_; n++) {
-    ObjectTableEntry& entry = table_[n];
-    if (entry.object) {
-      entry.object->Release();
+    table_capacity_.store(0, std::memory_order_release);
+    last_free_entry_ = 0;
+    for (uint32_t page = 0; page < kMaxPages && pages_[page]; page++) {
+      pages_[page].reset();
     }
   }
 
-  table_capacity_ = 0;
-  last_free_entry_ = 0;
-  free(table_);
-  table_ = nullptr;
+  // Release all objects. Done outside the lock since destructors may call
+  // back into the table.
+  for (auto object : objects) {
+    object->Release();
+  }
 }
 
 X_STATUS ObjectTable::FindFreeSlot(uint32_t* out_slot) {
   // Find a free slot.
+  uint32_t capacity = table_capacity_.load(std::memory_order_relaxed);
   uint32_t slot = last_free_entry_;
   uint32_t scan_count = 0;
-  while (scan_count < table_capacity_) {
-    ObjectTableEntry& entry = table_[slot];
-    if (!entry.object) {
+  while (scan_count < capacity) {
+    ObjectTableEntry& entry = EntryAt(slot);
+    if (!entry.object.load(std::memory_order_relaxed)) {
       *out_slot = slot;
       return X_STATUS_SUCCESS;
     }
     scan_count++;
-    slot = (slot + 1) % table_capacity_;
+    slot = (slot + 1) % capacity;
     if (slot == 0) {
       // Never allow 0 handles.
       scan_count++;
@@ -62,7 +78,7 @@ X_STATUS ObjectTable::FindFreeSlot(uint32_t* out_slot) {
   }
 
   // Table out of slots, expand.
-  uint32_t new_table_capacity = std::max(16 * 1024u, table_capacity_ * 2);
+  uint32_t new_table_capacity = std::max(16 * 1024u, capacity * 2);
   if (!Resize(new_table_capacity)) {
     return X_STATUS_NO_MEMORY;
   }
@@ -75,23 +91,23 @@ X_STATUS ObjectTable::FindFreeSlot(uint32_t* out_slot) {
 }
 
 bool ObjectTable::Resize(uint32_t new_capacity) {
-  uint32_t new_size = new_capacity * sizeof(ObjectTableEntry);
-  uint32_t old_size = table_capacity_ * sizeof(ObjectTableEntry);
-  auto new_table =
-      reinterpret_cast<ObjectTableEntry*>(realloc(table_, new_size));
-  if (!new_table) {
+  uint32_t old_capacity = table_capacity_.load(std::memory_order_relaxed);
+  new_capacity = std::min(new_capacity, kMaxSlots);
+  if (new_capacity <= old_capacity) {
     return false;
   }
 
-  // Zero out new entries.
-  if (new_size > old_size) {
-    std::memset(reinterpret_cast<uint8_t*>(new_table) + old_size, 0,
-                new_size - old_size);
+  // Pages are allocated zeroed and never move; publishing the capacity makes
+  // them visible to lock-free lookups.
+  uint32_t page_count = (new_capacity + kPageSize - 1) >> kPageShift;
+  for (uint32_t page = 0; page < page_count; page++) {
+    if (!pages_[page]) {
+      pages_[page] = std::make_unique<ObjectTableEntry[]>(kPageSize);
+    }
   }
 
-  last_free_entry_ = table_capacity_;
-  table_capacity_ = new_capacity;
-  table_ = new_table;
+  last_free_entry_ = old_capacity;
+  table_capacity_.store(new_capacity, std::memory_order_release);
 
   return true;
 }
@@ -101,7 +117,7 @@ X_STATUS ObjectTable::AddHandle(XObject* object, X_HANDLE* out_handle) {
 
   uint32_t handle = 0;
   {
-    auto global_lock = global_critical_region_.Acquire();
+    std::lock_guard<std::mutex> lock(mutex_);
 
     // Find a free slot.
     uint32_t slot = 0;
@@ -109,14 +125,16 @@ X_STATUS ObjectTable::AddHandle(XObject* object, X_HANDLE* out_handle) {
 
     // Stash.
     if (XSUCCEEDED(result)) {
-      ObjectTableEntry& entry = table_[slot];
-      entry.object = object;
-      entry.handle_ref_count = 1;
+      ObjectTableEntry& entry = EntryAt(slot);
       handle = XObject::kHandleBase + (slot << 2);
       object->handles().push_back(handle);
 
       // Retain so long as the object is in the table.
       object->Retain();
+      entry.handle_ref_count.store(1);
+
+      // Publish last; lookups can see the object from here on.
+      entry.object.store(object);
 
       REXKRNL_DEBUG("Added handle:{:08X} for {}", handle, typeid(*object).name());
     }
@@ -135,10 +153,10 @@ X_STATUS ObjectTable::DuplicateHandle(X_HANDLE handle, X_HANDLE* out_handle) {
   X_STATUS result = X_STATUS_SUCCESS;
   handle = TranslateHandle(handle);
 
-  XObject* object = LookupObject(handle, false);
+  XObject* object = LookupAndRetain(handle);
   if (object) {
     result = AddHandle(object, out_handle);
-    object->Release();  // Release the ref that LookupObject took
+    object->Release();  // Release the ref that LookupAndRetain took
   } else {
     result = X_STATUS_INVALID_HANDLE;
   }
@@ -147,38 +165,49 @@ X_STATUS ObjectTable::DuplicateHandle(X_HANDLE handle, X_HANDLE* out_handle) {
 }
 
 X_STATUS ObjectTable::RetainHandle(X_HANDLE handle) {
-  auto global_lock = global_critical_region_.Acquire();
-
   ObjectTableEntry* entry = LookupTable(handle);
   if (!entry) {
     return X_STATUS_INVALID_HANDLE;
   }
 
+  // Under the lock ReleaseHandle drops the count in, so a count that reached
+  // zero is never raised again and a free slot is never counted.
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!entry->object.load(std::memory_order_relaxed)) {
+    return X_STATUS_INVALID_HANDLE;
+  }
   entry->handle_ref_count++;
   return X_STATUS_SUCCESS;
 }
 
 X_STATUS ObjectTable::ReleaseHandle(X_HANDLE handle) {
-  auto global_lock = global_critical_region_.Acquire();
-
+  handle = TranslateHandle(handle);
   ObjectTableEntry* entry = LookupTable(handle);
   if (!entry) {
     return X_STATUS_INVALID_HANDLE;
   }
 
-  if (--entry->handle_ref_count == 0) {
+  XObject* object = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!entry->object.load(std::memory_order_relaxed)) {
+      return X_STATUS_INVALID_HANDLE;
+    }
+    if (--entry->handle_ref_count != 0) {
+      // FIXME: Return a status code telling the caller it wasn't released
+      // (but not a failure code)
+      return X_STATUS_SUCCESS;
+    }
+
     // No more references. Remove it from the table.
-    return RemoveHandle(handle);
+    object = DetachEntry(*entry, handle);
   }
 
-  // FIXME: Return a status code telling the caller it wasn't released
-  // (but not a failure code)
+  FinishRemoval(*entry, object);
   return X_STATUS_SUCCESS;
 }
 
 X_STATUS ObjectTable::RemoveHandle(X_HANDLE handle) {
-  X_STATUS result = X_STATUS_SUCCESS;
-
   handle = TranslateHandle(handle);
   if (!handle) {
     return X_STATUS_INVALID_HANDLE;
@@ -189,43 +218,71 @@ X_STATUS ObjectTable::RemoveHandle(X_HANDLE handle) {
     return X_STATUS_INVALID_HANDLE;
   }
 
-  auto global_lock = global_critical_region_.Acquire();
-  if (entry->object) {
-    auto object = entry->object;
-    entry->object = nullptr;
-    assert_zero(entry->handle_ref_count);
-    entry->handle_ref_count = 0;
+  XObject* object = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    object = DetachEntry(*entry, handle);
+  }
 
-    // Walk the object's handles and remove this one.
-    auto handle_entry =
-        std::find(object->handles().begin(), object->handles().end(), handle);
-    if (handle_entry != object->handles().end()) {
-      object->handles().erase(handle_entry);
-    }
+  FinishRemoval(*entry, object);
+  return X_STATUS_SUCCESS;
+}
 
-    REXKRNL_DEBUG("Removed handle:{:08X} for {}", handle, typeid(*object).name());
+XObject* ObjectTable::DetachEntry(ObjectTableEntry& entry, X_HANDLE handle) {
+  // Whoever swaps the object out owns the removal. The count is reset under
+  // the same lock AddHandle takes, so a new owner of the slot can't have
+  // its count overwritten.
+  XObject* object = entry.object.exchange(nullptr);
+  if (!object) {
+    return nullptr;
+  }
+  assert_zero(entry.handle_ref_count.load());
+  entry.handle_ref_count.store(0);
 
-    // Remove object name from mapping to prevent naming collision.
-    if (!object->name().empty()) {
-      RemoveNameMapping(object->name());
-    }
-    // Release now that the object has been removed from the table.
-    object->Release();
+  // Walk the object's handles and remove this one.
+  auto handle_entry = std::find(object->handles().begin(),
+                                object->handles().end(), handle);
+  if (handle_entry != object->handles().end()) {
+    object->handles().erase(handle_entry);
   }
 
-  return X_STATUS_SUCCESS;
+  REXKRNL_DEBUG("Removed handle:{:08X} for {}", handle,
+                typeid(*object).name());
+
+  // Remove object name from mapping to prevent naming collision.
+  if (!object->name().empty()) {
+    name_table_.erase(string::string_key_case(object->name()));
+  }
+  return object;
+}
+
+void ObjectTable::FinishRemoval(ObjectTableEntry& entry, XObject* object) {
+  if (!object) {
+    return;
+  }
+
+  // A lookup that read the pointer before the swap may still be about to
+  // retain it; let it finish so the release below can't free the object
+  // under it.
+  WaitForReaders(entry);
+
+  // Release now that the object has been removed from the table.
+  object->Release();
 }
 
 std::vector<object_ref<XObject>> ObjectTable::GetAllObjects() {
-  auto lock = global_critical_region_.Acquire();
   std::vector<object_ref<XObject>> results;
 
-  for (uint32_t slot = 0; slot < table_capacity_; slot++) {
-    auto& entry = table_[slot];
-    if (entry.object && std::find(results.begin(), results.end(),
-                                  entry.object) == results.end()) {
-      entry.object->Retain();
-      results.push_back(object_ref<XObject>(entry.object));
+  uint32_t capacity = table_capacity_.load(std::memory_order_acquire);
+  for (uint32_t slot = 0; slot < capacity; slot++) {
+    auto object = RetainEntry(EntryAt(slot));
+    if (!object) {
+      continue;
+    }
+    if (std::find(results.begin(), results.end(), object) == results.end()) {
+      results.push_back(object_ref<XObject>(object));
+    } else {
+      object->Release();
     }
   }
 
@@ -233,16 +290,27 @@ std::vector<object_ref<XObject>> ObjectTable::GetAllObjects() {
 }
 
 void ObjectTable::PurgeAllObjects() {
-  auto lock = global_critical_region_.Acquire();
-  for (uint32_t slot = 0; slot < table_capacity_; slot++) {
-    auto& entry = table_[slot];
-    if (entry.object && !entry.object->is_host_object()) {
-      entry.handle_ref_count = 0;
-      entry.object->Release();
-
-      entry.object = nullptr;
+  // Empty the slots under the lock, like RemoveHandle, but release outside
+  // it since destructors may close other handles.
+  std::vector<std::pair<ObjectTableEntry*, XObject*>> purged;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint32_t capacity = table_capacity_.load(std::memory_order_acquire);
+    for (uint32_t slot = 0; slot < capacity; slot++) {
+      auto& entry = EntryAt(slot);
+      auto object = entry.object.load();
+      if (object && !object->is_host_object() &&
+          entry.object.compare_exchange_strong(object, nullptr)) {
+        entry.handle_ref_count.store(0);
+        purged.emplace_back(&entry, object);
+      }
     }
   }
+
+  for (auto [entry, object] : purged) {
+    WaitForReaders(*entry);
+    object->Release();
+  }
 }
 
 ObjectTable::ObjectTableEntry* ObjectTable::LookupTable(X_HANDLE handle) {
@@ -251,69 +319,65 @@ ObjectTable::ObjectTableEntry* ObjectTable::LookupTable(X_HANDLE handle) {
     return nullptr;
   }
 
-  auto global_lock = global_critical_region_.Acquire();
-
   // Lower 2 bits are ignored.
   uint32_t slot = GetHandleSlot(handle);
-  if (slot <= table_capacity_) {
-    return &table_[slot];
+  if (slot < table_capacity_.load(std::memory_order_acquire)) {
+    return &EntryAt(slot);
   }
 
   return nullptr;
 }
 
+XObject* ObjectTable::RetainEntry(ObjectTableEntry& entry) {
+  // Announce the read before loading the pointer. RemoveHandle swaps the
+  // pointer out before checking `readers`, so (all seq_cst) either it sees us
+  // and waits, or we see the null it stored.
+  entry.readers.fetch_add(1);
+  auto object = entry.object.load();
+  if (object) {
+    object->Retain();
+  }
+  entry.readers.fetch_sub(1);
+  return object;
+}
+
+void ObjectTable::WaitForReaders(ObjectTableEntry& entry) {
+  // Readers hold the count for two atomic ops and a Retain, so this is a
+  // handful of iterations at most.
+  while (entry.readers.load() != 0) {
+    std::this_thread::yield();
+  }
+}
+
 // Generic lookup
 template <>
 object_ref<XObject> ObjectTable::LookupObject<XObject>(X_HANDLE handle) {
-  auto object = ObjectTable::LookupObject(handle, false);
+  auto object = ObjectTable::LookupAndRetain(handle);
   auto result = object_ref<XObject>(reinterpret_cast<XObject*>(object));
   return result;
 }
 
-XObject* ObjectTable::LookupObject(X_HANDLE handle, bool already_locked) {
-  handle = TranslateHandle(handle);
-  if (!handle) {
+XObject* ObjectTable::LookupAndRetain(X_HANDLE handle) {
+  ObjectTableEntry* entry = LookupTable(handle);
+  if (!entry) {
     return nullptr;
   }
 
-  XObject* object = nullptr;
-  if (!already_locked) {
-    global_critical_region_.mutex().lock();
-  }
-
-  // Lower 2 bits are ignored.
-  uint32_t slot = GetHandleSlot(handle);
-
-  // Verify slot.
-  if (slot < table_capacity_) {
-    ObjectTableEntry& entry = table_[slot];
-    if (entry.object) {
-      object = entry.object;
-    }
-  }
-
-  // Retain the object pointer.
-  if (object) {
-    object->Retain();
-  }
-
-  if (!already_locked) {
-    global_critical_region_.mutex().unlock();
-  }
-
-  return object;
+  return RetainEntry(*entry);
 }
 
 void ObjectTable::GetObjectsByType(XObject::Type type,
                                    std::vector<object_ref<XObject>>* results) {
-  auto global_lock = global_critical_region_.Acquire();
-  for (uint32_t slot = 0; slot < table_capacity_; ++slot) {
-    auto& entry = table_[slot];
-    if (entry.object) {
-      if (entry.object->type() == type) {
-        entry.object->Retain();
-        results->push_back(object_ref<XObject>(entry.object));
-      }
+  uint32_t capacity = table_capacity_.load(std::memory_order_acquire);
+  for (uint32_t slot = 0; slot < capacity; ++slot) {
+    auto object = RetainEntry(EntryAt(slot));
+    if (!object) {
+      continue;
+    }
+    if (object->type() == type) {
+      results->push_back(object_ref<XObject>(object));
+    } else {
+      object->Release();
     }
   }
 }
@@ -333,7 +397,7 @@ X_HANDLE ObjectTable::TranslateHandle(X_HANDLE handle) {
 
 X_STATUS ObjectTable::AddNameMapping(const std::string_view name,
                                      X_HANDLE handle) {
-  auto global_lock = global_critical_region_.Acquire();
+  std::lock_guard<std::mutex> lock(mutex_);
   if (name_table_.count(string::string_key_case(name))) {
     return X_STATUS_OBJECT_NAME_COLLISION;
   }
@@ -343,7 +407,7 @@ X_STATUS ObjectTable::AddNameMapping(const std::string_view name,
 
 void ObjectTable::RemoveNameMapping(const std::string_view name) {
   // Names are case-insensitive.
-  auto global_lock = global_critical_region_.Acquire();
+  std::lock_guard<std::mutex> lock(mutex_);
   auto it = name_table_.find(string::string_key_case(name));
   if (it != name_table_.end()) {
     name_table_.erase(it);
@@ -353,40 +417,44 @@ void ObjectTable::RemoveNameMapping(const std::string_view name) {
 X_STATUS ObjectTable::GetObjectByName(const std::string_view name,
                                       X_HANDLE* out_handle) {
   // Names are case-insensitive.
-  auto global_lock = global_critical_region_.Acquire();
-  auto it = name_table_.find(string::string_key_case(name));
-  if (it == name_table_.end()) {
-    *out_handle = X_INVALID_HANDLE_VALUE;
-    return X_STATUS_OBJECT_NAME_NOT_FOUND;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = name_table_.find(string::string_key_case(name));
+    if (it == name_table_.end()) {
+      *out_handle = X_INVALID_HANDLE_VALUE;
+      return X_STATUS_OBJECT_NAME_NOT_FOUND;
+    }
+    *out_handle = it->second;
   }
-  *out_handle = it->second;
 
-  // We need to ref the handle. I think.
-  auto obj = LookupObject(it->second, true);
-  if (obj) {
-    obj->RetainHandle();
-    obj->Release();
+  // Ref the handle we hand out; it may have been closed since the lookup.
+  if (XFAILED(RetainHandle(*out_handle))) {
+    *out_handle = X_INVALID_HANDLE_VALUE;
+    return X_STATUS_OBJECT_NAME_NOT_FOUND;
   }
 
   return X_STATUS_SUCCESS;
 }
 
 bool ObjectTable::Save(stream::ByteStream* stream) {
-  stream->Write<uint32_t>(table_capacity_);
-  for (uint32_t i = 0; i < table_capacity_; i++) {
-    auto& entry = table_[i];
-    stream->Write<int32_t>(entry.handle_ref_count);
+  uint32_t capacity = table_capacity_.load();
+  stream->Write<uint32_t>(capacity);
+  for (uint32_t i = 0; i < capacity; i++) {
+    auto& entry = EntryAt(i);
+    stream->Write<int32_t>(entry.handle_ref_count.load());
   }
 
   return true;
 }
 
 bool ObjectTable::Restore(stream::ByteStream* stream) {
+  std::lock_guard<std::mutex> lock(mutex_);
   Resize(stream->Read<uint32_t>());
-  for (uint32_t i = 0; i < table_capacity_; i++) {
-    auto& entry = table_[i];
+  uint32_t capacity = table_capacity_.load();
+  for (uint32_t i = 0; i < capacity; i++) {
+    auto& entry = EntryAt(i);
     // entry.object = nullptr;
-    entry.handle_ref_count = stream->Read<int32_t>();
+    entry.handle_ref_count.store(stream->Read<int32_t>());
   }
 
   return true;
@@ -394,12 +462,13 @@ bool ObjectTable::Restore(stream::ByteStream* stream) {
 
 X_STATUS ObjectTable::RestoreHandle(X_HANDLE handle, XObject* object) {
   uint32_t slot = GetHandleSlot(handle);
-  assert_true(table_capacity_ >= slot);
+  assert_true(table_capacity_ > slot);
 
-  if (table_capacity_ >= slot) {
-    auto& entry = table_[slot];
-    entry.object = object;
+  if (table_capacity_ > slot) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& entry = EntryAt(slot);
     object->Retain();
+    entry.object.store(object);
   }
 
   return X_STATUS_SUCCESS;
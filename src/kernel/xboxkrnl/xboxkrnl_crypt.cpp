@@ -14,6 +14,7 @@
 
 #include <algorithm>
 
+#include <rex/crypto.h>
 #include <rex/logging.h>
 #include <rex/platform.h>
 #include <rex/kernel/kernel_state.h>
@@ -26,13 +27,10 @@
 #include <rex/platform.h>  // for bcrypt.h
 #endif
 
-#include "crypto/TinySHA1.hpp"
 #include "crypto/des/des.cpp"
 #include "crypto/des/des.h"
 #include "crypto/des/des3.h"
 #include "crypto/des/descbc.h"
-#include "crypto/sha256.cpp"
-#include "crypto/sha256.h"
 
 extern "C" {
 #include "aes_128/aes.h"
@@ -96,18 +94,17 @@ typedef struct {
 } XECRYPT_SHA_STATE;
 static_assert_size(XECRYPT_SHA_STATE, 0x58);
 
-void InitSha1(sha1::SHA1* sha, const XECRYPT_SHA_STATE* state) {
-  uint32_t digest[5];
-  std::copy(std::begin(state->state), std::end(state->state), digest);
-
-  sha->init(digest, state->buffer, state->count);
+rex::crypto::Sha1 LoadSha1(const XECRYPT_SHA_STATE* state) {
+  uint32_t words[5];
+  std::copy(std::begin(state->state), std::end(state->state), words);
+  return rex::crypto::Sha1(words, state->count, state->buffer);
 }
 
-void StoreSha1(const sha1::SHA1* sha, XECRYPT_SHA_STATE* state) {
-  std::copy_n(sha->getDigest(), rex::countof(state->state), state->state);
+void StoreSha1(const rex::crypto::Sha1& sha, XECRYPT_SHA_STATE* state) {
+  std::copy_n(sha.state(), rex::countof(state->state), state->state);
 
-  state->count = static_cast<uint32_t>(sha->getByteCount());
-  std::copy_n(sha->getBlock(), sha->getBlockByteIndex(), state->buffer);
+  state->count = static_cast<uint32_t>(sha.count());
+  std::copy_n(sha.buffer(), sha.count() % sha.kBlockSize, state->buffer);
 }
 
 void XeCryptShaInit_entry(pointer_t<XECRYPT_SHA_STATE> sha_state) {
@@ -122,45 +119,43 @@ void XeCryptShaInit_entry(pointer_t<XECRYPT_SHA_STATE> sha_state) {
 
 void XeCryptShaUpdate_entry(pointer_t<XECRYPT_SHA_STATE> sha_state,
                             lpvoid_t input, dword_t input_size) {
-  sha1::SHA1 sha;
-  InitSha1(&sha, sha_state);
+  auto sha = LoadSha1(sha_state);
 
-  sha.processBytes(input, input_size);
+  sha.Update(input, input_size);
 
-  StoreSha1(&sha, sha_state);
+  StoreSha1(sha, sha_state);
 }
 
 void XeCryptShaFinal_entry(pointer_t<XECRYPT_SHA_STATE> sha_state,
                            pointer_t<uint8_t> out, dword_t out_size) {
-  sha1::SHA1 sha;
-  InitSha1(&sha, sha_state);
+  auto sha = LoadSha1(sha_state);
 
   uint8_t digest[0x14];
-  sha.finalize(digest);
+  sha.Final(digest);
 
   std::copy_n(digest, std::min<size_t>(rex::countof(digest), out_size),
               static_cast<uint8_t*>(out));
-  std::copy_n(sha.getDigest(), rex::countof(sha_state->state), sha_state->state);
+  std::copy_n(sha.state(), rex::countof(sha_state->state), sha_state->state);
 }
 
 void XeCryptSha_entry(lpvoid_t input_1, dword_t input_1_size, lpvoid_t input_2,
                       dword_t input_2_size, lpvoid_t input_3,
                       dword_t input_3_size, lpvoid_t output,
                       dword_t output_size) {
-  sha1::SHA1 sha;
+  rex::crypto::Sha1 sha;
 
   if (input_1 && input_1_size) {
-    sha.processBytes(input_1, input_1_size);
+    sha.Update(input_1, input_1_size);
   }
   if (input_2 && input_2_size) {
-    sha.processBytes(input_2, input_2_size);
+    sha.Update(input_2, input_2_size);
   }
   if (input_3 && input_3_size) {
-    sha.processBytes(input_3, input_3_size);
+    sha.Update(input_3, input_3_size);
   }
 
   uint8_t digest[0x14];
-  sha.finalize(digest);
+  sha.Final(digest);
   std::copy_n(digest, std::min<size_t>(rex::countof(digest), output_size),
               output.as<uint8_t*>());
 }
@@ -172,6 +167,12 @@ typedef struct {
   uint8_t buffer[64];         // 0x24
 } XECRYPT_SHA256_STATE;
 
+rex::crypto::Sha256 LoadSha256(const XECRYPT_SHA256_STATE* state) {
+  uint32_t words[8];
+  std::copy(std::begin(state->state), std::end(state->state), words);
+  return rex::crypto::Sha256(words, state->count, state->buffer);
+}
+
 void XeCryptSha256Init_entry(pointer_t<XECRYPT_SHA256_STATE> sha_state) {
   sha_state.Zero();
 
@@ -187,33 +188,22 @@ void XeCryptSha256Init_entry(pointer_t<XECRYPT_SHA256_STATE> sha_state) {
 
 void XeCryptSha256Update_entry(pointer_t<XECRYPT_SHA256_STATE> sha_state,
                                lpvoid_t input, dword_t input_size) {
-  sha256::SHA256 sha;
-  std::copy(std::begin(sha_state->state), std::end(sha_state->state),
-            sha.getHashValues());
-  std::copy(std::begin(sha_state->buffer), std::end(sha_state->buffer),
-            sha.getBuffer());
-  sha.setTotalSize(sha_state->count);
-
-  sha.add(input, input_size);
-
-  std::copy_n(sha.getHashValues(), rex::countof(sha_state->state),
-              sha_state->state);
-  std::copy_n(sha.getBuffer(), rex::countof(sha_state->buffer),
+  auto sha = LoadSha256(sha_state);
+
+  sha.Update(input, input_size);
+
+  std::copy_n(sha.state(), rex::countof(sha_state->state), sha_state->state);
+  std::copy_n(sha.buffer(), rex::countof(sha_state->buffer),
               sha_state->buffer);
-  sha_state->count = static_cast<uint32_t>(sha.getTotalSize());
+  sha_state->count = static_cast<uint32_t>(sha.count());
 }
 
 void XeCryptSha256Final_entry(pointer_t<XECRYPT_SHA256_STATE> sha_state,
                               pointer_t<uint8_t> out, dword_t out_size) {
-  sha256::SHA256 sha;
-  std::copy(std::begin(sha_state->state), std::end(sha_state->state),
-            sha.getHashValues());
-  std::copy(std::begin(sha_state->buffer), std::end(sha_state->buffer),
-            sha.getBuffer());
-  sha.setTotalSize(sha_state->count);
+  auto sha = LoadSha256(sha_state);
 
   uint8_t hash[32];
-  sha.getHash(hash);
+  sha.Final(hash);
 
   std::copy_n(hash, std::min<size_t>(rex::countof(hash), out_size),
               static_cast<uint8_t*>(out));
@@ -486,46 +476,27 @@ void XeCryptAesKey_entry(pointer_t<XECRYPT_AES_STATE> state_ptr, lpvoid_t key) {
 
 void XeCryptAesEcb_entry(pointer_t<XECRYPT_AES_STATE> state_ptr,
                          lpvoid_t inp_ptr, lpvoid_t out_ptr, dword_t encrypt) {
-  const uint8_t* keytab =
-      reinterpret_cast<const uint8_t*>(state_ptr->keytabenc);
+  // The first round key is the cipher key itself.
+  rex::crypto::Aes128 aes(&state_ptr->keytabenc[0][0][0]);
   if (encrypt) {
-    aes_encrypt_128(keytab, inp_ptr, out_ptr);
+    aes.EncryptBlock(inp_ptr.as<const uint8_t*>(), out_ptr.as<uint8_t*>());
   } else {
-    aes_decrypt_128(keytab, inp_ptr, out_ptr);
+    aes.DecryptBlock(inp_ptr.as<const uint8_t*>(), out_ptr.as<uint8_t*>());
   }
 }
 
 void XeCryptAesCbc_entry(pointer_t<XECRYPT_AES_STATE> state_ptr,
                          lpvoid_t inp_ptr, dword_t inp_size, lpvoid_t out_ptr,
                          lpvoid_t feed_ptr, dword_t encrypt) {
-  const uint8_t* keytab =
-      reinterpret_cast<const uint8_t*>(state_ptr->keytabenc);
-  const uint8_t* inp = inp_ptr.as<const uint8_t*>();
-  uint8_t* out = out_ptr.as<uint8_t*>();
-  uint8_t* feed = feed_ptr.as<uint8_t*>();
+  rex::crypto::Aes128 aes(&state_ptr->keytabenc[0][0][0]);
+  // Partial trailing blocks were always processed as whole ones.
+  size_t length = (size_t(inp_size) + 15) & ~size_t(15);
   if (encrypt) {
-    for (uint32_t i = 0; i < inp_size; i += 16) {
-      for (uint32_t j = 0; j < 16; ++j) {
-        feed[j] ^= inp[j];
-      }
-      aes_encrypt_128(keytab, feed, feed);
-      std::memcpy(out, feed, 16);
-      inp += 16;
-      out += 16;
-    }
+    aes.EncryptCbc(feed_ptr.as<uint8_t*>(), inp_ptr.as<const uint8_t*>(),
+                   out_ptr.as<uint8_t*>(), length);
   } else {
-    for (uint32_t i = 0; i < inp_size; i += 16) {
-      // In case inp == out.
-      uint8_t tmp[16];
-      std::memcpy(tmp, inp, 16);
-      aes_decrypt_128(keytab, inp, out);
-      for (uint32_t j = 0; j < 16; ++j) {
-        out[j] ^= feed[j];
-      }
-      std::memcpy(feed, tmp, 16);
-      inp += 16;
-      out += 16;
-    }
+    aes.DecryptCbc(feed_ptr.as<uint8_t*>(), inp_ptr.as<const uint8_t*>(),
+                   out_ptr.as<uint8_t*>(), length);
   }
 }
 
@@ -534,7 +505,7 @@ void XeCryptHmacSha_entry(lpvoid_t key, dword_t key_size_in, lpvoid_t inp_1,
                           dword_t inp_2_size, lpvoid_t inp_3,
                           dword_t inp_3_size, lpvoid_t out, dword_t out_size) {
   uint32_t key_size = key_size_in;
-  sha1::SHA1 sha;
+  rex::crypto::Sha1 sha;
   uint8_t kpad_i[0x40];
   uint8_t kpad_o[0x40];
   uint8_t tmp_key[0x40];
@@ -544,9 +515,9 @@ void XeCryptHmacSha_entry(lpvoid_t key, dword_t key_size_in, lpvoid_t inp_1,
   // Setup HMAC key
   // If > block size, use its hash
   if (key_size > 0x40) {
-    sha1::SHA1 sha_key;
-    sha_key.processBytes(key, key_size);
-    sha_key.finalize((uint8_t*)tmp_key);
+    rex::crypto::Sha1 sha_key;
+    sha_key.Update(key, key_size);
+    sha_key.Final(tmp_key);
 
     key_size = 0x14u;
   } else {
@@ -559,28 +530,28 @@ void XeCryptHmacSha_entry(lpvoid_t key, dword_t key_size_in, lpvoid_t inp_1,
   }
 
   // Inner
-  sha.processBytes(kpad_i, 0x40);
+  sha.Update(kpad_i, 0x40);
 
   if (inp_1_size) {
-    sha.processBytes(inp_1, inp_1_size);
+    sha.Update(inp_1, inp_1_size);
   }
 
   if (inp_2_size) {
-    sha.processBytes(inp_2, inp_2_size);
+    sha.Update(inp_2, inp_2_size);
   }
 
   if (inp_3_size) {
-    sha.processBytes(inp_3, inp_3_size);
+    sha.Update(inp_3, inp_3_size);
   }
 
   uint8_t digest[0x14];
-  sha.finalize(digest);
-  sha.reset();
+  sha.Final(digest);
 
   // Outer
-  sha.processBytes(kpad_o, 0x40);
-  sha.processBytes(digest, 0x14);
-  sha.finalize(digest);
+  sha = rex::crypto::Sha1();
+  sha.Update(kpad_o, 0x40);
+  sha.Update(digest, 0x14);
+  sha.Final(digest);
 
   std::memcpy(out, digest, std::min((uint32_t)out_size, 0x14u));
 }
@@ -192,6 +192,56 @@ dword_result_t NtOpenFile_entry(
       open_options);
 }
 
+// Everything needed to report an overlapped request back to the guest once it
+// has run on the kernel I/O pool. The status block is written before anything
+// can wake a waiter: then the completion ports and the file, the APC, and
+// finally the event.
+struct AsyncIoCompletion {
+  object_ref<XFile> file;
+  object_ref<XEvent> event;
+  object_ref<XThread> thread;
+  uint32_t apc_routine;
+  uint32_t apc_context;
+  uint32_t io_status_block_ptr;
+
+  void Complete(X_STATUS result, uint32_t information) {
+    if (io_status_block_ptr) {
+      auto io_status_block =
+          kernel_memory()->TranslateVirtual<X_IO_STATUS_BLOCK*>(
+              io_status_block_ptr);
+      io_status_block->status = result;
+      io_status_block->information = information;
+    }
+    file->NotifyCompletion(apc_context, result, information);
+    // Low bit probably means do not queue to IO ports.
+    if ((apc_routine & ~1u) && apc_context && thread) {
+      thread->EnqueueApc(apc_routine & ~1u, apc_context, io_status_block_ptr,
+                         0);
+    }
+    if (event) {
+      event->Set(0, false);
+    }
+  }
+};
+
+// Marks the request pending and returns what the worker needs to finish it.
+static AsyncIoCompletion BeginAsyncIo(
+    object_ref<XFile> file, object_ref<XEvent> ev, uint32_t apc_routine,
+    uint32_t apc_context, pointer_t<X_IO_STATUS_BLOCK>& io_status_block) {
+  if (io_status_block) {
+    io_status_block->status = X_STATUS_PENDING;
+    io_status_block->information = 0;
+  }
+  file->ResetCompletion();
+  if (ev) {
+    ev->Reset();
+  }
+  return AsyncIoCompletion{std::move(file), std::move(ev),
+                           retain_object(XThread::GetCurrentThread()),
+                           apc_routine, apc_context,
+                           io_status_block.guest_address()};
+}
+
 dword_result_t NtReadFile_entry(dword_t file_handle, dword_t event_handle,
                                 lpvoid_t apc_routine_ptr, lpvoid_t apc_context,
                                 pointer_t<X_IO_STATUS_BLOCK> io_status_block,
@@ -218,7 +268,7 @@ dword_result_t NtReadFile_entry(dword_t file_handle, dword_t event_handle,
   }
 
   if (XSUCCEEDED(result)) {
-    if (true || file->is_synchronous()) {
+    if (file->is_synchronous()) {
       // Synchronous.
       uint32_t bytes_read = 0;
       result = file->Read(
@@ -241,31 +291,28 @@ dword_result_t NtReadFile_entry(dword_t file_handle, dword_t event_handle,
         }
       }
 
-      if (!file->is_synchronous()) {
-        result = X_STATUS_PENDING;
-      }
-
       // Mark that we should signal the event now. We do this after
       // we have written the info out.
       signal_event = true;
     } else {
-      // TODO(benvanik): async.
-
-      // X_STATUS_PENDING if not returning immediately.
-      // XFile is waitable and signalled after each async req completes.
-      // reset the input event (->Reset())
-      /*xeNtReadFileState* call_state = new xeNtReadFileState();
-      XAsyncRequest* request = new XAsyncRequest(
-      state, file,
-      (XAsyncRequest::CompletionCallback)xeNtReadFileCompleted,
-      call_state);*/
-      // result = file->Read(buffer.guest_address(), buffer_length, byte_offset,
-      //                     request);
-      if (io_status_block) {
-        io_status_block->status = X_STATUS_PENDING;
-        io_status_block->information = 0;
-      }
-
+      // Overlapped: the read runs on the kernel I/O pool and the completion
+      // reports it to the guest, status block first.
+      auto completion = BeginAsyncIo(
+          file, std::move(ev), static_cast<uint32_t>(apc_routine_ptr),
+          apc_context, io_status_block);
+      file->QueueAsyncIo([file, completion = std::move(completion),
+                          buffer = buffer.guest_address(),
+                          length = uint32_t(buffer_length),
+                          offset = byte_offset_ptr
+                                       ? static_cast<uint64_t>(*byte_offset_ptr)
+                                       : uint64_t(-1),
+                          apc_context = uint32_t(apc_context)]() mutable {
+        uint32_t bytes_read = 0;
+        X_STATUS status =
+            file->Read(buffer, length, offset, &bytes_read, apc_context,
+                       false);
+        completion.Complete(status, bytes_read);
+      });
       result = X_STATUS_PENDING;
     }
   }
@@ -310,7 +357,7 @@ dword_result_t NtReadFileScatter_entry(
   }
 
   if (XSUCCEEDED(result)) {
-    if (true || file->is_synchronous()) {
+    if (file->is_synchronous()) {
       // Synchronous.
       uint32_t bytes_read = 0;
       result = file->ReadScatter(
@@ -333,34 +380,29 @@ dword_result_t NtReadFileScatter_entry(
         }
       }
 
-      if (!file->is_synchronous()) {
-        result = X_STATUS_PENDING;
-      }
-
       // Mark that we should signal the event now. We do this after
       // we have written the info out.
       signal_event = true;
     } else {
-      // TODO(benvanik): async.
-
       // TODO: On Windows it might be worth trying to use Win32 ReadFileScatter
       // here instead of handling it ourselves
 
-      // X_STATUS_PENDING if not returning immediately.
-      // XFile is waitable and signalled after each async req completes.
-      // reset the input event (->Reset())
-      /*xeNtReadFileState* call_state = new xeNtReadFileState();
-      XAsyncRequest* request = new XAsyncRequest(
-      state, file,
-      (XAsyncRequest::CompletionCallback)xeNtReadFileCompleted,
-      call_state);*/
-      // result = file->Read(buffer.guest_address(), buffer_length, byte_offset,
-      //                     request);
-      if (io_status_block) {
-        io_status_block->status = X_STATUS_PENDING;
-        io_status_block->information = 0;
-      }
-
+      // Overlapped; see NtReadFile.
+      auto completion = BeginAsyncIo(
+          file, std::move(ev), static_cast<uint32_t>(apc_routine_ptr),
+          apc_context, io_status_block);
+      file->QueueAsyncIo([file, completion = std::move(completion),
+                          segments = segment_array.guest_address(),
+                          length = uint32_t(length),
+                          offset = byte_offset_ptr
+                                       ? static_cast<uint64_t>(*byte_offset_ptr)
+                                       : uint64_t(-1),
+                          apc_context = uint32_t(apc_context)]() mutable {
+        uint32_t bytes_read = 0;
+        X_STATUS status = file->ReadScatter(segments, length, offset,
+                                            &bytes_read, apc_context, false);
+        completion.Complete(status, bytes_read);
+      });
       result = X_STATUS_PENDING;
     }
   }
@@ -399,8 +441,7 @@ dword_result_t NtWriteFile_entry(dword_t file_handle, dword_t event_handle,
 
   // Execute write.
   if (XSUCCEEDED(result)) {
-    // TODO(benvanik): async path.
-    if (true || file->is_synchronous()) {
+    if (file->is_synchronous()) {
       // Synchronous request.
       uint32_t bytes_written = 0;
       result = file->Write(
@@ -424,21 +465,28 @@ dword_result_t NtWriteFile_entry(dword_t file_handle, dword_t event_handle,
         }
       }
 
-      if (!file->is_synchronous()) {
-        result = X_STATUS_PENDING;
-      }
-
       // Mark that we should signal the event now. We do this after
       // we have written the info out.
       signal_event = true;
     } else {
-      // X_STATUS_PENDING if not returning immediately.
+      // Overlapped; see NtReadFile.
+      auto completion =
+          BeginAsyncIo(file, std::move(ev), static_cast<uint32_t>(apc_routine),
+                       apc_context, io_status_block);
+      file->QueueAsyncIo([file, completion = std::move(completion),
+                          buffer = buffer.guest_address(),
+                          length = uint32_t(buffer_length),
+                          offset = byte_offset_ptr
+                                       ? static_cast<uint64_t>(*byte_offset_ptr)
+                                       : uint64_t(-1),
+                          apc_context = uint32_t(apc_context)]() mutable {
+        uint32_t bytes_written = 0;
+        X_STATUS status =
+            file->Write(buffer, length, offset, &bytes_written, apc_context,
+                        false);
+        completion.Complete(status, bytes_written);
+      });
       result = X_STATUS_PENDING;
-
-      if (io_status_block) {
-        io_status_block->status = X_STATUS_PENDING;
-        io_status_block->information = 0;
-      }
     }
   }
 
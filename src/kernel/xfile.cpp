@@ -168,14 +168,7 @@ X_STATUS XFile::Read(uint32_t buffer_guest_address, uint32_t buffer_length,
   }
 
   if (notify_completion) {
-    XIOCompletion::IONotification notify;
-    notify.apc_context = apc_context;
-    notify.num_bytes = uint32_t(bytes_read);
-    notify.status = result;
-
-    NotifyIOCompletionPorts(notify);
-
-    async_event_->Set();
+    NotifyCompletion(apc_context, result, uint32_t(bytes_read));
   }
 
   return result;
@@ -183,7 +176,7 @@ X_STATUS XFile::Read(uint32_t buffer_guest_address, uint32_t buffer_length,
 
 X_STATUS XFile::ReadScatter(uint32_t segments_guest_address, uint32_t length,
                             uint64_t byte_offset, uint32_t* out_bytes_read,
-                            uint32_t apc_context) {
+                            uint32_t apc_context, bool notify_completion) {
   X_STATUS result = X_STATUS_SUCCESS;
 
   // segments points to an array of buffer pointers of type
@@ -225,21 +218,16 @@ X_STATUS XFile::ReadScatter(uint32_t segments_guest_address, uint32_t length,
     *out_bytes_read = uint32_t(read_total);
   }
 
-  XIOCompletion::IONotification notify;
-  notify.apc_context = apc_context;
-  notify.num_bytes = uint32_t(read_total);
-  notify.status = result;
-
-  NotifyIOCompletionPorts(notify);
-
-  async_event_->Set();
+  if (notify_completion) {
+    NotifyCompletion(apc_context, result, read_total);
+  }
 
   return result;
 }
 
 X_STATUS XFile::Write(uint32_t buffer_guest_address, uint32_t buffer_length,
                       uint64_t byte_offset, uint32_t* out_bytes_written,
-                      uint32_t apc_context) {
+                      uint32_t apc_context, bool notify_completion) {
   if (byte_offset == uint64_t(-1)) {
     // Write from current position.
     byte_offset = position_;
@@ -253,23 +241,52 @@ X_STATUS XFile::Write(uint32_t buffer_guest_address, uint32_t buffer_length,
     position_ += bytes_written;
   }
 
-  XIOCompletion::IONotification notify;
-  notify.apc_context = apc_context;
-  notify.num_bytes = uint32_t(bytes_written);
-  notify.status = result;
-
-  NotifyIOCompletionPorts(notify);
-
   if (out_bytes_written) {
     *out_bytes_written = uint32_t(bytes_written);
   }
 
-  async_event_->Set();
+  if (notify_completion) {
+    NotifyCompletion(apc_context, result, uint32_t(bytes_written));
+  }
   return result;
 }
 
 X_STATUS XFile::SetLength(size_t length) { return file_->SetLength(length); }
 
+void XFile::QueueAsyncIo(std::move_only_function<void()> fn) {
+  std::lock_guard<std::mutex> lock(async_io_lock_);
+  async_io_queue_.push_back(std::move(fn));
+  if (!async_io_running_) {
+    async_io_running_ = true;
+    kernel_state()->QueueIoWork(
+        [file = retain_object(this)]() { file->DrainAsyncIo(); });
+  }
+}
+
+void XFile::DrainAsyncIo() {
+  std::unique_lock<std::mutex> lock(async_io_lock_);
+  while (!async_io_queue_.empty()) {
+    auto fn = std::move(async_io_queue_.front());
+    async_io_queue_.pop_front();
+    lock.unlock();
+    fn();
+    lock.lock();
+  }
+  async_io_running_ = false;
+}
+
+void XFile::NotifyCompletion(uint32_t apc_context, X_STATUS result,
+                             uint32_t bytes_transferred) {
+  XIOCompletion::IONotification notify;
+  notify.apc_context = apc_context;
+  notify.num_bytes = bytes_transferred;
+  notify.status = result;
+
+  NotifyIOCompletionPorts(notify);
+
+  async_event_->Set();
+}
+
 void XFile::RegisterIOCompletionPort(uint32_t key,
                                      object_ref<XIOCompletion> port) {
   std::lock_guard<std::mutex> lock(completion_port_lock_);
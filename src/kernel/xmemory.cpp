@@ -12,6 +12,7 @@
 #include <rex/kernel/xmemory.h>
 
 #include <algorithm>
+#include <bit>
 #include <cstring>
 #include <utility>
 
@@ -41,6 +42,14 @@ REXCVAR_DEFINE_BOOL(scribble_heap, false,
     "Scribble 0xCD into all allocated heap memory",
     "Memory");
 
+REXCVAR_DEFINE_STRING(write_watch, "auto", "Memory",
+    "How CPU writes to GPU-cached physical memory are detected: protect "
+    "(write-protected pages, an access violation per first write), "
+    "userfaultfd (kernel-recorded writes collected once per GPU submission, "
+    "Linux 6.7+), or auto (userfaultfd if supported)")
+    .allowed({"auto", "protect", "userfaultfd"})
+    .lifecycle(rex::cvar::Lifecycle::kRequiresRestart);
+
 namespace rex::memory {
 
 uint32_t get_page_count(uint32_t value, uint32_t page_size) {
@@ -106,6 +115,7 @@ Memory::~Memory() {
 
   // Uninstall the MMIO handler, as we won't be able to service more requests.
   mmio_handler_.reset();
+  write_watch_.reset();
 
   for (auto invalidation_callback : physical_memory_invalidation_callbacks_) {
     delete invalidation_callback;
@@ -214,6 +224,28 @@ bool Memory::Initialize() {
   }
   REXKRNL_DEBUG("Installed MMIO handler for physical address translation");
 
+  // Watch for writes to the guest views of physical memory without access
+  // violations if the host can, with page protection as the fallback.
+  if (REXCVAR_GET(write_watch) != "protect") {
+    write_watch_ = rex::memory::WriteWatch::Create();
+    if (write_watch_) {
+      for (uint8_t* view :
+           {views_.vA0000000, views_.vC0000000, views_.vE0000000}) {
+        if (!write_watch_->Register(view, 0x20000000)) {
+          write_watch_.reset();
+          break;
+        }
+      }
+    }
+    if (write_watch_) {
+      REXKRNL_DEBUG("Watching physical memory writes with userfaultfd");
+    } else if (REXCVAR_GET(write_watch) == "userfaultfd") {
+      REXKRNL_WARN(
+          "userfaultfd write watching is not supported by the host, using "
+          "page protection");
+    }
+  }
+
   // ?
   uint32_t unk_phys_alloc;
   heaps_.vA0000000.Alloc(0x340000, 64 * 1024, memory::kMemoryAllocationReserve,
@@ -521,6 +553,15 @@ void Memory::UnregisterPhysicalMemoryInvalidationCallback(
   delete entry;
 }
 
+void Memory::PollPhysicalMemoryWrites() {
+  if (!write_watch_) {
+    return;
+  }
+  heaps_.vA0000000.PollWrites();
+  heaps_.vC0000000.PollWrites();
+  heaps_.vE0000000.PollWrites();
+}
+
 void Memory::EnablePhysicalMemoryAccessCallbacks(
     uint32_t physical_address, uint32_t length,
     bool enable_invalidation_notifications, bool enable_data_providers) {
@@ -730,6 +771,146 @@ uint32_t FromPageAccess(rex::memory::PageAccess protect) {
   return memory::kMemoryProtectNoAccess;
 }
 
+void FreePageIndex::Initialize(uint32_t page_count) {
+  page_count_ = page_count;
+  leaf_count_ = std::bit_ceil(std::max(page_count, 1u));
+  nodes_.assign(size_t(leaf_count_) * 2, Node{0, 0, 0});
+  Reset();
+}
+
+void FreePageIndex::Reset() {
+  std::fill(nodes_.begin(), nodes_.end(), Node{0, 0, 0});
+  Set(0, page_count_, true);
+}
+
+void FreePageIndex::Set(uint32_t first_page, uint32_t page_count, bool free) {
+  if (!page_count) {
+    return;
+  }
+  assert_true(first_page + page_count <= page_count_);
+  uint32_t value = free ? 1 : 0;
+  uint32_t lo = leaf_count_ + first_page;
+  uint32_t hi = lo + page_count - 1;
+  for (uint32_t i = lo; i <= hi; ++i) {
+    nodes_[i] = Node{value, value, value};
+  }
+  // Walk up, recomputing only the ancestors of the touched leaves.
+  for (uint32_t half = 1; lo > 1; half <<= 1) {
+    lo >>= 1;
+    hi >>= 1;
+    for (uint32_t i = lo; i <= hi; ++i) {
+      Pull(i, half);
+    }
+  }
+}
+
+void FreePageIndex::Pull(uint32_t node, uint32_t half) {
+  const Node& l = nodes_[node * 2];
+  const Node& r = nodes_[node * 2 + 1];
+  Node& n = nodes_[node];
+  n.prefix = l.prefix == half ? half + r.prefix : l.prefix;
+  n.suffix = r.suffix == half ? half + l.suffix : r.suffix;
+  n.best = std::max({l.best, r.best, l.suffix + r.prefix});
+}
+
+uint32_t FreePageIndex::FindFirst(uint32_t begin, uint32_t end,
+                                  uint32_t count) const {
+  end = std::min(end, page_count_);
+  if (!count || begin >= end || end - begin < count) {
+    return kNotFound;
+  }
+  uint32_t run = 0;
+  return FindFirst(1, 0, leaf_count_, begin, end, count, run);
+}
+
+uint32_t FreePageIndex::FindFirst(uint32_t node, uint32_t lo, uint32_t len,
+                                  uint32_t begin, uint32_t end, uint32_t count,
+                                  uint32_t& run) const {
+  // `run` is the length of the free run ending just before `lo` (counting
+  // only pages >= begin).
+  if (lo + len <= begin || lo >= end) {
+    return kNotFound;
+  }
+  const Node& n = nodes_[node];
+  if (begin <= lo && lo + len <= end) {
+    if (run + n.prefix >= count) {
+      return lo - run;
+    }
+    if (n.best < count) {
+      run = n.prefix == len ? run + len : n.suffix;
+      return kNotFound;
+    }
+  }
+  uint32_t half = len / 2;
+  uint32_t result =
+      FindFirst(node * 2, lo, half, begin, end, count, run);
+  if (result != kNotFound) {
+    return result;
+  }
+  return FindFirst(node * 2 + 1, lo + half, half, begin, end, count, run);
+}
+
+uint32_t FreePageIndex::FindLast(uint32_t begin, uint32_t end,
+                                 uint32_t count) const {
+  end = std::min(end, page_count_);
+  if (!count || begin >= end || end - begin < count) {
+    return kNotFound;
+  }
+  uint32_t run = 0;
+  return FindLast(1, 0, leaf_count_, begin, end, count, run);
+}
+
+uint32_t FreePageIndex::FindLast(uint32_t node, uint32_t lo, uint32_t len,
+                                 uint32_t begin, uint32_t end, uint32_t count,
+                                 uint32_t& run) const {
+  // Mirror of FindFirst: `run` is the free run starting at `lo + len`.
+  if (lo + len <= begin || lo >= end) {
+    return kNotFound;
+  }
+  const Node& n = nodes_[node];
+  if (begin <= lo && lo + len <= end) {
+    if (run + n.suffix >= count) {
+      return lo + len + run - count;
+    }
+    if (n.best < count) {
+      run = n.suffix == len ? run + len : n.prefix;
+      return kNotFound;
+    }
+  }
+  uint32_t half = len / 2;
+  uint32_t result =
+      FindLast(node * 2 + 1, lo + half, half, begin, end, count, run);
+  if (result != kNotFound) {
+    return result;
+  }
+  return FindLast(node * 2, lo, half, begin, end, count, run);
+}
+
+uint32_t FreePageIndex::FindUsed(uint32_t begin, uint32_t end) const {
+  end = std::min(end, page_count_);
+  if (begin >= end) {
+    return end;
+  }
+  return std::min(FindUsed(1, 0, leaf_count_, begin, end), end);
+}
+
+uint32_t FreePageIndex::FindUsed(uint32_t node, uint32_t lo, uint32_t len,
+                                 uint32_t begin, uint32_t end) const {
+  if (lo + len <= begin || lo >= end) {
+    return UINT32_MAX;
+  }
+  const Node& n = nodes_[node];
+  if (begin <= lo && lo + len <= end) {
+    return n.prefix == len ? UINT32_MAX : lo + n.prefix;
+  }
+  uint32_t half = len / 2;
+  uint32_t result = FindUsed(node * 2, lo, half, begin, end);
+  if (result != UINT32_MAX) {
+    return result;
+  }
+  return FindUsed(node * 2 + 1, lo + half, half, begin, end);
+}
+
 BaseHeap::BaseHeap()
     : membase_(nullptr), heap_base_(0), heap_size_(0), page_size_(0) {}
 
@@ -746,6 +927,7 @@ void BaseHeap::Initialize(memory::Memory* memory, uint8_t* membase, HeapType hea
   page_size_ = page_size;
   host_address_offset_ = host_address_offset;
   page_table_.resize(heap_size / page_size);
+  free_pages_.Initialize(uint32_t(page_table_.size()));
 }
 
 void BaseHeap::Dispose() {
@@ -878,8 +1060,10 @@ bool BaseHeap::Restore(stream::ByteStream* stream) {
     page.qword = stream->Read<uint64_t>();
     if (!page.state) {
       // Unallocated.
+      free_pages_.MarkFree(uint32_t(i), 1);
       continue;
     }
+    free_pages_.MarkUsed(uint32_t(i), 1);
 
     memory::PageAccess page_access = memory::PageAccess::kNoAccess;
     if ((page.current_protect & memory::kMemoryProtectRead) &&
@@ -917,6 +1101,7 @@ bool BaseHeap::Restore(stream::ByteStream* stream) {
 void BaseHeap::Reset() {
   // TODO(DrChat): protect pages.
   std::memset(page_table_.data(), 0, sizeof(PageEntry) * page_table_.size());
+  free_pages_.Reset();
   // TODO(Triang3l): Remove access callbacks from pages if this is a physical
   // memory heap.
 }
@@ -1008,6 +1193,7 @@ bool BaseHeap::AllocFixed(uint32_t base_address, uint32_t size,
     page_entry.current_protect = protect;
     page_entry.state = memory::kMemoryAllocationReserve | allocation_type;
   }
+  free_pages_.MarkUsed(start_page_number, page_count);
 
   return true;
 }
@@ -1037,83 +1223,61 @@ bool BaseHeap::AllocRange(uint32_t low_address, uint32_t high_address,
   auto global_lock = global_critical_region_.Acquire();
 
   // Find a free page range.
-  // The base page must match the requested alignment, so we first scan for
-  // a free aligned page and only then check for continuous free pages.
-  // TODO(benvanik): optimized searching (free list buckets, bitmap, etc).
+  // The base page must match the requested alignment. free_pages_ yields the
+  // nearest run of page_count free pages; if its aligned base doesn't fit,
+  // the first used page in the way bounds the next search. This picks the
+  // same page the old linear scan did: the lowest base at low_page_number +
+  // k * stride, or the highest stride-aligned base when top_down.
   uint32_t start_page_number = UINT_MAX;
   uint32_t end_page_number = UINT_MAX;
   uint32_t page_scan_stride = alignment / page_size_;
   high_page_number = high_page_number - (high_page_number % page_scan_stride);
   if (top_down) {
-    for (int64_t base_page_number =
-             high_page_number - rex::round_up(page_count, page_scan_stride);
-         base_page_number >= low_page_number;
-         base_page_number -= page_scan_stride) {
-      if (page_table_[base_page_number].state != 0) {
-        // Base page not free, skip to next usable page.
-        continue;
+    uint32_t search_end = high_page_number;
+    for (;;) {
+      uint32_t found_page_number =
+          free_pages_.FindLast(low_page_number, search_end, page_count);
+      if (found_page_number == FreePageIndex::kNotFound) {
+        break;
       }
-      // Check requested range to ensure free.
-      start_page_number = uint32_t(base_page_number);
-      end_page_number = uint32_t(base_page_number) + page_count - 1;
-      assert_true(end_page_number < page_table_.size());
-      bool any_taken = false;
-      for (uint32_t page_number = uint32_t(base_page_number);
-           !any_taken && page_number <= end_page_number; ++page_number) {
-        bool is_free = page_table_[page_number].state == 0;
-        if (!is_free) {
-          // At least one page in the range is used, skip to next.
-          // We know we'll be starting at least before this page.
-          any_taken = true;
-          if (page_count > page_number) {
-            // Not enough space left to fit entire page range. Breaks outer
-            // loop.
-            base_page_number = -1;
-          } else {
-            base_page_number = page_number - page_count;
-            base_page_number -= base_page_number % page_scan_stride;
-            base_page_number += page_scan_stride;  // cancel out loop logic
-          }
-          break;
-        }
+      uint32_t base_page_number =
+          found_page_number - (found_page_number % page_scan_stride);
+      if (base_page_number < low_page_number) {
+        break;
       }
-      if (!any_taken) {
-        // Found our place.
+      uint32_t used_page_number = free_pages_.FindUsed(
+          base_page_number, base_page_number + page_count);
+      if (used_page_number == base_page_number + page_count) {
+        start_page_number = base_page_number;
+        end_page_number = base_page_number + page_count - 1;
         break;
       }
-      // Retry.
-      start_page_number = end_page_number = UINT_MAX;
+      // Every aligned base above this one was already ruled out, and every
+      // one below that reaches used_page_number overlaps it.
+      search_end = used_page_number;
     }
-  } else {
-    for (uint32_t base_page_number = low_page_number;
-         base_page_number <= high_page_number - page_count;
-         base_page_number += page_scan_stride) {
-      if (page_table_[base_page_number].state != 0) {
-        // Base page not free, skip to next usable page.
-        continue;
+  } else if (high_page_number >= page_count) {
+    uint32_t search_begin = low_page_number;
+    for (;;) {
+      uint32_t found_page_number =
+          free_pages_.FindFirst(search_begin, high_page_number, page_count);
+      if (found_page_number == FreePageIndex::kNotFound) {
+        break;
       }
-      // Check requested range to ensure free.
-      start_page_number = base_page_number;
-      end_page_number = base_page_number + page_count - 1;
-      bool any_taken = false;
-      for (uint32_t page_number = base_page_number;
-           !any_taken && page_number <= end_page_number; ++page_number) {
-        bool is_free = page_table_[page_number].state == 0;
-        if (!is_free) {
-          // At least one page in the range is used, skip to next.
-          // We know we'll be starting at least after this page.
-          any_taken = true;
-          base_page_number = rex::round_up(page_number + 1, page_scan_stride);
-          base_page_number -= page_scan_stride;  // cancel out loop logic
-          break;
-        }
+      uint32_t base_page_number =
+          low_page_number + rex::round_up(found_page_number - low_page_number,
+                                          page_scan_stride, false);
+      if (base_page_number > high_page_number - page_count) {
+        break;
       }
-      if (!any_taken) {
-        // Found our place.
+      uint32_t used_page_number = free_pages_.FindUsed(
+          base_page_number, base_page_number + page_count);
+      if (used_page_number == base_page_number + page_count) {
+        start_page_number = base_page_number;
+        end_page_number = base_page_number + page_count - 1;
         break;
       }
-      // Retry.
-      start_page_number = end_page_number = UINT_MAX;
+      search_begin = used_page_number + 1;
     }
   }
   if (start_page_number == UINT_MAX || end_page_number == UINT_MAX) {
@@ -1153,6 +1317,7 @@ bool BaseHeap::AllocRange(uint32_t low_address, uint32_t high_address,
     page_entry.current_protect = protect;
     page_entry.state = memory::kMemoryAllocationReserve | allocation_type;
   }
+  free_pages_.MarkUsed(start_page_number, page_count);
 
   *out_address = heap_base_ + (start_page_number * page_size_);
   return true;
@@ -1243,6 +1408,7 @@ bool BaseHeap::Release(uint32_t base_address, uint32_t* out_region_size) {
     auto& page_entry = page_table_[page_number];
     page_entry.qword = 0;
   }
+  free_pages_.MarkFree(base_page_number, base_page_entry.region_page_count);
 
   return true;
 }
@@ -1702,6 +1868,26 @@ void PhysicalHeap::EnableAccessCallbacks(uint32_t physical_address,
       enable_data_providers ? rex::memory::PageAccess::kNoAccess
                             : rex::memory::PageAccess::kReadOnly;
   uint8_t* protect_base = membase_ + heap_base_;
+  // Host write watches only record writes, they can't block reads for data
+  // providers.
+  rex::memory::WriteWatch* write_watch =
+      enable_data_providers ? nullptr : memory_->write_watch_.get();
+  auto protect_system_pages = [&](uint32_t first, uint32_t count) {
+    uint8_t* base = protect_base + first * system_page_size_;
+    size_t length = size_t(count) * system_page_size_;
+    if (write_watch) {
+      if (write_watch->Arm(base, length)) {
+        return;
+      }
+      // Access violations are still handled, so protection works for any
+      // pages the watch couldn't take.
+      REXKRNL_WARN(
+          "Failed to arm the write watch for {} system pages at {}, "
+          "write-protecting them instead",
+          count, static_cast<const void*>(base));
+    }
+    rex::memory::Protect(base, length, protect_access);
+  };
   uint32_t protect_system_page_first = UINT32_MAX;
   auto global_lock = global_critical_region_.Acquire();
   for (uint32_t i = system_page_first; i <= system_page_last; ++i) {
@@ -1756,19 +1942,15 @@ void PhysicalHeap::EnableAccessCallbacks(uint32_t physical_address,
       }
     } else {
       if (protect_system_page_first != UINT32_MAX) {
-        rex::memory::Protect(
-            protect_base + protect_system_page_first * system_page_size_,
-            (i - protect_system_page_first) * system_page_size_,
-            protect_access);
+        protect_system_pages(protect_system_page_first,
+                             i - protect_system_page_first);
         protect_system_page_first = UINT32_MAX;
       }
     }
   }
   if (protect_system_page_first != UINT32_MAX) {
-    rex::memory::Protect(
-        protect_base + protect_system_page_first * system_page_size_,
-        (system_page_last + 1 - protect_system_page_first) * system_page_size_,
-        protect_access);
+    protect_system_pages(protect_system_page_first,
+                         system_page_last + 1 - protect_system_page_first);
   }
 }
 
@@ -1944,6 +2126,87 @@ bool PhysicalHeap::TriggerCallbacks(
   return true;
 }
 
+void PhysicalHeap::PollWrites() {
+  rex::memory::WriteWatch* write_watch = memory_->write_watch_.get();
+  if (!write_watch) {
+    return;
+  }
+  std::vector<std::pair<size_t, size_t>> written;
+  // First system page and count of each written run of watched pages.
+  std::vector<std::pair<uint32_t, uint32_t>> written_pages;
+  {
+    auto global_lock = global_critical_region_.Acquire();
+    // Only scan between the first and the last watched page.
+    uint32_t block_index_first = UINT32_MAX, block_index_last = 0;
+    for (uint32_t i = 0; i < uint32_t(system_page_flags_.size()); ++i) {
+      if (system_page_flags_[i].notify_on_invalidation) {
+        block_index_first = std::min(block_index_first, i);
+        block_index_last = i;
+      }
+    }
+    if (block_index_first == UINT32_MAX) {
+      return;
+    }
+    uint32_t bit_index;
+    rex::bit_scan_forward(
+        system_page_flags_[block_index_first].notify_on_invalidation,
+        &bit_index);
+    uint32_t system_page_first = (block_index_first << 6) + bit_index;
+    uint32_t system_page_last =
+        (block_index_last << 6) + 63 -
+        uint32_t(std::countl_zero(
+            system_page_flags_[block_index_last].notify_on_invalidation));
+    if (!write_watch->CollectWritten(
+            membase_ + heap_base_ +
+                size_t(system_page_first) * system_page_size_,
+            size_t(system_page_last + 1 - system_page_first) *
+                system_page_size_,
+            written)) {
+      // Nothing is known about what was written, so treat every watched page
+      // as written. They are then re-armed, or protected if arming fails
+      // too, when the GPU watches them again.
+      REXKRNL_ERROR(
+          "Failed to collect written pages from the write watch, invalidating "
+          "all watched pages");
+      written.clear();
+      written.emplace_back(
+          0, size_t(system_page_last + 1 - system_page_first) *
+                 system_page_size_);
+    }
+    // Pages in the scanned span that were never armed aren't write-protected,
+    // so the scan reports them as written too. Keep only the watched ones.
+    for (const std::pair<size_t, size_t>& range : written) {
+      uint32_t page_first =
+          system_page_first + uint32_t(range.first / system_page_size_);
+      uint32_t page_end =
+          page_first + uint32_t(range.second / system_page_size_);
+      uint32_t run_first = UINT32_MAX;
+      for (uint32_t i = page_first; i <= page_end; ++i) {
+        bool watched = i < page_end &&
+                       (system_page_flags_[i >> 6].notify_on_invalidation &
+                        (uint64_t(1) << (i & 63)));
+        if (watched) {
+          if (run_first == UINT32_MAX) {
+            run_first = i;
+          }
+        } else if (run_first != UINT32_MAX) {
+          written_pages.emplace_back(run_first, i - run_first);
+          run_first = UINT32_MAX;
+        }
+      }
+    }
+  }
+  // Notify like a write access violation would, for exactly the written pages
+  // as there's no protection to lift.
+  for (const std::pair<uint32_t, uint32_t>& pages : written_pages) {
+    uint32_t host_offset = pages.first * system_page_size_;
+    uint32_t virtual_address =
+        heap_base_ + rex::sat_sub(host_offset, host_address_offset());
+    TriggerCallbacks(global_critical_region_.Acquire(), virtual_address,
+                     pages.second * system_page_size_, true, true, false);
+  }
+}
+
 uint32_t PhysicalHeap::GetPhysicalAddress(uint32_t address) const {
   assert_true(address >= heap_base_);
   address -= heap_base_;
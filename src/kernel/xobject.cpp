@@ -375,72 +375,77 @@ object_ref<XObject> XObject::GetNativeObject(KernelState* kernel_state,
   // We identify this by setting wait_list_flink to a magic value. When set,
   // wait_list_blink will hold a handle to our object.
 
+  auto header = reinterpret_cast<X_DISPATCH_HEADER*>(native_ptr);
+
+  // Fast path: already initialized. Neither the header read nor the object
+  // table lookup needs a lock, so KeSetEvent/KeWait* from many threads don't
+  // serialize here.
+  // TODO: assert if the type of the object != as_type
+  // TODO(benvanik): assert nothing has been changed in the struct.
+  if (uint32_t handle = LoadStashedHandle(header)) {
+    return kernel_state->object_table()->LookupObject<XObject>(handle);
+  }
+
+  // Slow path: first use. Take the lock and check again in case another
+  // thread initialized the object while we were getting here.
   auto global_lock = rex::thread::global_critical_region::AcquireDirect();
 
-  auto header = reinterpret_cast<X_DISPATCH_HEADER*>(native_ptr);
+  if (uint32_t handle = LoadStashedHandle(header)) {
+    return kernel_state->object_table()->LookupObject<XObject>(handle);
+  }
 
   if (as_type == -1) {
     as_type = header->type;
   }
 
-  if (header->wait_list_flink == kXObjSignature) {
-    // Already initialized.
-    // TODO: assert if the type of the object != as_type
-    uint32_t handle = header->wait_list_blink;
-    auto object = kernel_state->object_table()->LookupObject<XObject>(handle);
-
-    // TODO(benvanik): assert nothing has been changed in the struct.
-    return object;
-  } else {
-    // First use, create new.
-    // https://www.nirsoft.net/kernel_struct/vista/KOBJECTS.html
-    XObject* object = nullptr;
-    switch (as_type) {
-      case 0:  // EventNotificationObject
-      case 1:  // EventSynchronizationObject
-      {
-        auto ev = new XEvent(kernel_state);
-        ev->InitializeNative(native_ptr, header);
-        object = ev;
-      } break;
-      case 2:  // MutantObject
-      {
-        auto mutant = new XMutant(kernel_state);
-        mutant->InitializeNative(native_ptr, header);
-        object = mutant;
-      } break;
-      case 5:  // SemaphoreObject
-      {
-        auto sem = new XSemaphore(kernel_state);
-        auto success = sem->InitializeNative(native_ptr, header);
-        // Can't report failure to the guest at late initialization:
-        assert_true(success);
-        object = sem;
-      } break;
-      case 3:   // ProcessObject
-      case 4:   // QueueObject
-      case 6:   // ThreadObject
-      case 7:   // GateObject
-      case 8:   // TimerNotificationObject
-      case 9:   // TimerSynchronizationObject
-      case 18:  // ApcObject
-      case 19:  // DpcObject
-      case 20:  // DeviceQueueObject
-      case 21:  // EventPairObject
-      case 22:  // InterruptObject
-      case 23:  // ProfileObject
-      case 24:  // ThreadedDpcObject
-      default:
-        assert_always();
-        return NULL;
-    }
+  // First use, create new.
+  // https://www.nirsoft.net/kernel_struct/vista/KOBJECTS.html
+  XObject* object = nullptr;
+  switch (as_type) {
+    case 0:  // EventNotificationObject
+    case 1:  // EventSynchronizationObject
+    {
+      auto ev = new XEvent(kernel_state);
+      ev->InitializeNative(native_ptr, header);
+      object = ev;
+    } break;
+    case 2:  // MutantObject
+    {
+      auto mutant = new XMutant(kernel_state);
+      mutant->InitializeNative(native_ptr, header);
+      object = mutant;
+    } break;
+    case 5:  // SemaphoreObject
+    {
+      auto sem = new XSemaphore(kernel_state);
+      auto success = sem->InitializeNative(native_ptr, header);
+      // Can't report failure to the guest at late initialization:
+      assert_true(success);
+      object = sem;
+    } break;
+    case 3:   // ProcessObject
+    case 4:   // QueueObject
+    case 6:   // ThreadObject
+    case 7:   // GateObject
+    case 8:   // TimerNotificationObject
+    case 9:   // TimerSynchronizationObject
+    case 18:  // ApcObject
+    case 19:  // DpcObject
+    case 20:  // DeviceQueueObject
+    case 21:  // EventPairObject
+    case 22:  // InterruptObject
+    case 23:  // ProfileObject
+    case 24:  // ThreadedDpcObject
+    default:
+      assert_always();
+      return NULL;
+  }
 
-    // Stash pointer in struct.
-    // FIXME: This assumes the object contains a dispatch header (some don't!)
-    StashHandle(header, object->handle());
+  // Stash pointer in struct.
+  // FIXME: This assumes the object contains a dispatch header (some don't!)
+  StashHandle(header, object->handle());
 
-    return object_ref<XObject>(object);
-  }
+  return object_ref<XObject>(object);
 }
 
 }  // namespace rex::kernel
@@ -16,6 +16,7 @@
 #include <fmt/format.h>
 #include <rex/cvar.h>
 #include <rex/stream.h>
+#include <rex/time/chrono_steady_cast.h>
 #include <rex/time/clock.h>
 #include <rex/literals.h>
 #include <rex/logging.h>
@@ -859,23 +860,24 @@ X_STATUS XThread::Suspend(uint32_t* out_suspend_count) {
 
 X_STATUS XThread::Delay(uint32_t processor_mode, uint32_t alertable,
                         uint64_t interval) {
+  using rex::chrono::WinSystemClock;
+  using rex::chrono::XSystemClock;
   int64_t timeout_ticks = interval;
-  uint32_t timeout_ms;
+  std::chrono::steady_clock::time_point deadline;
   if (timeout_ticks > 0) {
-    // Absolute time, based on January 1, 1601.
-    // TODO(benvanik): convert time to relative time.
-    assert_always();
-    timeout_ms = 0;
-  } else if (timeout_ticks < 0) {
-    // Relative time.
-    timeout_ms = uint32_t(-timeout_ticks / 10000);  // Ticks -> MS
+    // Absolute time, based on January 1, 1601. Guest time runs scaled, so go
+    // through the host system clock before pinning it to the steady clock.
+    deadline = date::clock_cast<std::chrono::steady_clock>(
+        date::clock_cast<WinSystemClock>(
+            XSystemClock::from_file_time(timeout_ticks)));
   } else {
-    timeout_ms = 0;
+    // Relative time, in 100ns ticks. Zero just yields.
+    auto timeout = rex::chrono::hundrednanoseconds(
+        -chrono::Clock::ScaleGuestDurationFileTime(timeout_ticks));
+    deadline = std::chrono::steady_clock::now() + timeout;
   }
-  timeout_ms = chrono::Clock::ScaleGuestDurationMillis(timeout_ms);
   if (alertable) {
-    auto result =
-        rex::thread::AlertableSleep(std::chrono::milliseconds(timeout_ms));
+    auto result = rex::thread::AlertablePreciseSleepUntil(deadline);
     switch (result) {
       default:
       case rex::thread::SleepResult::kSuccess:
@@ -883,8 +885,11 @@ X_STATUS XThread::Delay(uint32_t processor_mode, uint32_t alertable,
       case rex::thread::SleepResult::kAlerted:
         return X_STATUS_USER_APC;
     }
+  } else if (timeout_ticks == 0) {
+    rex::thread::MaybeYield();
+    return X_STATUS_SUCCESS;
   } else {
-    rex::thread::Sleep(std::chrono::milliseconds(timeout_ms));
+    rex::thread::PreciseSleepUntil(deadline);
     return X_STATUS_SUCCESS;
   }
 }
@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <filesystem>
 #include <string>
 
@@ -23,6 +24,11 @@ struct CliContext {
     bool verbose = false;
     bool force = false;  // Generate output despite validation errors
     bool enableExceptionHandlers = false;  // Enable SEH exception handler generation
+    uint32_t codegenThreads = 0;  // Emission worker override (0 = keep config value)
+    bool profile = false;  // Write per-phase codegen profile JSON
+    std::string profileOutput;  // Profile JSON path (empty = next to config)
+    bool profileInstrument = false;  // Emit execution counters into the generated code
+    std::string profileUse;  // Execution profile to optimize against (empty = keep config value)
 };
 
 } // namespace rexglue::cli
@@ -15,6 +15,7 @@
 
 #include <fmt/format.h>
 #include <filesystem>
+#include <fstream>
 
 namespace rexglue::cli {
 
@@ -31,8 +32,36 @@ Result<void> CodegenFromConfig(const std::string& config_path, const CliContext&
         pipeline->context().Config().generateExceptionHandlers = true;
         REXLOG_INFO("Exception handler generation enabled");
     }
+    if (ctx.codegenThreads != 0) {
+        pipeline->context().Config().codegenThreads = ctx.codegenThreads;
+    }
+    if (ctx.profileInstrument) {
+        pipeline->context().Config().profileInstrument = true;
+        REXLOG_INFO("Profile instrumentation enabled");
+    }
+    if (!ctx.profileUse.empty()) {
+        // Relative to the working directory, not the config like the TOML key
+        pipeline->context().Config().profileUsePath = std::filesystem::absolute(ctx.profileUse).string();
+    }
+
+    auto result = pipeline->Run(ctx.force);
+
+    // Written even when the run fails, so a slow failing phase can still be inspected
+    if (ctx.profile) {
+        std::filesystem::path profilePath = ctx.profileOutput.empty()
+            ? std::filesystem::path(config_path).parent_path() / "codegen_profile.json"
+            : std::filesystem::path(ctx.profileOutput);
+
+        std::ofstream out(profilePath, std::ios::binary | std::ios::trunc);
+        if (out) {
+            out << pipeline->context().profile.toJson();
+            REXLOG_INFO("Wrote codegen profile to {}", profilePath.string());
+        } else {
+            REXLOG_WARN("Failed to write codegen profile to {}", profilePath.string());
+        }
+    }
 
-    return pipeline->Run(ctx.force);
+    return result;
 }
 
 } // namespace rexglue::cli
@@ -368,6 +368,13 @@ bool recompile_tests(
         codegen::Recompiler recompiler;
         codegen::RecompilerConfig config;
         config.outDirectoryPath = std::string(outDirPath);
+        // Tests check CR and XER after blr, so flags must survive the return.
+        // The seq_abi_ files check the ABI assumption itself.
+        config.flagLivenessAssumeAbi = stem.starts_with("seq_abi_");
+        // Test functions are never overridden, so the flush mode pass is safe
+        config.flushModeAnalysis = true;
+        // The seq_inline_ files emit their leaf calls in place
+        config.inlineMaxInstructions = stem.starts_with("seq_inline_") ? 8 : 0;
         auto ctx = codegen::CodegenContext::Create(
             codegen::BinaryView::fromModule(module),
             std::move(config));
@@ -385,6 +392,7 @@ bool recompile_tests(
         }
         std::sort(functions.begin(), functions.end(),
                   [](const auto* a, const auto* b) { return a->base() < b->base(); });
+        recompiler.analyzeFunctions(functions);
 
         // Recompile each function
         for (const auto* fn : functions) {
@@ -20,6 +20,11 @@
 // Analyze/Codegen flags
 REXCVAR_DEFINE_BOOL(force, false, "Codegen", "Generate output even if validation errors occur");
 REXCVAR_DEFINE_BOOL(enable_exception_handlers, false, "Codegen", "Enable generation of SEH exception handler code");
+REXCVAR_DEFINE_UINT32(codegen_threads, 0, "Codegen", "Worker threads for C++ emission (0 = use config/auto, 1 = serial)");
+REXCVAR_DEFINE_BOOL(profile, false, "Codegen", "Write per-phase timing/throughput JSON after codegen");
+REXCVAR_DEFINE_STRING(profile_output, "", "Codegen", "Path for --profile JSON (default: codegen_profile.json next to the config)");
+REXCVAR_DEFINE_BOOL(profile_instrument, false, "Codegen", "Emit function entry and indirect call counters for profile-guided codegen");
+REXCVAR_DEFINE_STRING(profile_use, "", "Codegen", "Execution profile from a --profile_instrument build to optimize against");
 
 // Recompile-tests flags
 REXCVAR_DEFINE_STRING(bin_dir, "", "RecompileTests", "Directory containing linked .bin and .map files");
@@ -91,6 +96,11 @@ int main(int argc, char** argv) {
     ctx.verbose = verbose;
     ctx.force = REXCVAR_GET(force);
     ctx.enableExceptionHandlers = REXCVAR_GET(enable_exception_handlers);
+    ctx.codegenThreads = REXCVAR_GET(codegen_threads);
+    ctx.profile = REXCVAR_GET(profile);
+    ctx.profileOutput = REXCVAR_GET(profile_output);
+    ctx.profileInstrument = REXCVAR_GET(profile_instrument);
+    ctx.profileUse = REXCVAR_GET(profile_use);
 
     Result<void> result = Ok();
     if (command == "init") {
@@ -0,0 +1,98 @@
+/**
+ * @file        runtime/guest/profile.cpp
+ * @brief       Execution counters for profile-guided recompilation
+ *
+ * @copyright   Copyright (c) 2026 Tom Clay <tomc@tctechstuff.com>
+ *              All rights reserved.
+ *
+ * @license     BSD 3-Clause License
+ *              See LICENSE file in the project root for full license text.
+ */
+
+#include <rex/runtime/guest/profile.h>
+
+#include <fstream>
+#include <iterator>
+
+#include <fmt/format.h>
+
+namespace rex::runtime::guest {
+
+GuestProfile* g_guest_profile = nullptr;
+
+GuestProfile::GuestProfile(uint32_t code_base, uint32_t code_size)
+    : code_base_(code_base),
+      slot_count_(code_size >> 2),
+      entries_(new std::atomic<uint64_t>[slot_count_]()),
+      sites_(new std::atomic<IndirectSite*>[slot_count_]()) {}
+
+GuestProfile::~GuestProfile() {
+  for (uint32_t i = 0; i < slot_count_; ++i) {
+    delete sites_[i].load(std::memory_order_relaxed);
+  }
+}
+
+void GuestProfile::RecordIndirect(uint32_t site, uint32_t target) {
+  uint32_t index = (site - code_base_) >> 2;
+  if (index >= slot_count_ || target == 0) {
+    return;
+  }
+
+  IndirectSite* record = sites_[index].load(std::memory_order_acquire);
+  if (!record) {
+    auto* fresh = new IndirectSite();
+    if (sites_[index].compare_exchange_strong(record, fresh,
+                                              std::memory_order_acq_rel)) {
+      record = fresh;
+    } else {
+      delete fresh;
+    }
+  }
+
+  // Slots fill in first-seen order and are never evicted
+  for (size_t i = 0; i < kSiteTargets; ++i) {
+    uint32_t seen = record->targets[i].load(std::memory_order_relaxed);
+    if (seen == 0 && record->targets[i].compare_exchange_strong(
+                         seen, target, std::memory_order_relaxed)) {
+      seen = target;
+    }
+    if (seen == target) {
+      record->counts[i].fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+  }
+  record->other.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool GuestProfile::Save(const std::filesystem::path& path) const {
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  if (!file) {
+    return false;
+  }
+
+  auto out = std::ostreambuf_iterator<char>(file);
+  fmt::format_to(out, "# rex guest profile\n");
+  for (uint32_t i = 0; i < slot_count_; ++i) {
+    uint32_t address = code_base_ + (i << 2);
+    if (uint64_t count = entries_[i].load(std::memory_order_relaxed)) {
+      fmt::format_to(out, "entry {:08X} {}\n", address, count);
+    }
+    const IndirectSite* record = sites_[i].load(std::memory_order_acquire);
+    if (!record) {
+      continue;
+    }
+    for (size_t j = 0; j < kSiteTargets; ++j) {
+      uint32_t target = record->targets[j].load(std::memory_order_relaxed);
+      if (target != 0) {
+        fmt::format_to(out, "indirect {:08X} {:08X} {}\n", address, target,
+                       record->counts[j].load(std::memory_order_relaxed));
+      }
+    }
+    if (uint64_t other = record->other.load(std::memory_order_relaxed)) {
+      fmt::format_to(out, "indirect {:08X} 00000000 {}\n", address, other);
+    }
+  }
+  return static_cast<bool>(file.flush());
+}
+
+}  // namespace rex::runtime::guest
@@ -29,6 +29,8 @@
 REXCVAR_DEFINE_BOOL(disable_global_lock, false,
     "Disable global threading lock",
     "Runtime");
+REXCVAR_DEFINE_STRING(guest_profile, "", "Runtime",
+    "Write execution counts from a profile_instrument build to this file on shutdown");
 
 namespace rex::runtime {
 
@@ -42,6 +44,9 @@ Processor::~Processor() {
     auto global_lock = global_critical_region_.Acquire();
     modules_.clear();
   }
+  if (profile_ && guest::g_guest_profile == profile_.get()) {
+    guest::g_guest_profile = nullptr;
+  }
 }
 
 void Processor::PreLaunch() {
@@ -253,6 +258,12 @@ bool Processor::InitializeFunctionTable(uint32_t code_base, uint32_t code_size,
   function_table_initialized_ = true;
   REXLOG_INFO("Processor function table initialized: code={:08X}-{:08X}, image={:08X}-{:08X}",
          code_base, code_base + code_size, image_base, image_base + image_size);
+
+  if (!REXCVAR_GET(guest_profile).empty()) {
+    profile_ = std::make_unique<guest::GuestProfile>(code_base, code_size);
+    guest::g_guest_profile = profile_.get();
+    REXLOG_INFO("Recording guest profile to {}", REXCVAR_GET(guest_profile));
+  }
   return true;
 }
 
@@ -266,6 +277,18 @@ void Processor::SetFunction(uint32_t guest_address, ::PPCFunc* func) {
   memory_->SetFunction(guest_address, func);
 }
 
+void Processor::SaveProfile() {
+  if (!profile_) {
+    return;
+  }
+  const auto& path = REXCVAR_GET(guest_profile);
+  if (profile_->Save(path)) {
+    REXLOG_INFO("Wrote guest profile to {}", path);
+  } else {
+    REXLOG_ERROR("Failed to write guest profile to {}", path);
+  }
+}
+
 ::PPCFunc* Processor::GetFunction(uint32_t guest_address) {
   auto it = function_table_.find(guest_address);
   if (it != function_table_.end()) {
@@ -17,6 +17,7 @@
 #include <fmt/format.h>
 
 #include <rex/byte_order.h>
+#include <rex/crypto.h>
 #include <rex/logging.h>
 #include <rex/math.h>
 #include <rex/memory.h>
@@ -29,9 +30,6 @@
 #include <rex/kernel/xmodule.h>
 #include <rex/runtime.h>
 
-#include "crypto/TinySHA1.hpp"
-#include "crypto/rijndael-alg-fst.c"
-#include "crypto/rijndael-alg-fst.h"
 #include "pe/pe_image.h"
 
 static const uint8_t xe_xex2_retail_key[16] = {
@@ -44,21 +42,15 @@ static const uint8_t xe_xex2_devkit_key[16] = {
 void aes_decrypt_buffer(const uint8_t* session_key, const uint8_t* input_buffer,
                         const size_t input_size, uint8_t* output_buffer,
                         const size_t output_size) {
-  uint32_t rk[4 * (MAXNR + 1)];
   uint8_t ivec[16] = {0};
-  int32_t Nr = rijndaelKeySetupDec(rk, session_key, 128);
-  const uint8_t* ct = input_buffer;
-  uint8_t* pt = output_buffer;
-  for (size_t n = 0; n < input_size; n += 16, ct += 16, pt += 16) {
-    // Decrypt 16 uint8_ts from input -> output.
-    rijndaelDecrypt(rk, Nr, ct, pt);
-    for (size_t i = 0; i < 16; i++) {
-      // XOR with previous.
-      pt[i] ^= ivec[i];
-      // Set previous.
-      ivec[i] = ct[i];
-    }
-  }
+  // CBC only works on whole blocks; a partial trailing block can't be
+  // decrypted, so it is left as is.
+  if (input_size % 16) {
+    REXLOG_WARN("XEX: {} bytes past the last whole AES block left encrypted",
+                input_size % 16);
+  }
+  rex::crypto::Aes128(session_key)
+      .DecryptCbc(ivec, input_buffer, output_buffer, input_size & ~size_t(15));
 }
 
 namespace rex::runtime {
@@ -215,9 +207,9 @@ int XexModule::ApplyPatch(XexModule* module) {
 
   // Compare hash inside delta descriptor to base XEX signature
   uint8_t digest[0x14];
-  sha1::SHA1 s;
-  s.processBytes(module->xex_security_info()->rsa_signature, 0x100);
-  s.finalize(digest);
+  rex::crypto::Sha1 s;
+  s.Update(module->xex_security_info()->rsa_signature, 0x100);
+  s.Final(digest);
 
   if (memcmp(digest, patch_header->digest_source, 0x14) != 0) {
     REXLOG_WARN(
@@ -407,9 +399,9 @@ int XexModule::ApplyPatch(XexModule* module) {
     const auto* next_block = (const xex2_compressed_block_info*)p;
 
     // Compare block hash, if no match we probably used wrong decrypt key
-    s.reset();
-    s.processBytes(p, cur_block->block_size);
-    s.finalize(digest);
+    rex::crypto::Sha1 s;
+    s.Update(p, cur_block->block_size);
+    s.Final(digest);
 
     if (memcmp(digest, cur_block->block_hash, 0x14) != 0) {
       result_code = 9;
@@ -615,9 +607,8 @@ int XexModule::ReadImageBasicCompressed(const void* xex_addr,
   std::memset(buffer, 0, total_size);  // Quickly zero the contents.
   uint8_t* d = buffer;
 
-  uint32_t rk[4 * (MAXNR + 1)];
+  rex::crypto::Aes128 aes(session_key_);
   uint8_t ivec[16] = {0};
-  int32_t Nr = rijndaelKeySetupDec(rk, session_key_, 128);
 
   for (size_t n = 0; n < block_count; n++) {
     const uint32_t data_size = comp_info.blocks[n].data_size;
@@ -631,20 +622,15 @@ int XexModule::ReadImageBasicCompressed(const void* xex_addr,
         }
         memcpy(d, p, data_size);
         break;
-      case XEX_ENCRYPTION_NORMAL: {
-        const uint8_t* ct = p;
-        uint8_t* pt = d;
-        for (size_t m = 0; m < data_size; m += 16, ct += 16, pt += 16) {
-          // Decrypt 16 uint8_ts from input -> output.
-          rijndaelDecrypt(rk, Nr, ct, pt);
-          for (size_t i = 0; i < 16; i++) {
-            // XOR with previous.
-            pt[i] ^= ivec[i];
-            // Set previous.
-            ivec[i] = ct[i];
-          }
+      case XEX_ENCRYPTION_NORMAL:
+        if (data_size % 16) {
+          REXLOG_WARN(
+              "XEX: block {} is {} bytes, not a whole number of AES blocks",
+              n, data_size);
         }
-      } break;
+        // The CBC chain continues across blocks.
+        aes.DecryptCbc(ivec, p, d, data_size & ~uint32_t(15));
+        break;
       default:
         assert_always();
         return 1;
@@ -674,7 +660,6 @@ int XexModule::ReadImageCompressed(const void* xex_addr, size_t xex_length) {
   uint8_t* compress_buffer = NULL;
   const uint8_t* p = NULL;
   uint8_t* d = NULL;
-  sha1::SHA1 s;
 
   // Decrypt (if needed).
   bool free_input = false;
@@ -715,9 +700,9 @@ int XexModule::ReadImageCompressed(const void* xex_addr, size_t xex_length) {
     const auto* next_block = (const xex2_compressed_block_info*)p;
 
     // Compare block hash, if no match we probably used wrong decrypt key
-    s.reset();
-    s.processBytes(p, cur_block->block_size);
-    s.finalize(block_calced_digest);
+    rex::crypto::Sha1 s;
+    s.Update(p, cur_block->block_size);
+    s.Final(block_calced_digest);
     if (memcmp(block_calced_digest, cur_block->block_hash, 0x14) != 0) {
       result_code = 2;
       break;
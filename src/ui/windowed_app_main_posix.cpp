@@ -20,6 +20,7 @@
 #include <rex/cvar.h>
 #include <rex/logging.h>
 #include <rex/filesystem.h>
+#include <rex/profiling.h>
 #include <rex/ui/windowed_app.h>
 #include <rex/ui/windowed_app_context_gtk.h>
 #include <spdlog/common.h>
@@ -77,6 +78,7 @@ extern "C" int main(int argc_pre_gtk, char** argv_pre_gtk) {
                 log_path.string().c_str(), e.what());
     rex::InitLogging(nullptr);
     }
+    rex::debug::Profiler::Initialize();
 
     if (app->OnInitialize()) {
       app_context.RunMainGTKLoop();
@@ -88,6 +90,8 @@ extern "C" int main(int argc_pre_gtk, char** argv_pre_gtk) {
     app->InvokeOnDestroy();
   }
 
+  rex::debug::Profiler::Shutdown();
+
   // Logging may still be needed in the destructors.
   rex::ShutdownLogging();
 
@@ -18,6 +18,7 @@
 
 #include <rex/cvar.h>
 #include <rex/platform.h>
+#include <rex/profiling.h>
 #include <rex/ui/windowed_app.h>
 #include <rex/ui/windowed_app_context_win.h>
 #include <rex/logging.h>
@@ -83,6 +84,8 @@ int WINAPI wWinMain(HINSTANCE hinstance, HINSTANCE hinstance_prev,
     printf("Console attached for debugging\n");
   }
 
+  rex::debug::Profiler::Initialize();
+
   int result;
 
   {
@@ -120,6 +123,8 @@ int WINAPI wWinMain(HINSTANCE hinstance, HINSTANCE hinstance_prev,
     app->InvokeOnDestroy();
   }
 
+  rex::debug::Profiler::Shutdown();
+
   // TODO: Port ShutdownWin32App from Xenia
   // Logging may still be needed in the destructors.
   // rex::ShutdownWin32App();
@@ -0,0 +1,227 @@
+/**
+ * @file        tests/bench/codegen_bench.cpp
+ * @brief       Codegen pipeline benchmark over the PPC instruction test corpus
+ *
+ * @copyright   Copyright (c) 2026 Tom Clay <tomc@tctechstuff.com>
+ *              All rights reserved.
+ *
+ * @license     BSD 3-Clause License
+ *              See LICENSE file in the project root for full license text.
+ */
+
+// Stitches every linked tests/ppc binary into one synthetic image (repeated
+// --repeat times), gives it a PDATA table covering each test_ symbol, and
+// runs the real Analyze() + Recompiler pipeline over it. The result is the
+// same per-phase JSON that `rexglue codegen --profile` writes, so numbers
+// from the bench and from a retail XEX can be compared directly.
+
+#include <rex/codegen/analyze.h>
+#include <rex/codegen/codegen_context.h>
+#include <rex/codegen/recompiler.h>
+#include <rex/codegen/test_module.h>
+#include <rex/runtime/map_parser.h>
+#include <rex/byte_order.h>
+#include <rex/cvar.h>
+#include <rex/logging.h>
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <vector>
+
+REXCVAR_DEFINE_STRING(bin_dir, "", "Bench", "Directory containing linked tests/ppc .bin and .map files");
+REXCVAR_DEFINE_STRING(output, "", "Bench", "Path for the JSON report (default: stdout)");
+REXCVAR_DEFINE_STRING(out_dir, "", "Bench", "Directory for generated C++ (default: temp dir)");
+REXCVAR_DEFINE_UINT32(repeat, 16, "Bench", "Copies of the corpus in the synthetic image");
+REXCVAR_DEFINE_UINT32(codegen_threads, 0, "Bench", "Worker threads for emission (0 = auto, 1 = serial)");
+REXCVAR_DEFINE_UINT32(analysis_threads, 0, "Bench", "Worker threads for discovery (0 = auto, 1 = serial)");
+REXCVAR_DEFINE_BOOL(codegen_cache, false, "Bench", "Reuse emitted bodies from a previous bench run");
+REXCVAR_DEFINE_BOOL(flag_liveness, true, "Bench", "Skip CR and XER[CA] updates nothing reads");
+REXCVAR_DEFINE_BOOL(flush_mode_analysis, false, "Bench", "Track the FPU/VMX flush mode across labels and calls");
+REXCVAR_DEFINE_UINT32(devirtualize_max_targets, 2, "Bench", "Guard indirect calls with up to this many likely targets (0 = off)");
+REXCVAR_DEFINE_UINT32(inline_max_instructions, 0, "Bench", "Inline leaf functions up to this many instructions (0 = off)");
+REXCVAR_DEFINE_BOOL(profile_instrument, false, "Bench", "Emit execution profile counters");
+
+namespace fs = std::filesystem;
+namespace codegen = rex::codegen;
+
+namespace {
+
+/// Load address of the synthetic image (matches -Ttext in tests/ppc)
+constexpr uint32_t kImageBase = 0x82010000;
+
+/// Keep each stitched binary on a 16-byte boundary so branch offsets stay aligned
+constexpr size_t kBinaryAlignment = 16;
+
+struct SyntheticImage {
+    std::vector<uint8_t> data;
+    uint32_t pdataAddress = 0;
+    uint32_t pdataSize = 0;
+    size_t functionCount = 0;
+};
+
+struct CorpusBinary {
+    std::vector<uint8_t> data;
+    std::vector<uint32_t> functionOffsets;  ///< test_ symbol offsets, sorted
+};
+
+std::vector<CorpusBinary> LoadCorpus(const fs::path& binDir) {
+    std::vector<fs::path> bins;
+    for (const auto& entry : fs::directory_iterator(binDir)) {
+        if (entry.path().extension() == ".bin") {
+            bins.push_back(entry.path());
+        }
+    }
+    std::sort(bins.begin(), bins.end());
+
+    rex::runtime::MapParseOptions options;
+    options.prefix_filter = "test_";
+
+    std::vector<CorpusBinary> corpus;
+    for (const auto& binPath : bins) {
+        auto mapPath = fs::path(binPath).replace_extension(".map");
+        auto symbols = rex::runtime::ParseNmMap(mapPath, options);
+        if (!symbols || symbols->empty()) {
+            REXLOG_WARN("Skipping {}: no test_ symbols in {}", binPath.filename().string(),
+                        mapPath.string());
+            continue;
+        }
+
+        CorpusBinary binary;
+        std::ifstream file(binPath, std::ios::binary);
+        binary.data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        if (binary.data.empty()) {
+            continue;
+        }
+
+        for (const auto& sym : *symbols) {
+            if (sym.address < binary.data.size()) {
+                binary.functionOffsets.push_back(sym.address);
+            }
+        }
+        std::sort(binary.functionOffsets.begin(), binary.functionOffsets.end());
+        binary.functionOffsets.erase(
+            std::unique(binary.functionOffsets.begin(), binary.functionOffsets.end()),
+            binary.functionOffsets.end());
+        corpus.push_back(std::move(binary));
+    }
+    return corpus;
+}
+
+/// Append an IMAGE_CE_RUNTIME_FUNCTION (big-endian) for [begin, begin + size).
+void AppendPdataEntry(std::vector<uint8_t>& pdata, uint32_t begin, uint32_t size) {
+    uint32_t data = ((size / 4) << 8) | (1u << 30);  // FunctionLength, ThirtyTwoBit
+    for (uint32_t value : {begin, data}) {
+        uint32_t be = rex::byte_swap(value);
+        auto* bytes = reinterpret_cast<const uint8_t*>(&be);
+        pdata.insert(pdata.end(), bytes, bytes + sizeof(be));
+    }
+}
+
+SyntheticImage BuildImage(const std::vector<CorpusBinary>& corpus, uint32_t repeat) {
+    SyntheticImage image;
+    std::vector<uint8_t> pdata;
+
+    for (uint32_t copy = 0; copy < repeat; copy++) {
+        for (const auto& binary : corpus) {
+            image.data.resize((image.data.size() + kBinaryAlignment - 1) & ~(kBinaryAlignment - 1));
+            uint32_t base = kImageBase + static_cast<uint32_t>(image.data.size());
+            image.data.insert(image.data.end(), binary.data.begin(), binary.data.end());
+
+            const auto& offsets = binary.functionOffsets;
+            for (size_t i = 0; i < offsets.size(); i++) {
+                uint32_t end = i + 1 < offsets.size() ? offsets[i + 1]
+                                                      : static_cast<uint32_t>(binary.data.size());
+                AppendPdataEntry(pdata, base + offsets[i], (end - offsets[i]) & ~3u);
+                image.functionCount++;
+            }
+        }
+    }
+
+    image.data.resize((image.data.size() + kBinaryAlignment - 1) & ~(kBinaryAlignment - 1));
+    image.pdataAddress = kImageBase + static_cast<uint32_t>(image.data.size());
+    image.pdataSize = static_cast<uint32_t>(pdata.size());
+    image.data.insert(image.data.end(), pdata.begin(), pdata.end());
+    return image;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    rex::cvar::Init(argc, argv);
+    rex::cvar::ApplyEnvironment();
+
+    std::map<std::string, std::string> categoryLevels;
+    rex::InitLogging(rex::BuildLogConfig(nullptr, REXCVAR_GET(log_level), categoryLevels));
+
+    std::string binDir = REXCVAR_GET(bin_dir);
+    if (binDir.empty() || !fs::is_directory(binDir)) {
+        std::cerr << "Usage: codegen_bench --bin_dir=<build>/tests/ppc/bin [--repeat=N] [--output=report.json]\n";
+        return 1;
+    }
+
+    auto corpus = LoadCorpus(binDir);
+    if (corpus.empty()) {
+        REXLOG_ERROR("No usable .bin/.map pairs in {}", binDir);
+        return 1;
+    }
+
+    uint32_t repeat = std::max(1u, REXCVAR_GET(repeat));
+    auto image = BuildImage(corpus, repeat);
+    REXLOG_INFO("Synthetic image: {} binaries x {} copies, {} functions, {} bytes",
+                corpus.size(), repeat, image.functionCount, image.data.size());
+
+    codegen::TestModule module;
+    module.Load(kImageBase, image.data.data(), image.data.size());
+    module.SetExceptionDirectory(image.pdataAddress, image.pdataSize);
+    module.set_name("codegen_bench");
+
+    fs::path outDir = REXCVAR_GET(out_dir);
+    if (outDir.empty()) {
+        outDir = fs::temp_directory_path() / "rexglue_codegen_bench";
+    }
+    fs::create_directories(outDir);
+
+    codegen::RecompilerConfig config;
+    config.projectName = "bench";
+    config.outDirectoryPath = outDir.string();
+    config.codegenThreads = REXCVAR_GET(codegen_threads);
+    config.analysisThreads = REXCVAR_GET(analysis_threads);
+    config.codegenCache = REXCVAR_GET(codegen_cache);
+    config.flagLiveness = REXCVAR_GET(flag_liveness);
+    config.flushModeAnalysis = REXCVAR_GET(flush_mode_analysis);
+    config.devirtualizeMaxTargets = REXCVAR_GET(devirtualize_max_targets);
+    config.inlineMaxInstructions = REXCVAR_GET(inline_max_instructions);
+    config.profileInstrument = REXCVAR_GET(profile_instrument);
+
+    auto ctx = codegen::CodegenContext::Create(codegen::BinaryView::fromModule(module), std::move(config));
+
+    // Test binaries have no imports and call each other only through relative
+    // branches, so validation errors here would be a pipeline regression, but
+    // they shouldn't stop the timing run.
+    auto analyzed = codegen::Analyze(ctx);
+    if (!analyzed) {
+        REXLOG_WARN("Analyze reported: {}", analyzed.error().message);
+    }
+
+    codegen::Recompiler recompiler;
+    recompiler.ctx_ = &ctx;
+    if (!recompiler.recompile(true)) {
+        REXLOG_ERROR("Recompile failed");
+        return 1;
+    }
+
+    std::string json = ctx.profile.toJson();
+    std::string outputPath = REXCVAR_GET(output);
+    if (outputPath.empty()) {
+        std::cout << json;
+    } else {
+        std::ofstream out(outputPath, std::ios::binary | std::ios::trunc);
+        out << json;
+        REXLOG_INFO("Wrote codegen profile to {}", outputPath);
+    }
+    return 0;
+}
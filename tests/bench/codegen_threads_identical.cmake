@@ -0,0 +1,46 @@
+# Run codegen_bench serially and with several emit workers and fail unless
+# both runs write byte-identical C++.
+#
+# Usage: cmake -DBENCH=<codegen_bench> -DBIN_DIR=<tests/ppc/bin>
+#              -DWORK_DIR=<scratch dir> -P codegen_threads_identical.cmake
+
+file(REMOVE_RECURSE "${WORK_DIR}")
+
+foreach(_threads 1 4)
+    execute_process(
+        COMMAND "${BENCH}"
+                --bin_dir=${BIN_DIR}
+                --out_dir=${WORK_DIR}/threads_${_threads}
+                --output=${WORK_DIR}/threads_${_threads}.json
+                --repeat=2
+                --codegen_threads=${_threads}
+                --codegen_cache=false
+                --flush_mode_analysis=true
+                --inline_max_instructions=8
+        RESULT_VARIABLE _result)
+    if(NOT _result EQUAL 0)
+        message(FATAL_ERROR "codegen_bench with ${_threads} threads failed: ${_result}")
+    endif()
+endforeach()
+
+file(GLOB_RECURSE _serial RELATIVE "${WORK_DIR}/threads_1" "${WORK_DIR}/threads_1/*")
+file(GLOB_RECURSE _parallel RELATIVE "${WORK_DIR}/threads_4" "${WORK_DIR}/threads_4/*")
+list(SORT _serial)
+list(SORT _parallel)
+if(NOT _serial STREQUAL _parallel)
+    message(FATAL_ERROR "Serial and parallel runs wrote different files:\n"
+                        "  serial:   ${_serial}\n  parallel: ${_parallel}")
+endif()
+if(NOT _serial)
+    message(FATAL_ERROR "codegen_bench wrote no files to ${WORK_DIR}/threads_1")
+endif()
+
+foreach(_file IN LISTS _serial)
+    execute_process(
+        COMMAND ${CMAKE_COMMAND} -E compare_files
+                "${WORK_DIR}/threads_1/${_file}" "${WORK_DIR}/threads_4/${_file}"
+        RESULT_VARIABLE _result)
+    if(NOT _result EQUAL 0)
+        message(FATAL_ERROR "${_file} differs between 1 and 4 codegen threads")
+    endif()
+endforeach()
@@ -0,0 +1,105 @@
+/**
+ * @file        tests/bench/copy_and_swap_bench.cpp
+ * @brief       Throughput benchmark for the copy_and_swap kernels
+ *
+ * @copyright   Copyright (c) 2026 Tom Clay <tomc@tctechstuff.com>
+ *              All rights reserved.
+ *
+ * @license     BSD 3-Clause License
+ *              See LICENSE file in the project root for full license text.
+ */
+
+// Byte-swaps buffers from 256 bytes (a vertex fetch) up to 16 MiB (a texture
+// upload) with each kernel the host supports, and reports GB/s per kernel,
+// variant and size as one JSON object per line.
+
+#include <rex/cvar.h>
+#include <rex/logging.h>
+#include <rex/memory/utils.h>
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+REXCVAR_DEFINE_UINT32(bytes_per_run, 256u << 20, "Bench",
+                      "Bytes swapped per kernel, variant and size");
+
+namespace {
+
+using rex::memory::SwapKernel;
+
+struct Variant {
+  const char* name;
+  void (*fn)(void*, const void*, size_t);
+  size_t element_size;
+};
+
+const Variant kVariants[] = {
+    {"16", rex::memory::copy_and_swap_16_unaligned, 2},
+    {"32", rex::memory::copy_and_swap_32_unaligned, 4},
+    {"64", rex::memory::copy_and_swap_64_unaligned, 8},
+    {"16_in_32", rex::memory::copy_and_swap_16_in_32_unaligned, 4},
+};
+
+const char* KernelName(SwapKernel kernel) {
+  switch (kernel) {
+    case SwapKernel::kScalar:
+      return "scalar";
+    case SwapKernel::kSSSE3:
+      return "ssse3";
+    case SwapKernel::kAVX2:
+      return "avx2";
+    case SwapKernel::kAVX512:
+      return "avx512";
+    case SwapKernel::kNEON:
+      return "neon";
+  }
+  return "unknown";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  rex::cvar::Init(argc, argv);
+  rex::InitLogging();
+
+  constexpr size_t kSizes[] = {256, 4 << 10, 64 << 10, 1 << 20, 16 << 20};
+  std::vector<uint8_t> src(kSizes[std::size(kSizes) - 1]);
+  std::vector<uint8_t> dest(src.size());
+  for (size_t i = 0; i < src.size(); ++i) {
+    src[i] = uint8_t(i);
+  }
+
+  SwapKernel original = rex::memory::GetSwapKernel();
+  for (auto kernel : {SwapKernel::kScalar, SwapKernel::kSSSE3,
+                      SwapKernel::kAVX2, SwapKernel::kAVX512,
+                      SwapKernel::kNEON}) {
+    if (!rex::memory::SetSwapKernel(kernel)) {
+      continue;
+    }
+    for (const auto& variant : kVariants) {
+      for (size_t size : kSizes) {
+        size_t count = size / variant.element_size;
+        size_t iterations =
+            std::max<size_t>(1, REXCVAR_GET(bytes_per_run) / size);
+        variant.fn(dest.data(), src.data(), count);  // warm up
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; ++i) {
+          variant.fn(dest.data(), src.data(), count);
+        }
+        auto end = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(end - start).count();
+        std::cout << fmt::format(
+            "{{\"kernel\": \"{}\", \"variant\": \"{}\", \"bytes\": {}, "
+            "\"gb_per_s\": {:.2f}}}\n",
+            KernelName(kernel), variant.name, size,
+            seconds > 0.0 ? double(size) * iterations / seconds / 1e9 : 0.0);
+      }
+    }
+  }
+  rex::memory::SetSwapKernel(original);
+  return 0;
+}
@@ -0,0 +1,121 @@
+/**
+ * @file        tests/bench/crypto_bench.cpp
+ * @brief       Throughput benchmark for rex::crypto
+ *
+ * @copyright   Copyright (c) 2026 Tom Clay <tomc@tctechstuff.com>
+ *              All rights reserved.
+ *
+ * @license     BSD 3-Clause License
+ *              See LICENSE file in the project root for full license text.
+ */
+
+// Runs CRC32, SHA-1, SHA-256 and AES-128-CBC decryption over one buffer with
+// the crypto_hardware cvar on and off, plus the byte-at-a-time CRC table loop
+// RtlComputeCrc32 used before, and prints MB/s for each as one JSON object.
+
+#include <rex/crypto.h>
+#include <rex/cvar.h>
+#include <rex/logging.h>
+#include <fmt/format.h>
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+REXCVAR_DECLARE(bool, crypto_hardware);
+REXCVAR_DEFINE_UINT32(buffer_kb, 1024, "Bench", "Buffer size in KiB");
+REXCVAR_DEFINE_UINT32(iterations, 64, "Bench", "Passes over the buffer per measurement");
+
+namespace {
+
+uint32_t Crc32Bytewise(uint32_t crc, const uint8_t* data, size_t length) {
+  static const auto table = [] {
+    std::vector<uint32_t> t(256);
+    for (uint32_t i = 0; i < 256; ++i) {
+      uint32_t c = i;
+      for (int bit = 0; bit < 8; ++bit) {
+        c = (c >> 1) ^ (0xEDB88320u & (0u - (c & 1)));
+      }
+      t[i] = c;
+    }
+    return t;
+  }();
+  crc = ~crc;
+  for (size_t i = 0; i < length; ++i) {
+    crc = table[(data[i] ^ crc) & 0xFF] ^ (crc >> 8);
+  }
+  return ~crc;
+}
+
+template <typename Fn>
+double MeasureMBps(size_t bytes, uint32_t iterations, Fn&& fn) {
+  fn();  // warm up
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < iterations; ++i) {
+    fn();
+  }
+  auto end = std::chrono::steady_clock::now();
+  double seconds = std::chrono::duration<double>(end - start).count();
+  return seconds > 0.0 ? double(bytes) * iterations / seconds / 1e6 : 0.0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  rex::cvar::Init(argc, argv);
+  rex::InitLogging();
+
+  size_t size = size_t(REXCVAR_GET(buffer_kb)) * 1024;
+  uint32_t iterations = REXCVAR_GET(iterations);
+  std::vector<uint8_t> data(size);
+  for (size_t i = 0; i < size; ++i) {
+    data[i] = uint8_t(i * 31 + 7);
+  }
+  std::vector<uint8_t> out(size);
+  const uint8_t key[16] = {0x20, 0xB1, 0x85, 0xA5, 0x9D, 0x28, 0xFD, 0xC3,
+                           0x40, 0x58, 0x3F, 0xBB, 0x08, 0x96, 0xBF, 0x91};
+  rex::crypto::Aes128 aes(key);
+
+  volatile uint32_t sink = 0;
+  std::string json = fmt::format("{{\"bytes\": {}", size);
+  json += fmt::format(", \"crc32_bytewise\": {:.0f}", MeasureMBps(size, iterations, [&] {
+    sink = Crc32Bytewise(0, data.data(), size);
+  }));
+  for (bool hardware : {false, true}) {
+    REXCVAR_SET(crypto_hardware, hardware);
+    const char* suffix = hardware ? "hardware" : "portable";
+    json += fmt::format(", \"crc32_{}\": {:.0f}", suffix,
+                        MeasureMBps(size, iterations, [&] {
+                          sink = rex::crypto::Crc32(0, data.data(), size);
+                        }));
+    json += fmt::format(", \"sha1_{}\": {:.0f}", suffix,
+                        MeasureMBps(size, iterations, [&] {
+                          rex::crypto::Sha1 sha;
+                          sha.Update(data.data(), size);
+                          uint8_t digest[20];
+                          sha.Final(digest);
+                          sink = digest[0];
+                        }));
+    json += fmt::format(", \"sha256_{}\": {:.0f}", suffix,
+                        MeasureMBps(size, iterations, [&] {
+                          rex::crypto::Sha256 sha;
+                          sha.Update(data.data(), size);
+                          uint8_t digest[32];
+                          sha.Final(digest);
+                          sink = digest[0];
+                        }));
+    json += fmt::format(", \"aes_cbc_decrypt_{}\": {:.0f}", suffix,
+                        MeasureMBps(size, iterations, [&] {
+                          uint8_t iv[16] = {};
+                          aes.DecryptCbc(iv, data.data(), out.data(), size & ~size_t(15));
+                        }));
+  }
+  REXCVAR_SET(crypto_hardware, true);
+  json += fmt::format(", \"hardware\": {{\"crc32\": {}, \"sha1\": {}, \"sha256\": {}, \"aes\": {}}}}}",
+                      rex::crypto::HasHardwareCrc32(), rex::crypto::HasHardwareSha1(),
+                      rex::crypto::HasHardwareSha256(), rex::crypto::HasHardwareAes());
+  std::cout << json << "\n";
+  return 0;
+}
@@ -0,0 +1,172 @@
+/**
+ * @file        tests/bench/heap_fragmentation_bench.cpp
+ * @brief       Fragmentation stress benchmark for BaseHeap allocation
+ *
+ * @copyright   Copyright (c) 2026 Tom Clay <tomc@tctechstuff.com>
+ *              All rights reserved.
+ *
+ * @license     BSD 3-Clause License
+ *              See LICENSE file in the project root for full license text.
+ */
+
+// Fills the 4 KB virtual heap with randomly sized allocations, frees a random
+// subset to leave holes, then runs a steady-state mix of allocate/release the
+// way level streaming does. Every search the heap performs is replayed against
+// a linear page scan (the pre-index algorithm) over a mirror of the page
+// states, so the JSON reports both costs for the same fragmentation pattern.
+
+#include <rex/cvar.h>
+#include <rex/logging.h>
+#include <rex/kernel/xmemory.h>
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+REXCVAR_DEFINE_UINT32(fill, 20000, "Bench", "Allocations made before the stress phase");
+REXCVAR_DEFINE_UINT32(ops, 20000, "Bench", "Allocate/release operations in the stress phase");
+REXCVAR_DEFINE_UINT32(max_pages, 16, "Bench", "Largest allocation in pages");
+
+namespace {
+
+constexpr uint32_t kHeapAddress = 0x10000000;  // v00000000, 4 KB pages
+constexpr uint32_t kPageSize = 4096;
+
+struct Allocation {
+  uint32_t address;
+  uint32_t pages;
+};
+
+/// Bottom-up linear scan over page states, as BaseHeap::AllocRange did it.
+uint32_t LinearFind(const std::vector<uint8_t>& used, uint32_t page_count) {
+  uint32_t page_total = uint32_t(used.size());
+  for (uint32_t base = 0; base + page_count <= page_total; ++base) {
+    if (used[base]) {
+      continue;
+    }
+    uint32_t page = base;
+    while (page < base + page_count && !used[page]) {
+      ++page;
+    }
+    if (page == base + page_count) {
+      return base;
+    }
+    base = page;
+  }
+  return UINT32_MAX;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  rex::cvar::Init(argc, argv);
+  rex::InitLogging();
+
+  rex::memory::Memory memory;
+  if (!memory.Initialize()) {
+    std::cerr << "Failed to initialize guest memory\n";
+    return 1;
+  }
+  auto* heap = memory.LookupHeap(kHeapAddress);
+  uint32_t heap_base = heap->heap_base();
+  std::vector<uint8_t> used(heap->heap_size() / kPageSize);
+
+  // Mirror whatever Memory::Initialize already reserved (e.g. the zero page).
+  for (uint32_t page = 0; page < used.size();) {
+    rex::memory::HeapAllocationInfo info;
+    heap->QueryRegionInfo(heap_base + page * kPageSize, &info);
+    uint32_t region_pages = std::max(1u, info.region_size / kPageSize);
+    if (info.state) {
+      std::fill_n(used.begin() + page,
+                  std::min<size_t>(region_pages, used.size() - page), uint8_t(1));
+    }
+    page += region_pages;
+  }
+
+  uint32_t max_pages = std::max(1u, REXCVAR_GET(max_pages));
+  std::mt19937 rng(42);
+  std::vector<Allocation> live;
+
+  double index_ns = 0.0;
+  double linear_ns = 0.0;
+  uint64_t searches = 0;
+
+  auto allocate = [&]() {
+    uint32_t pages = 1 + rng() % max_pages;
+    uint32_t address = 0;
+    auto start = std::chrono::steady_clock::now();
+    bool ok = heap->Alloc(pages * kPageSize, kPageSize,
+                          rex::memory::kMemoryAllocationReserve,
+                          rex::memory::kMemoryProtectRead |
+                              rex::memory::kMemoryProtectWrite,
+                          false, &address);
+    auto mid = std::chrono::steady_clock::now();
+    uint32_t linear_page = LinearFind(used, pages);
+    auto end = std::chrono::steady_clock::now();
+    index_ns += std::chrono::duration<double, std::nano>(mid - start).count();
+    linear_ns += std::chrono::duration<double, std::nano>(end - mid).count();
+    ++searches;
+    if (!ok) {
+      return false;
+    }
+
+    uint32_t page = (address - heap_base) / kPageSize;
+    if (page != linear_page) {
+      std::cerr << fmt::format("Address mismatch: heap {:08X}, linear {:08X}\n",
+                               address, heap_base + linear_page * kPageSize);
+      std::exit(1);
+    }
+    std::fill_n(used.begin() + page, pages, uint8_t(1));
+    live.push_back({address, pages});
+    return true;
+  };
+
+  auto release = [&]() {
+    if (live.empty()) {
+      return;
+    }
+    size_t victim = rng() % live.size();
+    Allocation allocation = live[victim];
+    live[victim] = live.back();
+    live.pop_back();
+    heap->Release(allocation.address);
+    uint32_t page = (allocation.address - heap_base) / kPageSize;
+    std::fill_n(used.begin() + page, allocation.pages, uint8_t(0));
+  };
+
+  for (uint32_t i = 0; i < REXCVAR_GET(fill) && allocate(); ++i) {
+  }
+  // Punch holes: drop roughly half of what was just allocated.
+  for (size_t i = live.size() / 2; i > 0; --i) {
+    release();
+  }
+
+  index_ns = linear_ns = 0.0;
+  searches = 0;
+  for (uint32_t i = 0; i < REXCVAR_GET(ops); ++i) {
+    if (rng() % 2) {
+      allocate();
+    } else {
+      release();
+    }
+  }
+
+  uint32_t free_pages = uint32_t(std::count(used.begin(), used.end(), 0));
+  std::cout << fmt::format(
+      "{{\"live_allocations\": {}, \"free_pages\": {}, \"searches\": {}, "
+      "\"index_ns_per_alloc\": {:.1f}, \"linear_ns_per_search\": {:.1f}, "
+      "\"speedup\": {:.2f}}}\n",
+      live.size(), free_pages, searches,
+      searches ? index_ns / searches : 0.0,
+      searches ? linear_ns / searches : 0.0,
+      index_ns > 0.0 ? linear_ns / index_ns : 0.0);
+
+  for (const auto& allocation : live) {
+    heap->Release(allocation.address);
+  }
+  return 0;
+}
@@ -0,0 +1,121 @@
+/**
+ * @file        tests/bench/logging_bench.cpp
+ * @brief       Throughput benchmark for the logging macros
+ *
+ * @copyright   Copyright (c) 2026 Tom Clay <tomc@tctechstuff.com>
+ *              All rights reserved.
+ *
+ * @license     BSD 3-Clause License
+ *              See LICENSE file in the project root for full license text.
+ */
+
+// Several threads log the kind of statement REXKRNL_IMPORT_TRACE produces
+// (a few integers and a string) to a file sink. Each mode reports messages
+// per second seen by the logging threads:
+//   legacy   - GetLogger() shared_ptr copy, then spdlog's synchronous path
+//   sync     - REXKRNL_* macros with log_async off
+//   async    - REXKRNL_* macros with log_async on (includes the final flush)
+//   disabled - REXKRNL_TRACE with the category at info
+
+#include <rex/cvar.h>
+#include <rex/logging.h>
+#include <fmt/format.h>
+
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+REXCVAR_DEFINE_UINT32(threads, 4, "Bench", "Logging threads");
+REXCVAR_DEFINE_UINT32(messages, 200000, "Bench", "Messages per thread");
+
+namespace {
+
+template <typename Fn>
+double MessagesPerSecond(Fn&& log_one, bool flush) {
+  uint32_t thread_count = REXCVAR_GET(threads);
+  uint32_t messages = REXCVAR_GET(messages);
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (uint32_t t = 0; t < thread_count; ++t) {
+    threads.emplace_back([&, t] {
+      for (uint32_t i = 0; i < messages; ++i) {
+        log_one(t, i);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  if (flush) {
+    rex::FlushLogging();
+  }
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  return double(thread_count) * messages / seconds;
+}
+
+void Reinit(const std::string& path, bool async, spdlog::level::level_enum level) {
+  rex::ShutdownLogging();
+  std::filesystem::remove(path);
+  REXCVAR_SET(log_async, async);
+  rex::LogConfig config;
+  config.log_file = path.c_str();
+  config.log_to_console = false;
+  config.default_level = level;
+  rex::InitLogging(config);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  rex::cvar::Init(argc, argv);
+  std::string path =
+      (std::filesystem::temp_directory_path() / "rex_logging_bench.log").string();
+  const std::string name = "XamContentCreateEnumerator";
+
+  Reinit(path, false, spdlog::level::trace);
+  double legacy = MessagesPerSecond(
+      [&](uint32_t t, uint32_t i) {
+        if (auto logger = rex::GetLogger(rex::LogCategory::Kernel)) {
+          logger->log(spdlog::source_loc{__FILE__, __LINE__, __FUNCTION__},
+                      spdlog::level::trace, "[T:{:08X}] {}({:08X}, {})", t, name, i,
+                      i * 3);
+        }
+      },
+      true);
+
+  Reinit(path, false, spdlog::level::trace);
+  double sync = MessagesPerSecond(
+      [&](uint32_t t, uint32_t i) {
+        REXKRNL_TRACE("[T:{:08X}] {}({:08X}, {})", t, name, i, i * 3);
+      },
+      true);
+
+  Reinit(path, true, spdlog::level::trace);
+  double async = MessagesPerSecond(
+      [&](uint32_t t, uint32_t i) {
+        REXKRNL_TRACE("[T:{:08X}] {}({:08X}, {})", t, name, i, i * 3);
+      },
+      true);
+
+  Reinit(path, false, spdlog::level::info);
+  double disabled = MessagesPerSecond(
+      [&](uint32_t t, uint32_t i) {
+        REXKRNL_TRACE("[T:{:08X}] {}({:08X}, {})", t, name, i, i * 3);
+      },
+      false);
+
+  rex::ShutdownLogging();
+  std::filesystem::remove(path);
+
+  std::cout << fmt::format(
+      "{{\"threads\": {}, \"messages_per_thread\": {}, "
+      "\"legacy_msgs_per_sec\": {:.0f}, \"sync_msgs_per_sec\": {:.0f}, "
+      "\"async_msgs_per_sec\": {:.0f}, \"disabled_msgs_per_sec\": {:.0f}}}\n",
+      REXCVAR_GET(threads), REXCVAR_GET(messages), legacy, sync, async, disabled);
+  return 0;
+}
@@ -0,0 +1,245 @@
+/**
+ * @file        tests/bench/shader_interpreter_bench.cpp
+ * @brief       Vertex throughput benchmark for the CPU shader interpreter
+ *
+ * @copyright   Copyright (c) 2026 Tom Clay <tomc@tctechstuff.com>
+ *              All rights reserved.
+ *
+ * @license     BSD 3-Clause License
+ *              See LICENSE file in the project root for full license text.
+ */
+
+// Runs a vertex shader over a vertex buffer one vertex at a time with
+// ShaderInterpreter::Execute and in 4, 8 and 16 lane batches with
+// ExecuteBatch, and prints vertices per second for each as one JSON object.
+// The default shader is a typical transform: position through a 4x4 matrix,
+// normal through a 3x3 one, texture coordinates passed through. A captured
+// shader can be measured instead by pointing --ucode at a
+// shader_*.ucode.bin.vert file written with --dump_shaders; every vertex
+// fetch constant then points at the same buffer of small values.
+
+#include <rex/cvar.h>
+#include <rex/graphics/pipeline/shader/interpreter.h>
+#include <rex/graphics/register_file.h>
+#include <rex/kernel/xmemory.h>
+#include <rex/logging.h>
+#include <rex/string/buffer.h>
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+REXCVAR_DEFINE_STRING(ucode, "", "Bench", "Dumped vertex shader ucode to run instead of the built-in one");
+REXCVAR_DEFINE_UINT32(vertex_count, 65536, "Bench", "Vertices per pass");
+REXCVAR_DEFINE_UINT32(iterations, 8, "Bench", "Passes per measurement");
+
+namespace {
+
+namespace gpu = rex::graphics;
+namespace ucode = rex::graphics::ucode;
+namespace xenos = rex::graphics::xenos;
+
+constexpr uint32_t kVertexStride = 8;
+
+class NullBatchExportSink : public gpu::ShaderInterpreter::BatchExportSink {
+ public:
+  void Export(ucode::ExportRegister export_register,
+              const float (*value)[gpu::ShaderInterpreter::kMaxBatchLanes],
+              uint32_t value_mask, uint32_t lane_mask) override {
+    sum = sum + value[0][0];
+  }
+  volatile float sum = 0.0f;
+};
+
+class NullExportSink : public gpu::ShaderInterpreter::ExportSink {
+ public:
+  void Export(ucode::ExportRegister export_register, const float* value,
+              uint32_t value_mask) override {
+    sum = sum + value[0];
+  }
+  volatile float sum = 0.0f;
+};
+
+void AppendExec(std::vector<uint32_t>& ucode, uint32_t address,
+                uint32_t count, uint32_t fetch_count) {
+  // An exec_end paired with a nop; the first fetch_count are fetches.
+  uint32_t sequence = 0;
+  for (uint32_t i = 0; i < fetch_count; ++i) {
+    sequence |= 1u << (i * 2);
+  }
+  ucode.push_back(address | count << 12 | sequence << 16);
+  ucode.push_back(uint32_t(ucode::ControlFlowOpcode::kExecEnd) << 12);
+  ucode.push_back(0);
+}
+
+void AppendVertexFetch(std::vector<uint32_t>& ucode, uint32_t dest,
+                       xenos::VertexFormat format, int32_t offset,
+                       bool is_mini) {
+  // xyz1 for 3 components, xy01 for 2.
+  uint32_t swizzle = format == xenos::VertexFormat::k_32_32_FLOAT
+                         ? (0 | 1 << 3 | 4 << 6 | 5 << 9)
+                         : (0 | 1 << 3 | 2 << 6 | 5 << 9);
+  ucode.push_back(dest << 12 | 1u << 19);
+  ucode.push_back(swizzle | uint32_t(format) << 16 | uint32_t(is_mini) << 30);
+  ucode.push_back(kVertexStride | (uint32_t(offset) & 0x7FFFFF) << 8);
+}
+
+// Vector-only ALU instruction of a temporary and a constant operand, writing
+// to a temporary or, with is_export, to an export register.
+void AppendAlu(std::vector<uint32_t>& ucode, ucode::AluVectorOpcode opcode,
+               uint32_t dest, uint32_t write_mask, uint32_t src_temp,
+               uint32_t src_constant, bool is_export = false) {
+  ucode.push_back(dest | uint32_t(is_export) << 15 | write_mask << 16 |
+                  uint32_t(ucode::AluScalarOpcode::kRetainPrev) << 26);
+  ucode.push_back(0);
+  ucode.push_back(src_constant << 8 | src_temp << 16 | uint32_t(opcode) << 24 |
+                  1u << 31);
+}
+
+std::vector<uint32_t> BuildTransformShader() {
+  std::vector<uint32_t> ucode;
+  AppendExec(ucode, 1, 14, 3);
+  // r1 = position, r2 = normal, r3 = texture coordinates.
+  AppendVertexFetch(ucode, 1, xenos::VertexFormat::k_32_32_32_FLOAT, 0, false);
+  AppendVertexFetch(ucode, 2, xenos::VertexFormat::k_32_32_32_FLOAT, 3, true);
+  AppendVertexFetch(ucode, 3, xenos::VertexFormat::k_32_32_FLOAT, 6, true);
+  // r4 = c0-c3 * r1.
+  for (uint32_t i = 0; i < 4; ++i) {
+    AppendAlu(ucode, ucode::AluVectorOpcode::kDp4, 4, 1u << i, 1, i);
+  }
+  // r5.xyz = c4-c6 * r2.
+  for (uint32_t i = 0; i < 3; ++i) {
+    AppendAlu(ucode, ucode::AluVectorOpcode::kDp3, 5, 1u << i, 2, 4 + i);
+  }
+  // oPos = r4 * c7, o0 = r5 * c7, o1 = r3 + c8, o2 = r1 * c8.
+  AppendAlu(ucode, ucode::AluVectorOpcode::kMul,
+            uint32_t(ucode::ExportRegister::kVSPosition), 0b1111, 4, 7, true);
+  AppendAlu(ucode, ucode::AluVectorOpcode::kMul, 0, 0b0111, 5, 7, true);
+  AppendAlu(ucode, ucode::AluVectorOpcode::kAdd, 1, 0b0011, 3, 8, true);
+  AppendAlu(ucode, ucode::AluVectorOpcode::kMul, 2, 0b1111, 1, 8, true);
+  return ucode;
+}
+
+std::vector<uint32_t> LoadUcode(const std::string& path) {
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  if (!file) {
+    return {};
+  }
+  std::vector<uint32_t> ucode(size_t(file.tellg()) / sizeof(uint32_t));
+  file.seekg(0);
+  file.read(reinterpret_cast<char*>(ucode.data()),
+            ucode.size() * sizeof(uint32_t));
+  return ucode;
+}
+
+template <typename Fn>
+double MeasureVerticesPerSecond(uint32_t vertices, uint32_t iterations,
+                                Fn&& fn) {
+  fn();  // warm up
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < iterations; ++i) {
+    fn();
+  }
+  auto end = std::chrono::steady_clock::now();
+  double seconds = std::chrono::duration<double>(end - start).count();
+  return seconds > 0.0 ? double(vertices) * iterations / seconds : 0.0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  rex::cvar::Init(argc, argv);
+  rex::InitLogging();
+
+  std::string ucode_path = REXCVAR_GET(ucode);
+  std::vector<uint32_t> ucode =
+      ucode_path.empty() ? BuildTransformShader() : LoadUcode(ucode_path);
+  if (ucode.empty()) {
+    std::cerr << "Failed to load " << ucode_path << "\n";
+    return 1;
+  }
+  gpu::Shader shader(xenos::ShaderType::kVertex, ucode.size(), ucode.data(),
+                     ucode.size(), std::endian::native);
+  rex::string::StringBuffer disasm;
+  shader.AnalyzeUcode(disasm);
+  if (!gpu::ShaderInterpreter::CanInterpretShader(shader)) {
+    std::cerr << "The shader uses texture fetches\n";
+    return 1;
+  }
+
+  rex::memory::Memory memory;
+  if (!memory.Initialize()) {
+    std::cerr << "Failed to initialize guest memory\n";
+    return 1;
+  }
+  uint32_t vertex_count = REXCVAR_GET(vertex_count);
+  uint32_t iterations = REXCVAR_GET(iterations);
+  uint32_t buffer_dwords = vertex_count * kVertexStride;
+  uint32_t buffer = memory.GetPhysicalAddress(memory.SystemHeapAlloc(
+      buffer_dwords * 4, 4096, rex::memory::kSystemHeapPhysical));
+  auto vertices = memory.TranslatePhysical<float*>(buffer);
+  for (uint32_t i = 0; i < buffer_dwords; ++i) {
+    vertices[i] = float(int32_t(i * 37 % 17) - 8) * 0.125f;
+  }
+
+  auto registers = std::make_unique<gpu::RegisterFile>();
+  auto& values = registers->values;
+  xenos::xe_gpu_vertex_fetch_t fetch = {};
+  fetch.type = xenos::FetchConstantType::kVertex;
+  fetch.address = buffer >> 2;
+  fetch.size = buffer_dwords;
+  for (uint32_t i = 0; i < 96; ++i) {
+    values[gpu::XE_GPU_REG_SHADER_CONSTANT_FETCH_00_0 + i * 2] = fetch.dword_0;
+    values[gpu::XE_GPU_REG_SHADER_CONSTANT_FETCH_00_0 + i * 2 + 1] =
+        fetch.dword_1;
+  }
+  gpu::reg::SQ_VS_CONST vs_const = {};
+  vs_const.size = 255;
+  values[gpu::XE_GPU_REG_SQ_VS_CONST] = vs_const.value;
+  for (uint32_t i = 0; i < 256 * 4; ++i) {
+    values[gpu::XE_GPU_REG_SHADER_CONSTANT_000_X + i] =
+        std::bit_cast<uint32_t>(float(int32_t(i % 7) - 3) * 0.25f);
+  }
+
+  gpu::ShaderInterpreter interpreter(*registers, memory);
+  interpreter.SetShader(shader);
+  NullExportSink export_sink;
+  NullBatchExportSink batch_export_sink;
+  interpreter.SetExportSink(&export_sink);
+  interpreter.SetBatchExportSink(&batch_export_sink);
+
+  std::string json = fmt::format(
+      "{{\"ucode_dwords\": {}, \"vertices\": {}", ucode.size(), vertex_count);
+  json += fmt::format(
+      ", \"execute\": {:.0f}",
+      MeasureVerticesPerSecond(vertex_count, iterations, [&] {
+        for (uint32_t i = 0; i < vertex_count; ++i) {
+          interpreter.temp_registers()[0] = float(i);
+          interpreter.Execute();
+        }
+      }));
+  for (uint32_t lanes : {4u, 8u, 16u}) {
+    json += fmt::format(
+        ", \"execute_batch_{}\": {:.0f}", lanes,
+        MeasureVerticesPerSecond(vertex_count, iterations, [&] {
+          float* indices = interpreter.batch_temp_register(0, 0);
+          for (uint32_t i = 0; i < vertex_count; i += lanes) {
+            uint32_t lane_count = std::min(lanes, vertex_count - i);
+            for (uint32_t lane = 0; lane < lane_count; ++lane) {
+              indices[lane] = float(i + lane);
+            }
+            interpreter.ExecuteBatch(lane_count);
+          }
+        }));
+  }
+  json += "}";
+  std::cout << json << "\n";
+  return 0;
+}
@@ -0,0 +1,107 @@
+/**
+ * @file        tests/bench/sleep_jitter_bench.cpp
+ * @brief       Wake-up latency benchmark for rex::thread sleeps and timers
+ *
+ * @copyright   Copyright (c) 2026 Tom Clay <tomc@tctechstuff.com>
+ *              All rights reserved.
+ *
+ * @license     BSD 3-Clause License
+ *              See LICENSE file in the project root for full license text.
+ */
+
+// Games pace frames and audio with KeDelayExecutionThread and kernel timers at
+// intervals well under a millisecond. For each requested interval this sleeps
+// repeatedly and records how late the thread actually woke, for the plain OS
+// sleep, rex::thread::Sleep, rex::thread::PreciseSleepUntil (what Delay uses)
+// and a rex::thread::Timer waited on with Wait(). The JSON reports median, p99
+// and worst lateness.
+
+#include <rex/cvar.h>
+#include <rex/thread.h>
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+REXCVAR_DEFINE_UINT32(samples, 500, "Bench", "Sleeps measured per interval");
+
+namespace {
+
+using std::chrono::steady_clock;
+
+struct Stats {
+  double median_us;
+  double p99_us;
+  double max_us;
+};
+
+Stats Summarize(std::vector<double>& late_us) {
+  std::sort(late_us.begin(), late_us.end());
+  auto at = [&](double q) {
+    return late_us[std::min(late_us.size() - 1, size_t(q * late_us.size()))];
+  };
+  return {at(0.5), at(0.99), late_us.back()};
+}
+
+template <typename SleepFn>
+Stats Measure(std::chrono::microseconds interval, SleepFn&& sleep) {
+  std::vector<double> late_us;
+  late_us.reserve(REXCVAR_GET(samples));
+  for (uint32_t i = 0; i < REXCVAR_GET(samples); ++i) {
+    auto start = steady_clock::now();
+    sleep(interval);
+    auto late = steady_clock::now() - (start + interval);
+    late_us.push_back(std::chrono::duration<double, std::micro>(late).count());
+  }
+  return Summarize(late_us);
+}
+
+std::string ToJson(const Stats& stats) {
+  return fmt::format(
+      "{{\"median_late_us\": {:.1f}, \"p99_late_us\": {:.1f}, "
+      "\"max_late_us\": {:.1f}}}",
+      stats.median_us, stats.p99_us, stats.max_us);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  rex::cvar::Init(argc, argv);
+
+  auto timer = rex::thread::Timer::CreateSynchronizationTimer();
+  const std::chrono::microseconds intervals[] = {
+      std::chrono::microseconds(100), std::chrono::microseconds(500),
+      std::chrono::microseconds(1000), std::chrono::microseconds(2000),
+      std::chrono::microseconds(16667)};
+
+  std::cout << "[\n";
+  for (size_t i = 0; i < std::size(intervals); ++i) {
+    auto interval = intervals[i];
+    Stats os = Measure(interval, [](auto duration) {
+      std::this_thread::sleep_for(duration);
+    });
+    Stats rex_sleep = Measure(interval, [](auto duration) {
+      rex::thread::Sleep(duration);
+    });
+    Stats rex_precise = Measure(interval, [](auto duration) {
+      rex::thread::PreciseSleepUntil(steady_clock::now() + duration);
+    });
+    Stats rex_timer = Measure(interval, [&](auto duration) {
+      timer->SetOnceAfter(duration);
+      rex::thread::Wait(timer.get(), false);
+    });
+    std::cout << fmt::format(
+        "  {{\"interval_us\": {}, \"os_sleep\": {}, \"rex_sleep\": {}, "
+        "\"rex_precise_sleep\": {}, \"rex_timer\": {}}}{}\n",
+        interval.count(), ToJson(os), ToJson(rex_sleep), ToJson(rex_precise),
+        ToJson(rex_timer),
+        i + 1 < std::size(intervals) ? "," : "");
+  }
+  std::cout << "]\n";
+  return 0;
+}
@@ -0,0 +1,122 @@
+/**
+ * @file        tests/bench/wait_contention_bench.cpp
+ * @brief       Wake-up contention benchmark for rex::thread wait handles
+ *
+ * @copyright   Copyright (c) 2026 Tom Clay <tomc@tctechstuff.com>
+ *              All rights reserved.
+ *
+ * @license     BSD 3-Clause License
+ *              See LICENSE file in the project root for full license text.
+ */
+
+// A token is passed around a ring of threads, each blocked on its own
+// auto-reset event, so at any moment one thread runs and the rest wait. This
+// is the guest pattern where a global condition variable hurts most: every
+// Set() used to wake the whole ring. The legacy column reproduces that design
+// (one process-wide mutex + condition_variable, notify_all on every signal)
+// next to the real rex::thread::Event so the two can be compared on the same
+// machine.
+
+#include <rex/cvar.h>
+#include <rex/thread.h>
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+REXCVAR_DEFINE_UINT32(threads, 48, "Bench", "Threads in the token ring");
+REXCVAR_DEFINE_UINT32(laps, 2000, "Bench", "Times the token goes around the ring");
+
+namespace {
+
+/// The pre-keyed implementation: all events share one mutex and condition.
+class LegacyEvent {
+ public:
+  void Set() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    signaled_ = true;
+    cond_.notify_all();
+  }
+
+  void Wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cond_.wait(lock, [this] { return signaled_; });
+    signaled_ = false;
+  }
+
+ private:
+  static inline std::mutex mutex_;
+  static inline std::condition_variable cond_;
+  bool signaled_ = false;
+};
+
+class RexEvent {
+ public:
+  void Set() { event_->Set(); }
+  void Wait() { rex::thread::Wait(event_.get(), false); }
+
+ private:
+  std::unique_ptr<rex::thread::Event> event_ =
+      rex::thread::Event::CreateAutoResetEvent(false);
+};
+
+/// Returns nanoseconds per token hand-off.
+template <typename EventT>
+double RunRing(uint32_t thread_count, uint32_t laps) {
+  std::vector<EventT> events(thread_count);
+  std::atomic<bool> stop{false};
+
+  std::vector<std::thread> ring;
+  ring.reserve(thread_count);
+  for (uint32_t i = 0; i < thread_count; ++i) {
+    ring.emplace_back([&, i] {
+      auto& next = events[(i + 1) % thread_count];
+      uint32_t lap = 0;
+      for (;;) {
+        events[i].Wait();
+        if (i == 0 && ++lap >= laps) {
+          stop.store(true, std::memory_order_relaxed);
+        }
+        bool stopping = stop.load(std::memory_order_relaxed);
+        next.Set();
+        if (stopping) break;
+      }
+    });
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  events[0].Set();
+  for (auto& t : ring) {
+    t.join();
+  }
+  std::chrono::duration<double, std::nano> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  return elapsed.count() / (static_cast<double>(thread_count) * laps);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  rex::cvar::Init(argc, argv);
+
+  uint32_t thread_count = std::max(2u, REXCVAR_GET(threads));
+  uint32_t laps = std::max(1u, REXCVAR_GET(laps));
+
+  double legacy_ns = RunRing<LegacyEvent>(thread_count, laps);
+  double keyed_ns = RunRing<RexEvent>(thread_count, laps);
+
+  std::cout << fmt::format(
+      "{{\"threads\": {}, \"handoffs\": {}, \"legacy_ns_per_handoff\": {:.1f}, "
+      "\"keyed_ns_per_handoff\": {:.1f}, \"speedup\": {:.2f}}}\n",
+      thread_count, static_cast<uint64_t>(thread_count) * laps, legacy_ns,
+      keyed_ns, keyed_ns > 0.0 ? legacy_ns / keyed_ns : 0.0);
+  return 0;
+}
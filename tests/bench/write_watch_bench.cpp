@@ -0,0 +1,111 @@
+/**
+ * @file        tests/bench/write_watch_bench.cpp
+ * @brief       Cost of detecting CPU writes to GPU-watched physical memory
+ *
+ * @copyright   Copyright (c) 2026 Tom Clay <tomc@tctechstuff.com>
+ *              All rights reserved.
+ *
+ * @license     BSD 3-Clause License
+ *              See LICENSE file in the project root for full license text.
+ */
+
+// Simulates frames of a game updating resources the GPU caches: every frame
+// the watched range is armed again as the caches would after uploading it, the
+// CPU writes to some of its pages, and the writes are polled as at a command
+// buffer submission. Prints the time per frame and per written page as one
+// JSON object for the backend picked with --write_watch; run once with
+// --write_watch=protect and once with --write_watch=userfaultfd to compare an
+// access violation per page against the kernel recording the writes.
+
+#include <rex/cvar.h>
+#include <rex/kernel/xmemory.h>
+#include <rex/logging.h>
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <utility>
+
+REXCVAR_DEFINE_UINT32(watched_pages, 4096, "Bench", "4 KB pages watched per frame");
+REXCVAR_DEFINE_UINT32(written_pages, 256, "Bench", "Pages written per frame, spread over the watched ones");
+REXCVAR_DEFINE_UINT32(frames, 200, "Bench", "Frames per measurement");
+
+namespace {
+
+std::pair<uint32_t, uint32_t> CountInvalidation(void* context_ptr,
+                                                uint32_t physical_address_start,
+                                                uint32_t length,
+                                                bool exact_range) {
+  // Unwatch only what was written, like the GPU caches, so every written page
+  // is detected separately.
+  ++*static_cast<uint64_t*>(context_ptr);
+  return {physical_address_start, length};
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  rex::cvar::Init(argc, argv);
+  rex::InitLogging();
+
+  rex::memory::Memory memory;
+  if (!memory.Initialize()) {
+    std::cerr << "Failed to initialize guest memory\n";
+    return 1;
+  }
+  uint32_t watched_pages = REXCVAR_GET(watched_pages);
+  uint32_t written_pages = std::min(REXCVAR_GET(written_pages), watched_pages);
+  uint32_t frames = REXCVAR_GET(frames);
+  uint32_t size = watched_pages * 4096;
+  uint32_t address = memory.SystemHeapAlloc(size, 4096,
+                                            rex::memory::kSystemHeapPhysical);
+  if (!address) {
+    std::cerr << "Failed to allocate " << size << " bytes\n";
+    return 1;
+  }
+  uint32_t physical_address = memory.GetPhysicalAddress(address);
+  auto host = memory.TranslateVirtual<volatile uint8_t*>(address);
+
+  uint64_t invalidations = 0;
+  void* callback_handle = memory.RegisterPhysicalMemoryInvalidationCallback(
+      CountInvalidation, &invalidations);
+  uint32_t written_stride = written_pages ? watched_pages / written_pages : 0;
+  auto frame = [&](uint32_t index) {
+    memory.EnablePhysicalMemoryAccessCallbacks(physical_address, size, true,
+                                               false);
+    for (uint32_t i = 0; i < written_pages; ++i) {
+      host[(i * written_stride) * 4096 + (index & 4095)] = uint8_t(index);
+    }
+    memory.PollPhysicalMemoryWrites();
+  };
+
+  frame(0);  // warm up
+  invalidations = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t i = 1; i <= frames; ++i) {
+    frame(i);
+  }
+  auto end = std::chrono::steady_clock::now();
+  double ns =
+      std::chrono::duration<double, std::nano>(end - start).count();
+
+  memory.UnregisterPhysicalMemoryInvalidationCallback(callback_handle);
+  memory.SystemHeapFree(address);
+
+  std::cout << fmt::format(
+                   "{{\"backend\": \"{}\", \"watched_pages\": {}, "
+                   "\"written_pages\": {}, \"frames\": {}, "
+                   "\"invalidations_per_frame\": {:.1f}, "
+                   "\"ns_per_frame\": {:.0f}, \"ns_per_written_page\": {:.0f}}}",
+                   memory.is_physical_memory_write_watch_polled()
+                       ? "userfaultfd"
+                       : "protect",
+                   watched_pages, written_pages, frames,
+                   double(invalidations) / frames, ns / frames,
+                   written_pages ? ns / frames / written_pages : 0.0)
+            << "\n";
+  return 0;
+}
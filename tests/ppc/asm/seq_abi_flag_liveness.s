@@ -0,0 +1,23 @@
+test_abi_flag_liveness_return:
+  # cr2-cr4 outlive the return; the volatile cr6 write nothing reads is dropped
+  #_ REGISTER_IN r3 1
+  #_ REGISTER_IN r4 2
+  cmpw cr2, r3, r4
+  cmpw cr3, r4, r3
+  cmpw cr4, r3, r3
+  cmpw cr6, r3, r4
+  blr
+  #_ REGISTER_OUT cr 0x00842000
+
+test_abi_flag_liveness_read:
+  # A volatile field read before the return is still written
+  #_ REGISTER_IN r3 1
+  #_ REGISTER_IN r4 2
+  li r12, 0
+  cmpw cr6, r3, r4
+  bge cr6, abi_flag_liveness_read_done
+  li r12, 1
+abi_flag_liveness_read_done:
+  blr
+  #_ REGISTER_OUT r12 1
+  #_ REGISTER_OUT cr 0x00000080
@@ -0,0 +1,45 @@
+test_flag_liveness_partial:
+  #_ REGISTER_IN r3 5
+  #_ REGISTER_IN r4 5
+  li r12, 0
+  cmpw r3, r4 # only cr0.eq is read before cr0 is written again
+  bne flag_liveness_partial_done
+  li r12, 1
+flag_liveness_partial_done:
+  cmpwi r12, 1
+  blr
+  #_ REGISTER_OUT r12 1
+  #_ REGISTER_OUT cr 0x20000000
+
+test_flag_liveness_fields:
+  #_ REGISTER_IN r3 2
+  #_ REGISTER_IN r4 9
+  li r12, 0
+  cmplw cr6, r3, r4 # only cr6.lt is read
+  cmpw cr7, r4, r3 # only cr7.gt is read
+  bge cr6, flag_liveness_fields_done
+  ble cr7, flag_liveness_fields_done
+  li r12, 1
+flag_liveness_fields_done:
+  cmpw cr6, r12, r12
+  cmpw cr7, r12, r12
+  blr
+  #_ REGISTER_OUT r12 1
+  #_ REGISTER_OUT cr 0x00000022
+
+test_flag_liveness_carry_loop:
+  #_ REGISTER_IN r3 0xFFFFFFFF
+  #_ REGISTER_IN r4 3
+  li r5, 0
+  addic r7, r5, 0 # CA=0
+  mtctr r4
+flag_liveness_carry_loop_top:
+  addze r5, r5 # reads CA from the previous iteration
+  srawi r8, r3, 1 # CA=1, written again before anything reads it
+  addc r6, r3, r4 # CA=1
+  bdnz flag_liveness_carry_loop_top
+  blr
+  #_ REGISTER_OUT r5 2
+  #_ REGISTER_OUT r6 0x100000002
+  #_ REGISTER_OUT r7 0
+  #_ REGISTER_OUT r8 0xffffffffffffffff
@@ -0,0 +1,76 @@
+test_flush_mode_loop:
+  # v3 lanes are denormal: VMX flushes them, scalar FPU keeps f1
+  #_ REGISTER_IN f1 1.0e-310
+  #_ REGISTER_IN f2 0.0
+  #_ REGISTER_IN v3 [00000001, 00000001, 00000001, 00000001]
+  #_ REGISTER_IN v4 [00000000, 00000000, 00000000, 00000000]
+  #_ REGISTER_IN r3 2
+  mtctr r3
+flush_mode_loop_top:
+  fadd f3, f1, f2 # entered in unknown mode, then VMX from the back edge
+  vaddfp v5, v3, v4
+  bdnz flush_mode_loop_top
+  blr
+  #_ REGISTER_OUT f3 1.0e-310
+  #_ REGISTER_OUT v5 [00000000, 00000000, 00000000, 00000000]
+
+test_flush_mode_join:
+  #_ REGISTER_IN f1 1.0e-310
+  #_ REGISTER_IN f2 0.0
+  #_ REGISTER_IN v3 [00000001, 00000001, 00000001, 00000001]
+  #_ REGISTER_IN v4 [00000000, 00000000, 00000000, 00000000]
+  #_ REGISTER_IN r3 1
+  cmpwi r3, 0
+  vaddfp v5, v3, v4
+  beq flush_mode_join_done
+  fadd f3, f1, f2 # only one way into the label switches back to FPU
+flush_mode_join_done:
+  fadd f4, f1, f2
+  blr
+  #_ REGISTER_OUT f3 1.0e-310
+  #_ REGISTER_OUT f4 1.0e-310
+  #_ REGISTER_OUT v5 [00000000, 00000000, 00000000, 00000000]
+
+test_flush_mode_to_vmx:
+  vaddfp v7, v3, v4
+  blr
+
+test_flush_mode_to_fpu:
+  fadd f5, f1, f2
+  blr
+
+test_flush_mode_keep:
+  addi r5, r5, 1
+  blr
+
+test_flush_mode_callee_vmx:
+  #_ REGISTER_IN f1 1.0e-310
+  #_ REGISTER_IN f2 0.0
+  #_ REGISTER_IN v3 [00000001, 00000001, 00000001, 00000001]
+  #_ REGISTER_IN v4 [00000000, 00000000, 00000000, 00000000]
+  #_ REGISTER_IN r5 0
+  fadd f3, f1, f2
+  bl test_flush_mode_to_vmx # returns in VMX
+  bl test_flush_mode_keep # leaves it that way
+  fadd f4, f1, f2 # has to switch back to FPU
+  blr
+  #_ REGISTER_OUT f3 1.0e-310
+  #_ REGISTER_OUT f4 1.0e-310
+  #_ REGISTER_OUT v7 [00000000, 00000000, 00000000, 00000000]
+  #_ REGISTER_OUT r5 1
+
+test_flush_mode_callee_fpu:
+  #_ REGISTER_IN f1 1.0e-310
+  #_ REGISTER_IN f2 0.0
+  #_ REGISTER_IN v3 [00000001, 00000001, 00000001, 00000001]
+  #_ REGISTER_IN v4 [00000000, 00000000, 00000000, 00000000]
+  #_ REGISTER_IN r5 0
+  vaddfp v5, v3, v4
+  bl test_flush_mode_keep # leaves it in VMX
+  bl test_flush_mode_to_fpu # returns in FPU
+  vaddfp v6, v3, v4 # has to switch back to VMX
+  blr
+  #_ REGISTER_OUT f5 1.0e-310
+  #_ REGISTER_OUT v5 [00000000, 00000000, 00000000, 00000000]
+  #_ REGISTER_OUT v6 [00000000, 00000000, 00000000, 00000000]
+  #_ REGISTER_OUT r5 1
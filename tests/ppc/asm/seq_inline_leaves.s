@@ -0,0 +1,34 @@
+test_inline_leaf_compare:
+  cmpw r3, r4
+  addic r5, r3, -1
+  blr
+
+test_inline_call:
+  #_ REGISTER_IN r3 1
+  #_ REGISTER_IN r4 2
+  li r7, 0
+  bl test_inline_leaf_compare # emitted in place
+  addze r7, r7 # reads CA from the inlined addic
+  blr
+  #_ REGISTER_OUT r5 0
+  #_ REGISTER_OUT r7 1
+  #_ REGISTER_OUT cr 0x80000000
+
+test_inline_tail_call:
+  #_ REGISTER_IN r3 1
+  #_ REGISTER_IN r4 2
+  b test_inline_leaf_compare # the caller reads whatever the leaf leaves in CR
+  #_ REGISTER_OUT r5 0
+  #_ REGISTER_OUT cr 0x80000000
+
+test_inline_tail_call_carry:
+  #_ REGISTER_IN r3 1
+  #_ REGISTER_IN r4 2
+  mflr r12
+  li r7, 0
+  bl test_inline_tail_call # a real call; the tail call inside is inlined
+  addze r7, r7
+  mtlr r12
+  blr
+  #_ REGISTER_OUT r7 1
+  #_ REGISTER_OUT cr 0x80000000
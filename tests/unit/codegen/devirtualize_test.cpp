@@ -0,0 +1,158 @@
+/**
+ * @file        devirtualize_test.cpp
+ * @brief       Unit tests for the vtable slot matcher behind guarded bctr/bctrl
+ *
+ * @copyright   Copyright (c) 2026 Tom Clay
+ * @license     BSD 3-Clause License
+ */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+#include <rex/byte_order.h>
+
+#include "devirtualize.h"
+#include "insn_flow.h"
+
+using rex::codegen::FindVtableSlot;
+using rex::codegen::IsBranch;
+using rex::codegen::MayWriteGpr;
+
+namespace {
+
+constexpr uint32_t kBctrl = 0x4E800421;
+constexpr uint32_t kBl = 0x48000101;
+constexpr uint32_t kBlr = 0x4E800020;
+
+uint32_t Lwz(uint32_t rd, int16_t offset, uint32_t ra) {
+    return (32u << 26) | (rd << 21) | (ra << 16) | static_cast<uint16_t>(offset);
+}
+
+uint32_t Stw(uint32_t rs, int16_t offset, uint32_t ra) {
+    return (36u << 26) | (rs << 21) | (ra << 16) | static_cast<uint16_t>(offset);
+}
+
+uint32_t Stwu(uint32_t rs, int16_t offset, uint32_t ra) {
+    return (37u << 26) | (rs << 21) | (ra << 16) | static_cast<uint16_t>(offset);
+}
+
+uint32_t Addi(uint32_t rd, uint32_t ra, int16_t value) {
+    return (14u << 26) | (rd << 21) | (ra << 16) | static_cast<uint16_t>(value);
+}
+
+uint32_t Rlwinm(uint32_t ra, uint32_t rs, uint32_t sh, uint32_t mb, uint32_t me) {
+    return (21u << 26) | (rs << 21) | (ra << 16) | (sh << 11) | (mb << 6) | (me << 1);
+}
+
+uint32_t Lmw(uint32_t rd, int16_t offset, uint32_t ra) {
+    return (46u << 26) | (rd << 21) | (ra << 16) | static_cast<uint16_t>(offset);
+}
+
+uint32_t Mtctr(uint32_t rs) {
+    return 0x7C0903A6 | (rs << 21);
+}
+
+/// Instruction words as they sit in guest memory
+std::vector<uint32_t> Block(std::initializer_list<uint32_t> words) {
+    std::vector<uint32_t> block;
+    for (uint32_t word : words) {
+        block.push_back(rex::byte_swap(word));
+    }
+    return block;
+}
+
+} // namespace
+
+TEST_CASE("FindVtableSlot matches a vtable call", "[codegen][devirtualize]") {
+    auto block = Block({Lwz(11, 0, 3), Lwz(10, 8, 11), Mtctr(10), kBctrl});
+    CHECK(FindVtableSlot(block, true) == 8u);
+    CHECK(FindVtableSlot(block, false) == 8u);
+
+    SECTION("Instructions that leave both registers alone don't break the match") {
+        auto spaced = Block({Lwz(11, 0, 3), Addi(4, 4, 1), Lwz(10, 0x24, 11),
+                             Stw(10, 0, 1), Mtctr(10), kBctrl});
+        CHECK(FindVtableSlot(spaced, true) == 0x24u);
+    }
+}
+
+TEST_CASE("FindVtableSlot gives up on clobbered registers", "[codegen][devirtualize]") {
+    SECTION("Function pointer written after the slot load") {
+        auto block = Block({Lwz(11, 0, 3), Lwz(10, 8, 11), Addi(10, 10, 4), Mtctr(10), kBctrl});
+        CHECK_FALSE(FindVtableSlot(block, true).has_value());
+        CHECK_FALSE(FindVtableSlot(block, false).has_value());
+    }
+
+    SECTION("Vtable pointer written after the vtable load") {
+        auto block = Block({Lwz(11, 0, 3), Addi(11, 11, 16), Lwz(10, 8, 11), Mtctr(10), kBctrl});
+        CHECK_FALSE(FindVtableSlot(block, true).has_value());
+        CHECK(FindVtableSlot(block, false) == 8u);
+    }
+
+    SECTION("No vtable load at all") {
+        auto block = Block({Lwz(10, 8, 11), Mtctr(10), kBctrl});
+        CHECK_FALSE(FindVtableSlot(block, true).has_value());
+        CHECK(FindVtableSlot(block, false) == 8u);
+    }
+}
+
+TEST_CASE("FindVtableSlot rejects slots that aren't word offsets", "[codegen][devirtualize]") {
+    SECTION("Negative") {
+        auto block = Block({Lwz(11, 0, 3), Lwz(10, -4, 11), Mtctr(10), kBctrl});
+        CHECK_FALSE(FindVtableSlot(block, true).has_value());
+        CHECK_FALSE(FindVtableSlot(block, false).has_value());
+    }
+
+    SECTION("Unaligned") {
+        auto block = Block({Lwz(11, 0, 3), Lwz(10, 6, 11), Mtctr(10), kBctrl});
+        CHECK_FALSE(FindVtableSlot(block, true).has_value());
+        CHECK_FALSE(FindVtableSlot(block, false).has_value());
+    }
+
+    SECTION("Absolute") {
+        auto block = Block({Lwz(10, 8, 0), Mtctr(10), kBctrl});
+        CHECK_FALSE(FindVtableSlot(block, false).has_value());
+    }
+}
+
+TEST_CASE("FindVtableSlot stops at a branch in the lookback", "[codegen][devirtualize]") {
+    auto block = Block({Lwz(11, 0, 3), kBl, Lwz(10, 8, 11), Mtctr(10), kBctrl});
+    CHECK_FALSE(FindVtableSlot(block, true).has_value());
+    CHECK(FindVtableSlot(block, false) == 8u);
+
+    auto beforeSlot = Block({Lwz(11, 0, 3), Lwz(10, 8, 11), kBl, Mtctr(10), kBctrl});
+    CHECK_FALSE(FindVtableSlot(beforeSlot, false).has_value());
+
+    CHECK_FALSE(FindVtableSlot({}, false).has_value());
+}
+
+TEST_CASE("MayWriteGpr", "[codegen][devirtualize]") {
+    CHECK(MayWriteGpr(Lwz(10, 8, 11), 10));
+    CHECK_FALSE(MayWriteGpr(Lwz(10, 8, 11), 12));
+
+    CHECK_FALSE(MayWriteGpr(Stw(10, 0, 11), 10));
+    CHECK_FALSE(MayWriteGpr(Stw(10, 0, 11), 11));
+
+    CHECK(MayWriteGpr(Stwu(1, -16, 1), 1));
+    CHECK_FALSE(MayWriteGpr(Stwu(10, -16, 1), 10));
+
+    CHECK(MayWriteGpr(Rlwinm(10, 11, 2, 0, 29), 10));
+    CHECK_FALSE(MayWriteGpr(Rlwinm(10, 11, 2, 0, 29), 11));
+
+    CHECK(MayWriteGpr(Lmw(28, -16, 1), 31));
+    CHECK(MayWriteGpr(Lmw(28, -16, 1), 28));
+    CHECK_FALSE(MayWriteGpr(Lmw(28, -16, 1), 27));
+}
+
+TEST_CASE("IsBranch", "[codegen][insn_flow]") {
+    CHECK(IsBranch(kBl));
+    CHECK(IsBranch(kBlr));
+    CHECK(IsBranch(kBctrl));
+    CHECK(IsBranch(0x41820010));  // beq +0x10
+    CHECK(IsBranch(0x44000002));  // sc
+    CHECK_FALSE(IsBranch(Mtctr(10)));
+    CHECK_FALSE(IsBranch(Lwz(10, 8, 11)));
+    CHECK_FALSE(IsBranch(0x4C421382));  // crxor 2, 2, 2
+}
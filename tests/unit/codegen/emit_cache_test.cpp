@@ -0,0 +1,210 @@
+/**
+ * @file        emit_cache_test.cpp
+ * @brief       Unit tests for the per-function emission cache
+ *
+ * A body saved by one run must come back for a function whose key is
+ * unchanged and be dropped when its code, the config flags or the code it
+ * inlines changed. Truncated, corrupt and old-version files yield an empty
+ * cache instead of stale bodies.
+ *
+ * @copyright   Copyright (c) 2026 Tom Clay
+ * @license     BSD 3-Clause License
+ */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <rex/byte_order.h>
+#include <rex/codegen/binary_view.h>
+#include <rex/codegen/codegen_context.h>
+#include <rex/codegen/config.h>
+#include <rex/codegen/function_graph.h>
+#include <rex/codegen/test_module.h>
+
+#include "emit_cache.h"
+
+using rex::codegen::BinaryView;
+using rex::codegen::CallTarget;
+using rex::codegen::CodegenContext;
+using rex::codegen::EmitCache;
+using rex::codegen::FunctionAuthority;
+using rex::codegen::FunctionNode;
+using rex::codegen::InlineLeaves;
+using rex::codegen::RecompilerConfig;
+using rex::codegen::TestModule;
+
+namespace {
+
+constexpr uint32_t kCaller = 0x82010000;  ///< bl kCallee; blr
+constexpr uint32_t kCallee = 0x82010010;  ///< li r3, value; blr
+constexpr uint32_t kCallerSize = 0x10;
+constexpr uint32_t kCalleeSize = 0x08;
+
+constexpr uint32_t kNop = 0x60000000;
+constexpr uint32_t kBlr = 0x4E800020;
+
+const std::vector<std::string> kBodies = {"caller body", "callee body"};
+
+/// Code for both functions as it sits in guest memory
+std::vector<uint32_t> Code(int16_t calleeValue) {
+    const uint32_t bl = 0x48000001 | (kCallee - kCaller);
+    const uint32_t li = (14u << 26) | (3u << 21) | static_cast<uint16_t>(calleeValue);
+    std::vector<uint32_t> code;
+    for (uint32_t word : {bl, kBlr, kNop, kNop, li, kBlr}) {
+        code.push_back(rex::byte_swap(word));
+    }
+    return code;
+}
+
+/// Context with the caller and callee registered and the call edge resolved
+CodegenContext MakeContext(const std::vector<uint32_t>& code, RecompilerConfig config = {}) {
+    TestModule module;
+    module.Load(kCaller, reinterpret_cast<const uint8_t*>(code.data()), code.size() * sizeof(uint32_t));
+    auto ctx = CodegenContext::Create(BinaryView::fromModule(module), std::move(config));
+
+    auto& graph = ctx.graph;
+    graph.addFunction(kCaller, kCallerSize, FunctionAuthority::DISCOVERED, true);
+    graph.addBlockToFunction(kCaller, {kCaller, kCallerSize});
+    graph.setFunctionName(kCaller, "caller");
+    graph.addFunction(kCallee, kCalleeSize, FunctionAuthority::DISCOVERED, true);
+    graph.addBlockToFunction(kCallee, {kCallee, kCalleeSize});
+    graph.setFunctionName(kCallee, "callee");
+    graph.addCallToFunction(kCaller, kCaller, CallTarget::function(graph.getFunction(kCallee)));
+    return ctx;
+}
+
+std::vector<const FunctionNode*> Functions(const CodegenContext& ctx) {
+    return {ctx.graph.getFunction(kCaller), ctx.graph.getFunction(kCallee)};
+}
+
+/// Saves kBodies for ctx's functions to path
+void Save(const CodegenContext& ctx, const std::filesystem::path& path,
+          const InlineLeaves* inlineLeaves = nullptr) {
+    EmitCache cache(ctx, path);
+    cache.Prepare(Functions(ctx), nullptr, nullptr, inlineLeaves);
+    REQUIRE(cache.Save(kBodies));
+}
+
+/// Loads path for ctx and reports which functions hit, caller first
+std::vector<bool> Hits(const CodegenContext& ctx, const std::filesystem::path& path,
+                       const InlineLeaves* inlineLeaves = nullptr) {
+    EmitCache cache(ctx, path);
+    cache.Load();
+    cache.Prepare(Functions(ctx), nullptr, nullptr, inlineLeaves);
+    std::vector<bool> hits;
+    for (size_t i = 0; i < kBodies.size(); ++i) {
+        auto body = cache.Take(i);
+        if (body) {
+            CHECK(*body == kBodies[i]);
+        }
+        hits.push_back(body.has_value());
+    }
+    return hits;
+}
+
+const std::vector<bool> kAllHit = {true, true};
+const std::vector<bool> kAllMiss = {false, false};
+
+}  // namespace
+
+TEST_CASE("EmitCache round trips unchanged functions", "[codegen][emit_cache]") {
+    auto path = std::filesystem::temp_directory_path() / "rex_emit_cache_round_trip.bin";
+    auto code = Code(1);
+    auto ctx = MakeContext(code);
+    Save(ctx, path);
+
+    CHECK(Hits(ctx, path) == kAllHit);
+
+    // A fresh context over the same code and config computes the same keys
+    auto again = MakeContext(code);
+    CHECK(Hits(again, path) == kAllHit);
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("EmitCache keys change with what feeds emission", "[codegen][emit_cache]") {
+    auto path = std::filesystem::temp_directory_path() / "rex_emit_cache_keys.bin";
+    auto code = Code(1);
+    auto changed = Code(2);
+
+    SECTION("Callee code") {
+        auto ctx = MakeContext(code);
+        Save(ctx, path);
+        CHECK(Hits(MakeContext(changed), path) == std::vector<bool>{true, false});
+    }
+
+    SECTION("Inlined callee code") {
+        InlineLeaves leaves = {kCallee};
+        auto ctx = MakeContext(code);
+        Save(ctx, path, &leaves);
+        CHECK(Hits(ctx, path, &leaves) == kAllHit);
+        CHECK(Hits(MakeContext(changed), path, &leaves) == kAllMiss);
+    }
+
+    SECTION("Inlining decision") {
+        InlineLeaves leaves = {kCallee};
+        auto ctx = MakeContext(code);
+        Save(ctx, path);
+        CHECK(Hits(ctx, path, &leaves) == std::vector<bool>{false, true});
+    }
+
+    SECTION("Config flags") {
+        auto ctx = MakeContext(code);
+        Save(ctx, path);
+
+        RecompilerConfig config;
+        config.flagLiveness = !config.flagLiveness;
+        CHECK(Hits(MakeContext(code, std::move(config)), path) == kAllMiss);
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("EmitCache drops unreadable files", "[codegen][emit_cache]") {
+    auto path = std::filesystem::temp_directory_path() / "rex_emit_cache_unreadable.bin";
+    auto ctx = MakeContext(Code(1));
+    Save(ctx, path);
+    REQUIRE(Hits(ctx, path) == kAllHit);
+
+    auto patch = [&](std::streamoff offset, const auto& value) {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(offset);
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+
+    // Header: 8-byte magic, version, count; entries: base, key, length, body
+    constexpr std::streamoff kVersionOffset = 8;
+    constexpr std::streamoff kFirstLengthOffset = 16 + 4 + 16;
+
+    SECTION("Missing") {
+        std::filesystem::remove(path);
+        CHECK(Hits(ctx, path) == kAllMiss);
+    }
+
+    SECTION("Truncated") {
+        std::filesystem::resize_file(path, std::filesystem::file_size(path) - 3);
+        CHECK(Hits(ctx, path) == kAllMiss);
+    }
+
+    SECTION("Corrupt magic") {
+        patch(0, uint8_t{'X'});
+        CHECK(Hits(ctx, path) == kAllMiss);
+    }
+
+    SECTION("Corrupt body length") {
+        patch(kFirstLengthOffset, ~uint64_t{0});
+        CHECK(Hits(ctx, path) == kAllMiss);
+    }
+
+    SECTION("Other version") {
+        patch(kVersionOffset, EmitCache::kVersion + 1);
+        CHECK(Hits(ctx, path) == kAllMiss);
+    }
+
+    std::filesystem::remove(path);
+}
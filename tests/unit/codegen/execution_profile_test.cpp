@@ -0,0 +1,147 @@
+/**
+ * @file        execution_profile_test.cpp
+ * @brief       Unit tests for the guest profile round trip into codegen
+ *
+ * A profile written by GuestProfile::Save must read back through
+ * ExecutionProfile::Load with the same counts, indirect targets sorted
+ * busiest first and hot functions covering kHotFraction of all calls.
+ *
+ * @copyright   Copyright (c) 2026 Tom Clay
+ * @license     BSD 3-Clause License
+ */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <utility>
+#include <vector>
+
+#include <rex/codegen/execution_profile.h>
+#include <rex/runtime/guest/profile.h>
+
+using rex::codegen::ExecutionProfile;
+using rex::codegen::FunctionHeat;
+using rex::runtime::guest::GuestProfile;
+
+namespace {
+
+constexpr uint32_t kCodeBase = 0x82000000;
+constexpr uint32_t kCodeSize = 0x1000;
+
+void Record(GuestProfile& profile, uint32_t function, int count) {
+    for (int i = 0; i < count; ++i) {
+        profile.RecordEntry(function);
+    }
+}
+
+void Record(GuestProfile& profile, uint32_t site, uint32_t target, int count) {
+    for (int i = 0; i < count; ++i) {
+        profile.RecordIndirect(site, target);
+    }
+}
+
+}  // namespace
+
+TEST_CASE("Guest profile round trips into ExecutionProfile", "[codegen][profile]") {
+    GuestProfile recorder(kCodeBase, kCodeSize);
+    Record(recorder, kCodeBase + 0x00, 90);
+    Record(recorder, kCodeBase + 0x10, 9);
+    Record(recorder, kCodeBase + 0x20, 1);
+    Record(recorder, kCodeBase + kCodeSize, 5);  // Outside the code range
+
+    const uint32_t site = kCodeBase + 0x100;
+    Record(recorder, site, 0x82000A00, 1);
+    Record(recorder, site, 0x82000B00, 3);
+    Record(recorder, site, 0x82000C00, 2);
+    Record(recorder, site, 0x82000D00, 1);
+    Record(recorder, site, 0, 4);  // Ignored
+
+    auto path = std::filesystem::temp_directory_path() / "rex_execution_profile_test.txt";
+    REQUIRE(recorder.Save(path));
+    auto profile = ExecutionProfile::Load(path);
+    std::filesystem::remove(path);
+    REQUIRE(profile);
+
+    SECTION("Entry counts") {
+        CHECK(profile->totalEntries() == 100);
+        CHECK(profile->entryCount(kCodeBase + 0x00) == 90);
+        CHECK(profile->entryCount(kCodeBase + 0x10) == 9);
+        CHECK(profile->entryCount(kCodeBase + 0x20) == 1);
+        CHECK(profile->entryCount(kCodeBase + 0x30) == 0);
+        CHECK(profile->entryCount(kCodeBase + kCodeSize) == 0);
+    }
+
+    SECTION("Hot functions cover kHotFraction of all calls") {
+        CHECK(profile->heat(kCodeBase + 0x00) == FunctionHeat::Hot);
+        CHECK(profile->heat(kCodeBase + 0x10) == FunctionHeat::Normal);
+        CHECK(profile->heat(kCodeBase + 0x20) == FunctionHeat::Normal);
+        CHECK(profile->heat(kCodeBase + 0x30) == FunctionHeat::Cold);
+    }
+
+    SECTION("Site targets are sorted busiest first") {
+        const auto& sites = profile->indirectSites();
+        REQUIRE(sites.size() == 1);
+        auto it = sites.find(site);
+        REQUIRE(it != sites.end());
+        CHECK(it->second.total == 7);
+
+        // Ties keep the order the targets were first seen in
+        std::vector<std::pair<uint32_t, uint64_t>> expected = {
+            {0x82000B00, 3}, {0x82000C00, 2}, {0x82000A00, 1}, {0x82000D00, 1}};
+        CHECK(it->second.targets == expected);
+    }
+}
+
+TEST_CASE("Guest profile folds targets past kSiteTargets into the total", "[codegen][profile]") {
+    static_assert(GuestProfile::kSiteTargets == 4);
+
+    GuestProfile recorder(kCodeBase, kCodeSize);
+    const uint32_t site = kCodeBase + 0x40;
+    for (uint32_t i = 0; i < GuestProfile::kSiteTargets; ++i) {
+        Record(recorder, site, 0x82000800 + i * 0x10, 2);
+    }
+    Record(recorder, site, 0x82000900, 3);
+    Record(recorder, site, 0x82000910, 4);
+
+    auto path = std::filesystem::temp_directory_path() / "rex_execution_profile_overflow_test.txt";
+    REQUIRE(recorder.Save(path));
+    auto profile = ExecutionProfile::Load(path);
+    std::filesystem::remove(path);
+    REQUIRE(profile);
+
+    const auto& record = profile->indirectSites().at(site);
+    CHECK(record.total == 2 * GuestProfile::kSiteTargets + 7);
+    REQUIRE(record.targets.size() == GuestProfile::kSiteTargets);
+    for (const auto& [target, count] : record.targets) {
+        CHECK(target < 0x82000900);
+        CHECK(count == 2);
+    }
+
+    // Nothing was entered, so there is no basis for calling anything hot or cold
+    CHECK(profile->totalEntries() == 0);
+    CHECK(profile->heat(kCodeBase) == FunctionHeat::Normal);
+}
+
+TEST_CASE("ExecutionProfile rejects missing and malformed files", "[codegen][profile]") {
+    auto path = std::filesystem::temp_directory_path() / "rex_execution_profile_missing.txt";
+    std::filesystem::remove(path);
+    CHECK_FALSE(ExecutionProfile::Load(path));
+
+    {
+        GuestProfile recorder(kCodeBase, kCodeSize);
+        REQUIRE(recorder.Save(path));
+    }
+    auto empty = ExecutionProfile::Load(path);
+    REQUIRE(empty);
+    CHECK(empty->totalEntries() == 0);
+    CHECK(empty->indirectSites().empty());
+
+    {
+        std::ofstream file(path, std::ios::trunc);
+        file << "entry 82000000\n";
+    }
+    CHECK_FALSE(ExecutionProfile::Load(path));
+    std::filesystem::remove(path);
+}
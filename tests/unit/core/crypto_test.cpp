@@ -0,0 +1,213 @@
+/**
+ * @file        crypto_test.cpp
+ * @brief       Unit tests for rex::crypto
+ *
+ * @copyright   Copyright (c) 2026 Tom Clay
+ * @license     BSD 3-Clause License
+ */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <rex/cvar.h>
+#include <rex/crypto.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+REXCVAR_DECLARE(bool, crypto_hardware);
+
+namespace {
+
+std::string Hex(const uint8_t* data, size_t size) {
+    static constexpr char kDigits[] = "0123456789abcdef";
+    std::string hex;
+    for (size_t i = 0; i < size; ++i) {
+        hex += kDigits[data[i] >> 4];
+        hex += kDigits[data[i] & 0xF];
+    }
+    return hex;
+}
+
+std::vector<uint8_t> Unhex(std::string_view hex) {
+    std::vector<uint8_t> bytes;
+    for (size_t i = 0; i + 1 < hex.size(); i += 2) {
+        bytes.push_back(uint8_t(std::stoi(std::string(hex.substr(i, 2)), nullptr, 16)));
+    }
+    return bytes;
+}
+
+template <typename Hash>
+std::string Digest(std::string_view text) {
+    Hash hash;
+    hash.Update(text.data(), text.size());
+    uint8_t digest[Hash::kDigestSize];
+    hash.Final(digest);
+    return Hex(digest, sizeof(digest));
+}
+
+std::vector<uint8_t> RandomBytes(size_t size) {
+    std::mt19937 rng(static_cast<uint32_t>(size));
+    std::vector<uint8_t> bytes(size);
+    for (auto& byte : bytes) {
+        byte = uint8_t(rng());
+    }
+    return bytes;
+}
+
+/// Runs `fn` with the accelerated paths enabled and disabled.
+template <typename Fn>
+void ForEachBackend(Fn&& fn) {
+    for (bool hardware : {true, false}) {
+        REXCVAR_SET(crypto_hardware, hardware);
+        fn();
+    }
+    REXCVAR_SET(crypto_hardware, true);
+}
+
+}  // namespace
+
+TEST_CASE("Crc32 matches the IEEE check value", "[crypto]") {
+    ForEachBackend([] {
+        CHECK(rex::crypto::Crc32(0, "123456789", 9) == 0xCBF43926);
+        CHECK(rex::crypto::Crc32(0x1234, "", 0) == 0x1234);
+    });
+}
+
+TEST_CASE("Crc32 hardware and portable paths agree", "[crypto]") {
+    for (size_t size : {1, 15, 16, 63, 64, 65, 127, 128, 200, 4096, 4099}) {
+        auto data = RandomBytes(size + 3);
+        for (size_t offset : {0, 3}) {
+            REXCVAR_SET(crypto_hardware, true);
+            uint32_t hardware = rex::crypto::Crc32(0xDEADBEEF, data.data() + offset, size);
+            REXCVAR_SET(crypto_hardware, false);
+            uint32_t portable = rex::crypto::Crc32(0xDEADBEEF, data.data() + offset, size);
+            INFO("size " << size << " offset " << offset);
+            CHECK(hardware == portable);
+        }
+    }
+    REXCVAR_SET(crypto_hardware, true);
+
+    // Chained calls equal one call over the whole buffer.
+    auto data = RandomBytes(1000);
+    uint32_t whole = rex::crypto::Crc32(0, data.data(), data.size());
+    uint32_t split = rex::crypto::Crc32(0, data.data(), 333);
+    split = rex::crypto::Crc32(split, data.data() + 333, data.size() - 333);
+    CHECK(whole == split);
+}
+
+TEST_CASE("Sha1 matches FIPS 180 vectors", "[crypto]") {
+    ForEachBackend([] {
+        CHECK(Digest<rex::crypto::Sha1>("") == "da39a3ee5e6b4b0d3255bfef95601890afd80709");
+        CHECK(Digest<rex::crypto::Sha1>("abc") == "a9993e364706816aba3e25717850c26c9cd0d89d");
+        CHECK(Digest<rex::crypto::Sha1>(
+                  "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq") ==
+              "84983e441c3bd26ebaae4aa1f95129e5e54670f1");
+    });
+}
+
+TEST_CASE("Sha256 matches FIPS 180 vectors", "[crypto]") {
+    ForEachBackend([] {
+        CHECK(Digest<rex::crypto::Sha256>("") ==
+              "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+        CHECK(Digest<rex::crypto::Sha256>("abc") ==
+              "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+        CHECK(Digest<rex::crypto::Sha256>(
+                  "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq") ==
+              "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+    });
+}
+
+TEST_CASE("Sha hashes resume from saved state", "[crypto]") {
+    auto data = RandomBytes(300);
+    rex::crypto::Sha256 whole;
+    whole.Update(data.data(), data.size());
+
+    rex::crypto::Sha256 first;
+    first.Update(data.data(), 100);
+    rex::crypto::Sha256 resumed(first.state(), first.count(), first.buffer());
+    for (size_t i = 100; i < data.size(); i += 7) {
+        resumed.Update(data.data() + i, std::min<size_t>(7, data.size() - i));
+    }
+    REQUIRE(resumed.count() == whole.count());
+
+    uint8_t a[32], b[32];
+    whole.Final(a);
+    resumed.Final(b);
+    CHECK(Hex(a, 32) == Hex(b, 32));
+}
+
+TEST_CASE("Sha hardware and portable paths agree", "[crypto]") {
+    for (size_t size : {0, 55, 56, 64, 119, 1000, 4096}) {
+        auto data = RandomBytes(size);
+        std::string sha1[2], sha256[2];
+        for (int hardware = 0; hardware < 2; ++hardware) {
+            REXCVAR_SET(crypto_hardware, hardware != 0);
+            rex::crypto::Sha1 h1;
+            h1.Update(data.data(), data.size());
+            uint8_t d1[20];
+            h1.Final(d1);
+            sha1[hardware] = Hex(d1, sizeof(d1));
+            rex::crypto::Sha256 h2;
+            h2.Update(data.data(), data.size());
+            uint8_t d2[32];
+            h2.Final(d2);
+            sha256[hardware] = Hex(d2, sizeof(d2));
+        }
+        INFO("size " << size);
+        CHECK(sha1[0] == sha1[1]);
+        CHECK(sha256[0] == sha256[1]);
+    }
+    REXCVAR_SET(crypto_hardware, true);
+}
+
+TEST_CASE("Aes128 matches FIPS 197 and SP 800-38A vectors", "[crypto]") {
+    ForEachBackend([] {
+        auto key = Unhex("000102030405060708090a0b0c0d0e0f");
+        auto plain = Unhex("00112233445566778899aabbccddeeff");
+        rex::crypto::Aes128 aes(key.data());
+        uint8_t block[16];
+        aes.EncryptBlock(plain.data(), block);
+        CHECK(Hex(block, 16) == "69c4e0d86a7b0430d8cdb78070b4c55a");
+        aes.DecryptBlock(block, block);
+        CHECK(Hex(block, 16) == Hex(plain.data(), 16));
+
+        auto cbc_key = Unhex("2b7e151628aed2a6abf7158809cf4f3c");
+        auto cbc_plain = Unhex(
+            "6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e51"
+            "30c81c46a35ce411e5fbc1191a0a52eff69f2445df4f9b17ad2b417be66c3710");
+        const std::string cbc_cipher =
+            "7649abac8119b246cee98e9b12e9197d5086cb9b507219ee95db113a917678b2"
+            "73bed6b8e3c1743b7116e69e222295163ff1caa1681fac09120eca307586e1a7";
+        rex::crypto::Aes128 cbc(cbc_key.data());
+        auto iv = Unhex("000102030405060708090a0b0c0d0e0f");
+        std::vector<uint8_t> buffer(cbc_plain);
+        cbc.EncryptCbc(iv.data(), buffer.data(), buffer.data(), buffer.size());
+        CHECK(Hex(buffer.data(), buffer.size()) == cbc_cipher);
+        CHECK(Hex(iv.data(), 16) == cbc_cipher.substr(96));
+
+        // Decrypt in two chained calls, in place.
+        iv = Unhex("000102030405060708090a0b0c0d0e0f");
+        cbc.DecryptCbc(iv.data(), buffer.data(), buffer.data(), 16);
+        cbc.DecryptCbc(iv.data(), buffer.data() + 16, buffer.data() + 16, 48);
+        CHECK(buffer == cbc_plain);
+    });
+}
+
+TEST_CASE("Aes128 hardware and portable CBC agree", "[crypto]") {
+    auto key = RandomBytes(16);
+    auto data = RandomBytes(16 * 37);
+    rex::crypto::Aes128 aes(key.data());
+    std::vector<uint8_t> out[2];
+    for (int hardware = 0; hardware < 2; ++hardware) {
+        REXCVAR_SET(crypto_hardware, hardware != 0);
+        uint8_t iv[16] = {};
+        out[hardware].resize(data.size());
+        aes.DecryptCbc(iv, data.data(), out[hardware].data(), data.size());
+    }
+    REXCVAR_SET(crypto_hardware, true);
+    CHECK(out[0] == out[1]);
+}
@@ -0,0 +1,140 @@
+/**
+ * @file        logging_test.cpp
+ * @brief       Unit tests for the level cache and async logging backend
+ *
+ * @copyright   Copyright (c) 2026 Tom Clay
+ * @license     BSD 3-Clause License
+ */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <rex/cvar.h>
+#include <rex/logging.h>
+
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "test_files.h"
+
+namespace {
+
+rex::LogConfig FileOnlyConfig(const std::string& path) {
+    rex::LogConfig config;
+    config.log_file = path.c_str();
+    config.log_to_console = false;
+    config.default_level = spdlog::level::info;
+    return config;
+}
+
+struct Unformattable {
+    int value;
+};
+
+struct LogOnExit {
+    ~LogOnExit() {
+        // The drain frees the thread's ring, which has already been retired.
+        rex::FlushLogging();
+        REXLOG_INFO("logged at thread exit");
+    }
+};
+
+}  // namespace
+
+template <>
+struct fmt::formatter<Unformattable> : fmt::formatter<int> {
+    auto format(const Unformattable& v, fmt::format_context& ctx) const {
+        return fmt::formatter<int>::format(v.value, ctx);
+    }
+};
+
+TEST_CASE("Level cache follows category levels", "[logging]") {
+    auto path = (std::filesystem::temp_directory_path() / "rex_logging_levels.log").string();
+    rex::ShutdownLogging();
+    rex::InitLogging(FileOnlyConfig(path));
+
+    CHECK(rex::ShouldLog(rex::LogCategory::Kernel, spdlog::level::info));
+    CHECK_FALSE(rex::ShouldLog(rex::LogCategory::Kernel, spdlog::level::debug));
+
+    rex::SetCategoryLevel(rex::LogCategory::Kernel, spdlog::level::trace);
+    CHECK(rex::ShouldLog(rex::LogCategory::Kernel, spdlog::level::trace));
+    CHECK_FALSE(rex::ShouldLog(rex::LogCategory::GPU, spdlog::level::debug));
+
+    rex::SetAllLevels(spdlog::level::off);
+    CHECK_FALSE(rex::ShouldLog(rex::LogCategory::Core, spdlog::level::critical));
+
+    rex::ShutdownLogging();
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Async logging copies arguments and keeps per-thread order", "[logging]") {
+    auto path = (std::filesystem::temp_directory_path() / "rex_logging_async.log").string();
+    rex::ShutdownLogging();
+    REXCVAR_SET(log_async, true);
+    rex::InitLogging(FileOnlyConfig(path));
+    REQUIRE(rex::detail::g_async_logging.load());
+
+    {
+        // The buffer is gone before the writer formats the message.
+        std::string temporary = "temporary text";
+        REXKRNL_INFO("string {} {}", temporary.c_str(), std::string_view(temporary));
+        temporary.assign(temporary.size(), 'x');
+    }
+    REXKRNL_INFO("custom {}", Unformattable{42});
+    REXKRNL_DEBUG("filtered {}", 1);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([t] {
+            for (int i = 0; i < 3000; ++i) {
+                REXLOG_INFO("thread {} message {}", t, i);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    rex::ShutdownLogging();
+    REXCVAR_SET(log_async, false);
+    std::string log = ReadTestFile(path);
+    std::filesystem::remove(path);
+
+    CHECK(log.find("string temporary text temporary text") != std::string::npos);
+    CHECK(log.find("custom 42") != std::string::npos);
+    CHECK(log.find("filtered") == std::string::npos);
+    for (int t = 0; t < 4; ++t) {
+        size_t last = 0;
+        for (int i = 0; i < 3000; i += 500) {
+            size_t pos = log.find(fmt::format("thread {} message {}\n", t, i));
+            REQUIRE(pos != std::string::npos);
+            CHECK(pos >= last);
+            last = pos;
+        }
+    }
+}
+
+TEST_CASE("Async logging after a thread's ring is retired writes synchronously", "[logging]") {
+    auto path = (std::filesystem::temp_directory_path() / "rex_logging_exit.log").string();
+    rex::ShutdownLogging();
+    REXCVAR_SET(log_async, true);
+    rex::InitLogging(FileOnlyConfig(path));
+
+    std::thread([] {
+        // Constructed before the thread's ring, so destroyed after it retires.
+        thread_local LogOnExit log_on_exit;
+        (void)log_on_exit;
+        REXLOG_INFO("logged before exit");
+    }).join();
+
+    rex::ShutdownLogging();
+    REXCVAR_SET(log_async, false);
+    std::string log = ReadTestFile(path);
+    std::filesystem::remove(path);
+
+    size_t before = log.find("logged before exit");
+    size_t after = log.find("logged at thread exit");
+    REQUIRE(before != std::string::npos);
+    REQUIRE(after != std::string::npos);
+}
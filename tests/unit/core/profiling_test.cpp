@@ -0,0 +1,114 @@
+/**
+ * @file        profiling_test.cpp
+ * @brief       Unit tests for the rex::debug profiler
+ *
+ * @copyright   Copyright (c) 2026 Tom Clay
+ * @license     BSD 3-Clause License
+ */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <rex/cvar.h>
+#include <rex/profiling.h>
+
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "test_files.h"
+
+REXCVAR_DECLARE(std::string, profiler_output);
+
+namespace {
+
+size_t CountOccurrences(const std::string& haystack, const std::string& needle) {
+    size_t count = 0;
+    for (size_t pos = haystack.find(needle); pos != std::string::npos;
+         pos = haystack.find(needle, pos + needle.size())) {
+        ++count;
+    }
+    return count;
+}
+
+void ProfiledFunction() {
+    SCOPE_profile_cpu_f("test");
+}
+
+}  // namespace
+
+TEST_CASE("Disabled profiler records nothing", "[profiling]") {
+    REQUIRE_FALSE(rex::debug::Profiler::is_enabled());
+    REQUIRE(rex::debug::Profiler::pending_events() == 0);
+    {
+        rex::debug::ProfileScope scope("test", "disabled");
+        COUNT_profile_set("test/disabled", 1);
+        COUNT_profile_add("test/disabled", 1);
+        rex::debug::Profiler::Flip();
+    }
+    CHECK(rex::debug::Profiler::pending_events() == 0);
+}
+
+TEST_CASE("Profiler writes zones, counters and frames from every thread", "[profiling]") {
+    auto path = std::filesystem::temp_directory_path() / "rex_profiling_test.json";
+    REXCVAR_SET(profiler_output, path.string());
+
+    rex::debug::Profiler::set_enabled(true);
+    REQUIRE(rex::debug::Profiler::is_enabled());
+
+    std::thread worker([] {
+        PROFILE_THREAD_ENTER("Profiled Worker");
+        for (int i = 0; i < 10; ++i) {
+            SCOPE_profile_cpu_i("test", "worker zone");
+        }
+        PROFILE_THREAD_EXIT();
+    });
+    for (int i = 0; i < 5; ++i) {
+        ProfiledFunction();
+    }
+    COUNT_profile_set("test/counter", 3);
+    COUNT_profile_add("test/counter", 4);
+    rex::debug::Profiler::Flip();
+    worker.join();
+
+    rex::debug::Profiler::set_enabled(false);
+    REQUIRE_FALSE(rex::debug::Profiler::is_enabled());
+
+    std::string profile = ReadTestFile(path);
+    std::filesystem::remove(path);
+
+    REQUIRE(profile.front() == '[');
+    REQUIRE(profile.find(']') != std::string::npos);
+    CHECK(CountOccurrences(profile, "\"name\":\"worker zone\"") == 10);
+    CHECK(CountOccurrences(profile, "\"name\":\"ProfiledFunction\"") == 5);
+    CHECK(CountOccurrences(profile, "\"name\":\"Profiled Worker\"") == 1);
+    CHECK(profile.find("\"value\":3") != std::string::npos);
+    CHECK(profile.find("\"value\":7") != std::string::npos);
+    CHECK(CountOccurrences(profile, "\"name\":\"Frame\"") == 1);
+}
+
+TEST_CASE("Profiler counters sum updates from every thread", "[profiling]") {
+    auto path = std::filesystem::temp_directory_path() / "rex_profiling_counter_test.json";
+    REXCVAR_SET(profiler_output, path.string());
+
+    rex::debug::Profiler::set_enabled(true);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; ++t) {
+        workers.emplace_back([] {
+            for (int i = 0; i < 1000; ++i) {
+                COUNT_profile_add("test/shared", 1);
+            }
+            PROFILE_THREAD_EXIT();
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    rex::debug::Profiler::set_enabled(false);
+
+    std::string profile = ReadTestFile(path);
+    std::filesystem::remove(path);
+
+    CHECK(CountOccurrences(profile, "\"name\":\"test/shared\"") == 4000);
+    CHECK(profile.find("\"value\":4000}") != std::string::npos);
+}
@@ -6,6 +6,10 @@
 
 #include <catch2/catch_test_macros.hpp>
 
+#include <filesystem>
+#include <fstream>
+#include <string>
+
 #include <rex/sha256.h>
 
 TEST_CASE("sha256 empty string", "[sha256]") {
@@ -23,3 +27,19 @@ TEST_CASE("sha256 file content", "[sha256]") {
     auto hash = rex::util::sha256(content);
     CHECK(hash.size() == 64);
 }
+
+TEST_CASE("sha256_file matches sha256 of the content", "[sha256]") {
+    // Longer than one read chunk, so the file is hashed in pieces
+    std::string content(200000, '\0');
+    for (size_t i = 0; i < content.size(); ++i) {
+        content[i] = char(i * 31 + 7);
+    }
+    auto path = std::filesystem::temp_directory_path() / "rex_sha256_file_test.bin";
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(content.data(), std::streamsize(content.size()));
+    }
+    CHECK(rex::util::sha256_file(path) == rex::util::sha256(content));
+    std::filesystem::remove(path);
+    CHECK(rex::util::sha256_file(path).empty());
+}
@@ -0,0 +1,22 @@
+/**
+ * @file        test_files.h
+ * @brief       File helpers shared by the core unit tests
+ *
+ * @copyright   Copyright (c) 2026 Tom Clay
+ * @license     BSD 3-Clause License
+ */
+
+#pragma once
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+// Whole file as a string, or empty if it can't be read.
+inline std::string ReadTestFile(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
@@ -0,0 +1,105 @@
+/**
+ * @file        wait_handle_test.cpp
+ * @brief       Unit tests for rex::thread wait handle semantics
+ *
+ * @copyright   Copyright (c) 2026 Tom Clay
+ * @license     BSD 3-Clause License
+ */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <rex/thread.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace std::chrono_literals;
+using rex::thread::Event;
+using rex::thread::Semaphore;
+using rex::thread::WaitHandle;
+using rex::thread::WaitResult;
+
+// Upper bound for waits that are expected to succeed; only reached on failure
+constexpr auto kGenerous = 10s;
+
+TEST_CASE("Auto-reset event releases exactly one waiter per Set", "[thread][wait]") {
+    auto event = Event::CreateAutoResetEvent(false);
+    std::atomic<int> woken{0};
+
+    auto wait = [&] {
+        if (rex::thread::Wait(event.get(), false, kGenerous) == WaitResult::kSuccess) woken++;
+    };
+    std::thread a(wait);
+    std::thread b(wait);
+
+    // A second Set before the first is consumed would be lost, so let one land
+    event->Set();
+    auto deadline = std::chrono::steady_clock::now() + kGenerous;
+    while (woken.load() == 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+    REQUIRE(woken.load() == 1);
+
+    event->Set();
+    a.join();
+    b.join();
+    CHECK(woken.load() == 2);
+
+    // Had one Set released both waiters, the other would still be pending
+    CHECK(rex::thread::Wait(event.get(), false, 0ms) == WaitResult::kTimeout);
+}
+
+TEST_CASE("Signalling one handle does not satisfy waiters on another", "[thread][wait]") {
+    auto first = Event::CreateManualResetEvent(false);
+    auto second = Event::CreateManualResetEvent(false);
+
+    // Whether first is set before or during the wait, only the timeout may end it
+    std::atomic<WaitResult> result{WaitResult::kSuccess};
+    std::thread waiter([&] { result = rex::thread::Wait(second.get(), false, 50ms); });
+    first->Set();
+    waiter.join();
+    CHECK(result.load() == WaitResult::kTimeout);
+
+    std::thread released([&] { result = rex::thread::Wait(second.get(), false, kGenerous); });
+    second->Set();
+    released.join();
+    CHECK(result.load() == WaitResult::kSuccess);
+}
+
+TEST_CASE("WaitAny reports the signalled handle", "[thread][wait]") {
+    auto a = Event::CreateAutoResetEvent(false);
+    auto b = Event::CreateAutoResetEvent(false);
+    WaitHandle* handles[] = {a.get(), b.get()};
+
+    std::thread signaller([&] {
+        std::this_thread::sleep_for(20ms);
+        b->Set();
+    });
+    auto [result, index] = rex::thread::WaitAny(handles, 2, false, kGenerous);
+    signaller.join();
+
+    CHECK(result == WaitResult::kSuccess);
+    CHECK(index == 1);
+    // Auto-reset: consumed by the wait
+    CHECK(rex::thread::Wait(b.get(), false, 0ms) == WaitResult::kTimeout);
+}
+
+TEST_CASE("WaitAll needs every handle and consumes them together", "[thread][wait]") {
+    auto event = Event::CreateAutoResetEvent(false);
+    auto semaphore = Semaphore::Create(0, 4);
+    WaitHandle* handles[] = {event.get(), semaphore.get()};
+
+    event->Set();
+    CHECK(rex::thread::WaitAll(handles, 2, false, 20ms) == WaitResult::kTimeout);
+
+    std::thread releaser([&] {
+        std::this_thread::sleep_for(20ms);
+        semaphore->Release(1, nullptr);
+    });
+    CHECK(rex::thread::WaitAll(handles, 2, false, kGenerous) == WaitResult::kSuccess);
+    releaser.join();
+
+    CHECK(rex::thread::Wait(event.get(), false, 0ms) == WaitResult::kTimeout);
+    CHECK(rex::thread::Wait(semaphore.get(), false, 0ms) == WaitResult::kTimeout);
+}
@@ -0,0 +1,437 @@
+/**
+ * @file        shader_interpreter_test.cpp
+ * @brief       Unit tests for batched execution in the CPU shader interpreter
+ *
+ * ExecuteBatch must produce bit-identical exports to running Execute once
+ * per vertex, for every lane count and for both lockstep and divergent
+ * control flow.
+ *
+ * @copyright   Copyright (c) 2026 Tom Clay
+ * @license     BSD 3-Clause License
+ */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <rex/graphics/pipeline/shader/interpreter.h>
+#include <rex/graphics/register_file.h>
+#include <rex/kernel/xmemory.h>
+#include <rex/string/buffer.h>
+
+#include "../memory/test_memory.h"
+
+namespace {
+
+namespace gpu = rex::graphics;
+namespace ucode = rex::graphics::ucode;
+namespace xenos = rex::graphics::xenos;
+
+constexpr uint32_t kVertexCount = 64;
+constexpr uint32_t kVertexStride = 5;
+
+// --- Microcode encoding ------------------------------------------------------
+
+// One 48-bit control flow instruction.
+struct Cf {
+    uint32_t word0;
+    uint32_t word1;
+};
+
+// Sequence bits of an exec, one character per instruction, 'f' for fetch.
+uint32_t Sequence(const char* instructions) {
+    uint32_t sequence = 0;
+    for (uint32_t i = 0; instructions[i]; ++i) {
+        sequence |= uint32_t(instructions[i] == 'f') << (i * 2);
+    }
+    return sequence;
+}
+
+Cf Exec(uint32_t address, const char* instructions, bool end) {
+    auto opcode = end ? ucode::ControlFlowOpcode::kExecEnd : ucode::ControlFlowOpcode::kExec;
+    return {address | uint32_t(std::strlen(instructions)) << 12 | Sequence(instructions) << 16,
+            uint32_t(opcode) << 12};
+}
+
+Cf CondExecPred(uint32_t address, const char* instructions, bool condition) {
+    return {address | uint32_t(std::strlen(instructions)) << 12 | Sequence(instructions) << 16,
+            uint32_t(condition) << 10 | uint32_t(ucode::ControlFlowOpcode::kCondExecPred) << 12};
+}
+
+Cf PredicatedJump(uint32_t target_cf, bool condition) {
+    return {target_cf | 1u << 14,
+            uint32_t(condition) << 10 | uint32_t(ucode::ControlFlowOpcode::kCondJmp) << 12};
+}
+
+void AppendCfPair(std::vector<uint32_t>& ucode, Cf a, Cf b) {
+    ucode.push_back(a.word0);
+    ucode.push_back((a.word1 & 0xFFFF) | b.word0 << 16);
+    ucode.push_back(b.word0 >> 16 | b.word1 << 16);
+}
+
+// Component-relative ALU source swizzle from absolute component indices.
+constexpr uint32_t Swizzle(uint32_t x, uint32_t y, uint32_t z, uint32_t w) {
+    return ((x - 0) & 3) | ((y - 1) & 3) << 2 | ((z - 2) & 3) << 4 | ((w - 3) & 3) << 6;
+}
+constexpr uint32_t kSwizzleXYZW = Swizzle(0, 1, 2, 3);
+
+struct Alu {
+    ucode::AluVectorOpcode vector_opcode = ucode::AluVectorOpcode::kMax;
+    ucode::AluScalarOpcode scalar_opcode = ucode::AluScalarOpcode::kRetainPrev;
+    uint32_t vector_dest = 0;
+    uint32_t scalar_dest = 0;
+    uint32_t vector_write_mask = 0;
+    uint32_t scalar_write_mask = 0;
+    bool export_data = false;
+    // src1, src2 and src3; temporaries if src_temp, float constants otherwise.
+    uint32_t src_reg[3] = {};
+    bool src_temp[3] = {};
+    uint32_t src_swizzle[3] = {kSwizzleXYZW, kSwizzleXYZW, kSwizzleXYZW};
+    bool is_predicated = false;
+    bool predicate_condition = false;
+    // Adds a0 to the index of the first constant operand.
+    bool const_0_a0_relative = false;
+
+    void AppendTo(std::vector<uint32_t>& ucode) const {
+        ucode.push_back(vector_dest | scalar_dest << 8 | uint32_t(export_data) << 15 |
+                        vector_write_mask << 16 | scalar_write_mask << 20 |
+                        uint32_t(scalar_opcode) << 26);
+        ucode.push_back(src_swizzle[2] | src_swizzle[1] << 8 | src_swizzle[0] << 16 |
+                        uint32_t(predicate_condition) << 27 | uint32_t(is_predicated) << 28 |
+                        uint32_t(const_0_a0_relative) << 29 |
+                        uint32_t(const_0_a0_relative) << 31);
+        ucode.push_back(src_reg[2] | src_reg[1] << 8 | src_reg[0] << 16 |
+                        uint32_t(vector_opcode) << 24 | uint32_t(src_temp[2]) << 29 |
+                        uint32_t(src_temp[1]) << 30 | uint32_t(src_temp[0]) << 31);
+    }
+};
+
+// Fetch destination swizzle, 3 bits per component: 0-3 xyzw, 4 zero, 5 one.
+constexpr uint32_t FetchSwizzle(uint32_t x, uint32_t y, uint32_t z, uint32_t w) {
+    return x | y << 3 | z << 6 | w << 9;
+}
+
+// vfetch from fetch constant 0 indexed by r0.x.
+void AppendVertexFetch(std::vector<uint32_t>& ucode, uint32_t dest, uint32_t dest_swizzle,
+                       xenos::VertexFormat format, int32_t offset, bool is_mini) {
+    ucode.push_back(dest << 12 | 1u << 19);
+    ucode.push_back(dest_swizzle | uint32_t(format) << 16 | uint32_t(is_mini) << 30);
+    ucode.push_back(kVertexStride | (uint32_t(offset) & 0x7FFFFF) << 8);
+}
+
+std::unique_ptr<gpu::Shader> MakeShader(uint64_t hash, const std::vector<uint32_t>& ucode) {
+    auto shader = std::make_unique<gpu::Shader>(xenos::ShaderType::kVertex, hash, ucode.data(),
+                                                ucode.size(), std::endian::native);
+    rex::string::StringBuffer disasm;
+    shader->AnalyzeUcode(disasm);
+    return shader;
+}
+
+// Lockstep shader: fetches, dot products, predication on the position sign,
+// a0-relative constants, and exports from both ALU halves.
+std::unique_ptr<gpu::Shader> MakeLockstepShader() {
+    std::vector<uint32_t> ucode;
+    AppendCfPair(ucode, Exec(2, "ffaaa", false), CondExecPred(7, "a", false));
+    AppendCfPair(ucode, Exec(8, "aaa", false), Exec(11, "a", true));
+
+    // r1 = position.xyz1, r2 = uv.xy01.
+    AppendVertexFetch(ucode, 1, FetchSwizzle(0, 1, 2, 5), xenos::VertexFormat::k_32_32_32_FLOAT,
+                      0, false);
+    AppendVertexFetch(ucode, 2, FetchSwizzle(0, 1, 4, 5), xenos::VertexFormat::k_32_32_FLOAT, 3,
+                      true);
+
+    // r3.x = dp4(r1, c0); p0 = r1.y > 0.
+    Alu dp4_x;
+    dp4_x.vector_opcode = ucode::AluVectorOpcode::kDp4;
+    dp4_x.vector_dest = 3;
+    dp4_x.vector_write_mask = 0b0001;
+    dp4_x.src_reg[0] = 1;
+    dp4_x.src_temp[0] = true;
+    dp4_x.src_reg[1] = 0;
+    dp4_x.scalar_opcode = ucode::AluScalarOpcode::kSetpGt;
+    dp4_x.src_reg[2] = 1;
+    dp4_x.src_temp[2] = true;
+    dp4_x.src_swizzle[2] = Swizzle(0, 0, 0, 1);
+    dp4_x.AppendTo(ucode);
+
+    // r3.y = dp4(r1, c1).
+    Alu dp4_y = dp4_x;
+    dp4_y.vector_write_mask = 0b0010;
+    dp4_y.src_reg[1] = 1;
+    dp4_y.scalar_opcode = ucode::AluScalarOpcode::kRetainPrev;
+    dp4_y.AppendTo(ucode);
+
+    // (p0) r3.xy = r3 * c2.
+    Alu scale;
+    scale.vector_opcode = ucode::AluVectorOpcode::kMul;
+    scale.vector_dest = 3;
+    scale.vector_write_mask = 0b0011;
+    scale.src_reg[0] = 3;
+    scale.src_temp[0] = true;
+    scale.src_reg[1] = 2;
+    scale.is_predicated = true;
+    scale.predicate_condition = true;
+    scale.AppendTo(ucode);
+
+    // (!p0) r3.zw = r2 + c3, in a predicated exec.
+    Alu offset;
+    offset.vector_opcode = ucode::AluVectorOpcode::kAdd;
+    offset.vector_dest = 3;
+    offset.vector_write_mask = 0b1100;
+    offset.src_reg[0] = 2;
+    offset.src_temp[0] = true;
+    offset.src_reg[1] = 3;
+    offset.AppendTo(ucode);
+
+    // a0 = r2.y.
+    Alu set_a0;
+    set_a0.vector_opcode = ucode::AluVectorOpcode::kMaxA;
+    set_a0.src_reg[0] = 2;
+    set_a0.src_temp[0] = true;
+    set_a0.src_swizzle[0] = Swizzle(1, 1, 1, 1);
+    set_a0.src_reg[1] = 2;
+    set_a0.src_temp[1] = true;
+    set_a0.src_swizzle[1] = Swizzle(1, 1, 1, 1);
+    set_a0.AppendTo(ucode);
+
+    // r5 = c[4 + a0] + r1.
+    Alu relative;
+    relative.vector_opcode = ucode::AluVectorOpcode::kAdd;
+    relative.vector_dest = 5;
+    relative.vector_write_mask = 0b1111;
+    relative.src_reg[0] = 4;
+    relative.src_reg[1] = 1;
+    relative.src_temp[1] = true;
+    relative.const_0_a0_relative = true;
+    relative.AppendTo(ucode);
+
+    // oPos = r3 * c7 + r5; ps = sin(r5.w).
+    Alu position;
+    position.vector_opcode = ucode::AluVectorOpcode::kMad;
+    position.vector_dest = uint32_t(ucode::ExportRegister::kVSPosition);
+    position.export_data = true;
+    position.vector_write_mask = 0b1111;
+    position.src_reg[0] = 3;
+    position.src_temp[0] = true;
+    position.src_reg[1] = 7;
+    position.src_reg[2] = 5;
+    position.src_temp[2] = true;
+    position.scalar_opcode = ucode::AluScalarOpcode::kSin;
+    position.AppendTo(ucode);
+
+    // o0.xyz = r5 + r1; o0.w = sin(r1.x).
+    Alu interpolator;
+    interpolator.vector_opcode = ucode::AluVectorOpcode::kAdd;
+    interpolator.vector_dest = uint32_t(ucode::ExportRegister::kVSInterpolator0);
+    interpolator.export_data = true;
+    interpolator.vector_write_mask = 0b0111;
+    interpolator.scalar_write_mask = 0b1000;
+    interpolator.src_reg[0] = 5;
+    interpolator.src_temp[0] = true;
+    interpolator.src_reg[1] = 1;
+    interpolator.src_temp[1] = true;
+    interpolator.scalar_opcode = ucode::AluScalarOpcode::kSin;
+    interpolator.src_reg[2] = 1;
+    interpolator.src_temp[2] = true;
+    interpolator.src_swizzle[2] = Swizzle(0, 0, 0, 0);
+    interpolator.AppendTo(ucode);
+
+    return MakeShader(0x10C857E9, ucode);
+}
+
+// Divergent shader: lanes jump over the first exec_end when r1.y > 0.
+std::unique_ptr<gpu::Shader> MakeDivergentShader() {
+    std::vector<uint32_t> ucode;
+    AppendCfPair(ucode, Exec(2, "fa", false), PredicatedJump(3, true));
+    AppendCfPair(ucode, Exec(4, "a", true), Exec(5, "a", true));
+
+    AppendVertexFetch(ucode, 1, FetchSwizzle(0, 1, 2, 5), xenos::VertexFormat::k_32_32_32_FLOAT,
+                      0, false);
+
+    // p0 = r1.y > 0.
+    Alu setp;
+    setp.scalar_opcode = ucode::AluScalarOpcode::kSetpGt;
+    setp.src_reg[2] = 1;
+    setp.src_temp[2] = true;
+    setp.src_swizzle[2] = Swizzle(0, 0, 0, 1);
+    setp.AppendTo(ucode);
+
+    // oPos = r1 * c0, or r1 + c1 past the jump.
+    for (auto opcode : {ucode::AluVectorOpcode::kMul, ucode::AluVectorOpcode::kAdd}) {
+        Alu position;
+        position.vector_opcode = opcode;
+        position.vector_dest = uint32_t(ucode::ExportRegister::kVSPosition);
+        position.export_data = true;
+        position.vector_write_mask = 0b1111;
+        position.src_reg[0] = 1;
+        position.src_temp[0] = true;
+        position.src_reg[1] = opcode == ucode::AluVectorOpcode::kMul ? 0 : 1;
+        position.AppendTo(ucode);
+    }
+
+    return MakeShader(0xD1E1267E, ucode);
+}
+
+// --- Execution ---------------------------------------------------------------
+
+// Exported component bits by export register.
+using Exports = std::map<uint32_t, std::array<uint32_t, 4>>;
+
+class RecordingSink : public gpu::ShaderInterpreter::ExportSink {
+ public:
+    Exports exports;
+
+    void Export(ucode::ExportRegister export_register, const float* value,
+                uint32_t value_mask) override {
+        auto& components = exports[uint32_t(export_register)];
+        for (uint32_t i = 0; i < 4; ++i) {
+            if (value_mask & (1u << i)) {
+                components[i] = std::bit_cast<uint32_t>(value[i]);
+            }
+        }
+    }
+};
+
+class RecordingBatchSink : public gpu::ShaderInterpreter::BatchExportSink {
+ public:
+    Exports exports[gpu::ShaderInterpreter::kMaxBatchLanes];
+
+    void Export(ucode::ExportRegister export_register,
+                const float (*value)[gpu::ShaderInterpreter::kMaxBatchLanes], uint32_t value_mask,
+                uint32_t lane_mask) override {
+        for (uint32_t lane = 0; lane < gpu::ShaderInterpreter::kMaxBatchLanes; ++lane) {
+            if (!(lane_mask & (1u << lane))) {
+                continue;
+            }
+            auto& components = exports[lane][uint32_t(export_register)];
+            for (uint32_t i = 0; i < 4; ++i) {
+                if (value_mask & (1u << i)) {
+                    components[i] = std::bit_cast<uint32_t>(value[i][lane]);
+                }
+            }
+        }
+    }
+};
+
+struct InterpreterFixture {
+    std::unique_ptr<gpu::RegisterFile> registers = std::make_unique<gpu::RegisterFile>();
+    std::unique_ptr<gpu::ShaderInterpreter> interpreter;
+
+    InterpreterFixture() {
+        auto& memory = GetTestMemory();
+        std::mt19937 rng(1234);
+        std::uniform_real_distribution<float> distribution(-4.0f, 4.0f);
+
+        // Vertices of position.xyz, uv.x and a constant index in uv.y.
+        uint32_t buffer = memory.SystemHeapAlloc(kVertexCount * kVertexStride * 4, 4096,
+                                                 rex::memory::kSystemHeapPhysical);
+        REQUIRE(buffer);
+        uint32_t buffer_physical = memory.GetPhysicalAddress(buffer);
+        auto vertices = memory.TranslatePhysical<float*>(buffer_physical);
+        for (uint32_t i = 0; i < kVertexCount; ++i) {
+            for (uint32_t j = 0; j < 4; ++j) {
+                vertices[i * kVertexStride + j] = distribution(rng);
+            }
+            vertices[i * kVertexStride + 4] = float(i % 3);
+        }
+
+        auto& values = registers->values;
+        xenos::xe_gpu_vertex_fetch_t fetch = {};
+        fetch.type = xenos::FetchConstantType::kVertex;
+        fetch.address = buffer_physical >> 2;
+        fetch.endian = xenos::Endian::kNone;
+        fetch.size = kVertexCount * kVertexStride;
+        values[gpu::XE_GPU_REG_SHADER_CONSTANT_FETCH_00_0] = fetch.dword_0;
+        values[gpu::XE_GPU_REG_SHADER_CONSTANT_FETCH_00_0 + 1] = fetch.dword_1;
+
+        gpu::reg::SQ_VS_CONST vs_const = {};
+        vs_const.size = 255;
+        values[gpu::XE_GPU_REG_SQ_VS_CONST] = vs_const.value;
+        for (uint32_t i = 0; i < 16 * 4; ++i) {
+            values[gpu::XE_GPU_REG_SHADER_CONSTANT_000_X + i] =
+                std::bit_cast<uint32_t>(distribution(rng));
+        }
+
+        interpreter = std::make_unique<gpu::ShaderInterpreter>(*registers, memory);
+    }
+
+    Exports RunVertex(uint32_t index) {
+        RecordingSink sink;
+        std::memset(interpreter->temp_registers(), 0,
+                    sizeof(float) * 4 * xenos::kMaxShaderTempRegisters);
+        interpreter->temp_registers()[0] = float(index);
+        interpreter->SetExportSink(&sink);
+        interpreter->Execute();
+        interpreter->SetExportSink(nullptr);
+        return sink.exports;
+    }
+
+    void RunBatch(uint32_t first_index, uint32_t lane_count, RecordingBatchSink& sink) {
+        for (uint32_t r = 0; r < xenos::kMaxShaderTempRegisters; ++r) {
+            for (uint32_t c = 0; c < 4; ++c) {
+                std::memset(interpreter->batch_temp_register(r, c), 0,
+                            sizeof(float) * gpu::ShaderInterpreter::kMaxBatchLanes);
+            }
+        }
+        for (uint32_t lane = 0; lane < lane_count; ++lane) {
+            interpreter->batch_temp_register(0, 0)[lane] = float(first_index + lane);
+        }
+        interpreter->SetBatchExportSink(&sink);
+        interpreter->ExecuteBatch(lane_count);
+        interpreter->SetBatchExportSink(nullptr);
+    }
+
+    void CheckBatchMatchesScalar(const gpu::Shader& shader) {
+        interpreter->SetShader(shader);
+        std::vector<Exports> expected;
+        for (uint32_t i = 0; i < kVertexCount; ++i) {
+            expected.push_back(RunVertex(i));
+            REQUIRE(expected.back().count(uint32_t(ucode::ExportRegister::kVSPosition)));
+        }
+        for (uint32_t lane_count : {1u, 3u, 4u, 7u, 8u, 13u, 16u}) {
+            for (uint32_t first = 0; first + lane_count <= kVertexCount; first += lane_count) {
+                RecordingBatchSink sink;
+                RunBatch(first, lane_count, sink);
+                for (uint32_t lane = 0; lane < lane_count; ++lane) {
+                    INFO("lane count " << lane_count << " vertex " << first + lane);
+                    CHECK(sink.exports[lane] == expected[first + lane]);
+                }
+                for (uint32_t lane = lane_count; lane < gpu::ShaderInterpreter::kMaxBatchLanes;
+                     ++lane) {
+                    CHECK(sink.exports[lane].empty());
+                }
+            }
+        }
+    }
+};
+
+}  // namespace
+
+TEST_CASE("ExecuteBatch matches Execute for lockstep control flow", "[graphics][interpreter]") {
+    InterpreterFixture fixture;
+    auto shader = MakeLockstepShader();
+    REQUIRE(gpu::ShaderInterpreter::CanInterpretShader(*shader));
+    fixture.CheckBatchMatchesScalar(*shader);
+}
+
+TEST_CASE("ExecuteBatch matches Execute for divergent jumps", "[graphics][interpreter]") {
+    InterpreterFixture fixture;
+    auto shader = MakeDivergentShader();
+    fixture.CheckBatchMatchesScalar(*shader);
+}
+
+TEST_CASE("ExecuteBatch reuses decoded shaders across switches", "[graphics][interpreter]") {
+    InterpreterFixture fixture;
+    auto lockstep = MakeLockstepShader();
+    auto divergent = MakeDivergentShader();
+    fixture.CheckBatchMatchesScalar(*lockstep);
+    fixture.CheckBatchMatchesScalar(*divergent);
+    fixture.CheckBatchMatchesScalar(*lockstep);
+}
@@ -10,6 +10,10 @@
 #include <rex/kernel/xobject.h>
 #include <rex/kernel/util/object_table.h>
 
+#include <atomic>
+#include <thread>
+#include <vector>
+
 using namespace rex;
 using namespace rex::kernel;
 using namespace rex::kernel::util;
@@ -568,6 +572,178 @@ TEST_CASE("ObjectTable GetAllObjects returns all objects", "[kernel][object_tabl
   table.Reset();
 }
 
+// =============================================================================
+// ObjectTable Concurrency Tests
+// =============================================================================
+
+TEST_CASE("ObjectTable lookups racing removal never see a freed object", "[kernel][object_table]") {
+  InitTestLogging();
+  DestructorCountReset reset;
+
+  ObjectTable table;
+  constexpr int kRounds = 200;
+
+  for (int round = 0; round < kRounds; ++round) {
+    auto* obj = new TestObject();
+    X_HANDLE handle = 0;
+    table.AddHandle(obj, &handle);
+    obj->Release();  // Table owns the only reference
+
+    std::atomic<bool> go{false};
+    std::atomic<bool> bad_type{false};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+      readers.emplace_back([&] {
+        while (!go.load()) {
+        }
+        for (int i = 0; i < 100; ++i) {
+          auto found = table.LookupObject<XObject>(handle);
+          // Touching the object would crash or trip ASan if it were freed.
+          // Catch2 assertions aren't thread-safe, so just record the result.
+          if (found && found->type() != XObject::Type::Undefined) {
+            bad_type = true;
+          }
+        }
+      });
+    }
+
+    go = true;
+    CHECK(table.ReleaseHandle(handle) == X_STATUS_SUCCESS);
+    for (auto& reader : readers) {
+      reader.join();
+    }
+
+    CHECK_FALSE(bad_type.load());
+    CHECK(!table.LookupObject<XObject>(handle));
+  }
+
+  CHECK(TestObject::destructor_count == kRounds);
+  table.Reset();
+}
+
+TEST_CASE("ObjectTable slot reuse racing removal keeps the new handle's count", "[kernel][object_table]") {
+  InitTestLogging();
+  DestructorCountReset reset;
+
+  ObjectTable table;
+  constexpr int kThreads = 4;
+  constexpr int kIterations = 2000;
+
+  // Each thread keeps its own object alive and churns handles for it, so
+  // freed slots are constantly reused by the other threads.
+  std::vector<TestObject*> objects;
+  for (int t = 0; t < kThreads; ++t) {
+    objects.push_back(new TestObject());
+  }
+
+  std::atomic<bool> go{false};
+  std::atomic<int> failures{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&, obj = objects[t]] {
+      while (!go.load()) {
+      }
+      for (int i = 0; i < kIterations; ++i) {
+        X_HANDLE handle = 0;
+        if (table.AddHandle(obj, &handle) != X_STATUS_SUCCESS ||
+            table.ReleaseHandle(handle) != X_STATUS_SUCCESS) {
+          failures++;
+        }
+      }
+    });
+  }
+
+  go = true;
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  CHECK(failures.load() == 0);
+  for (auto* obj : objects) {
+    // A count clobbered by a late removal leaves the handle in the table
+    CHECK(obj->handles().empty());
+    obj->Release();
+  }
+  CHECK(TestObject::destructor_count == kThreads);
+  table.Reset();
+}
+
+TEST_CASE("ObjectTable retains racing the last release never revive a handle", "[kernel][object_table]") {
+  InitTestLogging();
+  DestructorCountReset reset;
+
+  ObjectTable table;
+  constexpr int kRounds = 200;
+
+  for (int round = 0; round < kRounds; ++round) {
+    auto* obj = new TestObject();
+    X_HANDLE handle = 0;
+    table.AddHandle(obj, &handle);
+    obj->Release();  // Table owns the only reference
+
+    std::atomic<bool> go{false};
+    std::atomic<int> failures{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+      threads.emplace_back([&] {
+        while (!go.load()) {
+        }
+        for (int i = 0; i < 100; ++i) {
+          if (table.RetainHandle(handle) != X_STATUS_SUCCESS) {
+            continue;
+          }
+          // A retained handle must stay open until it is released again
+          if (!table.LookupObject<XObject>(handle)) {
+            failures++;
+          }
+          if (table.ReleaseHandle(handle) != X_STATUS_SUCCESS) {
+            failures++;
+          }
+        }
+      });
+    }
+
+    go = true;
+    CHECK(table.ReleaseHandle(handle) == X_STATUS_SUCCESS);
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    CHECK(failures.load() == 0);
+    CHECK(!table.LookupObject<XObject>(handle));
+    CHECK(table.RetainHandle(handle) == X_STATUS_INVALID_HANDLE);
+    CHECK(table.ReleaseHandle(handle) == X_STATUS_INVALID_HANDLE);
+  }
+
+  CHECK(TestObject::destructor_count == kRounds);
+  table.Reset();
+}
+
+TEST_CASE("ObjectTable GetObjectByName retains the handle it returns", "[kernel][object_table]") {
+  InitTestLogging();
+  DestructorCountReset reset;
+
+  ObjectTable table;
+  auto* obj = new TestObject();
+  X_HANDLE handle = 0;
+  table.AddHandle(obj, &handle);
+  obj->Release();
+  REQUIRE(table.AddNameMapping("Named", handle) == X_STATUS_SUCCESS);
+
+  X_HANDLE found = 0;
+  REQUIRE(table.GetObjectByName("named", &found) == X_STATUS_SUCCESS);
+  CHECK(found == handle);
+
+  // Two references now; the first release leaves the handle open
+  CHECK(table.ReleaseHandle(handle) == X_STATUS_SUCCESS);
+  CHECK(table.LookupObject<XObject>(handle));
+  CHECK(table.ReleaseHandle(handle) == X_STATUS_SUCCESS);
+  CHECK(!table.LookupObject<XObject>(handle));
+  CHECK(TestObject::destructor_count == 1);
+
+  table.Reset();
+}
+
 // =============================================================================
 // TODO: Tests requiring kernel integration
 // =============================================================================
@@ -575,5 +751,4 @@ TEST_CASE("ObjectTable GetAllObjects returns all objects", "[kernel][object_tabl
 // TODO: Test handle 0xFFFFFFFF (CurrentProcess) - requires full KernelState
 // TODO: Test handle 0xFFFFFFFE (CurrentThread) - requires XThread integration
 // TODO: Test GetObjectsByType<T>() with real typed objects
-// TODO: Test GetObjectByName with existing object - requires kernel_state for RetainHandle
 // TODO: Test case-insensitive name lookup via GetObjectByName
@@ -0,0 +1,112 @@
+/**
+ * @file        copy_and_swap_test.cpp
+ * @brief       Unit tests for the copy_and_swap kernels
+ *
+ * @copyright   Copyright (c) 2026 Tom Clay
+ * @license     BSD 3-Clause License
+ */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <rex/memory/utils.h>
+
+namespace {
+
+using rex::memory::SwapKernel;
+
+using CopyFn = void (*)(void*, const void*, size_t);
+
+struct Variant {
+    const char* name;
+    CopyFn fn;
+    size_t element_size;
+    // Source byte for each destination byte within an element.
+    uint8_t pattern[8];
+};
+
+const Variant kVariants[] = {
+    {"16", rex::memory::copy_and_swap_16_unaligned, 2, {1, 0}},
+    {"32", rex::memory::copy_and_swap_32_unaligned, 4, {3, 2, 1, 0}},
+    {"64", rex::memory::copy_and_swap_64_unaligned, 8, {7, 6, 5, 4, 3, 2, 1, 0}},
+    {"16_in_32", rex::memory::copy_and_swap_16_in_32_unaligned, 4, {2, 3, 0, 1}},
+};
+
+void CheckKernel(SwapKernel kernel) {
+    REQUIRE(rex::memory::SetSwapKernel(kernel));
+    std::vector<uint8_t> src(1024 + 16);
+    for (size_t i = 0; i < src.size(); ++i) {
+        src[i] = uint8_t(i * 7 + 3);
+    }
+    for (const auto& variant : kVariants) {
+        for (size_t offset : {0, 1, 3}) {
+            for (size_t count = 0; count <= 1024 / variant.element_size;
+                 count += count < 80 ? 1 : 37) {
+                size_t size = count * variant.element_size;
+                // Guard bytes past the end catch overruns.
+                std::vector<uint8_t> dest(size + 64 + offset, 0xCD);
+                variant.fn(dest.data() + offset, src.data() + offset, count);
+                bool ok = true;
+                for (size_t i = 0; i < size; ++i) {
+                    size_t base = i - i % variant.element_size;
+                    uint8_t expected =
+                        src[offset + base + variant.pattern[i % variant.element_size]];
+                    ok &= dest[offset + i] == expected;
+                }
+                for (size_t i = offset + size; i < dest.size(); ++i) {
+                    ok &= dest[i] == 0xCD;
+                }
+                INFO("variant " << variant.name << " count " << count
+                                << " offset " << offset);
+                REQUIRE(ok);
+
+                // In place, as callers swapping a buffer in memory do.
+                std::vector<uint8_t> buffer(src.begin(), src.begin() + offset + size);
+                variant.fn(buffer.data() + offset, buffer.data() + offset, count);
+                REQUIRE(std::memcmp(buffer.data() + offset, dest.data() + offset, size) == 0);
+            }
+        }
+    }
+}
+
+}  // namespace
+
+TEST_CASE("copy_and_swap kernels match the scalar reference", "[memory][copy_and_swap]") {
+    SwapKernel original = rex::memory::GetSwapKernel();
+    for (auto kernel : {SwapKernel::kScalar, SwapKernel::kSSSE3, SwapKernel::kAVX2,
+                        SwapKernel::kAVX512, SwapKernel::kNEON}) {
+        if (!rex::memory::IsSwapKernelSupported(kernel)) {
+            continue;
+        }
+        INFO("kernel " << int(kernel));
+        CheckKernel(kernel);
+    }
+    REQUIRE(rex::memory::SetSwapKernel(original));
+}
+
+TEST_CASE("Unsupported copy_and_swap kernels are rejected", "[memory][copy_and_swap]") {
+    SwapKernel original = rex::memory::GetSwapKernel();
+    REQUIRE(rex::memory::IsSwapKernelSupported(original));
+    for (auto kernel : {SwapKernel::kSSSE3, SwapKernel::kAVX2, SwapKernel::kAVX512,
+                        SwapKernel::kNEON}) {
+        if (!rex::memory::IsSwapKernelSupported(kernel)) {
+            CHECK_FALSE(rex::memory::SetSwapKernel(kernel));
+            CHECK(rex::memory::GetSwapKernel() == original);
+        }
+    }
+}
+
+TEST_CASE("SetSwapKernel accepts exactly the supported kernels", "[memory][copy_and_swap]") {
+    SwapKernel original = rex::memory::GetSwapKernel();
+    for (auto kernel : {SwapKernel::kScalar, SwapKernel::kSSSE3, SwapKernel::kAVX2,
+                        SwapKernel::kAVX512, SwapKernel::kNEON}) {
+        INFO("kernel " << int(kernel));
+        bool supported = rex::memory::IsSwapKernelSupported(kernel);
+        CHECK(rex::memory::SetSwapKernel(kernel) == supported);
+        CHECK((rex::memory::GetSwapKernel() == kernel) == supported);
+        REQUIRE(rex::memory::SetSwapKernel(original));
+    }
+}
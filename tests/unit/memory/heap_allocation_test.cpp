@@ -11,24 +11,17 @@
 
 #include <catch2/catch_test_macros.hpp>
 
+#include <algorithm>
+#include <random>
+#include <vector>
+
 #include <rex/kernel/xmemory.h>
 #include <rex/cvar.h>
 #include <rex/logging.h>
 
-namespace {
+#include "test_memory.h"
 
-// Shared memory instance - expensive to create, reuse across tests
-rex::memory::Memory& GetTestMemory() {
-    static rex::memory::Memory memory;
-    static bool initialized = false;
-    if (!initialized) {
-        rex::InitLogging();
-        bool result = memory.Initialize();
-        REQUIRE(result);
-        initialized = true;
-    }
-    return memory;
-}
+namespace {
 
 // Helper to cast away const for heap operations
 rex::memory::BaseHeap* MutableHeap(const rex::memory::BaseHeap* heap) {
@@ -379,6 +372,112 @@ TEST_CASE("Release frees memory for reallocation", "[memory][heap]") {
     heap->Release(target, nullptr);
 }
 
+TEST_CASE("Released holes are reused by range allocation", "[memory][heap]") {
+    auto& memory = GetTestMemory();
+    auto* heap = MutableHeap(memory.LookupHeap(0x23000000));
+    REQUIRE(heap != nullptr);
+
+    const uint32_t base = 0x23000000;
+    const uint32_t alloc_type =
+        rex::memory::kMemoryAllocationReserve | rex::memory::kMemoryAllocationCommit;
+    const uint32_t protect =
+        rex::memory::kMemoryProtectRead | rex::memory::kMemoryProtectWrite;
+
+    // [A: 1 page][B: 4 pages][C: 1 page], then free B to leave a hole.
+    REQUIRE(heap->AllocFixed(base, 0x1000, 0x1000, alloc_type, protect));
+    REQUIRE(heap->AllocFixed(base + 0x1000, 0x4000, 0x1000, alloc_type, protect));
+    REQUIRE(heap->AllocFixed(base + 0x5000, 0x1000, 0x1000, alloc_type, protect));
+    REQUIRE(heap->Release(base + 0x1000, nullptr));
+
+    SECTION("Fits in the hole") {
+        uint32_t addr = 0;
+        REQUIRE(heap->AllocRange(base, base + 0x100000, 0x2000, 0x1000, alloc_type,
+                                 protect, false, &addr));
+        CHECK(addr == base + 0x1000);
+        heap->Release(addr, nullptr);
+    }
+
+    SECTION("Alignment moves the base within the hole") {
+        uint32_t addr = 0;
+        REQUIRE(heap->AllocRange(base, base + 0x100000, 0x1000, 0x4000, alloc_type,
+                                 protect, false, &addr));
+        CHECK(addr == base + 0x4000);
+        heap->Release(addr, nullptr);
+    }
+
+    SECTION("Too large for the hole goes past C") {
+        uint32_t addr = 0;
+        REQUIRE(heap->AllocRange(base, base + 0x100000, 0x5000, 0x1000, alloc_type,
+                                 protect, false, &addr));
+        CHECK(addr == base + 0x6000);
+        heap->Release(addr, nullptr);
+    }
+
+    SECTION("Top-down takes the highest fit below the range end") {
+        uint32_t addr = 0;
+        REQUIRE(heap->AllocRange(base, base + 0x10000, 0x2000, 0x1000, alloc_type,
+                                 protect, true, &addr));
+        CHECK(addr == base + 0xE000);
+        heap->Release(addr, nullptr);
+    }
+
+    heap->Release(base, nullptr);
+    heap->Release(base + 0x5000, nullptr);
+}
+
+TEST_CASE("FreePageIndex matches a linear scan", "[memory][heap]") {
+    constexpr uint32_t kPages = 300;
+    rex::memory::FreePageIndex index;
+    index.Initialize(kPages);
+    std::vector<bool> free_pages(kPages, true);
+
+    auto is_free = [&](uint32_t first, uint32_t count) {
+        return std::all_of(free_pages.begin() + first, free_pages.begin() + first + count,
+                           [](bool f) { return f; });
+    };
+    auto linear_first = [&](uint32_t begin, uint32_t end, uint32_t count) {
+        for (uint32_t p = begin; p + count <= end; ++p) {
+            if (is_free(p, count)) {
+                return p;
+            }
+        }
+        return rex::memory::FreePageIndex::kNotFound;
+    };
+    auto linear_last = [&](uint32_t begin, uint32_t end, uint32_t count) {
+        for (uint32_t p = end; p >= begin + count; --p) {
+            if (is_free(p - count, count)) {
+                return p - count;
+            }
+        }
+        return rex::memory::FreePageIndex::kNotFound;
+    };
+
+    std::mt19937 rng(1234);
+    for (int step = 0; step < 2000; ++step) {
+        uint32_t first = rng() % kPages;
+        uint32_t count = 1 + rng() % std::min<uint32_t>(kPages - first, 24);
+        bool mark_free = rng() % 2;
+        std::fill(free_pages.begin() + first, free_pages.begin() + first + count, mark_free);
+        if (mark_free) {
+            index.MarkFree(first, count);
+        } else {
+            index.MarkUsed(first, count);
+        }
+
+        uint32_t begin = rng() % kPages;
+        uint32_t end = begin + rng() % (kPages - begin + 1);
+        uint32_t want = 1 + rng() % 16;
+        REQUIRE(index.FindFirst(begin, end, want) == linear_first(begin, end, want));
+        REQUIRE(index.FindLast(begin, end, want) == linear_last(begin, end, want));
+
+        uint32_t used = begin;
+        while (used < end && free_pages[used]) {
+            ++used;
+        }
+        REQUIRE(index.FindUsed(begin, end) == used);
+    }
+}
+
 // =============================================================================
 // Heap Selection Tests (LookupHeap)
 // =============================================================================
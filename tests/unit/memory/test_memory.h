@@ -0,0 +1,28 @@
+/**
+ * @file        test_memory.h
+ * @brief       Guest memory shared by the unit tests
+ *
+ * @copyright   Copyright (c) 2026 Tom Clay
+ * @license     BSD 3-Clause License
+ */
+
+#pragma once
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <rex/kernel/xmemory.h>
+#include <rex/logging.h>
+
+// Only one Memory may exist at a time, as it installs the process-wide MMIO
+// handler, and it's expensive to create - so every test uses this one.
+inline rex::memory::Memory& GetTestMemory() {
+    static rex::memory::Memory memory;
+    static bool initialized = false;
+    if (!initialized) {
+        rex::InitLogging();
+        bool result = memory.Initialize();
+        REQUIRE(result);
+        initialized = true;
+    }
+    return memory;
+}
@@ -0,0 +1,173 @@
+/**
+ * @file        write_watch_test.cpp
+ * @brief       Unit tests for physical memory write watching
+ *
+ * @copyright   Copyright (c) 2026 Tom Clay
+ * @license     BSD 3-Clause License
+ */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <rex/kernel/xmemory.h>
+#include <rex/memory/utils.h>
+
+#include "test_memory.h"
+
+namespace {
+
+struct Invalidation {
+    uint32_t physical_address;
+    uint32_t length;
+};
+
+std::pair<uint32_t, uint32_t> RecordInvalidation(void* context_ptr,
+                                                 uint32_t physical_address_start,
+                                                 uint32_t length, bool exact_range) {
+    static_cast<std::vector<Invalidation>*>(context_ptr)
+        ->push_back({physical_address_start, length});
+    return {0, UINT32_MAX};
+}
+
+bool Invalidated(const std::vector<Invalidation>& invalidations, uint32_t physical_address) {
+    for (const Invalidation& invalidation : invalidations) {
+        if (physical_address >= invalidation.physical_address &&
+            physical_address - invalidation.physical_address < invalidation.length) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace
+
+TEST_CASE("WriteWatch collects written pages per view", "[memory][write_watch]") {
+    auto write_watch = rex::memory::WriteWatch::Create();
+    if (!write_watch) {
+        SKIP("Write watching is not supported by the host");
+    }
+
+    const size_t page_size = rex::memory::page_size();
+    const size_t length = page_size * 16;
+    auto mapping = rex::memory::CreateFileMappingHandle(
+        "rex_write_watch_test", length, rex::memory::PageAccess::kReadWrite, true);
+    REQUIRE(mapping != rex::memory::kFileMappingHandleInvalid);
+    auto view_a = static_cast<uint8_t*>(rex::memory::MapFileView(
+        mapping, nullptr, length, rex::memory::PageAccess::kReadWrite, 0));
+    auto view_b = static_cast<uint8_t*>(rex::memory::MapFileView(
+        mapping, nullptr, length, rex::memory::PageAccess::kReadWrite, 0));
+    REQUIRE(view_a);
+    REQUIRE(view_b);
+
+    REQUIRE(write_watch->Register(view_a, length));
+    REQUIRE(write_watch->Register(view_b, length));
+    REQUIRE(write_watch->Arm(view_a, length));
+    REQUIRE(write_watch->Arm(view_b, length));
+
+    std::vector<std::pair<size_t, size_t>> written;
+    REQUIRE(write_watch->CollectWritten(view_a, length, written));
+    CHECK(written.empty());
+
+    // Pages 2-3 and 7 through view A.
+    view_a[page_size * 2 + 5] = 1;
+    view_a[page_size * 3] = 2;
+    view_a[page_size * 8 - 1] = 3;
+    REQUIRE(write_watch->CollectWritten(view_a, length, written));
+    REQUIRE(written.size() == 2);
+    CHECK(written[0] == std::make_pair(page_size * 2, page_size * 2));
+    CHECK(written[1] == std::make_pair(page_size * 7, page_size));
+
+    // Only the view written through sees the writes.
+    written.clear();
+    REQUIRE(write_watch->CollectWritten(view_b, length, written));
+    CHECK(written.empty());
+    CHECK(view_b[page_size * 3] == 2);
+
+    // Collecting armed the pages again.
+    REQUIRE(write_watch->CollectWritten(view_a, length, written));
+    CHECK(written.empty());
+    view_a[page_size * 3 + 1] = 4;
+    REQUIRE(write_watch->CollectWritten(view_a, length, written));
+    REQUIRE(written.size() == 1);
+    CHECK(written[0] == std::make_pair(page_size * 3, page_size));
+
+    write_watch.reset();
+    rex::memory::UnmapFileView(mapping, view_b, length);
+    rex::memory::UnmapFileView(mapping, view_a, length);
+    rex::memory::CloseFileMappingHandle(mapping, "rex_write_watch_test");
+}
+
+TEST_CASE("Physical memory writes trigger invalidation callbacks", "[memory][write_watch]") {
+    auto& memory = GetTestMemory();
+    const uint32_t size = 0x10000;
+    uint32_t address = memory.SystemHeapAlloc(size, 4096, rex::memory::kSystemHeapPhysical);
+    REQUIRE(address != 0);
+    uint32_t physical_address = memory.GetPhysicalAddress(address);
+    auto host = memory.TranslateVirtual<uint8_t*>(address);
+
+    std::vector<Invalidation> invalidations;
+    void* callback_handle =
+        memory.RegisterPhysicalMemoryInvalidationCallback(RecordInvalidation, &invalidations);
+    memory.EnablePhysicalMemoryAccessCallbacks(physical_address, size, true, false);
+
+    // Trapped right away with page protection, recorded until the poll with
+    // the host write watch - the same callbacks either way.
+    host[0x4010] = 1;
+    memory.PollPhysicalMemoryWrites();
+    CHECK(Invalidated(invalidations, physical_address + 0x4010));
+    CHECK_FALSE(Invalidated(invalidations, physical_address + 0x8000));
+    CHECK(host[0x4010] == 1);
+
+    // Invalidated pages are no longer watched.
+    invalidations.clear();
+    host[0x4020] = 2;
+    memory.PollPhysicalMemoryWrites();
+    CHECK(invalidations.empty());
+
+    // Until enabled again.
+    memory.EnablePhysicalMemoryAccessCallbacks(physical_address, size, true, false);
+    host[0x8000] = 3;
+    memory.PollPhysicalMemoryWrites();
+    CHECK(Invalidated(invalidations, physical_address + 0x8000));
+
+    memory.UnregisterPhysicalMemoryInvalidationCallback(callback_handle);
+    memory.SystemHeapFree(address);
+}
+
+TEST_CASE("Unwatched pages between watched ones aren't reported as written", "[memory][write_watch]") {
+    auto& memory = GetTestMemory();
+    const uint32_t size = 0x40000;
+    uint32_t address = memory.SystemHeapAlloc(size, 4096, rex::memory::kSystemHeapPhysical);
+    REQUIRE(address != 0);
+    uint32_t physical_address = memory.GetPhysicalAddress(address);
+    auto host = memory.TranslateVirtual<uint8_t*>(address);
+
+    std::vector<Invalidation> invalidations;
+    void* callback_handle =
+        memory.RegisterPhysicalMemoryInvalidationCallback(RecordInvalidation, &invalidations);
+    // Drop anything still watched from earlier tests.
+    memory.PollPhysicalMemoryWrites();
+    invalidations.clear();
+
+    // Only the first and the last page are armed; most of the span between
+    // them has never been.
+    memory.EnablePhysicalMemoryAccessCallbacks(physical_address, 0x1000, true, false);
+    memory.EnablePhysicalMemoryAccessCallbacks(physical_address + size - 0x1000, 0x1000, true,
+                                               false);
+    memory.PollPhysicalMemoryWrites();
+    CHECK(invalidations.empty());
+
+    // A write next to a watched page must not invalidate the unwatched one.
+    host[size - 0x2000] = 1;
+    host[size - 0x1000] = 2;
+    memory.PollPhysicalMemoryWrites();
+    CHECK(Invalidated(invalidations, physical_address + size - 0x1000));
+    CHECK_FALSE(Invalidated(invalidations, physical_address + size - 0x2000));
+    CHECK_FALSE(Invalidated(invalidations, physical_address + 0x20000));
+
+    memory.UnregisterPhysicalMemoryInvalidationCallback(callback_handle);
+    memory.SystemHeapFree(address);
+}